@@ -29,6 +29,7 @@ NS_ASSUME_NONNULL_BEGIN
 typedef void (^StorageProviderReadCompletionBlock)(StorageProviderReadResult result, NSData *_Nullable data, NSDate*_Nullable dateModified, const NSError *_Nullable error);
 typedef void (^StorageProviderUpdateCompletionBlock)(StorageProviderUpdateResult result, NSDate*_Nullable newRemoteModDate, const NSError *_Nullable error);
 typedef void (^StorageProviderGetModDateCompletionBlock)(NSDate*_Nullable modDate, const NSError *_Nullable error);
+typedef void (^StorageProviderStreamReadCompletionBlock)(StorageProviderReadResult result, NSInputStream *_Nullable stream, NSDate*_Nullable dateModified, const NSError *_Nullable error);
 
 @protocol SafeStorageProvider <NSObject>
 
@@ -78,6 +79,20 @@ typedef void (^StorageProviderGetModDateCompletionBlock)(NSDate*_Nullable modDat
 - (void)getModDate:(METADATA_PTR)safeMetaData
         completion:(StorageProviderGetModDateCompletionBlock)completion;
 
+@optional
+
+// Streaming variants. SafeStorageProviderStreamAdapter falls back to the NSData methods above if these are not implemented.
+
+- (void)pullDatabaseStream:(METADATA_PTR )safeMetaData
+             interactiveVC:(VIEW_CONTROLLER_PTR _Nullable)viewController
+                   options:(StorageProviderReadOptions*)options
+                completion:(StorageProviderStreamReadCompletionBlock)completion;
+
+- (void)pushDatabaseStream:(METADATA_PTR )safeMetaData
+             interactiveVC:(VIEW_CONTROLLER_PTR _Nullable)viewController
+                    stream:(NSInputStream *)stream
+                completion:(StorageProviderUpdateCompletionBlock)completion;
+
 @end
 
 NS_ASSUME_NONNULL_END
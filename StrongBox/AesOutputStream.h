@@ -13,6 +13,9 @@ NS_ASSUME_NONNULL_BEGIN
 @interface AesOutputStream : NSOutputStream
 
 - (instancetype)initToOutputStream:(NSOutputStream *)outputStream encrypt:(BOOL)encrypt key:(NSData*)key iv:(NSData*)iv chainOpensAndCloses:(BOOL)chainOpensAndCloses;
+- (instancetype)initToOutputStream:(NSOutputStream *)outputStream encrypt:(BOOL)encrypt key:(NSData*)key iv:(NSData*)iv chainOpensAndCloses:(BOOL)chainOpensAndCloses chunkSize:(size_t)chunkSize;
+
+@property (readonly) size_t chunkSize;
 
 @end
 
@@ -9,11 +9,14 @@
 #import "AesOutputStream.h"
 #import <CommonCrypto/CommonCrypto.h>
 #import "Utils.h"
+#import "AesInputStream.h"
 
 @interface AesOutputStream ()
 
 @property NSOutputStream* outputStream;
 @property CCCryptorRef *cryptor;
+@property size_t chunkSize;
+@property uint8_t* workChunk;
 @property NSError* error;
 
 @property BOOL closed;
@@ -25,6 +28,10 @@
 @implementation AesOutputStream
 
 - (instancetype)initToOutputStream:(NSOutputStream *)outputStream encrypt:(BOOL)encrypt key:(NSData *)key iv:(NSData *)iv chainOpensAndCloses:(BOOL)chainOpensAndCloses {
+    return [self initToOutputStream:outputStream encrypt:encrypt key:key iv:iv chainOpensAndCloses:chainOpensAndCloses chunkSize:kAesStreamDefaultChunkSize];
+}
+
+- (instancetype)initToOutputStream:(NSOutputStream *)outputStream encrypt:(BOOL)encrypt key:(NSData *)key iv:(NSData *)iv chainOpensAndCloses:(BOOL)chainOpensAndCloses chunkSize:(size_t)chunkSize {
     if (self = [super init]) {
         if (outputStream == nil) {
             return nil;
@@ -36,9 +43,13 @@
         
         if (status != kCCSuccess) {
             NSLog(@"Crypto Error: %d", status);
+            free(_cryptor);
+            _cryptor = nil;
             return nil;
         }
 
+        self.chunkSize = MAX(kCCBlockSizeAES128, chunkSize - (chunkSize % kCCBlockSizeAES128));
+        self.workChunk = malloc(self.chunkSize + kCCBlockSizeAES128);
         self.outputStream = outputStream;
         self.chainOpensAndCloses = chainOpensAndCloses;
     }
@@ -63,35 +74,46 @@
     }
     self.closed = YES;
         
-    size_t encRequired = CCCryptorGetOutputLength(*_cryptor, 0, YES);
-    uint8_t* encBlock = malloc(encRequired);
     size_t encWritten;
 
-    CCCryptorStatus status = CCCryptorFinal(*_cryptor, encBlock, encRequired, &encWritten);
+    CCCryptorStatus status = CCCryptorFinal(*_cryptor, self.workChunk, self.chunkSize + kCCBlockSizeAES128, &encWritten);
     if (status != kCCSuccess) {
         NSLog(@"Crypto Error: %d", status);
         self.error = [Utils createNSError:[NSString stringWithFormat:@"Crypto Error: %d", status] errorCode:status];
-        free(encBlock);
+        [self releaseResources];
         return;
     }
 
     if (encWritten > 0) {
-        NSInteger wrote = [self.outputStream write:encBlock maxLength:encWritten];
+        NSInteger wrote = [self.outputStream write:self.workChunk maxLength:encWritten];
         if ( wrote < 0 ) {
             NSLog(@"Error Writing final AES Block");
+            [self releaseResources];
             return;
         }
     }
     
-    free(encBlock);
-    
     if ( self.chainOpensAndCloses ) {
         [self.outputStream close];
     }
     
     self.outputStream = nil;
     
+    [self releaseResources];
+}
+
+- (void)dealloc {
+    [self releaseResources];
+}
+
+- (void)releaseResources {
+    if (self.workChunk) {
+        free(self.workChunk);
+        self.workChunk = nil;
+    }
+    
     if (self.cryptor) {
+        CCCryptorRelease(*_cryptor);
         free(self.cryptor);
         self.cryptor = nil;
     }
@@ -103,29 +125,31 @@
         return -1;
     }
 
-    size_t encRequired = CCCryptorGetOutputLength(*_cryptor, len, NO);
+    NSUInteger offset = 0;
     
-    uint8_t* encBlock = malloc(encRequired);
-    size_t encWritten;
-
-    CCCryptorStatus status = CCCryptorUpdate(*_cryptor, buffer, len, encBlock, encRequired, &encWritten);
-    if (status != kCCSuccess) {
-        NSLog(@"Crypto Error: %d", status);
-        self.error = [Utils createNSError:[NSString stringWithFormat:@"Crypto Error: %d", status] errorCode:status];
-        free(encBlock);
-        return - 1;
-    }
-
-    NSInteger ret = 0;
-    if ( encWritten > 0 ) { 
-        ret = [self.outputStream write:encBlock maxLength:encWritten];
+    while ( offset < len ) {
+        size_t currentLen = MIN(len - offset, self.chunkSize);
+        size_t encWritten;
 
+        CCCryptorStatus status = CCCryptorUpdate(*_cryptor, &buffer[offset], currentLen, self.workChunk, self.chunkSize + kCCBlockSizeAES128, &encWritten);
+        if (status != kCCSuccess) {
+            NSLog(@"Crypto Error: %d", status);
+            self.error = [Utils createNSError:[NSString stringWithFormat:@"Crypto Error: %d", status] errorCode:status];
+            return - 1;
+        }
 
+        if ( encWritten > 0 ) { 
+            NSInteger wrote = [self.outputStream write:self.workChunk maxLength:encWritten];
+            if ( wrote < 0 ) {
+                NSLog(@"AES: Error writing to outputstream");
+                return wrote;
+            }
+        }
+        
+        offset += currentLen;
     }
     
-    free(encBlock);
-    
-    return ret;
+    return len;
 }
 
 - (NSError *)streamError {
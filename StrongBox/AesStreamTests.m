@@ -0,0 +1,172 @@
+//
+//  AesStreamTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonCrypto.h>
+#import "AesInputStream.h"
+#import "AesOutputStream.h"
+
+static const NSUInteger kBenchmarkLength = 64 * 1024 * 1024;
+
+@interface AesStreamTests : XCTestCase
+
+@property NSData* key;
+@property NSData* iv;
+
+@end
+
+@implementation AesStreamTests
+
+- (void)setUp {
+    self.key = [self randomData:kCCKeySizeAES256];
+    self.iv = [self randomData:kCCBlockSizeAES128];
+}
+
+- (NSData*)randomData:(NSUInteger)length {
+    NSMutableData* ret = [NSMutableData dataWithLength:length];
+    XCTAssertEqual(SecRandomCopyBytes(kSecRandomDefault, length, ret.mutableBytes), errSecSuccess);
+    return ret;
+}
+
+- (NSData*)oneShot:(NSData*)data operation:(CCOperation)operation {
+    NSMutableData* ret = [NSMutableData dataWithLength:data.length + kCCBlockSizeAES128];
+    size_t written = 0;
+
+    XCTAssertEqual(CCCrypt(operation, kCCAlgorithmAES, kCCOptionPKCS7Padding, self.key.bytes, self.key.length, self.iv.bytes, data.bytes, data.length, ret.mutableBytes, ret.length, &written), kCCSuccess);
+    ret.length = written;
+
+    return ret;
+}
+
+- (NSData*)encrypt:(NSData*)data writeSize:(NSUInteger)writeSize chunkSize:(size_t)chunkSize {
+    NSOutputStream* memory = [NSOutputStream outputStreamToMemory];
+
+    AesOutputStream* aes = [[AesOutputStream alloc] initToOutputStream:memory encrypt:YES key:self.key iv:self.iv chainOpensAndCloses:YES chunkSize:chunkSize];
+    [aes open];
+
+    NSUInteger offset = 0;
+    while ( offset < data.length ) {
+        NSUInteger chunk = MIN(writeSize, data.length - offset);
+        XCTAssertEqual([aes write:&((const uint8_t*)data.bytes)[offset] maxLength:chunk], (NSInteger)chunk);
+        offset += chunk;
+    }
+
+    [aes close];
+    XCTAssertNil(aes.streamError);
+
+    return [memory propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+}
+
+- (NSData*)decrypt:(NSData*)data readSizes:(NSArray<NSNumber*>*)readSizes chunkSize:(size_t)chunkSize {
+    AesInputStream* aes = [[AesInputStream alloc] initWithStream:[NSInputStream inputStreamWithData:data] key:self.key iv:self.iv chunkSize:chunkSize];
+    [aes open];
+
+    NSMutableData* ret = NSMutableData.data;
+    NSMutableData* buffer = [NSMutableData dataWithLength:[[readSizes valueForKeyPath:@"@max.self"] unsignedIntegerValue]];
+
+    NSInteger read;
+    NSUInteger i = 0;
+    do {
+        NSUInteger len = readSizes[i++ % readSizes.count].unsignedIntegerValue;
+        read = [aes read:buffer.mutableBytes maxLength:len];
+
+        XCTAssertGreaterThanOrEqual(read, 0);
+        if ( read > 0 ) {
+            [ret appendBytes:buffer.bytes length:read];
+        }
+    } while ( read > 0 );
+
+    XCTAssertNil(aes.streamError);
+    [aes close];
+
+    return ret;
+}
+
+- (void)testRoundTripWithOddReadAndWriteSizes {
+    NSArray<NSNumber*>* lengths = @[@0, @1, @15, @16, @17, @4095, @(256 * 1024 + 7), @(3 * 1024 * 1024 + 13)];
+    NSArray<NSArray<NSNumber*>*>* readPatterns = @[@[@1], @[@7, @4096, @13], @[@16], @[@(16 * 1024)], @[@(64 * 1024 + 3), @31], @[@(4 * 1024 * 1024)]];
+
+    for ( NSNumber* length in lengths ) {
+        NSData* plain = [self randomData:length.unsignedIntegerValue];
+        NSData* expected = [self oneShot:plain operation:kCCEncrypt];
+
+        for ( NSNumber* writeSize in @[@1, @13, @4096, @(1024 * 1024 + 5)] ) {
+            if ( writeSize.unsignedIntegerValue == 1 && plain.length > 4096 ) {
+                continue;
+            }
+
+            XCTAssertEqualObjects([self encrypt:plain writeSize:writeSize.unsignedIntegerValue chunkSize:kAesStreamDefaultChunkSize], expected, @"length %@ write %@", length, writeSize);
+        }
+
+        for ( NSArray<NSNumber*>* readSizes in readPatterns ) {
+            if ( readSizes.firstObject.unsignedIntegerValue == 1 && plain.length > 4096 ) {
+                continue;
+            }
+
+            XCTAssertEqualObjects([self decrypt:expected readSizes:readSizes chunkSize:kAesStreamDefaultChunkSize], plain, @"length %@ reads %@", length, readSizes);
+        }
+    }
+}
+
+- (void)testSmallAndUnalignedChunkSizes {
+    NSData* plain = [self randomData:100 * 1024 + 9];
+    NSData* expected = [self oneShot:plain operation:kCCEncrypt];
+
+    for ( NSNumber* chunkSize in @[@1, @16, @33, @4096, @(128 * 1024)] ) {
+        XCTAssertEqualObjects([self encrypt:plain writeSize:5000 chunkSize:chunkSize.unsignedIntegerValue], expected);
+        XCTAssertEqualObjects([self decrypt:expected readSizes:@[@(20 * 1024), @3] chunkSize:chunkSize.unsignedIntegerValue], plain);
+    }
+}
+
+- (void)testTruncatedCipherTextIsAnError {
+    NSMutableData* cipherText = [self oneShot:[self randomData:1000] operation:kCCEncrypt].mutableCopy;
+    cipherText.length -= 5;
+
+    AesInputStream* aes = [[AesInputStream alloc] initWithStream:[NSInputStream inputStreamWithData:cipherText] key:self.key iv:self.iv];
+    [aes open];
+
+    uint8_t buffer[4096];
+    NSInteger read;
+    do {
+        read = [aes read:buffer maxLength:sizeof(buffer)];
+    } while ( read > 0 );
+
+    XCTAssertLessThan(read, 0);
+    XCTAssertNotNil(aes.streamError);
+
+    [aes close];
+}
+
+- (void)testPerformanceDecryptThroughput {
+    NSData* cipherText = [self oneShot:[self randomData:kBenchmarkLength] operation:kCCEncrypt];
+    NSMutableData* buffer = [NSMutableData dataWithLength:kAesStreamDefaultChunkSize];
+
+    [self measureBlock:^{
+        AesInputStream* aes = [[AesInputStream alloc] initWithStream:[NSInputStream inputStreamWithData:cipherText] key:self.key iv:self.iv];
+        [aes open];
+
+        NSUInteger total = 0;
+        NSInteger read;
+        while ( (read = [aes read:buffer.mutableBytes maxLength:buffer.length]) > 0 ) {
+            total += read;
+        }
+
+        [aes close];
+        XCTAssertEqual(total, kBenchmarkLength);
+    }];
+}
+
+- (void)testPerformanceEncryptThroughput {
+    NSData* plain = [self randomData:kBenchmarkLength];
+
+    [self measureBlock:^{
+        XCTAssertEqual([self encrypt:plain writeSize:128 * 1024 chunkSize:kAesStreamDefaultChunkSize].length, kBenchmarkLength + kCCBlockSizeAES128);
+    }];
+}
+
+@end
@@ -189,6 +189,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nullable) NSDate* lastQuickTypeMultiDbRegularClear;
 
 @property BOOL atomicSftpWrite;
+@property BOOL useUnlockSnapshotCache;
 
 @end
 
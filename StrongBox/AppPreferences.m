@@ -150,6 +150,7 @@ static NSString* const kDatabasesAreAlwaysReadOnly = @"databasesAreAlwaysReadOnl
 static NSString* const kDisableExport = @"disableExport";
 static NSString* const kDisablePrinting = @"disablePrinting";
 static NSString* const kAtomicSftpWrite = @"atomicSftpWrite";
+static NSString* const kUseUnlockSnapshotCache = @"useUnlockSnapshotCache";
 static NSString* const kStripUnusedHistoricalIcons = @"stripUnusedHistoricalIcons";
 
 @implementation AppPreferences
@@ -209,6 +210,14 @@ static NSString* const kStripUnusedHistoricalIcons = @"stripUnusedHistoricalIcon
     [self setBool:kAtomicSftpWrite value:atomicSftpWrite];
 }
 
+- (BOOL)useUnlockSnapshotCache {
+    return [self getBool:kUseUnlockSnapshotCache];
+}
+
+- (void)setUseUnlockSnapshotCache:(BOOL)useUnlockSnapshotCache {
+    [self setBool:kUseUnlockSnapshotCache value:useUnlockSnapshotCache];
+}
+
 - (BOOL)disableExport {
     return [self getBool:kDisableExport];
 }
@@ -8,12 +8,13 @@
 
 #import <UIKit/UIKit.h>
 #import "OTPToken.h"
+#import "TotpBatchGenerator.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface BrowseItemTotpCell : UITableViewCell
 
-- (void)setItem:(NSString*)title subtitle:(NSString*)subtitle icon:(UIImage*)icon expired:(BOOL)expired otpToken:(OTPToken*)otpToken;
+- (void)setItem:(NSString*)title subtitle:(NSString*)subtitle icon:(UIImage*)icon expired:(BOOL)expired uuid:(NSUUID*)uuid otpToken:(OTPToken*_Nullable)otpToken totpGenerator:(TotpBatchGenerator*)totpGenerator;
 
 @end
 
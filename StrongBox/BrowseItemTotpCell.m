@@ -18,7 +18,9 @@
 @property (weak, nonatomic) IBOutlet UILabel *labelUsername;
 @property (weak, nonatomic) IBOutlet UIImageView *icon;
 
+@property NSUUID* uuid;
 @property OTPToken* otpToken;
+@property TotpBatchGenerator* totpGenerator;
 
 @end
 
@@ -35,12 +37,14 @@
     [self stopObservingOtpUpdateTimer];
 }
 
-- (void)setItem:(NSString*)title subtitle:(NSString*)subtitle icon:(UIImage*)icon expired:(BOOL)expired otpToken:(OTPToken*)otpToken {
+- (void)setItem:(NSString*)title subtitle:(NSString*)subtitle icon:(UIImage*)icon expired:(BOOL)expired uuid:(NSUUID*)uuid otpToken:(OTPToken*)otpToken totpGenerator:(TotpBatchGenerator*)totpGenerator {
     self.labelTitle.text = title;
     self.labelUsername.text = subtitle;
     self.icon.image = icon;
     
+    self.uuid = uuid;
     self.otpToken = otpToken;
+    self.totpGenerator = totpGenerator;
     
     self.contentView.alpha = expired ? 0.35 : 1.0f;
     
@@ -64,7 +68,8 @@
 - (IBAction)updateOtpCode {
     if(self.otpToken) {
         uint64_t remainingSeconds = self.otpToken.period - ((uint64_t)([NSDate date].timeIntervalSince1970) % (uint64_t)self.otpToken.period);
-        self.labelOtp.text = [NSString stringWithFormat:@"%@", self.otpToken.password];
+        NSString* code = [self.totpGenerator currentCodeForId:self.uuid];
+        self.labelOtp.text = code ? code : self.otpToken.password;
         
         self.labelOtp.textColor = (remainingSeconds < 5) ? UIColor.systemRedColor : (remainingSeconds < 9) ? UIColor.systemOrangeColor : UIColor.systemBlueColor;
         
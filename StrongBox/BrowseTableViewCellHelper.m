@@ -121,7 +121,13 @@ static NSString* const kBrowseQuickViewItemCell = @"BrowseQuickViewItemCell";
         BrowseItemTotpCell* cell = [self.tableView dequeueReusableCellWithIdentifier:kBrowseItemTotpCell forIndexPath:indexPath];
         NSString* subtitle = [self getBrowseItemSubtitle:node subtitleOverride:subtitleOverride];
 
-        [cell setItem:title subtitle:subtitle icon:icon expired:node.expired otpToken:node.fields.otpToken];
+        [cell setItem:title
+             subtitle:subtitle
+                 icon:icon
+              expired:node.expired
+                 uuid:node.uuid
+             otpToken:node.fields.otpToken
+        totpGenerator:self.viewModel.database.totpGenerator];
         
         return cell;
     }
@@ -0,0 +1,107 @@
+//
+//  CommonPasswordFilterTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "CommonPasswordFilter.h"
+#import "PasswordMaker.h"
+
+static const NSUInteger kLargeListCount = 1000000;
+
+@interface CommonPasswordFilterTests : XCTestCase
+
+@end
+
+@implementation CommonPasswordFilterTests
+
+- (NSArray<NSString*>*)words:(NSString*)prefix count:(NSUInteger)count {
+    NSMutableArray<NSString*>* ret = [NSMutableArray arrayWithCapacity:count];
+    
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        [ret addObject:[NSString stringWithFormat:@"%@%lu", prefix, (unsigned long)i]];
+    }
+    
+    return ret;
+}
+
+- (void)testBundledListsAreRecognised {
+    for ( NSString* password in @[@"password", @"123456", @"qwerty", @"PassWord", @"abacus", @"zoom"] ) {
+        XCTAssertTrue([PasswordMaker.sharedInstance isCommonPassword:password], @"%@", password);
+    }
+    
+    for ( NSString* password in @[@"", @"Xk9#pL2!vq-Tm7", @"correct horse battery staple 1987"] ) {
+        XCTAssertFalse([PasswordMaker.sharedInstance isCommonPassword:password], @"%@", password);
+    }
+}
+
+- (void)testMembersAlwaysFoundAndCaseInsensitive {
+    NSArray<NSString*>* words = @[@"Hunter2", @"trustno1", @"ÜBERSICHT", @"🔑🔑🔑", [@"" stringByPaddingToLength:1000 withString:@"long" startingAtIndex:0]];
+    CommonPasswordFilter* filter = [CommonPasswordFilter filterWithWords:words];
+    
+    XCTAssertEqual(filter.count, words.count);
+    
+    for ( NSString* word in words ) {
+        XCTAssertTrue([filter contains:word]);
+        XCTAssertTrue([filter contains:word.uppercaseString]);
+        XCTAssertTrue([filter contains:word.lowercaseString]);
+    }
+}
+
+- (void)testDuplicatesAreCollapsed {
+    CommonPasswordFilter* filter = [CommonPasswordFilter filterWithWords:@[@"abc", @"ABC", @"abc", @"def"]];
+    
+    XCTAssertEqual(filter.count, 2);
+}
+
+- (void)testRoundTripsThroughData {
+    NSArray<NSString*>* words = [self words:@"word-" count:5000];
+    NSData* data = [CommonPasswordFilter serializeWords:words];
+    
+    CommonPasswordFilter* filter = [CommonPasswordFilter filterWithData:data];
+    XCTAssertNotNil(filter);
+    
+    for ( NSString* word in words ) {
+        XCTAssertTrue([filter contains:word]);
+    }
+    
+    XCTAssertNil([CommonPasswordFilter filterWithData:[data subdataWithRange:NSMakeRange(0, data.length - 2)]]);
+    XCTAssertNil([CommonPasswordFilter filterWithData:[@"not a filter" dataUsingEncoding:NSUTF8StringEncoding]]);
+}
+
+- (void)testLargeListFalsePositiveBoundAndSize {
+    CommonPasswordFilter* filter = [CommonPasswordFilter filterWithWords:[self words:@"common-" count:kLargeListCount]];
+    
+    XCTAssertEqual(filter.count, kLargeListCount);
+    XCTAssertLessThan(filter.sizeInBytes * 8.0 / kLargeListCount, 20.0);
+    
+    NSUInteger falsePositives = 0;
+    for ( NSString* word in [self words:@"other-" count:kLargeListCount] ) {
+        falsePositives += [filter contains:word] ? 1 : 0;
+    }
+    
+    XCTAssertLessThan(falsePositives, kLargeListCount / 10000); // Expected ~1/65536
+    
+    for ( NSString* word in [self words:@"common-" count:kLargeListCount] ) {
+        if ( ![filter contains:word] ) {
+            XCTFail(@"False negative: %@", word);
+            break;
+        }
+    }
+}
+
+- (void)testPerformanceLookup {
+    CommonPasswordFilter* filter = [CommonPasswordFilter filterWithWords:[self words:@"common-" count:kLargeListCount]];
+    NSArray<NSString*>* queries = [self words:@"query-" count:100000];
+    
+    [self measureBlock:^{
+        for ( NSString* query in queries ) {
+            [filter contains:query];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,114 @@
+//
+//  CompressionProfileTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "KeePassDatabase.h"
+#import "Kdbx4Database.h"
+#import "KeePassConstants.h"
+
+@interface CompressionProfileTests : XCTestCase
+
+@end
+
+@implementation CompressionProfileTests
+
+- (DatabaseModel*)databaseWithFormat:(DatabaseFormat)format entries:(NSUInteger)count attachmentLength:(NSUInteger)attachmentLength {
+    DatabaseModel* database = [[DatabaseModel alloc] initWithFormat:format compositeKeyFactors:[CompositeKeyFactors password:@"a"]];
+
+    NSMutableArray<Node*>* entries = NSMutableArray.array;
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        Node* entry = [[Node alloc] initAsRecord:[NSString stringWithFormat:@"Entry %lu", (unsigned long)i] parent:database.effectiveRootGroup];
+
+        entry.fields.username = [NSString stringWithFormat:@"user%lu@example.com", (unsigned long)i];
+        entry.fields.password = NSUUID.UUID.UUIDString;
+        entry.fields.notes = [@"" stringByPaddingToLength:512 withString:@"Lorem ipsum dolor sit amet. " startingAtIndex:0];
+
+        if ( attachmentLength ) {
+            NSMutableData* attachment = [NSMutableData dataWithLength:attachmentLength];
+            arc4random_buf(attachment.mutableBytes, attachment.length);
+
+            entry.fields.attachments[@"scan.jpg"] = [[KeePassAttachmentAbstractionLayer alloc] initNonPerformantWithData:attachment compressed:YES protectedInMemory:NO];
+        }
+
+        [entries addObject:entry];
+    }
+
+    [database addChildren:entries destination:database.effectiveRootGroup];
+
+    return database;
+}
+
+- (Class<AbstractDatabaseFormatAdaptor>)adaptorForFormat:(DatabaseFormat)format {
+    return format == kKeePass4 ? Kdbx4Database.class : KeePassDatabase.class;
+}
+
+- (NSData*)save:(DatabaseModel*)database {
+    NSOutputStream* outputStream = [NSOutputStream outputStreamToMemory];
+    [outputStream open];
+
+    __block NSError* saveError;
+    [[self adaptorForFormat:database.originalFormat] save:database outputStream:outputStream completion:^(BOOL userCancelled, NSString * _Nullable debugXml, NSError * _Nullable error) {
+        saveError = error;
+    }];
+
+    [outputStream close];
+
+    XCTAssertNil(saveError);
+
+    return [outputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+}
+
+- (DatabaseModel*)read:(NSData*)data format:(DatabaseFormat)format {
+    __block DatabaseModel* ret;
+    [[self adaptorForFormat:format] read:[NSInputStream inputStreamWithData:data] ckf:[CompositeKeyFactors password:@"a"] completion:^(BOOL userCancelled, DatabaseModel * _Nullable database, NSError * _Nullable innerStreamError, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        ret = database;
+    }];
+
+    return ret;
+}
+
+- (void)testEveryProfileRoundTrips {
+    for ( NSNumber* format in @[@(kKeePass4), @(kKeePass)] ) {
+        for ( NSNumber* profile in @[@(kCompressionProfileDefault), @(kCompressionProfileFast), @(kCompressionProfileMax)] ) {
+            DatabaseModel* database = [self databaseWithFormat:format.integerValue entries:50 attachmentLength:format.integerValue == kKeePass4 ? 16 * 1024 : 0];
+            database.meta.compressionProfile = profile.integerValue;
+
+            DatabaseModel* read = [self read:[self save:database] format:format.integerValue];
+
+            XCTAssertNotNil(read);
+            XCTAssertEqual(read.allSearchableEntries.count, 50);
+            XCTAssertEqual(read.meta.compressionProfile, profile.integerValue);
+            XCTAssertEqualObjects(read.allSearchableEntries.firstObject.fields.notes, database.allSearchableEntries.firstObject.fields.notes);
+        }
+    }
+}
+
+- (void)testDefaultProfileIsNotPersisted {
+    DatabaseModel* database = [self databaseWithFormat:kKeePass4 entries:1 attachmentLength:0];
+
+    database.meta.compressionProfile = kCompressionProfileMax;
+    database.meta.compressionProfile = kCompressionProfileDefault;
+
+    XCTAssertNil(database.meta.customData[kCompressionProfileCustomDataKey]);
+}
+
+- (void)testPerformanceAttachmentHeavyVaultByProfile {
+    DatabaseModel* database = [self databaseWithFormat:kKeePass4 entries:200 attachmentLength:256 * 1024];
+
+    for ( NSNumber* profile in @[@(kCompressionProfileFast), @(kCompressionProfileDefault), @(kCompressionProfileMax)] ) {
+        database.meta.compressionProfile = profile.integerValue;
+
+        NSDate* start = NSDate.date;
+        NSData* saved = [self save:database];
+
+        NSLog(@"Compression Profile %@: %lu bytes in %f seconds", profile, (unsigned long)saved.length, -start.timeIntervalSinceNow);
+    }
+}
+
+@end
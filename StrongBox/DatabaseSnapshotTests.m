@@ -0,0 +1,222 @@
+//
+//  DatabaseSnapshotTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "Serializator.h"
+#import "LargeVaultGenerator.h"
+#import "DatabaseSnapshot.h"
+#import "FastMaps.h"
+#import "NSData+Extensions.h"
+#import "Utils.h"
+
+@interface DatabaseSnapshotTests : XCTestCase
+
+@property NSURL* databaseUrl;
+@property NSURL* snapshotUrl;
+@property NSData* sourceSha256;
+
+@end
+
+@implementation DatabaseSnapshotTests
+
+- (void)setUp {
+    LargeVaultGeneratorConfig* config = LargeVaultGeneratorConfig.defaults;
+
+    config.password = @"a";
+    config.entryCount = 2000;
+
+    NSData* data = [Serializator expressToData:[LargeVaultGenerator generate:config] format:kKeePass4];
+    NSURL* directory = [NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES];
+
+    self.databaseUrl = [directory URLByAppendingPathComponent:[NSUUID.UUID.UUIDString stringByAppendingPathExtension:@"kdbx"]];
+    self.snapshotUrl = [directory URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+    self.sourceSha256 = data.sha256;
+
+    [data writeToURL:self.databaseUrl atomically:YES];
+}
+
+- (void)tearDown {
+    [NSFileManager.defaultManager removeItemAtURL:self.databaseUrl error:nil];
+    [NSFileManager.defaultManager removeItemAtURL:self.snapshotUrl error:nil];
+}
+
+- (DatabaseModel*)open:(DatabaseModelConfig*)config metrics:(SerializationMetrics*)metrics {
+    __block DatabaseModel* ret = nil;
+
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_enter(group);
+
+    [Serializator fromUrl:self.databaseUrl
+                      ckf:[CompositeKeyFactors password:@"a"]
+                   config:config
+            xmlDumpStream:nil
+                  metrics:metrics
+               completion:^(BOOL userCancelled, DatabaseModel * _Nullable model, NSError * _Nullable error) {
+        ret = model;
+        dispatch_group_leave(group);
+    }];
+
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    return ret;
+}
+
+- (DatabaseModel*)openWithSnapshot:(SerializationMetrics*)metrics {
+    return [self open:[DatabaseModelConfig withSnapshotUrl:self.snapshotUrl sourceSha256:self.sourceSha256] metrics:metrics];
+}
+
+- (void)waitForSnapshot {
+    NSDate* deadline = [NSDate dateWithTimeIntervalSinceNow:10];
+
+    while ( ![NSFileManager.defaultManager fileExistsAtPath:self.snapshotUrl.path] && deadline.timeIntervalSinceNow > 0 ) {
+        [NSThread sleepForTimeInterval:0.05];
+    }
+
+    XCTAssertTrue([NSFileManager.defaultManager fileExistsAtPath:self.snapshotUrl.path]);
+}
+
+- (void)assertNode:(Node*)node equalTo:(Node*)other {
+    XCTAssertTrue([node isSyncEqualTo:other isForUIDiffReport:YES checkHistory:YES], @"%@", node.title);
+    XCTAssertEqual(node.isGroup, other.isGroup);
+    XCTAssertEqual(node.childRecordsAllowed, other.childRecordsAllowed);
+    XCTAssertEqualObjects(node.fields.customFields.keys, other.fields.customFields.keys);
+    XCTAssertEqualObjects(node.fields.passwordModified, other.fields.passwordModified);
+    XCTAssertEqual(node.fields.keePassHistory.count, other.fields.keePassHistory.count);
+
+    for ( NSString* name in node.fields.attachments ) {
+        XCTAssertEqualObjects(node.fields.attachments[name].digestHash, other.fields.attachments[name].digestHash);
+    }
+
+    XCTAssertEqual(node.children.count, other.children.count);
+    [node.children enumerateObjectsUsingBlock:^(Node * _Nonnull child, NSUInteger idx, BOOL * _Nonnull stop) {
+        [self assertNode:child equalTo:other.children[idx]];
+    }];
+}
+
+- (void)assertDatabase:(DatabaseModel*)database equalTo:(DatabaseModel*)other {
+    XCTAssertEqual(database.rootNode.children.count, other.rootNode.children.count);
+    [database.rootNode.children enumerateObjectsUsingBlock:^(Node * _Nonnull child, NSUInteger idx, BOOL * _Nonnull stop) {
+        [self assertNode:child equalTo:other.rootNode.children[idx]];
+    }];
+
+    XCTAssertEqual(database.fastMaps.entryTotalCount, other.fastMaps.entryTotalCount);
+    XCTAssertEqual(database.fastMaps.groupTotalCount, other.fastMaps.groupTotalCount);
+    XCTAssertEqualObjects(database.fastMaps.withTotps, other.fastMaps.withTotps);
+    XCTAssertEqualObjects(database.fastMaps.withAttachments, other.fastMaps.withAttachments);
+    XCTAssertEqualObjects(database.fastMaps.withExpiryDates, other.fastMaps.withExpiryDates);
+    XCTAssertEqualObjects(database.fastMaps.tagMap, other.fastMaps.tagMap);
+    XCTAssertEqualObjects(database.fastMaps.usernameSet, other.fastMaps.usernameSet);
+    XCTAssertEqualObjects(database.fastMaps.urlSet, other.fastMaps.urlSet);
+
+    XCTAssertEqualObjects(database.meta.generator, other.meta.generator);
+    XCTAssertEqualObjects(database.meta.databaseName, other.meta.databaseName);
+    XCTAssertEqualObjects(database.meta.cipherUuid, other.meta.cipherUuid);
+    XCTAssertEqualObjects(database.meta.version, other.meta.version);
+    XCTAssertEqualObjects(database.meta.recycleBinGroup, other.meta.recycleBinGroup);
+    XCTAssertEqual(database.meta.compressionFlags, other.meta.compressionFlags);
+    XCTAssertEqual(database.meta.innerRandomStreamId, other.meta.innerRandomStreamId);
+    XCTAssertEqualObjects(database.meta.kdfParameters.uuid, other.meta.kdfParameters.uuid);
+    XCTAssertEqualObjects([NSSet setWithArray:database.meta.kdfParameters.parameters.allKeys], [NSSet setWithArray:other.meta.kdfParameters.parameters.allKeys]);
+    XCTAssertEqualObjects(database.deletedObjects, other.deletedObjects);
+    XCTAssertEqualObjects([NSSet setWithArray:database.iconPool.allKeys], [NSSet setWithArray:other.iconPool.allKeys]);
+}
+
+- (void)testSnapshotLoadedModelMatchesXmlLoadedModel {
+    DatabaseModel* xmlLoaded = [self openWithSnapshot:nil];
+    XCTAssertNotNil(xmlLoaded);
+
+    [self waitForSnapshot];
+
+    SerializationMetrics* metrics = [[SerializationMetrics alloc] init];
+    DatabaseModel* snapshotLoaded = [self openWithSnapshot:metrics];
+
+    XCTAssertNotNil(snapshotLoaded);
+    XCTAssertNil(metrics.stages[kSerializationStageDocument], @"Snapshot hit should skip the XML parse");
+
+    [self assertDatabase:snapshotLoaded equalTo:xmlLoaded];
+
+    NSData* resaved = [Serializator expressToData:snapshotLoaded format:kKeePass4];
+    DatabaseModel* reopened = [Serializator expressFromData:resaved password:@"a"];
+
+    XCTAssertNotNil(reopened);
+    [self assertDatabase:reopened equalTo:xmlLoaded];
+}
+
+- (void)testDirectRoundTrip {
+    DatabaseModel* database = [self open:DatabaseModelConfig.defaults metrics:nil];
+    NSData* key = getRandomData(32);
+
+    NSData* snapshot = [DatabaseSnapshot serialize:database sourceSha256:self.sourceSha256 key:key];
+    XCTAssertNotNil(snapshot);
+
+    DatabaseModel* restored = [DatabaseSnapshot deserialize:snapshot sourceSha256:self.sourceSha256 key:key ckf:database.ckfs];
+    XCTAssertNotNil(restored);
+
+    [self assertDatabase:restored equalTo:database];
+}
+
+- (void)testMismatchedSourceOrKeyFallsBack {
+    DatabaseModel* database = [self open:DatabaseModelConfig.defaults metrics:nil];
+    NSData* key = getRandomData(32);
+    NSData* snapshot = [DatabaseSnapshot serialize:database sourceSha256:self.sourceSha256 key:key];
+
+    XCTAssertNil([DatabaseSnapshot deserialize:snapshot sourceSha256:getRandomData(32) key:key ckf:database.ckfs]);
+    XCTAssertNil([DatabaseSnapshot deserialize:snapshot sourceSha256:self.sourceSha256 key:getRandomData(32) ckf:database.ckfs]);
+
+    NSMutableData* tampered = snapshot.mutableCopy;
+    ((uint8_t*)tampered.mutableBytes)[tampered.length / 2] ^= 0x01;
+    XCTAssertNil([DatabaseSnapshot deserialize:tampered sourceSha256:self.sourceSha256 key:key ckf:database.ckfs]);
+
+    [snapshot writeToURL:self.snapshotUrl atomically:YES];
+
+    SerializationMetrics* metrics = [[SerializationMetrics alloc] init];
+    DatabaseModel* opened = [self openWithSnapshot:metrics];
+
+    XCTAssertNotNil(opened, @"A snapshot under a different key should fall back to the XML parse");
+    XCTAssertNotNil(metrics.stages[kSerializationStageDocument]);
+    [self assertDatabase:opened equalTo:database];
+}
+
+- (void)testWrongPasswordStillFails {
+    [self openWithSnapshot:nil];
+    [self waitForSnapshot];
+
+    __block NSError* error = nil;
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_enter(group);
+
+    [Serializator fromUrl:self.databaseUrl
+                      ckf:[CompositeKeyFactors password:@"b"]
+                   config:[DatabaseModelConfig withSnapshotUrl:self.snapshotUrl sourceSha256:self.sourceSha256]
+               completion:^(BOOL userCancelled, DatabaseModel * _Nullable model, NSError * _Nullable innerError) {
+        XCTAssertNil(model);
+        error = innerError;
+        dispatch_group_leave(group);
+    }];
+
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    XCTAssertNotNil(error);
+}
+
+- (void)testPerformanceOpenFromXml {
+    [self measureBlock:^{
+        [self open:DatabaseModelConfig.defaults metrics:nil];
+    }];
+}
+
+- (void)testPerformanceOpenFromSnapshot {
+    [self openWithSnapshot:nil];
+    [self waitForSnapshot];
+
+    [self measureBlock:^{
+        [self openWithSnapshot:nil];
+    }];
+}
+
+@end
@@ -112,7 +112,7 @@
     self.cellUpgradeToV4.imageView.image = [UIImage systemImageNamed:@"exclamationmark.triangle"];
     self.cellReduceArgon2.imageView.image = [UIImage systemImageNamed:@"exclamationmark.triangle"];
     
-    [self cell:self.cellCalibrate setHidden:YES]; 
+    [self cell:self.cellCalibrate setHidden:self.model.isReadOnly || self.currentSettings.kdfAlgorithm != kKdfAlgorithmSha256];
     
     [self cell:self.cellRestoreDefaults setHidden:self.currentSettings.isStrongboxDefaultEncryptionSettings];
     
@@ -162,6 +162,9 @@
     else if ( [self.tableView cellForRowAtIndexPath:indexPath] == self.cellRestoreDefaults ) {
         [self restoreDefaults];
     }
+    else if ( [self.tableView cellForRowAtIndexPath:indexPath] == self.cellCalibrate ) {
+        [self calibrate];
+    }
 }
 
 - (void)promptForArgonMemory {
@@ -278,6 +281,12 @@
     }];
 }
 
+- (void)calibrate {
+    [self.currentSettings calibrateFor1Second];
+    
+    [self bindUI];
+}
+
 - (void)restoreDefaults {
     EncryptionSettingsViewModel* defaults = [EncryptionSettingsViewModel defaultsForFormat:self.currentSettings.format];
     
@@ -0,0 +1,118 @@
+//
+//  FieldReferenceIndexTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "DatabaseModel.h"
+#import "SprCompilation.h"
+
+static const NSUInteger kSharedCredentials = 50;
+static const NSUInteger kReferencingEntries = 5000;
+
+@interface FieldReferenceIndexTests : XCTestCase
+
+@property DatabaseModel* database;
+@property NSArray<Node*>* shared;
+@property NSArray<Node*>* referencing;
+
+@end
+
+@implementation FieldReferenceIndexTests
+
+- (void)setUp {
+    self.database = [[DatabaseModel alloc] initWithFormat:kKeePass4];
+
+    Node* sharedGroup = [[Node alloc] initAsGroup:@"Shared" parent:self.database.effectiveRootGroup keePassGroupTitleRules:YES uuid:nil];
+    Node* teamGroup = [[Node alloc] initAsGroup:@"Team" parent:self.database.effectiveRootGroup keePassGroupTitleRules:YES uuid:nil];
+    [self.database addChildren:@[sharedGroup, teamGroup] destination:self.database.effectiveRootGroup];
+
+    NSMutableArray<Node*>* shared = NSMutableArray.array;
+    for ( NSUInteger i = 0; i < kSharedCredentials; i++ ) {
+        Node* entry = [[Node alloc] initAsRecord:[NSString stringWithFormat:@"Shared Service %lu", (unsigned long)i] parent:sharedGroup];
+
+        entry.fields.username = [NSString stringWithFormat:@"service-account-%lu", (unsigned long)i];
+        entry.fields.password = [NSString stringWithFormat:@"Secret-%lu-%@", (unsigned long)i, NSUUID.UUID.UUIDString];
+        entry.fields.url = [NSString stringWithFormat:@"https://service%lu.example.com", (unsigned long)i];
+        entry.fields.notes = [NSString stringWithFormat:@"Owner: Platform Team\nTicket: OPS-%lu", (unsigned long)(1000 + i)];
+        [entry.fields setCustomField:@"Cost Centre" value:[StringValue valueWithString:[NSString stringWithFormat:@"CC-%lu", (unsigned long)(9000 + i)]]];
+
+        [shared addObject:entry];
+    }
+    [self.database addChildren:shared destination:sharedGroup];
+
+    NSMutableArray<Node*>* referencing = NSMutableArray.array;
+    for ( NSUInteger i = 0; i < kReferencingEntries; i++ ) {
+        NSUInteger target = i % kSharedCredentials;
+        Node* entry = [[Node alloc] initAsRecord:[NSString stringWithFormat:@"Login %lu", (unsigned long)i] parent:teamGroup];
+
+        entry.fields.username = [NSString stringWithFormat:@"{REF:U@T:Shared Service %lu}", (unsigned long)target];
+        entry.fields.password = [NSString stringWithFormat:@"{REF:P@U:service-account-%lu}", (unsigned long)target];
+
+        [referencing addObject:entry];
+    }
+    [self.database addChildren:referencing destination:teamGroup];
+
+    self.shared = shared;
+    self.referencing = referencing;
+}
+
+- (NSString*)compile:(NSString*)test {
+    return [SprCompilation.sharedInstance sprCompile:test node:self.referencing.firstObject database:self.database error:nil];
+}
+
+- (void)testReferencesResolveBySearchField {
+    Node* expected = self.shared[7];
+
+    XCTAssertEqualObjects([self compile:@"{REF:U@T:Shared Service 7}"], expected.fields.username);
+    XCTAssertEqualObjects([self compile:@"{REF:P@U:SERVICE-ACCOUNT-7}"], expected.fields.password);
+    XCTAssertEqualObjects([self compile:@"{REF:T@P:secret-7-}"], expected.title);
+    XCTAssertEqualObjects([self compile:@"{REF:T@A:service7.example}"], expected.title);
+    XCTAssertEqualObjects([self compile:@"{REF:T@O:CC-9007}"], expected.title);
+}
+
+- (void)testNotesReferenceResolves {
+    XCTAssertEqualObjects([self compile:@"{REF:U@N:OPS-1012}"], self.shared[12].fields.username);
+}
+
+- (void)testFirstMatchInTreeOrderWins {
+    XCTAssertEqualObjects([self compile:@"{REF:T@T:Shared Service 1}"], self.shared[1].title);
+    XCTAssertEqualObjects([self compile:@"{REF:T@N:Platform Team}"], self.shared[0].title);
+}
+
+- (void)testShortSearchTargetFallsBackToScan {
+    XCTAssertEqualObjects([self compile:@"{REF:T@U:-3}"], self.shared[3].title);
+}
+
+- (void)testCanonicallyEquivalentTargetResolves {
+    [self.database setItemTitle:self.shared[4] title:@"Cafe\u0301 Wi-Fi"];
+
+    XCTAssertEqualObjects([self compile:@"{REF:U@T:CAF\u00C9 WI-FI}"], self.shared[4].fields.username);
+    XCTAssertEqualObjects([self compile:@"{REF:U@T:caf\u00E9 wi}"], self.shared[4].fields.username);
+}
+
+- (void)testUnresolvedReferenceIsLeftAsIs {
+    XCTAssertEqualObjects([self compile:@"{REF:U@T:Does Not Exist}"], @"{REF:U@T:Does Not Exist}");
+}
+
+- (void)testIndexInvalidatedOnChange {
+    XCTAssertEqualObjects([self compile:@"{REF:U@T:Shared Service 3}"], self.shared[3].fields.username);
+
+    [self.database setItemTitle:self.shared[3] title:@"Renamed Service"];
+
+    XCTAssertEqualObjects([self compile:@"{REF:U@T:Renamed Service}"], self.shared[3].fields.username);
+}
+
+- (void)testPerformanceDereferenceAll {
+    [self measureBlock:^{
+        for ( Node* entry in self.referencing ) {
+            [SprCompilation.sharedInstance sprCompile:entry.fields.username node:entry database:self.database error:nil];
+            [SprCompilation.sharedInstance sprCompile:entry.fields.password node:entry database:self.database error:nil];
+        }
+    }];
+}
+
+@end
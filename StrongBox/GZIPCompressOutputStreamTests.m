@@ -0,0 +1,150 @@
+//
+//  GZIPCompressOutputStreamTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <zlib.h>
+#import "GZIPCompressOutputStream.h"
+#import "GZipInputStream.h"
+#import "StreamUtils.h"
+
+static const NSUInteger kBenchmarkLength = 32 * 1024 * 1024;
+
+@interface GZIPCompressOutputStreamTests : XCTestCase
+
+@end
+
+@implementation GZIPCompressOutputStreamTests
+
+- (NSData*)compressibleData:(NSUInteger)length {
+    NSMutableData* ret = [NSMutableData dataWithCapacity:length];
+
+    while ( ret.length < length ) {
+        NSString* line = [NSString stringWithFormat:@"<Entry><UUID>%@</UUID><Value>%u</Value></Entry>\n", NSUUID.UUID.UUIDString, arc4random_uniform(1000)];
+        [ret appendData:[line dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+
+    ret.length = length;
+
+    return ret;
+}
+
+- (NSData*)compress:(NSData*)data threads:(NSUInteger)threads writeSize:(NSUInteger)writeSize {
+    NSOutputStream* memory = [NSOutputStream outputStreamToMemory];
+    [memory open];
+
+    GZIPCompressOutputStream* gzip = [[GZIPCompressOutputStream alloc] initToOutputStream:memory threads:threads];
+    [gzip open];
+
+    NSUInteger offset = 0;
+    while ( offset < data.length ) {
+        NSUInteger chunk = MIN(writeSize, data.length - offset);
+        XCTAssertGreaterThanOrEqual([gzip write:&((const uint8_t*)data.bytes)[offset] maxLength:chunk], 0);
+        offset += chunk;
+    }
+
+    [gzip close];
+    XCTAssertNil(gzip.streamError);
+
+    NSData* ret = [memory propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    [memory close];
+
+    return ret;
+}
+
+- (NSData*)zlibInflate:(NSData*)compressed {
+    z_stream stream = { 0 };
+    XCTAssertEqual(inflateInit2(&stream, 31), Z_OK);
+
+    NSMutableData* ret = NSMutableData.data;
+    uint8_t buffer[32 * 1024];
+
+    stream.next_in = (Bytef*)compressed.bytes;
+    stream.avail_in = (uInt)compressed.length;
+
+    int status;
+    do {
+        stream.next_out = buffer;
+        stream.avail_out = sizeof(buffer);
+
+        status = inflate(&stream, Z_NO_FLUSH);
+        [ret appendBytes:buffer length:sizeof(buffer) - stream.avail_out];
+    } while ( status == Z_OK );
+
+    XCTAssertEqual(status, Z_STREAM_END);
+    XCTAssertEqual(stream.avail_in, 0);
+
+    inflateEnd(&stream);
+
+    return ret;
+}
+
+- (void)testParallelOutputInflatesWithStockZlibAndGZipInputStream {
+    for ( NSNumber* length in @[@0, @1, @(128 * 1024 - 1), @(128 * 1024), @(128 * 1024 + 1), @(3 * 1024 * 1024 + 17)] ) {
+        NSData* plaintext = [self compressibleData:length.unsignedIntegerValue];
+
+        for ( NSNumber* threads in @[@1, @2, @8] ) {
+            NSData* compressed = [self compress:plaintext threads:threads.unsignedIntegerValue writeSize:arc4random_uniform(64 * 1024) + 1];
+
+            XCTAssertEqualObjects([self zlibInflate:compressed], plaintext);
+
+            GZipInputStream* gunzip = [[GZipInputStream alloc] initWithStream:[NSInputStream inputStreamWithData:compressed]];
+            XCTAssertEqualObjects([StreamUtils readAll:gunzip], plaintext);
+        }
+    }
+}
+
+- (void)testParallelRandomDataRoundTrip {
+    NSMutableData* plaintext = [NSMutableData dataWithLength:1024 * 1024 + 3];
+    arc4random_buf(plaintext.mutableBytes, plaintext.length);
+
+    NSData* compressed = [self compress:plaintext threads:4 writeSize:100 * 1024];
+
+    XCTAssertEqualObjects([self zlibInflate:compressed], plaintext);
+}
+
+- (void)testDefaultInitializersAreSingleThreaded {
+    NSOutputStream* memory = [NSOutputStream outputStreamToMemory];
+
+    XCTAssertEqual([[GZIPCompressOutputStream alloc] initToOutputStream:memory].threads, 1);
+    XCTAssertEqual([[GZIPCompressOutputStream alloc] initToOutputStream:memory profile:kCompressionProfileFast].threads, 1);
+}
+
+- (void)testParallelCompressionRatioCloseToSerial {
+    NSData* plaintext = [self compressibleData:4 * 1024 * 1024];
+
+    NSUInteger serial = [self compress:plaintext threads:1 writeSize:32 * 1024].length;
+    NSUInteger parallel = [self compress:plaintext threads:4 writeSize:32 * 1024].length;
+
+    XCTAssertLessThan(parallel, serial + serial / 50);
+}
+
+- (void)benchmarkThreads:(NSUInteger)threads {
+    NSData* plaintext = [self compressibleData:kBenchmarkLength];
+
+    [self measureBlock:^{
+        [self compress:plaintext threads:threads writeSize:32 * 1024];
+    }];
+}
+
+- (void)testPerformanceOneThread {
+    [self benchmarkThreads:1];
+}
+
+- (void)testPerformanceTwoThreads {
+    [self benchmarkThreads:2];
+}
+
+- (void)testPerformanceFourThreads {
+    [self benchmarkThreads:4];
+}
+
+- (void)testPerformanceEightThreads {
+    [self benchmarkThreads:8];
+}
+
+@end
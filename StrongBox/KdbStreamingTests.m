@@ -0,0 +1,279 @@
+//
+//  KdbStreamingTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "KdbSerialization.h"
+#import "KeePassConstants.h"
+#import "Serializator.h"
+#import "LargeVaultGenerator.h"
+#import "StrongboxErrorCodes.h"
+
+@interface FailingInputStream : NSInputStream
+
+@property NSInputStream* inner;
+@property NSUInteger remaining;
+@property (nullable) NSError* error;
+
+@end
+
+@implementation FailingInputStream
+
+- (instancetype)initWithData:(NSData *)data failAfter:(NSUInteger)failAfter {
+    if ( self = [super init] ) {
+        _inner = [NSInputStream inputStreamWithData:data];
+        _remaining = failAfter;
+    }
+    
+    return self;
+}
+
+- (void)open {
+    [self.inner open];
+}
+
+- (void)close {
+    [self.inner close];
+}
+
+- (BOOL)hasBytesAvailable {
+    return self.error == nil;
+}
+
+- (NSStreamStatus)streamStatus {
+    return self.error ? NSStreamStatusError : self.inner.streamStatus;
+}
+
+- (NSError *)streamError {
+    return self.error;
+}
+
+- (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
+    if ( self.remaining == 0 ) {
+        self.error = [NSError errorWithDomain:NSPOSIXErrorDomain code:EIO userInfo:nil];
+        return -1;
+    }
+    
+    NSInteger read = [self.inner read:buffer maxLength:MIN(len, self.remaining)];
+    if ( read > 0 ) {
+        self.remaining -= read;
+    }
+    
+    return read;
+}
+
+- (BOOL)getBuffer:(uint8_t * _Nullable *)buffer length:(NSUInteger *)len {
+    return NO;
+}
+
+@end
+
+@interface KdbStreamingTests : XCTestCase
+
+@end
+
+@implementation KdbStreamingTests
+
+- (NSData*)randomData:(NSUInteger)length {
+    NSMutableData* ret = [NSMutableData dataWithLength:length];
+    XCTAssertEqual(SecRandomCopyBytes(kSecRandomDefault, ret.length, ret.mutableBytes), errSecSuccess);
+    return ret;
+}
+
+- (KdbSerializationData*)generate:(uint32_t)flags entryCount:(NSUInteger)entryCount {
+    KdbSerializationData* ret = [[KdbSerializationData alloc] init];
+    
+    ret.flags = flags;
+    ret.version = 0x00030004;
+    ret.transformRounds = 600;
+    
+    for ( uint32_t i = 0; i < 10; i++ ) {
+        KdbGroup* group = [[KdbGroup alloc] init];
+        
+        group.groupId = i + 1;
+        group.name = [NSString stringWithFormat:@"Group %u ✓", i];
+        group.creation = [NSDate dateWithTimeIntervalSince1970:1500000000 + i];
+        group.modification = [NSDate dateWithTimeIntervalSince1970:1600000000 + i];
+        group.imageId = @(i % 5);
+        group.level = i == 0 ? 0 : 1;
+        
+        [ret.groups addObject:group];
+    }
+    
+    for ( NSUInteger i = 0; i < entryCount; i++ ) {
+        KdbEntry* entry = [[KdbEntry alloc] init];
+        
+        entry.uuid = NSUUID.UUID;
+        entry.groupId = (uint32_t)(i % 10) + 1;
+        entry.title = [NSString stringWithFormat:@"Entry %lu", (unsigned long)i];
+        entry.username = [NSString stringWithFormat:@"user%lu@example.com", (unsigned long)i];
+        entry.password = [[self randomData:12] base64EncodedStringWithOptions:kNilOptions];
+        entry.url = @"https://example.com";
+        entry.notes = i % 7 == 0 ? [@"" stringByPaddingToLength:5000 withString:@"notes " startingAtIndex:0] : @"";
+        entry.creation = [NSDate dateWithTimeIntervalSince1970:1500000000 + i];
+        entry.modified = [NSDate dateWithTimeIntervalSince1970:1600000000 + i];
+        
+        if ( i % 50 == 0 ) {
+            entry.binaryFileName = [NSString stringWithFormat:@"attachment-%lu.bin", (unsigned long)i];
+            entry.binaryData = [self randomData:i % 100 == 0 ? 300 * 1024 : 17];
+        }
+        
+        [ret.entries addObject:entry];
+    }
+    
+    KdbEntry* meta = [[KdbEntry alloc] init];
+    meta.uuid = NSUUID.UUID;
+    meta.groupId = 1;
+    meta.title = @"Meta-Info";
+    meta.username = @"SYSTEM";
+    meta.url = @"$";
+    meta.notes = @"KPX_GROUP_TREE_STATE";
+    meta.binaryFileName = @"bin-stream";
+    meta.binaryData = [self randomData:200 * 1024];
+    [ret.metaEntries addObject:meta];
+    
+    return ret;
+}
+
+- (KdbSerializationData*)readStream:(NSData*)data password:(NSString*)password error:(NSError**)error {
+    return [KdbSerialization deserializeStream:[NSInputStream inputStreamWithData:data] password:password keyFileDigest:nil metrics:nil ppError:error];
+}
+
+- (void)assertEntry:(KdbEntry*)actual matches:(KdbEntry*)expected {
+    XCTAssertEqualObjects(actual.uuid, expected.uuid);
+    XCTAssertEqual(actual.groupId, expected.groupId);
+    XCTAssertEqualObjects(actual.title, expected.title);
+    XCTAssertEqualObjects(actual.username, expected.username);
+    XCTAssertEqualObjects(actual.password, expected.password);
+    XCTAssertEqualObjects(actual.url, expected.url);
+    XCTAssertEqualObjects(actual.notes, expected.notes);
+    XCTAssertEqualObjects(actual.modified, expected.modified);
+    XCTAssertEqualObjects(actual.binaryFileName, expected.binaryFileName);
+    XCTAssertEqualObjects(actual.binaryData, expected.binaryData);
+}
+
+- (void)testRoundTripWithAttachmentsAndMetaStreams {
+    for ( NSNumber* flags in @[@(kFlagsSha2 | kFlagsAes), @(kFlagsSha2 | kFlagsTwoFish)] ) {
+        KdbSerializationData* expected = [self generate:flags.unsignedIntValue entryCount:1000];
+        
+        NSError* error;
+        NSData* data = [KdbSerialization serialize:expected password:@"a" keyFileDigest:nil ppError:&error];
+        XCTAssertNotNil(data, @"%@", error);
+        
+        KdbSerializationData* actual = [self readStream:data password:@"a" error:&error];
+        XCTAssertNotNil(actual, @"%@", error);
+        
+        XCTAssertEqual(actual.flags, expected.flags);
+        XCTAssertEqual(actual.version, expected.version);
+        XCTAssertEqual(actual.transformRounds, expected.transformRounds);
+        XCTAssertEqual(actual.groups.count, expected.groups.count);
+        XCTAssertEqual(actual.entries.count, expected.entries.count);
+        XCTAssertEqual(actual.metaEntries.count, 1);
+        
+        for ( NSUInteger i = 0; i < expected.groups.count; i++ ) {
+            XCTAssertEqual(actual.groups[i].groupId, expected.groups[i].groupId);
+            XCTAssertEqualObjects(actual.groups[i].name, expected.groups[i].name);
+            XCTAssertEqualObjects(actual.groups[i].modification, expected.groups[i].modification);
+            XCTAssertEqualObjects(actual.groups[i].imageId, expected.groups[i].imageId);
+            XCTAssertEqual(actual.groups[i].level, expected.groups[i].level);
+        }
+        
+        for ( NSUInteger i = 0; i < expected.entries.count; i++ ) {
+            [self assertEntry:actual.entries[i] matches:expected.entries[i]];
+        }
+        
+        [self assertEntry:actual.metaEntries.firstObject matches:expected.metaEntries.firstObject];
+        XCTAssertTrue(actual.metaEntries.firstObject.isMetaEntry);
+    }
+}
+
+- (void)testStreamAndDataPathsAgree {
+    KdbSerializationData* expected = [self generate:kFlagsSha2 | kFlagsAes entryCount:200];
+    
+    NSOutputStream* outputStream = [NSOutputStream outputStreamToMemory];
+    [outputStream open];
+    NSError* error;
+    XCTAssertTrue([KdbSerialization serialize:expected password:@"a" keyFileDigest:nil outputStream:outputStream metrics:nil ppError:&error], @"%@", error);
+    [outputStream close];
+    
+    NSData* streamed = [outputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+    
+    KdbSerializationData* fromData = [KdbSerialization deserialize:streamed password:@"a" keyFileDigest:nil ppError:&error];
+    KdbSerializationData* fromStream = [self readStream:streamed password:@"a" error:&error];
+    
+    XCTAssertEqual(fromData.entries.count, expected.entries.count);
+    XCTAssertEqual(fromStream.entries.count, expected.entries.count);
+    
+    for ( NSUInteger i = 0; i < expected.entries.count; i++ ) {
+        [self assertEntry:fromData.entries[i] matches:fromStream.entries[i]];
+    }
+}
+
+- (void)testGeneratedVaultRoundTrips {
+    LargeVaultGeneratorConfig* config = LargeVaultGeneratorConfig.defaults;
+    
+    config.format = kKeePass1;
+    config.password = @"a";
+    config.entryCount = 2000;
+    config.attachmentProbability = 0.2;
+    config.maxAttachmentSize = 64 * 1024;
+    
+    DatabaseModel* database = [LargeVaultGenerator generate:config];
+    NSData* data = [Serializator expressToData:database format:kKeePass1];
+    DatabaseModel* opened = [Serializator expressFromData:data password:@"a"];
+    
+    XCTAssertNotNil(opened);
+    XCTAssertEqual(opened.allSearchableIncludingRecycled.count, database.allSearchableIncludingRecycled.count);
+    XCTAssertEqual(opened.attachmentEntries.count, database.attachmentEntries.count);
+}
+
+- (void)testWrongPasswordAndCorruptionFail {
+    NSData* data = [KdbSerialization serialize:[self generate:kFlagsSha2 | kFlagsAes entryCount:100] password:@"a" keyFileDigest:nil ppError:nil];
+    
+    NSError* error;
+    XCTAssertNil([self readStream:data password:@"b" error:&error]);
+    XCTAssertEqual(error.code, StrongboxErrorCodes.incorrectCredentials);
+    
+    NSMutableData* corrupted = data.mutableCopy;
+    ((uint8_t*)corrupted.mutableBytes)[corrupted.length / 2] ^= 0x01;
+    
+    error = nil;
+    XCTAssertNil([self readStream:corrupted password:@"a" error:&error]);
+    XCTAssertEqual(error.code, StrongboxErrorCodes.incorrectCredentials);
+    
+    for ( NSNumber* truncateTo in @[@(data.length - 1), @(data.length - 16), @(data.length / 2), @(130), @(10)] ) {
+        error = nil;
+        XCTAssertNil([self readStream:[data subdataWithRange:NSMakeRange(0, truncateTo.unsignedIntegerValue)] password:@"a" error:&error], @"%@", truncateTo);
+        XCTAssertNotNil(error, @"%@", truncateTo);
+    }
+}
+
+- (void)testReadErrorIsNotReportedAsIncorrectCredentials {
+    for ( NSNumber* flags in @[@(kFlagsSha2 | kFlagsAes), @(kFlagsSha2 | kFlagsTwoFish)] ) {
+        NSData* data = [KdbSerialization serialize:[self generate:flags.unsignedIntValue entryCount:100] password:@"a" keyFileDigest:nil ppError:nil];
+        
+        FailingInputStream* stream = [[FailingInputStream alloc] initWithData:data failAfter:data.length / 2];
+        
+        NSError* error;
+        XCTAssertNil([KdbSerialization deserializeStream:stream password:@"a" keyFileDigest:nil metrics:nil ppError:&error]);
+        XCTAssertEqualObjects(error.domain, NSPOSIXErrorDomain);
+        XCTAssertEqual(error.code, EIO);
+    }
+}
+
+- (void)testPerformanceStreamingOpenWithPeakMemory {
+    NSData* data = [KdbSerialization serialize:[self generate:kFlagsSha2 | kFlagsAes entryCount:50000] password:@"a" keyFileDigest:nil ppError:nil];
+    
+    XCTMeasureOptions* options = XCTMeasureOptions.defaultOptions;
+    options.iterationCount = 3;
+    
+    [self measureWithMetrics:@[[[XCTClockMetric alloc] init], [[XCTMemoryMetric alloc] init]] options:options block:^{
+        [self readStream:data password:@"a" error:nil];
+    }];
+}
+
+@end
@@ -0,0 +1,159 @@
+//
+//  KdbxStreamingSaveTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "KeePassDatabase.h"
+#import "KeePassCiphers.h"
+#import "KeePassConstants.h"
+#import "KP31HashedBlockStream.h"
+#import "KP31HashedBlockOutputStream.h"
+#import "StreamUtils.h"
+#import "NSArray+Extensions.h"
+
+@interface KdbxStreamingSaveTests : XCTestCase
+
+@end
+
+@implementation KdbxStreamingSaveTests
+
+- (DatabaseModel*)databaseWithEntries:(NSUInteger)count notesLength:(NSUInteger)notesLength {
+    DatabaseModel* database = [[DatabaseModel alloc] initWithFormat:kKeePass compositeKeyFactors:[CompositeKeyFactors password:@"a"]];
+
+    NSMutableArray<Node*>* entries = NSMutableArray.array;
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        Node* entry = [[Node alloc] initAsRecord:[NSString stringWithFormat:@"Entry %lu", (unsigned long)i] parent:database.effectiveRootGroup];
+
+        NSMutableString* notes = [NSMutableString stringWithCapacity:notesLength];
+        while ( notes.length < notesLength ) {
+            [notes appendString:NSUUID.UUID.UUIDString];
+        }
+        entry.fields.notes = notes;
+        entry.fields.password = NSUUID.UUID.UUIDString;
+
+        [entries addObject:entry];
+    }
+
+    [database addChildren:entries destination:database.effectiveRootGroup];
+
+    return database;
+}
+
+- (NSData*)save:(DatabaseModel*)database {
+    NSOutputStream* outputStream = [NSOutputStream outputStreamToMemory];
+    [outputStream open];
+
+    __block NSError* saveError;
+    [KeePassDatabase save:database outputStream:outputStream completion:^(BOOL userCancelled, NSString * _Nullable debugXml, NSError * _Nullable error) {
+        saveError = error;
+    }];
+
+    [outputStream close];
+
+    XCTAssertNil(saveError);
+
+    return [outputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+}
+
+- (DatabaseModel*)read:(NSData*)data {
+    __block DatabaseModel* ret;
+    [KeePassDatabase read:[NSInputStream inputStreamWithData:data] ckf:[CompositeKeyFactors password:@"a"] completion:^(BOOL userCancelled, DatabaseModel * _Nullable database, NSError * _Nullable innerStreamError, NSError * _Nullable error) {
+        XCTAssertNil(error);
+        XCTAssertNil(innerStreamError);
+        ret = database;
+    }];
+
+    return ret;
+}
+
+- (void)assertRoundTrip:(DatabaseModel*)database {
+    DatabaseModel* read = [self read:[self save:database]];
+
+    XCTAssertNotNil(read);
+    XCTAssertEqual(read.allSearchableEntries.count, database.allSearchableEntries.count);
+
+    NSDictionary<NSString*, Node*>* byTitle = [NSDictionary dictionaryWithObjects:read.allSearchableEntries forKeys:[read.allSearchableEntries map:^id _Nonnull(Node * _Nonnull obj, NSUInteger idx) {
+        return obj.title;
+    }]];
+
+    for ( Node* original in database.allSearchableEntries ) {
+        Node* found = byTitle[original.title];
+        XCTAssertEqualObjects(found.fields.notes, original.fields.notes);
+        XCTAssertEqualObjects(found.fields.password, original.fields.password);
+    }
+}
+
+- (void)testRoundTripGzip {
+    DatabaseModel* database = [self databaseWithEntries:100 notesLength:1024];
+    database.meta.compressionFlags = kGzipCompressionFlag;
+
+    [self assertRoundTrip:database];
+}
+
+- (void)testRoundTripUncompressed {
+    DatabaseModel* database = [self databaseWithEntries:100 notesLength:1024];
+    database.meta.compressionFlags = 0;
+
+    [self assertRoundTrip:database];
+}
+
+- (void)testRoundTripSpanningManyBlocks {
+    DatabaseModel* database = [self databaseWithEntries:16 notesLength:512 * 1024];
+    database.meta.compressionFlags = 0;
+
+    [self assertRoundTrip:database];
+}
+
+- (void)testRoundTripAllCiphers {
+    for ( NSUUID* cipher in @[aesCipherUuid(), chaCha20CipherUuid(), twoFishCipherUuid()] ) {
+        DatabaseModel* database = [self databaseWithEntries:20 notesLength:256];
+        database.meta.cipherUuid = cipher;
+
+        [self assertRoundTrip:database];
+    }
+}
+
+- (void)testHashedBlockOutputReadBack {
+    for ( NSNumber* length in @[@0, @1, @63, @64, @65, @1000, @4097] ) {
+        for ( NSNumber* blockSize in @[@1, @7, @64, @(kDefaultBlockifySize)] ) {
+            NSMutableData* plaintext = [NSMutableData dataWithLength:length.unsignedIntegerValue];
+            arc4random_buf(plaintext.mutableBytes, plaintext.length);
+
+            NSOutputStream* memory = [NSOutputStream outputStreamToMemory];
+            [memory open];
+
+            KP31HashedBlockOutputStream* blockify = [[KP31HashedBlockOutputStream alloc] initWithStream:memory blockSize:blockSize.unsignedIntegerValue];
+            [blockify open];
+
+            NSUInteger offset = 0;
+            while ( offset < plaintext.length ) {
+                NSUInteger chunk = MIN(arc4random_uniform(100) + 1, plaintext.length - offset);
+                XCTAssertEqual([blockify write:&((const uint8_t*)plaintext.bytes)[offset] maxLength:chunk], chunk);
+                offset += chunk;
+            }
+
+            [blockify close];
+            XCTAssertNil(blockify.streamError);
+
+            NSData* blocks = [memory propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
+            [memory close];
+
+            KP31HashedBlockStream* unblockify = [[KP31HashedBlockStream alloc] initWithStream:[NSInputStream inputStreamWithData:blocks]];
+            XCTAssertEqualObjects([StreamUtils readAll:unblockify], plaintext);
+        }
+    }
+}
+
+- (void)testPerformanceSave {
+    DatabaseModel* database = [self databaseWithEntries:2000 notesLength:1024];
+
+    [self measureBlock:^{
+        [self save:database];
+    }];
+}
+
+@end
@@ -0,0 +1,164 @@
+//
+//  KeyFileParserTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonDigest.h>
+#import "KeyFileParser.h"
+#import "BookmarksHelper.h"
+#import "NSData+Extensions.h"
+
+static const NSUInteger kSniffThreshold = 16 * 1024;
+
+@interface KeyFileParserTests : XCTestCase
+
+@property NSURL* directory;
+
+@end
+
+@implementation KeyFileParserTests
+
+- (void)setUp {
+    self.directory = [[NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES] URLByAppendingPathComponent:NSUUID.UUID.UUIDString isDirectory:YES];
+    [NSFileManager.defaultManager createDirectoryAtURL:self.directory withIntermediateDirectories:YES attributes:nil error:nil];
+    
+    [KeyFileParser clearDigestCache];
+}
+
+- (void)tearDown {
+    [NSFileManager.defaultManager removeItemAtURL:self.directory error:nil];
+    
+    [KeyFileParser clearDigestCache];
+}
+
+- (NSData*)randomData:(NSUInteger)length {
+    NSMutableData* ret = [NSMutableData dataWithLength:length];
+    XCTAssertEqual(SecRandomCopyBytes(kSecRandomDefault, ret.length, ret.mutableBytes), errSecSuccess);
+    return ret;
+}
+
+- (NSURL*)write:(NSData*)data {
+    NSURL* url = [self.directory URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+    XCTAssertTrue([data writeToURL:url atomically:YES]);
+    return url;
+}
+
+- (NSData*)digestOfUrl:(NSURL*)url format:(DatabaseFormat)format {
+    NSError* error;
+    NSString* bookmark = [BookmarksHelper getBookmarkFromUrl:url readOnly:YES error:&error];
+    XCTAssertNotNil(bookmark, @"%@", error);
+    
+    return [KeyFileParser getDigestFromBookmark:bookmark keyFileFileName:nil format:format error:&error];
+}
+
+- (void)assertDigestOf:(NSData*)data format:(DatabaseFormat)format expected:(NSData*)expected {
+    XCTAssertEqualObjects([KeyFileParser getNonePerformantKeyFileDigest:data checkForXml:format != kKeePass1], expected);
+    XCTAssertEqualObjects([self digestOfUrl:[self write:data] format:format], expected);
+}
+
+- (void)testXmlVersion1 {
+    NSData* key = [self randomData:32];
+    NSString* xml = [NSString stringWithFormat:@"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<KeyFile><Meta><Version>1.00</Version></Meta><Key><Data>%@</Data></Key></KeyFile>", key.base64String];
+    NSData* data = [xml dataUsingEncoding:NSUTF8StringEncoding];
+    
+    [self assertDigestOf:data format:kKeePass4 expected:key];
+    [self assertDigestOf:data format:kKeePass1 expected:data.sha256];
+}
+
+- (void)testXmlVersion2 {
+    NSData* key = [self randomData:32];
+    NSString* hash = [key.sha256.hexString substringToIndex:8];
+    NSString* xml = [NSString stringWithFormat:@"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<KeyFile><Meta><Version>2.0</Version></Meta><Key><Data Hash=\"%@\">%@</Data></Key></KeyFile>", hash, key.hexString];
+    
+    [self assertDigestOf:[xml dataUsingEncoding:NSUTF8StringEncoding] format:kKeePass4 expected:key];
+    
+    NSString* badHash = [NSString stringWithFormat:@"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<KeyFile><Meta><Version>2.0</Version></Meta><Key><Data Hash=\"00000000\">%@</Data></Key></KeyFile>", key.hexString];
+    NSData* badHashData = [badHash dataUsingEncoding:NSUTF8StringEncoding];
+    
+    [self assertDigestOf:badHashData format:kKeePass4 expected:badHashData.sha256];
+}
+
+- (void)testBinaryAndHexKeys {
+    NSData* binary = [self randomData:32];
+    [self assertDigestOf:binary format:kKeePass4 expected:binary];
+    [self assertDigestOf:binary format:kKeePass1 expected:binary];
+    
+    NSData* key = [self randomData:32];
+    NSData* hex = [key.hexString dataUsingEncoding:NSUTF8StringEncoding];
+    [self assertDigestOf:hex format:kKeePass4 expected:key];
+    [self assertDigestOf:hex format:kKeePass1 expected:key];
+}
+
+- (void)testArbitraryFilesAroundSniffThreshold {
+    for ( NSNumber* length in @[@(0), @(1), @(33), @(kSniffThreshold - 1), @(kSniffThreshold), @(kSniffThreshold + 1), @(1024 * 1024 + 7)] ) {
+        NSData* data = [self randomData:length.unsignedIntegerValue];
+        
+        [self assertDigestOf:data format:kKeePass4 expected:data.sha256];
+        [self assertDigestOf:data format:kKeePass1 expected:data.sha256];
+    }
+}
+
+- (void)testLargeXmlIsHashedAsIs {
+    NSData* key = [self randomData:32];
+    NSString* padding = [@"" stringByPaddingToLength:kSniffThreshold withString:@" " startingAtIndex:0];
+    NSString* xml = [NSString stringWithFormat:@"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<KeyFile><Meta><Version>1.00</Version></Meta><Key><Data>%@</Data></Key>%@</KeyFile>", key.base64String, padding];
+    NSData* data = [xml dataUsingEncoding:NSUTF8StringEncoding];
+    
+    [self assertDigestOf:data format:kKeePass4 expected:data.sha256];
+}
+
+- (void)testCachedDigestIsInvalidatedByModification {
+    NSData* first = [self randomData:kSniffThreshold * 4];
+    NSURL* url = [self write:first];
+    NSError* error;
+    NSString* bookmark = [BookmarksHelper getBookmarkFromUrl:url readOnly:YES error:&error];
+    
+    XCTAssertEqualObjects([KeyFileParser getDigestFromBookmark:bookmark keyFileFileName:nil format:kKeePass4 error:&error], first.sha256);
+    XCTAssertEqualObjects([KeyFileParser getDigestFromBookmark:bookmark keyFileFileName:nil format:kKeePass4 error:&error], first.sha256);
+    
+    NSData* second = [self randomData:kSniffThreshold * 4];
+    NSFileHandle* handle = [NSFileHandle fileHandleForWritingToURL:url error:&error];
+    [handle writeData:second];
+    [handle closeFile];
+    [NSFileManager.defaultManager setAttributes:@{ NSFileModificationDate : [NSDate dateWithTimeIntervalSinceNow:60] } ofItemAtPath:url.path error:&error];
+    
+    XCTAssertEqualObjects([KeyFileParser getDigestFromBookmark:bookmark keyFileFileName:nil format:kKeePass4 error:&error], second.sha256);
+}
+
+- (void)testFourGigabyteSparseFile {
+    const unsigned long long kSize = 4ULL * 1024 * 1024 * 1024;
+    
+    NSURL* url = [self.directory URLByAppendingPathComponent:@"sparse.iso"];
+    XCTAssertTrue([NSFileManager.defaultManager createFileAtPath:url.path contents:nil attributes:nil]);
+    
+    NSError* error;
+    NSFileHandle* handle = [NSFileHandle fileHandleForWritingToURL:url error:&error];
+    XCTAssertTrue([handle truncateAtOffset:kSize error:&error], @"%@", error);
+    [handle closeFile];
+    
+    CC_SHA256_CTX context;
+    CC_SHA256_Init(&context);
+    NSMutableData* zeroes = [NSMutableData dataWithLength:1024 * 1024];
+    for ( unsigned long long i = 0; i < kSize / zeroes.length; i++ ) {
+        CC_SHA256_Update(&context, zeroes.bytes, (CC_LONG)zeroes.length);
+    }
+    NSMutableData* expected = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final(expected.mutableBytes, &context);
+    
+    XCTMeasureOptions* options = XCTMeasureOptions.defaultOptions;
+    options.iterationCount = 1;
+    
+    [self measureWithMetrics:@[[[XCTClockMetric alloc] init], [[XCTMemoryMetric alloc] init]] options:options block:^{
+        XCTAssertEqualObjects([self digestOfUrl:url format:kKeePass4], expected);
+    }];
+    
+    NSDate* start = NSDate.date;
+    XCTAssertEqualObjects([self digestOfUrl:url format:kKeePass4], expected);
+    XCTAssertLessThan([NSDate.date timeIntervalSinceDate:start], 1.0);
+}
+
+@end
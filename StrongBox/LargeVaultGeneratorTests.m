@@ -0,0 +1,111 @@
+//
+//  LargeVaultGeneratorTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "LargeVaultGenerator.h"
+#import "VaultBenchmark.h"
+#import "Serializator.h"
+
+@interface LargeVaultGeneratorTests : XCTestCase
+
+@end
+
+@implementation LargeVaultGeneratorTests
+
+- (LargeVaultGeneratorConfig*)config:(DatabaseFormat)format {
+    LargeVaultGeneratorConfig* config = LargeVaultGeneratorConfig.defaults;
+
+    config.format = format;
+    config.seed = 42;
+    config.entryCount = 250;
+    config.groupDepth = 2;
+    config.groupsPerGroup = 3;
+    config.attachmentProbability = 0.2;
+    config.maxAttachmentSize = 4096;
+    config.totpProbability = 0.3;
+
+    return config;
+}
+
+- (NSArray<NSString*>*)fingerprint:(DatabaseModel*)database {
+    NSMutableArray<NSString*>* ret = NSMutableArray.array;
+
+    for ( Node* node in database.allSearchableIncludingRecycled ) {
+        [ret addObject:[NSString stringWithFormat:@"%@|%@|%@|%@|%lu|%lu", node.uuid.UUIDString, node.title, node.fields.password, node.fields.modified, (unsigned long)node.fields.attachments.count, (unsigned long)node.fields.keePassHistory.count]];
+    }
+
+    return [ret sortedArrayUsingSelector:@selector(compare:)];
+}
+
+- (void)testSameSeedGeneratesSameVault {
+    DatabaseModel* a = [LargeVaultGenerator generate:[self config:kKeePass4]];
+    DatabaseModel* b = [LargeVaultGenerator generate:[self config:kKeePass4]];
+
+    XCTAssertEqualObjects([self fingerprint:a], [self fingerprint:b]);
+}
+
+- (void)testDifferentSeedGeneratesDifferentVault {
+    LargeVaultGeneratorConfig* other = [self config:kKeePass4];
+    other.seed = 43;
+
+    DatabaseModel* a = [LargeVaultGenerator generate:[self config:kKeePass4]];
+    DatabaseModel* b = [LargeVaultGenerator generate:other];
+
+    XCTAssertNotEqualObjects([self fingerprint:a], [self fingerprint:b]);
+}
+
+- (void)testShapeMatchesConfig {
+    LargeVaultGeneratorConfig* config = [self config:kKeePass4];
+    DatabaseModel* database = [LargeVaultGenerator generate:config];
+
+    NSArray<Node*>* entries = [database.allSearchableIncludingRecycled filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"isGroup == NO"]];
+    NSArray<Node*>* groups = [database.allSearchableIncludingRecycled filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"isGroup == YES"]];
+
+    XCTAssertEqual(entries.count, config.entryCount);
+    XCTAssertEqual(groups.count, 3 + 3 * 3);
+    XCTAssertGreaterThan(database.totpEntries.count, 0);
+    XCTAssertGreaterThan(database.attachmentEntries.count, 0);
+
+    for ( Node* entry in entries ) {
+        XCTAssertEqual(entry.fields.customFields.count, config.customFieldsPerEntry);
+        XCTAssertEqual(entry.fields.keePassHistory.count, config.historyDepth);
+        XCTAssertLessThanOrEqual(entry.fields.tags.count, config.maxTagsPerEntry);
+    }
+}
+
+- (void)testRoundTripsAllFormats {
+    for ( NSNumber* format in @[@(kKeePass4), @(kKeePass), @(kKeePass1), @(kPasswordSafe)] ) {
+        LargeVaultGeneratorConfig* config = [self config:format.intValue];
+        DatabaseModel* database = [LargeVaultGenerator generate:config];
+
+        NSData* data = [Serializator expressToData:database format:config.format];
+        XCTAssertNotNil(data, @"Format %@", format);
+
+        DatabaseModel* unlocked = [Serializator expressFromData:data password:config.password];
+        XCTAssertNotNil(unlocked, @"Format %@", format);
+
+        XCTAssertEqual(unlocked.allSearchableIncludingRecycled.count, database.allSearchableIncludingRecycled.count, @"Format %@", format);
+    }
+}
+
+- (void)testBenchmarkEmitsJson {
+    LargeVaultGeneratorConfig* config = [self config:kKeePass4];
+    config.entryCount = 50;
+
+    NSData* json = [VaultBenchmark runAsJson:config iterations:1];
+    XCTAssertNotNil(json);
+
+    NSDictionary* results = [NSJSONSerialization JSONObjectWithData:json options:kNilOptions error:nil];
+    XCTAssertNil(results[@"error"]);
+
+    for ( NSString* stage in @[@"generate", @"save", @"unlock", @"search", @"audit", @"merge"] ) {
+        XCTAssertNotNil(results[@"stagesMs"][stage][@"median"], @"Stage %@", stage);
+    }
+}
+
+@end
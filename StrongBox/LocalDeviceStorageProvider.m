@@ -14,6 +14,7 @@
 #import "StrongboxiOSFilesManager.h"
 #import "LocalDatabaseIdentifier.h"
 #import "NSDate+Extensions.h"
+#import "StreamUtils.h"
 
 #ifndef IS_APP_EXTENSION
 #import "Strongbox-Swift.h"
@@ -245,6 +246,62 @@ suggestedFilename:(NSString *)suggestedFilename
     }
 }
 
+- (void)pullDatabaseStream:(DatabasePreferences *)safeMetaData
+             interactiveVC:(UIViewController *)viewController
+                   options:(StorageProviderReadOptions *)options
+                completion:(StorageProviderStreamReadCompletionBlock)completion {
+    NSURL *url = [self getFileUrl:safeMetaData];
+
+    NSError* error;
+    NSDictionary* attributes = [NSFileManager.defaultManager attributesOfItemAtPath:url.path error:&error];
+    
+    if (error) {
+        NSLog(@"Error = [%@]", error);
+        completion(kReadResultError, nil, nil, error);
+    }
+    else {
+        if (options.onlyIfModifiedDifferentFrom == nil || (![attributes.fileModificationDate isEqualToDateWithinEpsilon:options.onlyIfModifiedDifferentFrom] )) {
+            NSInputStream* stream = [NSInputStream inputStreamWithURL:url];
+            completion(stream ? kReadResultSuccess : kReadResultError, stream, attributes.fileModificationDate, nil);
+        }
+        else {
+            completion(kReadResultModifiedIsSameAsLocal, nil, nil, nil);
+        }
+    }
+}
+
+- (void)pushDatabaseStream:(DatabasePreferences *)safeMetaData
+             interactiveVC:(UIViewController *)viewController
+                    stream:(NSInputStream *)stream
+                completion:(StorageProviderUpdateCompletionBlock)completion {
+    NSURL* url = [self getFileUrl:safeMetaData];
+    NSURL* tmp = [url.URLByDeletingLastPathComponent URLByAppendingPathComponent:[NSString stringWithFormat:@".%@.tmp", NSUUID.UUID.UUIDString]];
+    
+    NSOutputStream* outputStream = [NSOutputStream outputStreamToFileAtPath:tmp.path append:NO];
+    
+    NSError* error;
+    if ( ![StreamUtils pipeFromStream:stream to:outputStream] || outputStream.streamError ) {
+        error = outputStream.streamError ? outputStream.streamError : stream.streamError;
+        [NSFileManager.defaultManager removeItemAtURL:tmp error:nil];
+        completion(kUpdateResultError, nil, error);
+        return;
+    }
+    
+    if ( ![NSFileManager.defaultManager replaceItemAtURL:url withItemAtURL:tmp backupItemName:nil options:kNilOptions resultingItemURL:nil error:&error] ) {
+        [NSFileManager.defaultManager removeItemAtURL:tmp error:nil];
+        completion(kUpdateResultError, nil, error);
+        return;
+    }
+
+    NSDictionary* attr = [NSFileManager.defaultManager attributesOfItemAtPath:url.path error:&error];
+    if (error) {
+        completion(kUpdateResultError, nil, error);
+    }
+    else {
+        completion(kUpdateResultSuccess, attr.fileModificationDate, nil);
+    }
+}
+
 - (void)getModDate:(nonnull METADATA_PTR)safeMetaData completion:(nonnull StorageProviderGetModDateCompletionBlock)completion {
     NSLog(@"🔴 LocalDeviceStorageProvider::getModDate not impl!");
 
@@ -76,7 +76,9 @@ NSString* const kSpecialSearchTermNearlyExpiredEntries = @"strongbox:nearlyExpir
 @property (readonly) id<SyncManagement> syncManagement;
 @property (readonly) NSArray<Node*>* legacyFavourites;
 
-@property (readonly) NSDictionary<NSString*, NSSet<NSUUID*>*> *domainNodeMap; 
+#if !TARGET_OS_IPHONE
+@property (readonly, nullable) BrowserAutoFillDomainIndex* domainNodeIndex;
+#endif
 
 @end
 
@@ -184,7 +186,6 @@ NSString* const kSpecialSearchTermNearlyExpiredEntries = @"strongbox:nearlyExpir
             return nil;
         }
         
-        _domainNodeMap = @{};
         _metadata = metaData;
         self.theDatabase = passwordDatabase;
         self.asyncUpdateEncryptionQueue = dispatch_queue_create("Model-AsyncUpdateEncryptionQueue", DISPATCH_QUEUE_SERIAL);
@@ -1632,18 +1633,17 @@ userInteractionRequired:(BOOL)userInteractionRequired
 - (NSArray<Node *> *)getAutoFillMatchingNodesForUrl:(NSString *)urlString {
 #ifndef IS_APP_EXTENSION 
     if ( self.metadata.autoFillEnabled ) {
-        NSSet<NSUUID*>* matches = [BrowserAutoFillManager getMatchingNodesWithUrl:urlString 
-                                                                    domainNodeMap:self.domainNodeMap];
+        NSSet<NSUUID*>* matches = [BrowserAutoFillManager getMatchingNodesWithUrl:urlString
+                                                                            index:self.domainNodeIndex
+                                                         includeEquivalentDomains:self.metadata.includeAssociatedDomains];
         
         NSArray<Node*> *ret = [self getItemsById:matches.allObjects];
         
-        return [ret sortedArrayUsingComparator:^NSComparisonResult(id  _Nonnull obj1, id  _Nonnull obj2) {
-            return [BrowserAutoFillManager compareMatchesWithNode1:obj1
-                                                             node2:obj2
-                                                               url:urlString
-                                                       isFavourite:^BOOL(Node * _Nonnull node) {
-                return [self isFavourite:node.uuid];
-            }];
+        return [BrowserAutoFillManager sortMatches:ret
+                                               url:urlString
+                                             index:self.domainNodeIndex
+                                       isFavourite:^BOOL(Node * _Nonnull node) {
+            return [self isFavourite:node.uuid];
         }];
     }
     else {
@@ -1657,15 +1657,12 @@ userInteractionRequired:(BOOL)userInteractionRequired
 #endif
 
 - (void)rebuildAutoFillDomainNodeMap {
-
-    _domainNodeMap = @{};
-    
 #if !TARGET_OS_IPHONE 
+    _domainNodeIndex = nil;
+    
     if ( self.metadata.autoFillEnabled ) {
-        _domainNodeMap = [BrowserAutoFillManager loadDomainNodeMap:self];
+        _domainNodeIndex = [BrowserAutoFillManager loadDomainNodeIndex:self];
     }
-#else
-    _domainNodeMap = @{};
 #endif
 }
 
@@ -0,0 +1,229 @@
+//
+//  MutableOrderedDictionaryTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "MutableOrderedDictionary.h"
+
+// The previous array + dictionary implementation, kept as the oracle for the differential tests.
+
+@interface LegacyOrderedDictionary : NSObject
+
+@property NSMutableArray<NSString*> *orderedKeys;
+@property NSMutableDictionary<NSString*, NSObject*> *kvps;
+
+@end
+
+@implementation LegacyOrderedDictionary
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.orderedKeys = [NSMutableArray array];
+        self.kvps = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (id)removeObjectAtIndex:(NSUInteger)atIndex {
+    if ( atIndex < self.orderedKeys.count ) {
+        id key = self.orderedKeys[atIndex];
+        id value = self.kvps[key];
+        
+        [self.orderedKeys removeObjectAtIndex:atIndex];
+        [self.kvps removeObjectForKey:key];
+        
+        return value;
+    }
+    
+    return nil;
+}
+
+- (void)updateOrAddKey:(id)key andValue:(id)value {
+    if ( self.kvps[key] ) {
+        if(value != nil) {
+            [self.kvps setValue:value forKey:key];
+        }
+        else {
+            [self.orderedKeys removeObject:key];
+            [self.kvps removeObjectForKey:key];
+        }
+    }
+    else {
+        if(value != nil) {
+            [self.orderedKeys addObject:key];
+            [self.kvps setValue:value forKey:key];
+        }
+    }
+}
+
+- (void)addKey:(id)key andValue:(id)value {
+    if(self.kvps[key]) {
+        [self.orderedKeys removeObject:key];
+        [self.kvps removeObjectForKey:key];
+    }
+
+    if(value != nil) {
+        [self.orderedKeys addObject:key];
+        [self.kvps setValue:value forKey:key];
+    }
+}
+
+- (void)insertKey:(id)key withValue:(id)value atIndex:(NSUInteger)atIndex {
+    if ( self.kvps[key] ) {
+        return;
+    }
+
+    if ( value != nil ) {
+        [self.orderedKeys insertObject:key atIndex:atIndex];
+        [self.kvps setValue:value forKey:key];
+    }
+}
+
+- (NSArray*)allValues {
+    NSMutableArray* ret = NSMutableArray.array;
+    for ( id key in self.orderedKeys ) {
+        [ret addObject:self.kvps[key]];
+    }
+    return ret;
+}
+
+@end
+
+@interface MutableOrderedDictionaryTests : XCTestCase
+
+@end
+
+@implementation MutableOrderedDictionaryTests
+
+- (void)assertDictionary:(MutableOrderedDictionary*)dictionary matches:(LegacyOrderedDictionary*)legacy context:(NSString*)context {
+    XCTAssertEqual(dictionary.count, legacy.orderedKeys.count, @"%@", context);
+    XCTAssertEqualObjects(dictionary.allKeys, legacy.orderedKeys, @"%@", context);
+    XCTAssertEqualObjects(dictionary.allValues, legacy.allValues, @"%@", context);
+    XCTAssertEqualObjects(dictionary.dictionary, legacy.kvps, @"%@", context);
+}
+
+- (void)testRandomizedOperationsMatchLegacyImplementation {
+    for ( NSNumber* keySpace in @[@(4), @(32), @(300), @(3000)] ) {
+        MutableOrderedDictionary<NSString*, NSString*>* dictionary = [[MutableOrderedDictionary alloc] init];
+        LegacyOrderedDictionary* legacy = [[LegacyOrderedDictionary alloc] init];
+        
+        for ( NSUInteger step = 0; step < 20000; step++ ) {
+            NSString* key = [NSString stringWithFormat:@"key-%u", arc4random_uniform(keySpace.unsignedIntValue)];
+            NSString* value = arc4random_uniform(4) == 0 ? nil : [NSString stringWithFormat:@"value-%lu", (unsigned long)step];
+            NSString* context = [NSString stringWithFormat:@"%@ step %lu", keySpace, (unsigned long)step];
+            
+            uint32_t op = arc4random_uniform(100);
+            
+            if ( op < 35 ) {
+                dictionary[key] = value;
+                [legacy updateOrAddKey:key andValue:value];
+            }
+            else if ( op < 60 ) {
+                [dictionary addKey:key andValue:value];
+                [legacy addKey:key andValue:value];
+            }
+            else if ( op < 75 ) {
+                NSUInteger index = arc4random_uniform((uint32_t)legacy.orderedKeys.count + 1);
+                
+                if ( value ) {
+                    [dictionary insertKey:key withValue:value atIndex:index];
+                    [legacy insertKey:key withValue:value atIndex:index];
+                }
+            }
+            else if ( op < 90 ) {
+                NSUInteger index = arc4random_uniform((uint32_t)legacy.orderedKeys.count + 2);
+                
+                XCTAssertEqualObjects([dictionary removeObjectAtIndex:index], [legacy removeObjectAtIndex:index], @"%@", context);
+            }
+            else if ( op < 99 ) {
+                [dictionary removeObjectForKey:key];
+                [legacy updateOrAddKey:key andValue:nil];
+            }
+            else {
+                [dictionary removeAllObjects];
+                [legacy.orderedKeys removeAllObjects];
+                [legacy.kvps removeAllObjects];
+            }
+            
+            XCTAssertEqualObjects(dictionary[key], legacy.kvps[key], @"%@", context);
+            XCTAssertEqual([dictionary containsKey:key], legacy.kvps[key] != nil, @"%@", context);
+            XCTAssertEqual(dictionary.count, legacy.orderedKeys.count, @"%@", context);
+            
+            if ( step % 97 == 0 ) {
+                [self assertDictionary:dictionary matches:legacy context:context];
+                
+                MutableOrderedDictionary* clone = [dictionary clone];
+                XCTAssertEqualObjects(clone, dictionary, @"%@", context);
+                [self assertDictionary:clone matches:legacy context:context];
+            }
+        }
+        
+        [self assertDictionary:dictionary matches:legacy context:keySpace.stringValue];
+    }
+}
+
+- (void)testCloneIsIndependent {
+    MutableOrderedDictionary<NSString*, NSString*>* dictionary = [[MutableOrderedDictionary alloc] init];
+    
+    for ( int i = 0; i < 100; i++ ) {
+        dictionary[@(i).stringValue] = @(i * 2).stringValue;
+    }
+    [dictionary removeObjectForKey:@"50"];
+    
+    MutableOrderedDictionary<NSString*, NSString*>* clone = [dictionary clone];
+    clone[@"1"] = @"changed";
+    [clone removeObjectForKey:@"2"];
+    
+    XCTAssertEqualObjects(dictionary[@"1"], @"2");
+    XCTAssertEqualObjects(dictionary[@"2"], @"4");
+    XCTAssertNil(dictionary[@"50"]);
+    XCTAssertEqual(dictionary.count, 99);
+    XCTAssertEqual(clone.count, 98);
+    XCTAssertNotEqualObjects(clone, dictionary);
+}
+
+- (void)testKeysAreCopied {
+    MutableOrderedDictionary<NSString*, NSString*>* dictionary = [[MutableOrderedDictionary alloc] init];
+    NSMutableString* key = [NSMutableString stringWithString:@"Title"];
+    
+    dictionary[key] = @"a";
+    [key appendString:@"Changed"];
+    
+    XCTAssertEqualObjects(dictionary[@"Title"], @"a");
+    XCTAssertNil(dictionary[key]);
+    XCTAssertEqualObjects([dictionary objectForCaseInsensitiveKey:@"TITLE"], @"a");
+}
+
+- (void)testPerformanceManyCustomFields {
+    NSMutableArray<NSString*>* keys = NSMutableArray.array;
+    for ( int i = 0; i < 2000; i++ ) {
+        [keys addObject:[NSString stringWithFormat:@"Custom Field %d", i]];
+    }
+    
+    [self measureBlock:^{
+        MutableOrderedDictionary<NSString*, NSString*>* dictionary = [[MutableOrderedDictionary alloc] init];
+        
+        for ( NSString* key in keys ) {
+            [dictionary addKey:key andValue:key];
+        }
+        
+        for ( NSString* key in keys ) {
+            [dictionary addKey:key andValue:key];
+            dictionary[key] = key;
+        }
+        
+        for ( NSString* key in keys ) {
+            if ( key.hash % 2 ) {
+                [dictionary removeObjectForKey:key];
+            }
+            [dictionary allValues];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,130 @@
+//
+//  NSDateExtensionsTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "NSDate+Extensions.h"
+
+@interface NSDateExtensionsTests : XCTestCase
+
+@property NSArray<NSDate*>* dates;
+
+@end
+
+@implementation NSDateExtensionsTests
+
+- (void)setUp {
+    NSMutableArray<NSDate*>* dates = @[NSDate.date, [NSDate dateWithTimeIntervalSinceNow:-86400], [NSDate dateWithTimeIntervalSinceNow:86400],
+                                       [NSDate dateWithTimeIntervalSince1970:0], [NSDate dateWithTimeIntervalSince1970:1234567890.123]].mutableCopy;
+
+    for ( int i = 0; i < 200; i++ ) {
+        [dates addObject:[NSDate dateWithTimeIntervalSince1970:(double)arc4random() + (arc4random() % 1000) / 1000.0]];
+    }
+
+    self.dates = dates;
+}
+
+- (NSDateFormatter*)styled:(NSDateFormatterStyle)dateStyle time:(NSDateFormatterStyle)timeStyle relative:(BOOL)relative {
+    NSDateFormatter *df = [[NSDateFormatter alloc] init];
+
+    df.timeStyle = timeStyle;
+    df.dateStyle = dateStyle;
+    df.doesRelativeDateFormatting = relative;
+    df.locale = NSLocale.currentLocale;
+
+    return df;
+}
+
+- (NSDateFormatter*)posix:(NSString*)format {
+    NSDateFormatter *df = [[NSDateFormatter alloc] init];
+
+    df.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    df.dateFormat = format;
+
+    return df;
+}
+
+- (void)assertMatchesFreshFormatters {
+    NSDictionary<NSString*, NSDateFormatter*>* expected = @{
+        @"friendlyDateString" : [self styled:NSDateFormatterMediumStyle time:NSDateFormatterNoStyle relative:YES],
+        @"friendlyDateTimeString" : [self styled:NSDateFormatterMediumStyle time:NSDateFormatterShortStyle relative:YES],
+        @"friendlyDateStringVeryShort" : [self styled:NSDateFormatterShortStyle time:NSDateFormatterShortStyle relative:YES],
+        @"friendlyDateStringVeryShortDateOnly" : [self styled:NSDateFormatterShortStyle time:NSDateFormatterNoStyle relative:NO],
+        @"friendlyDateTimeStringPrecise" : [self styled:NSDateFormatterShortStyle time:NSDateFormatterMediumStyle relative:YES],
+        @"fileNameCompatibleDateTime" : [self posix:@"yyyyMMdd_HHmmss"],
+        @"fileNameCompatibleDateTimePrecise" : [self posix:@"yyyyMMdd_HHmmss_SSS"],
+        @"friendlyTimeStringPrecise" : [self posix:@"HH:mm:ss.SSS"],
+        @"friendlyDateTimeStringBothPrecise" : [self posix:@"yyyy-MM-dd HH:mm:ss.SSS"],
+        @"iso8601DateString" : [self posix:@"yyyy-MM-dd'T'HH:mm:ssZZZZZ"],
+    };
+
+    for ( NSDate* date in self.dates ) {
+        for ( NSString* property in expected ) {
+            XCTAssertEqualObjects([date valueForKey:property], [expected[property] stringFromDate:date], @"%@ %@", property, date);
+        }
+
+        NSString* day = [[self posix:@"yyyy-MM-dd"] stringFromDate:date];
+        XCTAssertEqualObjects([NSDate fromYYYY_MM_DDString:day], [[self posix:@"yyyy-MM-dd"] dateFromString:day]);
+    }
+}
+
+- (void)testOutputsMatchFreshFormatters {
+    [self assertMatchesFreshFormatters];
+}
+
+- (void)testOutputsMatchFreshFormattersOnOtherThreads {
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t iteration) {
+        [self assertMatchesFreshFormatters];
+    });
+}
+
+- (void)testTimeZoneChangeInvalidatesCache {
+    NSTimeZone* original = NSTimeZone.defaultTimeZone;
+
+    for ( NSString* name in @[@"UTC", @"Asia/Tokyo", @"America/Los_Angeles"] ) {
+        NSTimeZone.defaultTimeZone = [NSTimeZone timeZoneWithName:name];
+        [NSNotificationCenter.defaultCenter postNotificationName:NSSystemTimeZoneDidChangeNotification object:nil];
+
+        [self assertMatchesFreshFormatters];
+    }
+
+    NSTimeZone.defaultTimeZone = original;
+    [NSNotificationCenter.defaultCenter postNotificationName:NSSystemTimeZoneDidChangeNotification object:nil];
+}
+
+- (void)testLocaleChangeNotificationKeepsOutputsCorrect {
+    [self assertMatchesFreshFormatters];
+
+    [NSNotificationCenter.defaultCenter postNotificationName:NSCurrentLocaleDidChangeNotification object:nil];
+
+    [self assertMatchesFreshFormatters];
+}
+
+- (void)testMicrosoftGraphDates {
+    NSDate* withMillis = [NSDate microsoftGraphDateFromString:@"2021-03-04T05:06:07.890Z"];
+    NSDate* withoutMillis = [NSDate microsoftGraphDateFromString:@"2021-03-04T05:06:07Z"];
+
+    XCTAssertNotNil(withMillis);
+    XCTAssertNotNil(withoutMillis);
+    XCTAssertEqualWithAccuracy(withMillis.timeIntervalSince1970 - withoutMillis.timeIntervalSince1970, 0.89, 0.001);
+    XCTAssertNil([NSDate microsoftGraphDateFromString:@"garbage"]);
+}
+
+- (void)testPerformanceFormat100kDates {
+    NSMutableArray<NSDate*>* dates = NSMutableArray.array;
+    for ( int i = 0; i < 100000; i++ ) {
+        [dates addObject:[NSDate dateWithTimeIntervalSince1970:arc4random()]];
+    }
+
+    [self measureBlock:^{
+        for ( NSDate* date in dates ) {
+            [date friendlyDateTimeString];
+        }
+    }];
+}
+
+@end
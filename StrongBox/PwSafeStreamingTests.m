@@ -0,0 +1,208 @@
+//
+//  PwSafeStreamingTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonDigest.h>
+#import "Serializator.h"
+#import "LargeVaultGenerator.h"
+#import "PwSafeSerialization.h"
+#import "StrongboxErrorCodes.h"
+
+static const NSUInteger kLargeEntryCount = 100000;
+
+@interface PwSafeStreamingTests : XCTestCase
+
+@property NSURL* databaseUrl;
+
+@end
+
+@implementation PwSafeStreamingTests
+
++ (DatabaseModel*)generated {
+    static DatabaseModel* generated;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        LargeVaultGeneratorConfig* config = LargeVaultGeneratorConfig.defaults;
+
+        config.format = kPasswordSafe;
+        config.password = @"a";
+        config.entryCount = kLargeEntryCount;
+        config.groupsPerGroup = 8;
+
+        generated = [LargeVaultGenerator generate:config];
+    });
+
+    return generated;
+}
+
++ (NSData*)data {
+    static NSData* data;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        data = [Serializator expressToData:self.generated format:kPasswordSafe];
+    });
+
+    return data;
+}
+
+- (void)setUp {
+    NSURL* directory = [NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES];
+
+    self.databaseUrl = [directory URLByAppendingPathComponent:[NSUUID.UUID.UUIDString stringByAppendingPathExtension:@"psafe3"]];
+
+    [PwSafeStreamingTests.data writeToURL:self.databaseUrl atomically:YES];
+}
+
+- (void)tearDown {
+    [NSFileManager.defaultManager removeItemAtURL:self.databaseUrl error:nil];
+}
+
+- (DatabaseModel*)open:(NSString*)password error:(NSError**)error {
+    __block DatabaseModel* ret = nil;
+    __block NSError* openError = nil;
+
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_enter(group);
+
+    [Serializator fromUrl:self.databaseUrl
+                      ckf:[CompositeKeyFactors password:password]
+                   config:DatabaseModelConfig.defaults
+               completion:^(BOOL userCancelled, DatabaseModel * _Nullable model, NSError * _Nullable innerError) {
+        ret = model;
+        openError = innerError;
+        dispatch_group_leave(group);
+    }];
+
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+    if ( error ) {
+        *error = openError;
+    }
+
+    return ret;
+}
+
+- (void)writeModified:(void (^)(NSMutableData* data))modify {
+    NSMutableData* data = PwSafeStreamingTests.data.mutableCopy;
+
+    modify(data);
+
+    [data writeToURL:self.databaseUrl atomically:YES];
+}
+
+- (void)testStreamingLoadMatchesGeneratedModel {
+    DatabaseModel* generated = PwSafeStreamingTests.generated;
+    DatabaseModel* loaded = [self open:@"a" error:nil];
+
+    XCTAssertNotNil(loaded);
+    XCTAssertEqual(loaded.meta.kdfIterations, generated.meta.kdfIterations);
+
+    NSArray<Node*>* expectedRecords = generated.rootNode.allChildRecords;
+    XCTAssertEqual(loaded.rootNode.allChildRecords.count, kLargeEntryCount);
+    XCTAssertEqual(loaded.rootNode.allChildRecords.count, expectedRecords.count);
+
+    NSMutableDictionary<NSUUID*, Node*>* loadedById = NSMutableDictionary.dictionary;
+    for ( Node* record in loaded.rootNode.allChildRecords ) {
+        loadedById[record.uuid] = record;
+    }
+
+    for ( Node* expected in expectedRecords ) {
+        Node* actual = loadedById[expected.uuid];
+
+        XCTAssertNotNil(actual, @"%@", expected.title);
+        XCTAssertEqualObjects(actual.title, expected.title);
+        XCTAssertEqualObjects([actual.parent getTitleHierarchy], [expected.parent getTitleHierarchy]);
+        XCTAssertEqualObjects(actual.fields.username, expected.fields.username);
+        XCTAssertEqualObjects(actual.fields.password, expected.fields.password);
+        XCTAssertEqualObjects(actual.fields.url, expected.fields.url);
+        XCTAssertEqualObjects(actual.fields.notes, expected.fields.notes);
+        XCTAssertEqualObjects(actual.fields.email, expected.fields.email);
+        XCTAssertEqualObjects(actual.fields.created, expected.fields.created);
+        XCTAssertEqualObjects(actual.fields.modified, expected.fields.modified);
+    }
+
+    NSMutableSet<NSArray<NSString*>*>* expectedGroups = NSMutableSet.set;
+    for ( Node* group in generated.rootNode.allChildGroups ) {
+        [expectedGroups addObject:[group getTitleHierarchy]];
+    }
+
+    NSMutableSet<NSArray<NSString*>*>* loadedGroups = NSMutableSet.set;
+    for ( Node* group in loaded.rootNode.allChildGroups ) {
+        XCTAssertFalse([loadedGroups containsObject:[group getTitleHierarchy]], @"Duplicate group %@", group.title);
+        [loadedGroups addObject:[group getTitleHierarchy]];
+    }
+
+    XCTAssertEqualObjects(loadedGroups, expectedGroups);
+}
+
+- (void)testOpenFromDataMatchesOpenFromFile {
+    DatabaseModel* fromData = [Serializator expressFromData:PwSafeStreamingTests.data password:@"a"];
+    DatabaseModel* fromFile = [self open:@"a" error:nil];
+
+    XCTAssertNotNil(fromData);
+    XCTAssertNotNil(fromFile);
+    XCTAssertEqual(fromData.rootNode.allChildRecords.count, fromFile.rootNode.allChildRecords.count);
+    XCTAssertEqual(fromData.rootNode.allChildGroups.count, fromFile.rootNode.allChildGroups.count);
+}
+
+- (void)testWrongPasswordFails {
+    NSError* error;
+
+    XCTAssertNil([self open:@"b" error:&error]);
+    XCTAssertEqual(error.code, StrongboxErrorCodes.incorrectCredentials);
+}
+
+- (void)testCorruptedCiphertextFailsHmac {
+    [self writeModified:^(NSMutableData *data) {
+        ((uint8_t*)data.mutableBytes)[data.length / 2] ^= 0x01;
+    }];
+
+    NSError* error;
+
+    XCTAssertNil([self open:@"a" error:&error]);
+    XCTAssertEqual(error.code, -3);
+}
+
+- (void)testCorruptedHmacFails {
+    [self writeModified:^(NSMutableData *data) {
+        ((uint8_t*)data.mutableBytes)[data.length - 1] ^= 0x01;
+    }];
+
+    NSError* error;
+
+    XCTAssertNil([self open:@"a" error:&error]);
+    XCTAssertEqual(error.code, -3);
+}
+
+- (void)testTruncatedFilesFail {
+    NSUInteger length = PwSafeStreamingTests.data.length;
+
+    for ( NSNumber* truncateTo in @[@(length - 1), @(length - CC_SHA256_DIGEST_LENGTH - 1), @(length / 2), @(SIZE_OF_PASSWORD_SAFE_3_HEADER + 8), @(10)] ) {
+        [self writeModified:^(NSMutableData *data) {
+            data.length = truncateTo.unsignedIntegerValue;
+        }];
+
+        NSError* error;
+
+        XCTAssertNil([self open:@"a" error:&error], @"%@", truncateTo);
+        XCTAssertNotNil(error, @"%@", truncateTo);
+    }
+}
+
+- (void)testPerformanceOpenWithPeakMemory {
+    XCTMeasureOptions* options = XCTMeasureOptions.defaultOptions;
+    options.iterationCount = 3;
+
+    [self measureWithMetrics:@[[[XCTClockMetric alloc] init], [[XCTMemoryMetric alloc] init]] options:options block:^{
+        [self open:@"a" error:nil];
+    }];
+}
+
+@end
@@ -0,0 +1,247 @@
+//
+//  SafeStorageProviderStreamAdapterTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <mach/mach.h>
+#import "SafeStorageProviderStreamAdapter.h"
+#import "NSData+Extensions.h"
+
+@interface DataOnlyTestStorageProvider : NSObject <SafeStorageProvider>
+
+@property NSURL* fileUrl;
+@property (nonatomic) StorageProvider storageId;
+@property (nonatomic) BOOL providesIcons;
+@property (nonatomic) BOOL browsableNew;
+@property (nonatomic) BOOL browsableExisting;
+@property (nonatomic) BOOL rootFolderOnly;
+@property (nonatomic) BOOL supportsConcurrentRequests;
+@property (nonatomic) BOOL defaultForImmediatelyOfferOfflineCache;
+@property (nonatomic) BOOL privacyOptInRequired;
+
+@end
+
+@implementation DataOnlyTestStorageProvider
+
+- (void)pullDatabase:(METADATA_PTR)safeMetaData interactiveVC:(VIEW_CONTROLLER_PTR)viewController options:(StorageProviderReadOptions *)options completion:(StorageProviderReadCompletionBlock)completion {
+    NSError* error;
+    NSData* data = [NSData dataWithContentsOfURL:self.fileUrl options:kNilOptions error:&error];
+    NSDictionary* attr = [NSFileManager.defaultManager attributesOfItemAtPath:self.fileUrl.path error:nil];
+    completion(data ? kReadResultSuccess : kReadResultError, data, attr.fileModificationDate, error);
+}
+
+- (void)pushDatabase:(METADATA_PTR)safeMetaData interactiveVC:(VIEW_CONTROLLER_PTR)viewController data:(NSData *)data completion:(StorageProviderUpdateCompletionBlock)completion {
+    NSError* error;
+    BOOL success = [data writeToURL:self.fileUrl options:NSDataWritingAtomic error:&error];
+    completion(success ? kUpdateResultSuccess : kUpdateResultError, NSDate.date, error);
+}
+
+- (void)create:(NSString *)nickName extension:(NSString *)extension data:(NSData *)data parentFolder:(NSObject *)parentFolder viewController:(VIEW_CONTROLLER_PTR)viewController completion:(void (^)(METADATA_PTR, const NSError *))completion { }
+- (void)delete:(METADATA_PTR)safeMetaData completion:(void (^)(const NSError *))completion { }
+- (void)list:(NSObject *)parentFolder viewController:(VIEW_CONTROLLER_PTR)viewController completion:(void (^)(BOOL, NSArray<StorageBrowserItem *> *, const NSError *))completion { }
+- (void)readWithProviderData:(NSObject *)providerData viewController:(VIEW_CONTROLLER_PTR)viewController options:(StorageProviderReadOptions *)options completion:(StorageProviderReadCompletionBlock)completionHandler { }
+- (void)loadIcon:(NSObject *)providerData viewController:(VIEW_CONTROLLER_PTR)viewController completion:(void (^)(IMAGE_TYPE_PTR))completionHandler { }
+- (METADATA_PTR)getDatabasePreferences:(NSString *)nickName providerData:(NSObject *)providerData { return nil; }
+- (void)getModDate:(METADATA_PTR)safeMetaData completion:(StorageProviderGetModDateCompletionBlock)completion { }
+
+@end
+
+@interface LocalFolderTestStorageProvider : DataOnlyTestStorageProvider
+
+@end
+
+@implementation LocalFolderTestStorageProvider
+
+- (void)pullDatabaseStream:(METADATA_PTR)safeMetaData interactiveVC:(VIEW_CONTROLLER_PTR)viewController options:(StorageProviderReadOptions *)options completion:(StorageProviderStreamReadCompletionBlock)completion {
+    NSDictionary* attr = [NSFileManager.defaultManager attributesOfItemAtPath:self.fileUrl.path error:nil];
+    completion(kReadResultSuccess, [NSInputStream inputStreamWithURL:self.fileUrl], attr.fileModificationDate, nil);
+}
+
+- (void)pushDatabaseStream:(METADATA_PTR)safeMetaData interactiveVC:(VIEW_CONTROLLER_PTR)viewController stream:(NSInputStream *)stream completion:(StorageProviderUpdateCompletionBlock)completion {
+    NSError* error;
+    NSData* sha256 = [SafeStorageProviderStreamAdapter writeStream:stream toFile:self.fileUrl error:&error];
+    completion(sha256 ? kUpdateResultSuccess : kUpdateResultError, NSDate.date, error);
+}
+
+@end
+
+@interface SafeStorageProviderStreamAdapterTests : XCTestCase
+
+@end
+
+@implementation SafeStorageProviderStreamAdapterTests
+
+static const unsigned long long kSyntheticFileSize = 500 * 1024 * 1024;
+static const unsigned long long kMaxPeakMemoryGrowth = 32 * 1024 * 1024;
+
+- (unsigned long long)physicalFootprint {
+    task_vm_info_data_t info;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+
+    if ( task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info, &count) != KERN_SUCCESS ) {
+        return 0;
+    }
+
+    return info.phys_footprint;
+}
+
+- (NSURL*)createSyntheticFile:(unsigned long long)size {
+    NSURL* url = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString]];
+    [NSFileManager.defaultManager createFileAtPath:url.path contents:nil attributes:nil];
+
+    NSFileHandle* handle = [NSFileHandle fileHandleForWritingToURL:url error:nil];
+    NSMutableData* chunk = [NSMutableData dataWithLength:1024 * 1024];
+
+    for ( unsigned long long written = 0; written < size; written += chunk.length ) {
+        arc4random_buf(chunk.mutableBytes, chunk.length);
+        [handle writeData:chunk];
+    }
+
+    [handle closeFile];
+
+    return url;
+}
+
+- (void)testStreamingPullHasBoundedPeakMemory {
+    LocalFolderTestStorageProvider* provider = [[LocalFolderTestStorageProvider alloc] init];
+    provider.fileUrl = [self createSyntheticFile:kSyntheticFileSize];
+
+    NSURL* destination = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString]];
+    METADATA_PTR database = nil;
+
+    unsigned long long before = [self physicalFootprint];
+    __block unsigned long long peak = before;
+    __block NSData* digest = nil;
+
+    dispatch_source_t sampler = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0));
+    dispatch_source_set_timer(sampler, DISPATCH_TIME_NOW, 10 * NSEC_PER_MSEC, NSEC_PER_MSEC);
+    dispatch_source_set_event_handler(sampler, ^{
+        peak = MAX(peak, [self physicalFootprint]);
+    });
+    dispatch_resume(sampler);
+
+    [SafeStorageProviderStreamAdapter pullDatabase:provider
+                                          database:database
+                                     interactiveVC:nil
+                                           options:[[StorageProviderReadOptions alloc] init]
+                                       destination:destination
+                                        completion:^(StorageProviderReadResult result, NSData * _Nullable sha256, NSDate * _Nullable dateModified, const NSError * _Nullable error) {
+        XCTAssertEqual(result, kReadResultSuccess);
+        XCTAssertNotNil(dateModified);
+        digest = sha256;
+    }];
+
+    dispatch_source_cancel(sampler);
+
+    NSLog(@"Peak memory growth during 500MB streaming pull: %llu bytes", peak - before);
+
+    XCTAssertLessThan(peak - before, kMaxPeakMemoryGrowth);
+
+    NSDictionary* attr = [NSFileManager.defaultManager attributesOfItemAtPath:destination.path error:nil];
+    XCTAssertEqual(attr.fileSize, kSyntheticFileSize);
+
+    NSData* expected = [NSData dataWithContentsOfURL:provider.fileUrl options:NSDataReadingMappedAlways error:nil].sha256;
+    XCTAssertEqualObjects(digest, expected);
+
+    [NSFileManager.defaultManager removeItemAtURL:provider.fileUrl error:nil];
+    [NSFileManager.defaultManager removeItemAtURL:destination error:nil];
+}
+
+- (void)testStreamingPushDigestMatchesSource {
+    LocalFolderTestStorageProvider* provider = [[LocalFolderTestStorageProvider alloc] init];
+    provider.fileUrl = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString]];
+
+    NSURL* source = [self createSyntheticFile:8 * 1024 * 1024];
+    METADATA_PTR database = nil;
+
+    __block NSData* digest = nil;
+    [SafeStorageProviderStreamAdapter pushDatabase:provider
+                                          database:database
+                                     interactiveVC:nil
+                                            source:source
+                                        completion:^(StorageProviderUpdateResult result, NSData * _Nullable sha256, NSDate * _Nullable newRemoteModDate, const NSError * _Nullable error) {
+        XCTAssertEqual(result, kUpdateResultSuccess);
+        digest = sha256;
+    }];
+
+    XCTAssertEqualObjects(digest, [NSData dataWithContentsOfURL:source].sha256);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:provider.fileUrl], [NSData dataWithContentsOfURL:source]);
+
+    [NSFileManager.defaultManager removeItemAtURL:provider.fileUrl error:nil];
+    [NSFileManager.defaultManager removeItemAtURL:source error:nil];
+}
+
+- (void)testDataOnlyProviderFallsBackToNSData {
+    DataOnlyTestStorageProvider* provider = [[DataOnlyTestStorageProvider alloc] init];
+    provider.fileUrl = [self createSyntheticFile:4 * 1024 * 1024];
+
+    XCTAssertFalse([provider respondsToSelector:@selector(pullDatabaseStream:interactiveVC:options:completion:)]);
+    XCTAssertFalse([provider respondsToSelector:@selector(pushDatabaseStream:interactiveVC:stream:completion:)]);
+
+    NSData* original = [NSData dataWithContentsOfURL:provider.fileUrl];
+    NSURL* destination = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString]];
+    METADATA_PTR database = nil;
+
+    __block NSData* pulledDigest = nil;
+    [SafeStorageProviderStreamAdapter pullDatabase:provider
+                                          database:database
+                                     interactiveVC:nil
+                                           options:[[StorageProviderReadOptions alloc] init]
+                                       destination:destination
+                                        completion:^(StorageProviderReadResult result, NSData * _Nullable sha256, NSDate * _Nullable dateModified, const NSError * _Nullable error) {
+        XCTAssertEqual(result, kReadResultSuccess);
+        XCTAssertNotNil(dateModified);
+        pulledDigest = sha256;
+    }];
+
+    XCTAssertEqualObjects(pulledDigest, original.sha256);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:destination], original);
+
+    NSURL* source = [self createSyntheticFile:2 * 1024 * 1024];
+
+    __block NSData* pushedDigest = nil;
+    [SafeStorageProviderStreamAdapter pushDatabase:provider
+                                          database:database
+                                     interactiveVC:nil
+                                            source:source
+                                        completion:^(StorageProviderUpdateResult result, NSData * _Nullable sha256, NSDate * _Nullable newRemoteModDate, const NSError * _Nullable error) {
+        XCTAssertEqual(result, kUpdateResultSuccess);
+        pushedDigest = sha256;
+    }];
+
+    XCTAssertEqualObjects(pushedDigest, [NSData dataWithContentsOfURL:source].sha256);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:provider.fileUrl], [NSData dataWithContentsOfURL:source]);
+
+    [NSFileManager.defaultManager removeItemAtURL:provider.fileUrl error:nil];
+    [NSFileManager.defaultManager removeItemAtURL:destination error:nil];
+    [NSFileManager.defaultManager removeItemAtURL:source error:nil];
+}
+
+- (void)testDataOnlyProviderPullFailureIsReported {
+    DataOnlyTestStorageProvider* provider = [[DataOnlyTestStorageProvider alloc] init];
+    provider.fileUrl = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString]];
+
+    NSURL* destination = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString]];
+    METADATA_PTR database = nil;
+
+    __block BOOL called = NO;
+    [SafeStorageProviderStreamAdapter pullDatabase:provider
+                                          database:database
+                                     interactiveVC:nil
+                                           options:[[StorageProviderReadOptions alloc] init]
+                                       destination:destination
+                                        completion:^(StorageProviderReadResult result, NSData * _Nullable sha256, NSDate * _Nullable dateModified, const NSError * _Nullable error) {
+        XCTAssertEqual(result, kReadResultError);
+        XCTAssertNil(sha256);
+        called = YES;
+    }];
+
+    XCTAssertTrue(called);
+    XCTAssertFalse([NSFileManager.defaultManager fileExistsAtPath:destination.path]);
+}
+
+@end
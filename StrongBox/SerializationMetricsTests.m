@@ -0,0 +1,128 @@
+//
+//  SerializationMetricsTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "Serializator.h"
+#import "LargeVaultGenerator.h"
+#import "SerializationMetrics.h"
+
+@interface SerializationMetricsTests : XCTestCase
+
+@end
+
+@implementation SerializationMetricsTests
+
+- (NSArray<NSString*>*)expectedOpenStages:(DatabaseFormat)format {
+    switch ( format ) {
+        case kKeePass:
+        case kKeePass4:
+            return @[kSerializationStageIo, kSerializationStageKdf, kSerializationStageIntegrity, kSerializationStageCipher, kSerializationStageCompression, kSerializationStageDocument, kSerializationStageModel, kSerializationStageFastMaps];
+        case kPasswordSafe:
+        case kKeePass1:
+            return @[kSerializationStageIo, kSerializationStageKdf, kSerializationStageIntegrity, kSerializationStageCipher, kSerializationStageDocument, kSerializationStageModel, kSerializationStageFastMaps];
+        default:
+            return @[kSerializationStageIo, kSerializationStageDocument, kSerializationStageModel, kSerializationStageFastMaps];
+    }
+}
+
+- (NSArray<NSString*>*)expectedSaveStages:(DatabaseFormat)format {
+    NSMutableArray<NSString*>* ret = [self expectedOpenStages:format].mutableCopy;
+
+    [ret removeObject:kSerializationStageFastMaps];
+
+    return ret;
+}
+
+- (DatabaseModel*)database:(DatabaseFormat)format {
+    LargeVaultGeneratorConfig* config = LargeVaultGeneratorConfig.defaults;
+
+    config.format = format;
+    config.password = @"a";
+    config.entryCount = 200;
+
+    return [LargeVaultGenerator generate:config];
+}
+
+- (void)assertStages:(NSArray<NSString*>*)expected metrics:(SerializationMetrics*)metrics format:(DatabaseFormat)format {
+    NSTimeInterval sum = 0;
+
+    for ( NSString* stage in expected ) {
+        SerializationStageMetrics* stageMetrics = metrics.stages[stage];
+
+        XCTAssertNotNil(stageMetrics, @"Format %d stage %@", format, stage);
+        XCTAssertGreaterThan(stageMetrics.calls, 0, @"Format %d stage %@", format, stage);
+        XCTAssertGreaterThanOrEqual(stageMetrics.wallTime, 0, @"Format %d stage %@", format, stage);
+        XCTAssertGreaterThanOrEqual(stageMetrics.cpuTime, 0, @"Format %d stage %@", format, stage);
+
+        sum += stageMetrics.wallTime;
+    }
+
+    XCTAssertGreaterThan(metrics.wallTime, 0, @"Format %d", format);
+    XCTAssertLessThanOrEqual(sum, metrics.wallTime + 0.001, @"Format %d - stage times should not double count nested stages", format);
+}
+
+- (void)testAllStagesPopulatedForEachFormat {
+    for ( NSNumber* format in @[@(kKeePass4), @(kKeePass), @(kPasswordSafe), @(kKeePass1)] ) {
+        DatabaseModel* database = [self database:format.intValue];
+
+        SerializationMetrics* saveMetrics = [[SerializationMetrics alloc] init];
+        NSData* data = [Serializator expressToData:database format:format.intValue metrics:saveMetrics];
+
+        XCTAssertNotNil(data, @"Format %@", format);
+        XCTAssertEqual(saveMetrics.stages[kSerializationStageIo].bytes, data.length, @"Format %@", format);
+        XCTAssertEqual(database.serializationMetrics, saveMetrics);
+        [self assertStages:[self expectedSaveStages:format.intValue] metrics:saveMetrics format:format.intValue];
+
+        SerializationMetrics* openMetrics = [[SerializationMetrics alloc] init];
+        DatabaseModel* opened = [Serializator expressFromData:data password:@"a" metrics:openMetrics];
+
+        XCTAssertNotNil(opened, @"Format %@", format);
+        XCTAssertEqual(opened.serializationMetrics, openMetrics);
+        XCTAssertGreaterThan(openMetrics.stages[kSerializationStageIo].bytes, 0, @"Format %@", format);
+        XCTAssertLessThanOrEqual(openMetrics.stages[kSerializationStageIo].bytes, data.length, @"Format %@", format);
+        [self assertStages:[self expectedOpenStages:format.intValue] metrics:openMetrics format:format.intValue];
+
+        NSError* error;
+        XCTAssertNotNil([NSJSONSerialization dataWithJSONObject:openMetrics.jsonDictionary options:kNilOptions error:&error], @"%@", error);
+    }
+}
+
+- (void)testDecompressionBytesExceedCompressedBytes {
+    DatabaseModel* database = [self database:kKeePass4];
+    NSData* data = [Serializator expressToData:database format:kKeePass4];
+
+    SerializationMetrics* metrics = [[SerializationMetrics alloc] init];
+    XCTAssertNotNil([Serializator expressFromData:data password:@"a" metrics:metrics]);
+
+    XCTAssertGreaterThan(metrics.stages[kSerializationStageCompression].bytes, metrics.stages[kSerializationStageCipher].bytes);
+}
+
+- (void)testNoMetricsByDefault {
+    DatabaseModel* database = [self database:kKeePass4];
+    NSData* data = [Serializator expressToData:database format:kKeePass4];
+
+    XCTAssertNil(database.serializationMetrics);
+    XCTAssertNil([Serializator expressFromData:data password:@"a"].serializationMetrics);
+}
+
+- (void)testNestedStagesRecordExclusiveTime {
+    SerializationMetrics* metrics = [[SerializationMetrics alloc] init];
+
+    [metrics start];
+    [metrics beginStage:kSerializationStageDocument];
+    [metrics beginStage:kSerializationStageCompression];
+    [NSThread sleepForTimeInterval:0.05];
+    [metrics endStage:kSerializationStageCompression];
+    [metrics endStage:kSerializationStageDocument];
+    [metrics stop];
+
+    XCTAssertGreaterThanOrEqual(metrics.stages[kSerializationStageCompression].wallTime, 0.05);
+    XCTAssertLessThan(metrics.stages[kSerializationStageDocument].wallTime, 0.01);
+}
+
+@end
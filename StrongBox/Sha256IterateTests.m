@@ -0,0 +1,103 @@
+//
+//  Sha256IterateTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonDigest.h>
+#import "sha256_iterate.h"
+#import "PwSafeSerialization.h"
+#import "EncryptionSettingsViewModel.h"
+
+@interface Sha256IterateTests : XCTestCase
+
+@end
+
+@implementation Sha256IterateTests
+
+- (NSData*)commonCrypto:(NSData*)seed iterations:(uint64_t)iterations {
+    uint8_t digest[CC_SHA256_DIGEST_LENGTH];
+    memcpy(digest, seed.bytes, CC_SHA256_DIGEST_LENGTH);
+
+    for ( uint64_t i = 0; i < iterations; i++ ) {
+        CC_SHA256(digest, CC_SHA256_DIGEST_LENGTH, digest);
+    }
+
+    return [NSData dataWithBytes:digest length:CC_SHA256_DIGEST_LENGTH];
+}
+
+- (NSData*)iterate:(NSData*)seed iterations:(uint64_t)iterations portable:(BOOL)portable {
+    uint8_t digest[SHA256_ITERATE_DIGEST_LENGTH];
+    memcpy(digest, seed.bytes, SHA256_ITERATE_DIGEST_LENGTH);
+
+    if ( portable ) {
+        sha256_iterate_portable(digest, iterations);
+    }
+    else {
+        sha256_iterate(digest, iterations);
+    }
+
+    return [NSData dataWithBytes:digest length:SHA256_ITERATE_DIGEST_LENGTH];
+}
+
+- (void)testMatchesCommonCryptoLoopBitForBit {
+    NSLog(@"sha256_iterate implementation: %s", sha256_iterate_implementation());
+
+    for ( NSNumber* iterations in @[@(0), @(1), @(2), @(3), @(17), @(2048), @(DEFAULT_KEYSTRETCH_ITERATIONS), @(100000)] ) {
+        for ( int i = 0; i < 8; i++ ) {
+            NSMutableData* seed = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+            XCTAssertEqual(SecRandomCopyBytes(kSecRandomDefault, seed.length, seed.mutableBytes), errSecSuccess);
+
+            NSData* expected = [self commonCrypto:seed iterations:iterations.unsignedLongLongValue];
+
+            XCTAssertEqualObjects([self iterate:seed iterations:iterations.unsignedLongLongValue portable:NO], expected, @"%@", iterations);
+            XCTAssertEqualObjects([self iterate:seed iterations:iterations.unsignedLongLongValue portable:YES], expected, @"%@", iterations);
+        }
+    }
+}
+
+- (void)testKnownVector {
+    uint8_t digest[SHA256_ITERATE_DIGEST_LENGTH] = { 0 };
+
+    sha256_iterate(digest, 1);
+
+    NSData* expected = [self commonCrypto:[NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH] iterations:1];
+    XCTAssertEqualObjects([NSData dataWithBytes:digest length:SHA256_ITERATE_DIGEST_LENGTH], expected);
+    XCTAssertEqual(digest[0], 0x66);
+    XCTAssertEqual(digest[31], 0x25);
+}
+
+- (void)testCalibrationIsWithinSliderBounds {
+    EncryptionSettingsViewModel* settings = [EncryptionSettingsViewModel defaultsForFormat:kPasswordSafe];
+    settings.kdfAlgorithm = kKdfAlgorithmSha256;
+
+    [settings calibrateForTargetTime:0.1];
+
+    XCTAssertGreaterThanOrEqual(settings.iterations, (uint64_t)pow(2, settings.minKdfIterations));
+    XCTAssertLessThanOrEqual(settings.iterations, (uint64_t)pow(2, settings.maxKdfIterations));
+
+    uint32_t shortTarget = [PwSafeSerialization keyStretchIterationsForTargetTime:0.1];
+    uint32_t longTarget = [PwSafeSerialization keyStretchIterationsForTargetTime:1.0];
+    XCTAssertGreaterThan(longTarget, shortTarget);
+}
+
+- (void)testPerformanceCommonCryptoLoop {
+    NSData* seed = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+
+    [self measureBlock:^{
+        [self commonCrypto:seed iterations:1 << 20];
+    }];
+}
+
+- (void)testPerformanceIterate {
+    NSData* seed = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+
+    [self measureBlock:^{
+        [self iterate:seed iterations:1 << 20 portable:NO];
+    }];
+}
+
+@end
@@ -0,0 +1,146 @@
+//
+//  SimpleXmlValueExtractorTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "SimpleXmlValueExtractor.h"
+#import "Utils.h"
+
+static const NSUInteger kPropertyIterations = 20000;
+
+@interface SimpleXmlValueExtractorTests : XCTestCase
+
+@property NSISO8601DateFormatter* formatter;
+@property NSDate* dotNetBaseEpochDate;
+
+@end
+
+@implementation SimpleXmlValueExtractorTests
+
+- (void)setUp {
+    self.formatter = [[NSISO8601DateFormatter alloc] init];
+    self.formatter.formatOptions = NSISO8601DateFormatWithInternetDateTime | NSISO8601DateFormatWithDashSeparatorInDate | NSISO8601DateFormatWithColonSeparatorInTime | NSISO8601DateFormatWithTimeZone;
+    self.formatter.timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
+
+    self.dotNetBaseEpochDate = [self.formatter dateFromString:@"0001-01-03T00:00:00Z"];
+}
+
+- (NSDate*)foundationV4Date:(NSString*)text {
+    NSData* data = [[NSData alloc] initWithBase64EncodedString:text options:NSDataBase64DecodingIgnoreUnknownCharacters];
+
+    if ( data.length != 8 ) {
+        return nil;
+    }
+
+    return [NSDate dateWithTimeInterval:littleEndian8BytesToUInt64((uint8_t*)data.bytes) sinceDate:self.dotNetBaseEpochDate];
+}
+
+- (NSUUID*)foundationUuid:(NSString*)text {
+    NSData* data = [[NSData alloc] initWithBase64EncodedString:text options:NSDataBase64DecodingIgnoreUnknownCharacters];
+
+    return data.length == sizeof(uuid_t) ? [[NSUUID alloc] initWithUUIDBytes:data.bytes] : nil;
+}
+
+- (NSDate*)randomDateFromYear:(int)from toYear:(int)to {
+    NSDate* start = [self.formatter dateFromString:[NSString stringWithFormat:@"%04d-01-01T00:00:00Z", from]];
+    NSDate* end = [self.formatter dateFromString:[NSString stringWithFormat:@"%04d-01-01T00:00:00Z", to]];
+
+    uint64_t range = (uint64_t)[end timeIntervalSinceDate:start];
+
+    uint64_t random = (uint64_t)arc4random() << 32 | arc4random();
+
+    return [start dateByAddingTimeInterval:(NSTimeInterval)(random % range)];
+}
+
+- (void)testV4DatesMatchFoundation {
+    for ( NSUInteger i = 0; i < kPropertyIterations; i++ ) {
+        uint64_t ticks = ((uint64_t)arc4random() << 32 | arc4random()) % 320000000000ULL;
+        NSString* text = [Uint64ToLittleEndianData(ticks) base64EncodedStringWithOptions:kNilOptions];
+
+        XCTAssertEqualObjects([SimpleXmlValueExtractor dateFromString:text v4Format:YES], [self foundationV4Date:text], @"%@", text);
+
+        NSDate* date = [SimpleXmlValueExtractor dateFromString:text v4Format:YES];
+        XCTAssertEqualObjects([SimpleXmlValueExtractor getV4String:date], text);
+    }
+}
+
+- (void)testUuidsMatchFoundation {
+    for ( NSUInteger i = 0; i < kPropertyIterations; i++ ) {
+        NSUUID* uuid = NSUUID.UUID;
+        uuid_t bytes;
+        [uuid getUUIDBytes:bytes];
+
+        NSString* expected = [[NSData dataWithBytes:bytes length:sizeof(uuid_t)] base64EncodedStringWithOptions:kNilOptions];
+
+        XCTAssertEqualObjects([SimpleXmlValueExtractor getUuidString:uuid], expected);
+        XCTAssertEqualObjects([SimpleXmlValueExtractor uuidFromString:expected], uuid);
+        XCTAssertEqualObjects([SimpleXmlValueExtractor uuidFromString:expected], [self foundationUuid:expected]);
+    }
+}
+
+- (void)testV3DatesMatchFoundation {
+    for ( NSUInteger i = 0; i < kPropertyIterations; i++ ) {
+        NSDate* date = [self randomDateFromYear:1600 toYear:9999];
+        NSString* expected = [self.formatter stringFromDate:date];
+
+        XCTAssertEqualObjects([SimpleXmlValueExtractor getV3String:date], expected);
+        XCTAssertEqualObjects([SimpleXmlValueExtractor dateFromString:expected v4Format:NO], [self.formatter dateFromString:expected], @"%@", expected);
+    }
+}
+
+- (void)testOddInputsFallBackToFoundation {
+    NSArray<NSString*>* v4 = @[@"", @"AAAAAAAAAAB=", @"AAAA AAAAAAA=", @" AAAAAAAAAAA=", @"AAAAAAAAAAA", @"AAAAAAAAAA==", @"AAAAAAAAAAAA", @"AAAAAAAAAAA=\n", @"é"];
+    for ( NSString* text in v4 ) {
+        XCTAssertEqualObjects([SimpleXmlValueExtractor dateFromString:text v4Format:YES], [self foundationV4Date:text], @"%@", text);
+    }
+
+    NSArray<NSString*>* uuids = @[@"", @"AAAAAAAAAAAAAAAAAAAAAA=", @"AAAAAAAAAAAAAAAAAAAAAB==", @"AAAAAAAAAAAA AAAAAAAAAAA==", @"AAAAAAAAAAAAAAAAAAAAAAAA", @"=AAAAAAAAAAAAAAAAAAAAAA="];
+    for ( NSString* text in uuids ) {
+        XCTAssertEqualObjects([SimpleXmlValueExtractor uuidFromString:text], [self foundationUuid:text], @"%@", text);
+    }
+
+    NSArray<NSString*>* v3 = @[@"", @"2021-02-29T00:00:00Z", @"2020-02-29T00:00:00Z", @"2021-13-01T00:00:00Z", @"2021-01-01T24:00:00Z",
+                               @"2021-01-01T00:00:60Z", @"1500-01-01T00:00:00Z", @"0001-01-03T00:00:00Z", @"2021-01-01t00:00:00Z",
+                               @"2021-01-01T00:00:00z", @"2021-01-01T00:00:00+01:00", @"2021-01-01T00:00:00.123Z", @"2021-1-01T00:00:00Z", @"garbage"];
+    for ( NSString* text in v3 ) {
+        XCTAssertEqualObjects([SimpleXmlValueExtractor dateFromString:text v4Format:NO], [self.formatter dateFromString:text], @"%@", text);
+    }
+
+    NSArray<NSDate*>* dates = @[[NSDate dateWithTimeIntervalSince1970:1.5], [NSDate dateWithTimeIntervalSince1970:-0.25], NSDate.date,
+                                [self.formatter dateFromString:@"1200-06-01T00:00:00Z"], [self.formatter dateFromString:@"1599-12-31T23:59:59Z"], NSDate.distantFuture];
+    for ( NSDate* date in dates ) {
+        XCTAssertEqualObjects([SimpleXmlValueExtractor getV3String:date], [self.formatter stringFromDate:date], @"%@", date);
+    }
+}
+
+- (void)testPerformanceV3DateParse {
+    NSMutableArray<NSString*>* strings = NSMutableArray.array;
+    for ( int i = 0; i < 100000; i++ ) {
+        [strings addObject:[self.formatter stringFromDate:[self randomDateFromYear:2000 toYear:2030]]];
+    }
+
+    [self measureBlock:^{
+        for ( NSString* text in strings ) {
+            [SimpleXmlValueExtractor dateFromString:text v4Format:NO];
+        }
+    }];
+}
+
+- (void)testPerformanceUuidParse {
+    NSMutableArray<NSString*>* strings = NSMutableArray.array;
+    for ( int i = 0; i < 100000; i++ ) {
+        [strings addObject:[SimpleXmlValueExtractor getUuidString:NSUUID.UUID]];
+    }
+
+    [self measureBlock:^{
+        for ( NSString* text in strings ) {
+            [SimpleXmlValueExtractor uuidFromString:text];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,162 @@
+//
+//  TotpBatchGeneratorTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "TotpBatchGenerator.h"
+#import "OTPToken+Generation.h"
+#import <CommonCrypto/CommonHMAC.h>
+
+static const NSUInteger kBenchmarkTokenCount = 10000;
+
+@interface TotpBatchGeneratorTests : XCTestCase
+
+@end
+
+@implementation TotpBatchGeneratorTests
+
+- (OTPToken*)rfc6238Token:(OTPAlgorithm)algorithm {
+    NSString* seed = algorithm == OTPAlgorithmSHA1 ? @"12345678901234567890" :
+                     algorithm == OTPAlgorithmSHA256 ? @"12345678901234567890123456789012" :
+                     @"1234567890123456789012345678901234567890123456789012345678901234";
+    
+    OTPToken* token = [OTPToken tokenWithType:OTPTokenTypeTimer secret:[seed dataUsingEncoding:NSASCIIStringEncoding] name:@"<Unknown>" issuer:@"<Unknown>"];
+    
+    token.algorithm = algorithm;
+    token.digits = 8;
+    token.period = 30;
+    
+    return token;
+}
+
+- (OTPToken*)randomToken {
+    NSMutableData* secret = [NSMutableData dataWithLength:10 + arc4random_uniform(150)];
+    XCTAssertEqual(SecRandomCopyBytes(kSecRandomDefault, secret.length, secret.mutableBytes), errSecSuccess);
+    
+    OTPToken* token = [OTPToken tokenWithType:OTPTokenTypeTimer secret:secret name:@"<Unknown>" issuer:@"<Unknown>"];
+    
+    OTPAlgorithm algorithms[] = { OTPAlgorithmSHA1, OTPAlgorithmSHA256, OTPAlgorithmSHA512 };
+    token.algorithm = algorithms[arc4random_uniform(3)];
+    token.digits = 6 + arc4random_uniform(3);
+    token.period = arc4random_uniform(2) ? 30 : 60;
+    
+    return token;
+}
+
+- (void)testRfc6238Vectors {
+    NSDictionary<NSNumber*, NSArray<NSString*>*>* vectors = @{
+        @(59)          : @[@"94287082", @"46119246", @"90693936"],
+        @(1111111109)  : @[@"07081804", @"68084774", @"25091201"],
+        @(1111111111)  : @[@"14050471", @"67062674", @"99943326"],
+        @(1234567890)  : @[@"89005924", @"91819424", @"93441116"],
+        @(2000000000)  : @[@"69279037", @"90698825", @"38618901"],
+        @(20000000000) : @[@"65353130", @"77737706", @"47863826"],
+    };
+    
+    NSArray<OTPToken*>* tokens = @[[self rfc6238Token:OTPAlgorithmSHA1], [self rfc6238Token:OTPAlgorithmSHA256], [self rfc6238Token:OTPAlgorithmSHA512]];
+    NSArray<NSUUID*>* ids = @[NSUUID.UUID, NSUUID.UUID, NSUUID.UUID];
+    
+    TotpBatchGenerator* generator = [[TotpBatchGenerator alloc] initWithTokens:[NSDictionary dictionaryWithObjects:tokens forKeys:ids]];
+    
+    for ( NSNumber* time in vectors ) {
+        NSDate* date = [NSDate dateWithTimeIntervalSince1970:time.doubleValue];
+        NSDictionary<NSUUID*, NSString*>* codes = [generator codesAtDate:date];
+        
+        for ( NSUInteger i = 0; i < tokens.count; i++ ) {
+            XCTAssertEqualObjects(codes[ids[i]], vectors[time][i], @"%@ %lu", time, (unsigned long)i);
+            XCTAssertEqualObjects([TotpBatchGenerator codeForToken:tokens[i] date:date], vectors[time][i], @"%@ %lu", time, (unsigned long)i);
+        }
+    }
+}
+
+- (NSString*)referenceCode:(OTPToken*)token date:(NSDate*)date {
+    uint64_t counter = CFSwapInt64HostToBig((uint64_t)(date.timeIntervalSince1970 / token.period));
+    
+    CCHmacAlgorithm algorithm = token.algorithm == OTPAlgorithmSHA256 ? kCCHmacAlgSHA256 : token.algorithm == OTPAlgorithmSHA512 ? kCCHmacAlgSHA512 : kCCHmacAlgSHA1;
+    size_t length = token.algorithm == OTPAlgorithmSHA256 ? CC_SHA256_DIGEST_LENGTH : token.algorithm == OTPAlgorithmSHA512 ? CC_SHA512_DIGEST_LENGTH : CC_SHA1_DIGEST_LENGTH;
+    
+    uint8_t hmac[CC_SHA512_DIGEST_LENGTH];
+    CCHmac(algorithm, token.secret.bytes, token.secret.length, &counter, sizeof(counter), hmac);
+    
+    uint8_t offset = hmac[length - 1] & 0x0f;
+    uint32_t truncated = ((hmac[offset] & 0x7f) << 24) | (hmac[offset + 1] << 16) | (hmac[offset + 2] << 8) | hmac[offset + 3];
+    
+    return [NSString stringWithFormat:@"%0*u", (int)token.digits, truncated % (uint32_t)pow(10, token.digits)];
+}
+
+- (void)testMatchesOtpTokenForRandomTokens {
+    NSMutableDictionary<NSUUID*, OTPToken*>* tokens = NSMutableDictionary.dictionary;
+    for ( int i = 0; i < 500; i++ ) {
+        tokens[NSUUID.UUID] = [self randomToken];
+    }
+    
+    NSDate* date = [NSDate dateWithTimeIntervalSince1970:1760000000];
+    
+    TotpBatchGenerator* generator = [[TotpBatchGenerator alloc] initWithTokens:tokens];
+    NSDictionary<NSUUID*, NSString*>* codes = [generator codesAtDate:date];
+    
+    XCTAssertEqual(codes.count, tokens.count);
+    
+    for ( NSUUID* uuid in tokens ) {
+        XCTAssertEqualObjects(codes[uuid], [self referenceCode:tokens[uuid] date:date]);
+    }
+}
+
+- (void)testCodesAreReusedWithinPeriod {
+    NSUUID* uuid = NSUUID.UUID;
+    TotpBatchGenerator* generator = [[TotpBatchGenerator alloc] initWithTokens:@{ uuid : [self rfc6238Token:OTPAlgorithmSHA1] }];
+    
+    NSString* first = [generator codeForId:uuid date:[NSDate dateWithTimeIntervalSince1970:1111111080]];
+    NSString* second = [generator codeForId:uuid date:[NSDate dateWithTimeIntervalSince1970:1111111109]];
+    NSString* next = [generator codeForId:uuid date:[NSDate dateWithTimeIntervalSince1970:1111111110]];
+    
+    XCTAssertEqual(first, second);
+    XCTAssertEqualObjects(second, @"07081804");
+    XCTAssertEqualObjects(next, @"14050471");
+    XCTAssertNil([generator currentCodeForId:NSUUID.UUID]);
+}
+
+- (void)testNonStandardTokensDelegateToOtpToken {
+    OTPToken* steam = [self rfc6238Token:OTPAlgorithmSHA1];
+    steam.algorithm = OTPAlgorithmSteam;
+    steam.digits = 5;
+    
+    NSUUID* uuid = NSUUID.UUID;
+    TotpBatchGenerator* generator = [[TotpBatchGenerator alloc] initWithTokens:@{ uuid : steam }];
+    
+    XCTAssertEqualObjects([generator currentCodeForId:uuid], steam.password);
+}
+
+- (void)testPerformanceOtpToken10k {
+    NSMutableArray<OTPToken*>* tokens = NSMutableArray.array;
+    for ( NSUInteger i = 0; i < kBenchmarkTokenCount; i++ ) {
+        [tokens addObject:[self randomToken]];
+    }
+    
+    [self measureBlock:^{
+        for ( OTPToken* token in tokens ) {
+            [token password];
+        }
+    }];
+}
+
+- (void)testPerformanceBatch10k {
+    NSMutableDictionary<NSUUID*, OTPToken*>* tokens = NSMutableDictionary.dictionary;
+    for ( NSUInteger i = 0; i < kBenchmarkTokenCount; i++ ) {
+        tokens[NSUUID.UUID] = [self randomToken];
+    }
+    
+    TotpBatchGenerator* generator = [[TotpBatchGenerator alloc] initWithTokens:tokens];
+    __block NSTimeInterval time = 1111111109;
+    
+    [self measureBlock:^{
+        time += 60;
+        [generator codesAtDate:[NSDate dateWithTimeIntervalSince1970:time]];
+    }];
+}
+
+@end
@@ -0,0 +1,459 @@
+//
+//  VariantDictionaryTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "VariantDictionary.h"
+#import "KdbxSerializationCommon.h"
+#import "Utils.h"
+
+static const NSUInteger kFuzzIterations = 50000;
+
+// The previous NSData based implementation. Parsing has bounds checks added so it can be run against malformed input and,
+// like the new parser, rejects fixed size values of the wrong length and string values that are not UTF-8. Writing is
+// unchanged, so lengths are UTF-16 counts and only agree with the new writer for ASCII keys and strings.
+@interface LegacyVariantDictionary : NSObject
+
++ (NSDictionary<NSString*, VariantObject*>*)fromData:(NSData*)data;
++ (NSData*)toData:(NSDictionary<NSString*, VariantObject*>*)dictionary;
+
+@end
+
+@implementation LegacyVariantDictionary
+
++ (NSData *)toData:(NSDictionary<NSString *,VariantObject *> *)dictionary {
+    NSMutableData *ret = [NSMutableData data];
+    
+    uint8_t version[] = { 0x00, 0x01 };
+    [ret appendBytes:version length:2];
+    
+    NSArray* sortedKeys = [dictionary.allKeys sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(id  _Nonnull obj1, id  _Nonnull obj2) {
+        return [obj1 compare:obj2];
+    }];
+    
+    for (NSString* key in sortedKeys) {
+        VariantObject* value = dictionary[key];
+        
+        uint8_t type[] = { value.type };
+        [ret appendBytes:type length:1];
+        [ret appendData:Uint32ToLittleEndianData((uint32_t)key.length)];
+        [ret appendData:[key dataUsingEncoding:NSUTF8StringEncoding]];
+        
+        uint32_t valueLength = value.type == kVariantTypeString ? (uint32_t)((NSString*)value.theObject).length : (uint32_t)legacyValueAsData(value).length;
+        [ret appendData:Uint32ToLittleEndianData(valueLength)];
+        [ret appendData:legacyValueAsData(value)];
+    }
+    
+    uint8_t terminator[] = {0x00};
+    [ret appendBytes:terminator length:1];
+    return ret;
+}
+
++ (NSDictionary<NSString*, VariantObject*>*)fromData:(NSData*)data {
+    NSMutableDictionary<NSString*, VariantObject*> *ret = [NSMutableDictionary dictionary];
+    
+    const uint8_t *bytes = data.bytes;
+    size_t length = data.length;
+    
+    if ( length < 3 || bytes[1] != 1 ) {
+        return nil;
+    }
+    
+    size_t offset = 2;
+    
+    while ( bytes[offset] != 0 ) {
+        if ( length - offset < 5 ) {
+            return nil;
+        }
+        
+        uint8_t type = bytes[offset];
+        size_t keyLength = littleEndian4BytesToUInt32((uint8_t*)bytes + offset + 1);
+        offset += 5;
+        
+        if ( length - offset < keyLength + 4 ) {
+            return nil;
+        }
+        
+        NSString* key = [[NSString alloc] initWithBytes:bytes + offset length:keyLength encoding:NSUTF8StringEncoding];
+        offset += keyLength;
+        
+        size_t valueLength = littleEndian4BytesToUInt32((uint8_t*)bytes + offset);
+        offset += 4;
+        
+        if ( !key || length - offset < valueLength ) {
+            return nil;
+        }
+        
+        NSObject* theObj = legacyGetObject(type, bytes + offset, valueLength);
+        if ( !theObj ) {
+            return nil;
+        }
+        
+        ret[key] = [[VariantObject alloc] initWithType:type theObject:theObj];
+        offset += valueLength;
+        
+        if ( offset >= length ) {
+            return nil;
+        }
+    }
+    
+    return ret;
+}
+
+static NSData* legacyValueAsData(VariantObject* value) {
+    switch (value.type) {
+        case kVariantTypeUint32:
+            return Uint32ToLittleEndianData(((NSNumber*)value.theObject).unsignedIntValue);
+        case kVariantTypeUint64:
+            return Uint64ToLittleEndianData(((NSNumber*)value.theObject).unsignedLongLongValue);
+        case kVariantTypeInt32:
+            return Int32ToLittleEndianData(((NSNumber*)value.theObject).intValue);
+        case kVariantTypeInt64:
+            return Int64ToLittleEndianData(((NSNumber*)value.theObject).longLongValue);
+        case kVariantTypeBool: {
+            uint8_t boolBytes[] = { ((NSNumber*)value.theObject).boolValue };
+            return [NSData dataWithBytes:boolBytes length:1];
+        }
+        case kVariantTypeString:
+            return [((NSString*)value.theObject) dataUsingEncoding:NSUTF8StringEncoding];
+        case kVariantTypeByteArray:
+            return ((NSData*)value.theObject);
+        default:
+            return [NSData data];
+    }
+}
+
+static NSObject* legacyGetObject(uint8_t type, const uint8_t* data, size_t length) {
+    switch (type) {
+        case kVariantTypeUint32:
+            return length == 4 ? @(littleEndian4BytesToUInt32((uint8_t*)data)) : nil;
+        case kVariantTypeUint64:
+            return length == 8 ? @(littleEndian8BytesToUInt64((uint8_t*)data)) : nil;
+        case kVariantTypeInt32:
+            return length == 4 ? @((int32_t)littleEndian4BytesToUInt32((uint8_t*)data)) : nil;
+        case kVariantTypeInt64:
+            return length == 8 ? @((int64_t)littleEndian8BytesToUInt64((uint8_t*)data)) : nil;
+        case kVariantTypeBool:
+            return length == 1 ? @(data[0] == 1) : nil;
+        case kVariantTypeString:
+            return [[NSString alloc] initWithBytes:data length:length encoding:NSUTF8StringEncoding];
+        default:
+            return [NSData dataWithBytes:data length:length];
+    }
+}
+
+@end
+
+@interface VariantDictionaryTests : XCTestCase
+
+@end
+
+@implementation VariantDictionaryTests
+
+- (NSDictionary<NSString*, VariantObject*>*)argon2Parameters {
+    uuid_t uuid = { 0x9e, 0x29, 0x8b, 0x19, 0x56, 0xdb, 0x47, 0x73, 0xb2, 0x3d, 0xfc, 0x3e, 0xc6, 0xf0, 0xa1, 0xe6 };
+    
+    return @{ @"$UUID" : [[VariantObject alloc] initWithType:kVariantTypeByteArray theObject:[NSData dataWithBytes:uuid length:sizeof(uuid_t)]],
+              @"S" : [[VariantObject alloc] initWithType:kVariantTypeByteArray theObject:[self randomData:32]],
+              @"P" : [[VariantObject alloc] initWithType:kVariantTypeUint32 theObject:@(2)],
+              @"M" : [[VariantObject alloc] initWithType:kVariantTypeUint64 theObject:@(64 * 1024 * 1024)],
+              @"I" : [[VariantObject alloc] initWithType:kVariantTypeUint64 theObject:@(10)],
+              @"V" : [[VariantObject alloc] initWithType:kVariantTypeUint32 theObject:@(0x13)] };
+}
+
+- (NSData*)randomData:(NSUInteger)length {
+    NSMutableData* ret = [NSMutableData dataWithLength:length];
+    arc4random_buf(ret.mutableBytes, length);
+    return ret;
+}
+
+- (void)assertDictionary:(NSDictionary<NSString*, VariantObject*>*)actual equals:(NSDictionary<NSString*, VariantObject*>*)expected message:(NSString*)message {
+    if ( expected == nil ) {
+        XCTAssertNil(actual, @"%@", message);
+        return;
+    }
+    
+    XCTAssertNotNil(actual, @"%@", message);
+    XCTAssertEqualObjects([NSSet setWithArray:actual.allKeys], [NSSet setWithArray:expected.allKeys], @"%@", message);
+    
+    for ( NSString* key in expected ) {
+        XCTAssertEqual(actual[key].type, expected[key].type, @"%@ %@", message, key);
+        XCTAssertEqualObjects(actual[key].theObject, expected[key].theObject, @"%@ %@", message, key);
+    }
+}
+
+- (BOOL)isAscii:(NSDictionary<NSString*, VariantObject*>*)dictionary {
+    for ( NSString* key in dictionary ) {
+        if ( ![key canBeConvertedToEncoding:NSASCIIStringEncoding] ) {
+            return NO;
+        }
+        
+        if ( dictionary[key].type == kVariantTypeString && ![(NSString*)dictionary[key].theObject canBeConvertedToEncoding:NSASCIIStringEncoding] ) {
+            return NO;
+        }
+    }
+    
+    return YES;
+}
+
+- (NSData*)fuzzInput {
+    static const uint8_t types[] = { kVariantTypeUint32, kVariantTypeUint64, kVariantTypeInt32, kVariantTypeInt64, kVariantTypeBool, kVariantTypeString, kVariantTypeByteArray, 0x7F };
+    static const char keyChars[] = "RSPIMV$UUID";
+    static const uint32_t interestingLengths[] = { 0, 1, 3, 4, 8, 0x7FFFFFFF, 0xFFFFFFFF };
+    
+    NSMutableData* data = [NSMutableData dataWithBytes:(uint8_t[]){ 0x00, 0x01 } length:2];
+    
+    uint32_t entries = arc4random_uniform(7);
+    for ( uint32_t i = 0; i < entries; i++ ) {
+        uint8_t type = types[arc4random_uniform(sizeof(types))];
+        
+        NSMutableData* key = [NSMutableData data];
+        uint32_t keyLength = arc4random_uniform(6);
+        for ( uint32_t j = 0; j < keyLength; j++ ) {
+            [key appendBytes:&keyChars[arc4random_uniform(sizeof(keyChars) - 1)] length:1];
+        }
+        
+        uint32_t valueLength;
+        switch (type) {
+            case kVariantTypeUint32:
+            case kVariantTypeInt32:
+                valueLength = 4;
+                break;
+            case kVariantTypeUint64:
+            case kVariantTypeInt64:
+                valueLength = 8;
+                break;
+            case kVariantTypeBool:
+                valueLength = 1;
+                break;
+            default:
+                valueLength = arc4random_uniform(40);
+                break;
+        }
+        
+        [data appendBytes:&type length:1];
+        [data appendData:Uint32ToLittleEndianData(keyLength)];
+        [data appendData:key];
+        [data appendData:Uint32ToLittleEndianData(valueLength)];
+        [data appendData:[self randomData:valueLength]];
+    }
+    
+    [data appendBytes:(uint8_t[]){ 0x00 } length:1];
+    
+    uint32_t mutations = arc4random_uniform(5);
+    for ( uint32_t i = 0; i < mutations && data.length; i++ ) {
+        uint8_t* bytes = data.mutableBytes;
+        
+        switch ( arc4random_uniform(4) ) {
+            case 0:
+                bytes[arc4random_uniform((uint32_t)data.length)] = arc4random_uniform(256);
+                break;
+            case 1:
+                data.length = arc4random_uniform((uint32_t)data.length);
+                break;
+            case 2:
+                if ( data.length >= 4 ) {
+                    uint32_t length = interestingLengths[arc4random_uniform(sizeof(interestingLengths) / sizeof(interestingLengths[0]))];
+                    [data replaceBytesInRange:NSMakeRange(arc4random_uniform((uint32_t)data.length - 3), 4) withBytes:Uint32ToLittleEndianData(length).bytes];
+                }
+                break;
+            default: {
+                uint8_t byte = arc4random_uniform(256);
+                [data replaceBytesInRange:NSMakeRange(arc4random_uniform((uint32_t)data.length + 1), 0) withBytes:&byte length:1];
+                break;
+            }
+        }
+    }
+    
+    return data;
+}
+
+- (void)testWriterMatchesLegacyBytes {
+    NSDictionary<NSString*, VariantObject*>* parameters = self.argon2Parameters.mutableCopy;
+    
+    NSMutableDictionary* all = parameters.mutableCopy;
+    all[@"i32"] = [[VariantObject alloc] initWithType:kVariantTypeInt32 theObject:@(-5)];
+    all[@"i64"] = [[VariantObject alloc] initWithType:kVariantTypeInt64 theObject:@(-1234567890123LL)];
+    all[@"b"] = [[VariantObject alloc] initWithType:kVariantTypeBool theObject:@(YES)];
+    all[@"s"] = [[VariantObject alloc] initWithType:kVariantTypeString theObject:@"hello"];
+    all[@"empty"] = [[VariantObject alloc] initWithType:kVariantTypeByteArray theObject:[NSData data]];
+    
+    for ( NSDictionary* dictionary in @[@{}, parameters, all] ) {
+        NSData* expected = [LegacyVariantDictionary toData:dictionary];
+        NSData* actual = [VariantDictionary toData:dictionary];
+        
+        XCTAssertEqualObjects(actual, expected);
+        [self assertDictionary:[VariantDictionary fromData:actual] equals:dictionary message:@"round trip"];
+    }
+}
+
+- (void)testNonAsciiKeysAndStringsRoundTrip {
+    NSDictionary* dictionary = @{ @"clé" : [[VariantObject alloc] initWithType:kVariantTypeString theObject:@"naïve ✓"] };
+    
+    NSData* data = [VariantDictionary toData:dictionary];
+    
+    XCTAssertEqual(data.length, 2 + (5 + 4) + (4 + 9) + 1);
+    [self assertDictionary:[VariantDictionary fromData:data] equals:dictionary message:@"non ascii"];
+}
+
+- (void)testViewAccessors {
+    NSMutableDictionary* dictionary = self.argon2Parameters.mutableCopy;
+    dictionary[@"i64"] = [[VariantObject alloc] initWithType:kVariantTypeInt64 theObject:@(-7)];
+    dictionary[@"b"] = [[VariantObject alloc] initWithType:kVariantTypeBool theObject:@(YES)];
+    
+    NSData* data = [VariantDictionary toData:dictionary];
+    
+    VariantDictionaryView view;
+    XCTAssertTrue(variantDictionaryViewInit(&view, data.bytes, data.length));
+    
+    uint64_t memory = 0;
+    XCTAssertTrue(variantDictionaryViewGetUInt64(&view, "M", &memory));
+    XCTAssertEqual(memory, 64 * 1024 * 1024);
+    
+    uint32_t parallelism = 0;
+    XCTAssertTrue(variantDictionaryViewGetUInt32(&view, "P", &parallelism));
+    XCTAssertEqual(parallelism, 2);
+    
+    int64_t i64 = 0;
+    XCTAssertTrue(variantDictionaryViewGetInt64(&view, "i64", &i64));
+    XCTAssertEqual(i64, -7);
+    
+    BOOL b = NO;
+    XCTAssertTrue(variantDictionaryViewGetBool(&view, "b", &b));
+    XCTAssertTrue(b);
+    
+    const uint8_t* salt = NULL;
+    uint32_t saltLength = 0;
+    XCTAssertTrue(variantDictionaryViewGetBytes(&view, "S", &salt, &saltLength));
+    XCTAssertEqualObjects([NSData dataWithBytes:salt length:saltLength], dictionary[@"S"].theObject);
+    XCTAssertTrue(salt >= (const uint8_t*)data.bytes && salt + saltLength <= (const uint8_t*)data.bytes + data.length);
+    
+    XCTAssertFalse(variantDictionaryViewGetUInt32(&view, "M", &parallelism));
+    XCTAssertFalse(variantDictionaryViewGetUInt64(&view, "Missing", &memory));
+    
+    NSUInteger count = 0;
+    size_t offset = 0;
+    VariantDictionaryEntry entry;
+    while ( variantDictionaryViewNextEntry(&view, &offset, &entry) ) {
+        count++;
+    }
+    XCTAssertEqual(count, dictionary.count);
+}
+
+- (void)testDuplicateKeysLastWins {
+    NSMutableData* data = [NSMutableData dataWithBytes:(uint8_t[]){ 0x00, 0x01 } length:2];
+    
+    for ( uint32_t i = 1; i <= 2; i++ ) {
+        [data appendBytes:(uint8_t[]){ kVariantTypeUint32, 0x01, 0x00, 0x00, 0x00, 'P', 0x04, 0x00, 0x00, 0x00 } length:10];
+        [data appendData:Uint32ToLittleEndianData(i)];
+    }
+    [data appendBytes:(uint8_t[]){ 0x00 } length:1];
+    
+    VariantDictionaryView view;
+    XCTAssertTrue(variantDictionaryViewInit(&view, data.bytes, data.length));
+    
+    uint32_t value = 0;
+    XCTAssertTrue(variantDictionaryViewGetUInt32(&view, "P", &value));
+    XCTAssertEqual(value, 2);
+    XCTAssertEqualObjects([VariantDictionary fromData:data][@"P"].theObject, @(2));
+}
+
+- (void)testMalformedInputs {
+    NSArray<NSData*>* inputs = @[[NSData data],
+                                 [NSData dataWithBytes:(uint8_t[]){ 0x00 } length:1],
+                                 [NSData dataWithBytes:(uint8_t[]){ 0x00, 0x01 } length:2],
+                                 [NSData dataWithBytes:(uint8_t[]){ 0x00, 0x02, 0x00 } length:3],
+                                 [NSData dataWithBytes:(uint8_t[]){ 0x00, 0x01, kVariantTypeUint32, 0x01 } length:4],
+                                 [NSData dataWithBytes:(uint8_t[]){ 0x00, 0x01, kVariantTypeUint32, 0xFF, 0xFF, 0xFF, 0xFF, 'P' } length:8],
+                                 [NSData dataWithBytes:(uint8_t[]){ 0x00, 0x01, kVariantTypeUint32, 0x01, 0x00, 0x00, 0x00, 'P', 0x01, 0x00, 0x00, 0x00, 0x07, 0x00 } length:14],
+                                 [NSData dataWithBytes:(uint8_t[]){ 0x00, 0x01, kVariantTypeBool, 0x01, 0x00, 0x00, 0x00, 'B', 0x00, 0x00, 0x00, 0x00, 0x00 } length:13],
+                                 [NSData dataWithBytes:(uint8_t[]){ 0x00, 0x01, kVariantTypeByteArray, 0x01, 0x00, 0x00, 0x00, 'S', 0xFF, 0xFF, 0xFF, 0xFF, 0x00 } length:13],
+                                 [NSData dataWithBytes:(uint8_t[]){ 0x00, 0x01, kVariantTypeByteArray, 0x01, 0x00, 0x00, 0x00, 'S', 0x01, 0x00, 0x00, 0x00, 0xAA } length:13],
+                                 [NSData dataWithBytes:(uint8_t[]){ 0x00, 0x01, kVariantTypeString, 0x01, 0x00, 0x00, 0x00, 'S', 0x01, 0x00, 0x00, 0x00, 0xFF, 0x00 } length:14]];
+    
+    for ( NSData* input in inputs ) {
+        XCTAssertNil([VariantDictionary fromData:input], @"%@", input);
+        XCTAssertNil([LegacyVariantDictionary fromData:input], @"%@", input);
+        
+        VariantDictionaryView view;
+        XCTAssertFalse(variantDictionaryViewInit(&view, input.bytes, input.length), @"%@", input);
+    }
+}
+
+- (void)testKdfParametersHeaderEntryRequiresUuid {
+    NSDictionary<NSString*, VariantObject*>* parameters = [self argon2Parameters];
+    
+    NSDictionary* parsed = (NSDictionary*)getHeaderEntryObject(KDFPARAMETERS, [VariantDictionary toData:parameters]);
+    [self assertDictionary:parsed equals:parameters message:@"Valid"];
+    
+    NSMutableDictionary<NSString*, VariantObject*>* shortUuid = parameters.mutableCopy;
+    shortUuid[@"$UUID"] = [[VariantObject alloc] initWithType:kVariantTypeByteArray theObject:[self randomData:8]];
+    XCTAssertNil(getHeaderEntryObject(KDFPARAMETERS, [VariantDictionary toData:shortUuid]));
+    
+    NSMutableDictionary<NSString*, VariantObject*>* stringUuid = parameters.mutableCopy;
+    stringUuid[@"$UUID"] = [[VariantObject alloc] initWithType:kVariantTypeString theObject:@"9e298b1956db4773b23dfc3ec6f0a1e6"];
+    XCTAssertNil(getHeaderEntryObject(KDFPARAMETERS, [VariantDictionary toData:stringUuid]));
+    
+    NSMutableDictionary<NSString*, VariantObject*>* noUuid = parameters.mutableCopy;
+    [noUuid removeObjectForKey:@"$UUID"];
+    XCTAssertNil(getHeaderEntryObject(KDFPARAMETERS, [VariantDictionary toData:noUuid]));
+}
+
+- (void)testFuzzAgainstLegacy {
+    NSUInteger accepted = 0;
+    
+    for ( NSUInteger i = 0; i < kFuzzIterations; i++ ) {
+        NSData* input = [self fuzzInput];
+        
+        NSDictionary* expected = [LegacyVariantDictionary fromData:input];
+        NSDictionary* actual = [VariantDictionary fromData:input];
+        
+        [self assertDictionary:actual equals:expected message:input.description];
+        
+        if ( !expected ) {
+            continue;
+        }
+        
+        accepted++;
+        
+        VariantDictionaryView view;
+        XCTAssertTrue(variantDictionaryViewInit(&view, input.bytes, input.length), @"%@", input);
+        
+        if ( [self isAscii:expected] ) {
+            NSData* rewritten = [VariantDictionary toData:actual];
+            XCTAssertEqualObjects(rewritten, [LegacyVariantDictionary toData:expected], @"%@", input);
+        }
+    }
+    
+    XCTAssertGreaterThan(accepted, kFuzzIterations / 10);
+}
+
+- (void)testPerformanceParseAndWrite {
+    NSData* data = [VariantDictionary toData:self.argon2Parameters];
+    
+    [self measureBlock:^{
+        for ( int i = 0; i < 100000; i++ ) {
+            [VariantDictionary toData:[VariantDictionary fromData:data]];
+        }
+    }];
+}
+
+- (void)testPerformanceViewAccessors {
+    NSData* data = [VariantDictionary toData:self.argon2Parameters];
+    
+    [self measureBlock:^{
+        for ( int i = 0; i < 100000; i++ ) {
+            VariantDictionaryView view;
+            uint64_t memory;
+            
+            variantDictionaryViewInit(&view, data.bytes, data.length);
+            variantDictionaryViewGetUInt64(&view, "M", &memory);
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,31 @@
+//
+//  WorkingCopyDigestTests.m
+//  StrongboxTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "WorkingCopyManager.h"
+#import "NSData+Extensions.h"
+
+@interface WorkingCopyDigestTests : XCTestCase
+
+@end
+
+@implementation WorkingCopyDigestTests
+
+- (void)testStreamingFileDigestMatches {
+    NSMutableData* data = [NSMutableData dataWithLength:3 * 1024 * 1024 + 17];
+    arc4random_buf(data.mutableBytes, data.length);
+
+    NSString* path = [NSTemporaryDirectory() stringByAppendingPathComponent:NSUUID.UUID.UUIDString];
+    [data writeToFile:path atomically:YES];
+
+    XCTAssertEqualObjects([WorkingCopyManager sha256OfFile:[NSURL fileURLWithPath:path]], data.sha256);
+
+    [NSFileManager.defaultManager removeItemAtPath:path error:nil];
+}
+
+@end
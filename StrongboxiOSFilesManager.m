@@ -75,6 +75,15 @@ static NSString* const kEncryptionStreamDirectoryName = @"_enc_stream";
     return ret;
 }
 
+- (NSURL *)syncManagerUnlockSnapshotsDirectory {
+    NSURL* url = self.sharedAppGroupDirectory;
+    NSURL* ret = [url URLByAppendingPathComponent:@"sync-manager/snapshots"];
+    
+    [self createIfNecessary:ret];
+    
+    return ret;
+}
+
 - (NSURL *)keyFilesDirectory {
     NSURL* url = self.sharedAppGroupDirectory;
     NSURL* ret = [url URLByAppendingPathComponent:@"key-files"];
@@ -195,6 +204,7 @@ static NSString* const kEncryptionStreamDirectoryName = @"_enc_stream";
     
     
     [self setIncludeExcludeFromBackup:self.syncManagerLocalWorkingCachesDirectory include:NO];
+    [self setIncludeExcludeFromBackup:self.syncManagerUnlockSnapshotsDirectory include:NO];
     
     
     
@@ -255,6 +265,7 @@ static NSString* const kEncryptionStreamDirectoryName = @"_enc_stream";
     [self deleteAllInDirectory:self.backupFilesDirectory];
     [self deleteAllInDirectory:self.preferencesDirectory];
     [self deleteAllInDirectory:self.syncManagerLocalWorkingCachesDirectory];
+    [self deleteAllInDirectory:self.syncManagerUnlockSnapshotsDirectory];
     [self deleteAllInDirectory:self.sharedAppGroupDirectory recursive:NO]; 
 }
 
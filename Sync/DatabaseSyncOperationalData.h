@@ -19,6 +19,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property (readonly) SyncStatus* status;
 @property (readonly) dispatch_queue_t dispatchSerialQueue;
+@property (nullable) NSData* lastSyncRemoteDigest; 
 
 - (void)enqueueSyncRequest:(SyncDatabaseRequest*)request;
 - (SyncDatabaseRequest*_Nullable)dequeueSyncRequest;
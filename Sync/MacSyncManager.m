@@ -8,6 +8,7 @@
 
 #import "MacSyncManager.h"
 #import "WorkingCopyManager.h"
+#import "KeyFileParser.h"
 #import "Utils.h"
 #import "Settings.h"
 #import "MacUrlSchemes.h"
@@ -204,6 +205,7 @@ interactiveVC:(NSViewController *)interactiveVC
 
 - (void)removeDatabaseAndLocalCopies:(MacDatabasePreferences*)database {
     [WorkingCopyManager.sharedInstance deleteLocalWorkingCache:database.uuid];
+    [KeyFileParser clearDigestCache];
 }
 
 @end
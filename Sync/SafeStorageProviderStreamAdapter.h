@@ -0,0 +1,36 @@
+//
+//  SafeStorageProviderStreamAdapter.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "SafeStorageProvider.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^StreamAdapterPullCompletionBlock)(StorageProviderReadResult result, NSData*_Nullable sha256, NSDate*_Nullable dateModified, const NSError *_Nullable error);
+typedef void (^StreamAdapterPushCompletionBlock)(StorageProviderUpdateResult result, NSData*_Nullable sha256, NSDate*_Nullable newRemoteModDate, const NSError *_Nullable error);
+
+@interface SafeStorageProviderStreamAdapter : NSObject
+
++ (void)pullDatabase:(id<SafeStorageProvider>)provider
+            database:(METADATA_PTR)database
+       interactiveVC:(VIEW_CONTROLLER_PTR _Nullable)viewController
+             options:(StorageProviderReadOptions*)options
+         destination:(NSURL*)destination
+          completion:(StreamAdapterPullCompletionBlock)completion;
+
++ (void)pushDatabase:(id<SafeStorageProvider>)provider
+            database:(METADATA_PTR)database
+       interactiveVC:(VIEW_CONTROLLER_PTR _Nullable)viewController
+              source:(NSURL*)source
+          completion:(StreamAdapterPushCompletionBlock)completion;
+
++ (NSData*_Nullable)writeStream:(NSInputStream*)stream toFile:(NSURL*)destination error:(NSError**)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
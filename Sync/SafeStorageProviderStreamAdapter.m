@@ -0,0 +1,134 @@
+//
+//  SafeStorageProviderStreamAdapter.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "SafeStorageProviderStreamAdapter.h"
+#import "HashingInputStream.h"
+#import "StreamUtils.h"
+#import "Utils.h"
+#import "NSData+Extensions.h"
+
+static const NSUInteger kStreamAdapterChunkSize = 64 * 1024;
+
+@implementation SafeStorageProviderStreamAdapter
+
++ (void)pullDatabase:(id<SafeStorageProvider>)provider
+            database:(METADATA_PTR)database
+       interactiveVC:(VIEW_CONTROLLER_PTR)viewController
+             options:(StorageProviderReadOptions *)options
+         destination:(NSURL *)destination
+          completion:(StreamAdapterPullCompletionBlock)completion {
+    if ( [provider respondsToSelector:@selector(pullDatabaseStream:interactiveVC:options:completion:)] ) {
+        [provider pullDatabaseStream:database
+                       interactiveVC:viewController
+                             options:options
+                          completion:^(StorageProviderReadResult result, NSInputStream * _Nullable stream, NSDate * _Nullable dateModified, const NSError * _Nullable error) {
+            [self onPulled:result stream:stream dateModified:dateModified error:error destination:destination completion:completion];
+        }];
+    }
+    else {
+        [provider pullDatabase:database
+                 interactiveVC:viewController
+                       options:options
+                    completion:^(StorageProviderReadResult result, NSData * _Nullable data, NSDate * _Nullable dateModified, const NSError * _Nullable error) {
+            NSInputStream* stream = data ? [NSInputStream inputStreamWithData:data] : nil;
+            [self onPulled:result stream:stream dateModified:dateModified error:error destination:destination completion:completion];
+        }];
+    }
+}
+
++ (void)onPulled:(StorageProviderReadResult)result
+          stream:(NSInputStream*)stream
+    dateModified:(NSDate*)dateModified
+           error:(const NSError*)error
+     destination:(NSURL*)destination
+      completion:(StreamAdapterPullCompletionBlock)completion {
+    if ( result != kReadResultSuccess || stream == nil ) {
+        completion(result, nil, dateModified, error);
+        return;
+    }
+    
+    NSError* writeError;
+    NSData* sha256 = [self writeStream:stream toFile:destination error:&writeError];
+    
+    if ( !sha256 ) {
+        completion(kReadResultError, nil, nil, writeError);
+    }
+    else {
+        completion(kReadResultSuccess, sha256, dateModified, nil);
+    }
+}
+
++ (void)pushDatabase:(id<SafeStorageProvider>)provider
+            database:(METADATA_PTR)database
+       interactiveVC:(VIEW_CONTROLLER_PTR)viewController
+              source:(NSURL *)source
+          completion:(StreamAdapterPushCompletionBlock)completion {
+    if ( [provider respondsToSelector:@selector(pushDatabaseStream:interactiveVC:stream:completion:)] ) {
+        NSInputStream* inner = [NSInputStream inputStreamWithURL:source];
+        HashingInputStream* stream = inner ? [[HashingInputStream alloc] initWithStream:inner] : nil;
+        
+        if ( !stream ) {
+            completion(kUpdateResultError, nil, nil, [Utils createNSError:@"Could not open source file for push." errorCode:-1]);
+            return;
+        }
+        
+        [provider pushDatabaseStream:database
+                       interactiveVC:viewController
+                              stream:stream
+                          completion:^(StorageProviderUpdateResult result, NSDate * _Nullable newRemoteModDate, const NSError * _Nullable error) {
+            completion(result, stream.sha256, newRemoteModDate, error);
+        }];
+    }
+    else {
+        NSError* error;
+        NSData* data = [NSData dataWithContentsOfURL:source options:NSDataReadingMappedIfSafe error:&error];
+        
+        if ( !data ) {
+            completion(kUpdateResultError, nil, nil, error);
+            return;
+        }
+        
+        [provider pushDatabase:database
+                 interactiveVC:viewController
+                          data:data
+                    completion:^(StorageProviderUpdateResult result, NSDate * _Nullable newRemoteModDate, const NSError * _Nullable error) {
+            completion(result, data.sha256, newRemoteModDate, error);
+        }];
+    }
+}
+
++ (NSData *)writeStream:(NSInputStream *)stream toFile:(NSURL *)destination error:(NSError **)error {
+    HashingInputStream* hashing = [[HashingInputStream alloc] initWithStream:stream];
+    NSOutputStream* outputStream = [NSOutputStream outputStreamToFileAtPath:destination.path append:NO];
+    
+    [hashing open];
+    [outputStream open];
+    
+    BOOL success = [StreamUtils pipeFromStream:hashing to:outputStream openAndCloseStreams:NO chunkSize:kStreamAdapterChunkSize];
+    
+    NSError* streamError = hashing.streamError ? hashing.streamError : outputStream.streamError;
+    
+    [outputStream close];
+    [hashing close];
+    
+    if ( !success || streamError || !hashing.sha256 ) {
+        NSLog(@"🔴 SafeStorageProviderStreamAdapter::writeStream - Failed [%@]", streamError);
+        
+        [NSFileManager.defaultManager removeItemAtURL:destination error:nil];
+        
+        if ( error ) {
+            *error = streamError ? streamError : [Utils createNSError:@"Could not write pulled database to disk." errorCode:-1];
+        }
+        
+        return nil;
+    }
+    
+    return hashing.sha256;
+}
+
+@end
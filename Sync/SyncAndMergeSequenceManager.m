@@ -32,6 +32,7 @@
 #import "BackupsManager.h"
 #import "CompositeKeyDeterminer.h"
 #import "CommonDatabasePreferences.h"
+#import "SafeStorageProviderStreamAdapter.h"
 
 #if TARGET_OS_IPHONE
 
@@ -319,12 +320,22 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
     
     [self logAndPublishStatusChange:databaseUuid syncId:syncId state:kSyncOperationStateInProgress message:initialLog];
 
+    NSURL* remoteUrl = [self getMergeWorkingFileUrl:@"remote"];
+    SyncAndMergeCompletionBlock cleanupAndComplete = ^(SyncAndMergeResult result, BOOL localWasChanged, NSError * _Nullable error) {
+        [NSFileManager.defaultManager removeItemAtURL:remoteUrl error:nil];
+        completion(result, localWasChanged, error);
+    };
+    
     id <SafeStorageProvider> provider = [SafeStorageProviderFactory getStorageProviderFromProviderId:database.storageProvider];
-    [provider pullDatabase:database
-             interactiveVC:parameters.interactiveVC
-                   options:opts
-                completion:^(StorageProviderReadResult result, NSData * _Nullable data, NSDate * _Nullable dateModified, const NSError * _Nullable error) {
-        if (result == kReadResultError || (result == kReadResultSuccess && (data == nil || dateModified == nil))) {
+    [SafeStorageProviderStreamAdapter pullDatabase:provider
+                                          database:database
+                                     interactiveVC:parameters.interactiveVC
+                                           options:opts
+                                       destination:remoteUrl
+                                        completion:^(StorageProviderReadResult result, NSData * _Nullable sha256, NSDate * _Nullable dateModified, const NSError * _Nullable error) {
+        SyncAndMergeCompletionBlock completion = cleanupAndComplete;
+        
+        if (result == kReadResultError || (result == kReadResultSuccess && (sha256 == nil || dateModified == nil))) {
             [self logAndPublishStatusChange:databaseUuid syncId:syncId state:kSyncOperationStateError error:error];
             completion(kSyncAndMergeError, NO, (NSError*)error);
         }
@@ -335,7 +346,7 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
         else if (result == kReadResultModifiedIsSameAsLocal) {
             if ( database.outstandingUpdateId != nil ) {
                 [self logMessage:databaseUuid syncId:syncId message:[NSString stringWithFormat:@"Pull Database - Source Mod Date same as Last Time we Checked, no source updates to worry about - Outstanding Update Express Scenario..."]];
-                [self handleOutstandingUpdate:databaseUuid syncId:syncId expressUpdateMode:YES remoteData:nil remoteModified:localModDate parameters:parameters completion:completion];
+                [self handleOutstandingUpdate:databaseUuid syncId:syncId expressUpdateMode:YES remoteUrl:nil remoteDigest:nil remoteModified:localModDate parameters:parameters completion:completion];
             }
             else {
                 [self logMessage:databaseUuid syncId:syncId message:[NSString stringWithFormat:@"Pull Database - Source Mod same as Working Copy Mod"]];
@@ -344,7 +355,7 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
             }
         }
         else if (result == kReadResultSuccess) {
-            [self onPulledRemoteDatabase:databaseUuid syncId:syncId localModDate:localModDate remoteData:data remoteModified:dateModified parameters:parameters completion:completion];
+            [self onPulledRemoteDatabase:databaseUuid syncId:syncId localModDate:localModDate remoteUrl:remoteUrl remoteDigest:sha256 remoteModified:dateModified parameters:parameters completion:completion];
         }
         else { 
             [self logAndPublishStatusChange:databaseUuid syncId:syncId state:kSyncOperationStateError message:@"Unknown status returned by Storage Provider"];
@@ -356,7 +367,8 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
 - (void)onPulledRemoteDatabase:(NSString*)databaseUuid
                         syncId:(NSUUID*)syncId
                   localModDate:(NSDate*)localModDate
-                    remoteData:(NSData*)remoteData
+                     remoteUrl:(NSURL*)remoteUrl
+                  remoteDigest:(NSData*)remoteDigest
                 remoteModified:(NSDate*)remoteModified
                     parameters:(SyncParameters*)parameters
                     completion:(SyncAndMergeCompletionBlock)completion {
@@ -369,30 +381,35 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
     METADATA_PTR database = [self databaseMetadataFromDatabaseId:databaseUuid];
 
     if (!database.outstandingUpdateId || localModDate == nil) {
-        [self logMessage:databaseUuid syncId:syncId message:@"No Updates to Push, syncing working copy from source."];
-        [self setLocalAndComplete:remoteData dateModified:remoteModified database:databaseUuid syncId:syncId localWasChanged:YES takeABackup:YES completion:completion];
+        NSURL* localCopy = [self getExistingWorkingCache:databaseUuid modified:nil];
+        
+        if ( localCopy && [self isSameAsLastSyncRemoteDigest:databaseUuid digest:remoteDigest] ) {
+            [self logMessage:databaseUuid syncId:syncId message:@"No Updates to Push, source content identical to working copy (SHA-256). Updating working copy mod date only."];
+            [self setLocalAndComplete:localCopy remoteDigest:remoteDigest dateModified:remoteModified database:databaseUuid syncId:syncId localWasChanged:NO takeABackup:NO completion:completion];
+        }
+        else {
+            [self logMessage:databaseUuid syncId:syncId message:@"No Updates to Push, syncing working copy from source."];
+            [self setLocalAndComplete:remoteUrl remoteDigest:remoteDigest dateModified:remoteModified database:databaseUuid syncId:syncId localWasChanged:YES takeABackup:YES completion:completion];
+        }
     }
     else {
-        [self handleOutstandingUpdate:databaseUuid syncId:syncId expressUpdateMode:NO remoteData:remoteData remoteModified:remoteModified parameters:parameters completion:completion];
+        [self handleOutstandingUpdate:databaseUuid syncId:syncId expressUpdateMode:NO remoteUrl:remoteUrl remoteDigest:remoteDigest remoteModified:remoteModified parameters:parameters completion:completion];
     }
 }
 
 - (void)handleOutstandingUpdate:(NSString*)databaseUuid
                          syncId:(NSUUID*)syncId
               expressUpdateMode:(BOOL)expressUpdateMode
-                     remoteData:(NSData*)remoteData
+                      remoteUrl:(NSURL*)remoteUrl
+                   remoteDigest:(NSData*)remoteDigest
                  remoteModified:(NSDate*)remoteModified
                      parameters:(SyncParameters*)parameters
                      completion:(SyncAndMergeCompletionBlock)completion {
     NSDate* localModDate;
     NSURL* localCopy = [self getExistingWorkingCache:databaseUuid modified:&localModDate];
-    NSData* localData;
     NSError* error;
-    if (localCopy) {
-        localData = [NSData dataWithContentsOfFile:localCopy.path options:kNilOptions error:&error];
-    }
     
-    if (!localCopy || !localData) {
+    if (!localCopy) {
         [self logMessage:databaseUuid syncId:syncId message:@"Could not read local copy but Update Outstanding..."];
         
         [self logAndPublishStatusChange:databaseUuid
@@ -402,6 +419,19 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
         
         completion(kSyncAndMergeError, NO, error);
     }
+    else if ( [self isSameAsLastSyncRemoteDigest:databaseUuid digest:[WorkingCopyManager sha256OfFile:localCopy]] ) {
+        METADATA_PTR database = [self databaseMetadataFromDatabaseId:databaseUuid];
+        database.outstandingUpdateId = nil;
+        
+        if ( remoteUrl == nil || [self isSameAsLastSyncRemoteDigest:databaseUuid digest:remoteDigest] ) {
+            [self logMessage:databaseUuid syncId:syncId message:@"Outstanding Update but Working Copy content is identical to last sync (SHA-256) and Source unchanged. Nothing to push or merge."];
+            [self setLocalAndComplete:localCopy remoteDigest:[self getOperationData:databaseUuid].lastSyncRemoteDigest dateModified:remoteModified database:databaseUuid syncId:syncId localWasChanged:NO takeABackup:NO completion:completion];
+        }
+        else {
+            [self logMessage:databaseUuid syncId:syncId message:@"Outstanding Update but Working Copy content is identical to last sync (SHA-256). Nothing to merge, syncing working copy from source."];
+            [self setLocalAndComplete:remoteUrl remoteDigest:remoteDigest dateModified:remoteModified database:databaseUuid syncId:syncId localWasChanged:YES takeABackup:YES completion:completion];
+        }
+    }
     else {
         
         
@@ -409,14 +439,15 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
         
         METADATA_PTR database = [self databaseMetadataFromDatabaseId:databaseUuid];
 
-        BOOL noRemoteChange = (database.lastSyncRemoteModDate && [database.lastSyncRemoteModDate isEqualToDateWithinEpsilon:remoteModified]);
+        BOOL noRemoteChange = (database.lastSyncRemoteModDate && [database.lastSyncRemoteModDate isEqualToDateWithinEpsilon:remoteModified]) ||
+                              [self isSameAsLastSyncRemoteDigest:databaseUuid digest:remoteDigest];
         
         if ( forcePush || noRemoteChange || expressUpdateMode ) { 
             [self logMessage:databaseUuid syncId:syncId message:[NSString stringWithFormat:@"Update to Push - [Simple Push because Force=%@, Source Changed=%@, Express Update Mode = %@]", forcePush ? @"YES" : @"NO", noRemoteChange ? @"NO" : @"YES", expressUpdateMode ? @"YES" : @"NO"]];
-            [self setRemoteAndComplete:localData database:databaseUuid syncId:syncId localWasChanged:NO interactiveVC:parameters.interactiveVC completion:completion];
+            [self setRemoteAndComplete:localCopy database:databaseUuid syncId:syncId localWasChanged:NO interactiveVC:parameters.interactiveVC completion:completion];
         }
         else {
-            [self doConflictResolution:databaseUuid syncId:syncId localData:localData localModDate:localModDate remoteData:remoteData remoteModified:remoteModified parameters:parameters completion:completion];
+            [self doConflictResolution:databaseUuid syncId:syncId localUrl:localCopy localModDate:localModDate remoteUrl:remoteUrl remoteDigest:remoteDigest remoteModified:remoteModified parameters:parameters completion:completion];
         }
     }
 }
@@ -426,9 +457,10 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
 
 - (void)doConflictResolution:(NSString*)databaseUuid
                       syncId:(NSUUID*)syncId
-                   localData:(NSData*)localData
+                    localUrl:(NSURL*)localUrl
                 localModDate:(NSDate*)localModDate
-                  remoteData:(NSData*)remoteData
+                   remoteUrl:(NSURL*)remoteUrl
+                remoteDigest:(NSData*)remoteDigest
               remoteModified:(NSDate*)remoteModified
                   parameters:(SyncParameters*)parameters
                   completion:(SyncAndMergeCompletionBlock)completion {
@@ -464,20 +496,21 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
     
 
     if ( strategy == kConflictResolutionStrategyAutoMerge ) {
-        [self conflictResolutionMerge:databaseUuid syncId:syncId parameters:parameters localData:localData remoteData:remoteData compareFirst:NO completion:completion];
+        [self conflictResolutionMerge:databaseUuid syncId:syncId parameters:parameters localUrl:localUrl remoteUrl:remoteUrl compareFirst:NO completion:completion];
     }
     else if (strategy == kConflictResolutionStrategyForcePushLocal) { 
-        [self conflictResolutionForcePushLocal:databaseUuid syncId:syncId localData:localData interactiveVC:parameters.interactiveVC completion:completion];
+        [self conflictResolutionForcePushLocal:databaseUuid syncId:syncId localUrl:localUrl interactiveVC:parameters.interactiveVC completion:completion];
     }
     else if (strategy == kConflictResolutionStrategyForcePullRemote) { 
-        [self conflictResolutionForcePullRemote:databaseUuid syncId:syncId remoteData:remoteData remoteModified:remoteModified interactiveVC:parameters.interactiveVC completion:completion];
+        [self conflictResolutionForcePullRemote:databaseUuid syncId:syncId remoteUrl:remoteUrl remoteDigest:remoteDigest remoteModified:remoteModified interactiveVC:parameters.interactiveVC completion:completion];
     }
     else if (strategy == kConflictResolutionStrategyAsk) {
         [self conflictResolutionAsk:databaseUuid
                              syncId:syncId
-                          localData:localData
+                           localUrl:localUrl
                        localModDate:localModDate
-                         remoteData:remoteData
+                          remoteUrl:remoteUrl
+                       remoteDigest:remoteDigest
                      remoteModified:remoteModified
                          parameters:parameters
                          completion:completion];
@@ -489,9 +522,10 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
 
 - (void)conflictResolutionAsk:(NSString*)databaseUuid
                        syncId:(NSUUID*)syncId
-                    localData:(NSData*)localData
+                     localUrl:(NSURL*)localUrl
                  localModDate:(NSDate*)localModDate
-                   remoteData:(NSData*)remoteData
+                    remoteUrl:(NSURL*)remoteUrl
+                 remoteDigest:(NSData*)remoteDigest
                remoteModified:(NSDate*)remoteModified
                    parameters:(SyncParameters*)parameters
                    completion:(SyncAndMergeCompletionBlock)completion {
@@ -500,9 +534,10 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
     dispatch_async(dispatch_get_main_queue(), ^{
         [self showConflictResolutionWizard:databaseUuid
                                     syncId:syncId
-                                 localData:localData
+                                  localUrl:localUrl
                               localModDate:localModDate
-                                remoteData:remoteData
+                                 remoteUrl:remoteUrl
+                              remoteDigest:remoteDigest
                             remoteModified:remoteModified
                                 parameters:parameters
                                 completion:completion];
@@ -511,9 +546,10 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
 
 - (void)showConflictResolutionWizard:(NSString*)databaseUuid
                               syncId:(NSUUID*)syncId
-                           localData:(NSData*)localData
+                            localUrl:(NSURL*)localUrl
                         localModDate:(NSDate*)localModDate
-                          remoteData:(NSData*)remoteData
+                           remoteUrl:(NSURL*)remoteUrl
+                        remoteDigest:(NSData*)remoteDigest
                       remoteModified:(NSDate*)remoteModified
                           parameters:(SyncParameters*)parameters
                           completion:(SyncAndMergeCompletionBlock)completion {
@@ -536,9 +572,10 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
             [self doConflictResolutionWizardChoice:databaseUuid
                                             syncId:syncId
                                       wizardResult:result
-                                         localData:localData
+                                          localUrl:localUrl
                                       localModDate:localModDate
-                                        remoteData:remoteData
+                                         remoteUrl:remoteUrl
+                                      remoteDigest:remoteDigest
                                     remoteModified:remoteModified
                                         parameters:parameters
                                         completion:completion];
@@ -557,15 +594,16 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
 - (void)doConflictResolutionWizardChoice:(NSString*)databaseUuid
                                   syncId:(NSUUID*)syncId
                             wizardResult:(ConflictResolutionWizardResult)wizardResult
-                               localData:(NSData*)localData
+                                localUrl:(NSURL*)localUrl
                             localModDate:(NSDate*)localModDate
-                              remoteData:(NSData*)remoteData
+                               remoteUrl:(NSURL*)remoteUrl
+                            remoteDigest:(NSData*)remoteDigest
                           remoteModified:(NSDate*)remoteModified
                               parameters:(SyncParameters*)parameters
                               completion:(SyncAndMergeCompletionBlock)completion {
     if (wizardResult == kConflictWizardResultAutoMerge) {
         [self logMessage:databaseUuid syncId:syncId message:@"User chose Auto-Merge"];
-        [self conflictResolutionMerge:databaseUuid syncId:syncId parameters:parameters localData:localData remoteData:remoteData compareFirst:NO completion:completion];
+        [self conflictResolutionMerge:databaseUuid syncId:syncId parameters:parameters localUrl:localUrl remoteUrl:remoteUrl compareFirst:NO completion:completion];
     }
     else if ( wizardResult == kConflictWizardResultAlwaysAutoMerge ) {
         [self logMessage:databaseUuid syncId:syncId message:@"User chose Always Auto-Merge"];
@@ -577,7 +615,7 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
                 METADATA_PTR database = [self databaseMetadataFromDatabaseId:databaseUuid];
                 database.conflictResolutionStrategy = kConflictResolutionStrategyAutoMerge;
                 
-                [self conflictResolutionMerge:databaseUuid syncId:syncId parameters:parameters localData:localData remoteData:remoteData compareFirst:NO completion:completion];
+                [self conflictResolutionMerge:databaseUuid syncId:syncId parameters:parameters localUrl:localUrl remoteUrl:remoteUrl compareFirst:NO completion:completion];
             }
             else {
                 [self conflictResolutionCancel:databaseUuid syncId:syncId completion:completion];
@@ -587,17 +625,17 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
     else if ( wizardResult == kConflictWizardResultCompare ) {
         [self logMessage:databaseUuid syncId:syncId message:@"User chose Compare"];
 
-        [self conflictResolutionMerge:databaseUuid syncId:syncId parameters:parameters localData:localData remoteData:remoteData compareFirst:YES completion:completion];
+        [self conflictResolutionMerge:databaseUuid syncId:syncId parameters:parameters localUrl:localUrl remoteUrl:remoteUrl compareFirst:YES completion:completion];
     }
     else if ( wizardResult == kConflictWizardResultForcePushLocal ) {
         [self logMessage:databaseUuid syncId:syncId message:@"User chose Force Push"];
 
-        [self conflictResolutionForcePushLocal:databaseUuid syncId:syncId localData:localData interactiveVC:parameters.interactiveVC completion:completion];
+        [self conflictResolutionForcePushLocal:databaseUuid syncId:syncId localUrl:localUrl interactiveVC:parameters.interactiveVC completion:completion];
     }
     else if ( wizardResult == kConflictWizardResultForcePullRemote ) {
         [self logMessage:databaseUuid syncId:syncId message:@"User chose Force Pull"];
 
-        [self conflictResolutionForcePullRemote:databaseUuid syncId:syncId remoteData:remoteData remoteModified:remoteModified interactiveVC:parameters.interactiveVC completion:completion];
+        [self conflictResolutionForcePullRemote:databaseUuid syncId:syncId remoteUrl:remoteUrl remoteDigest:remoteDigest remoteModified:remoteModified interactiveVC:parameters.interactiveVC completion:completion];
     }
     else if ( wizardResult == kConflictWizardResultSyncLater ) {
         [self logMessage:databaseUuid syncId:syncId message:@"User chose Sync Later"];
@@ -626,16 +664,17 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
 
 - (void)conflictResolutionForcePushLocal:(NSString*)databaseUuid
                                   syncId:(NSUUID*)syncId
-                               localData:(NSData*)localData
+                                localUrl:(NSURL*)localUrl
                            interactiveVC:(VIEW_CONTROLLER_PTR)interactiveVC
                               completion:(SyncAndMergeCompletionBlock)completion {
     [self logMessage:databaseUuid syncId:syncId message:@"Sync Conflict Resolution: Use Local - Pushing Working Copy and overwriting Source DB."];
-    [self setRemoteAndComplete:localData database:databaseUuid syncId:syncId localWasChanged:NO interactiveVC:interactiveVC completion:completion];
+    [self setRemoteAndComplete:localUrl database:databaseUuid syncId:syncId localWasChanged:NO interactiveVC:interactiveVC completion:completion];
 }
 
 - (void)conflictResolutionForcePullRemote:(NSString*)databaseUuid
                                    syncId:(NSUUID*)syncId
-                               remoteData:(NSData*)remoteData
+                                remoteUrl:(NSURL*)remoteUrl
+                             remoteDigest:(NSData*)remoteDigest
                            remoteModified:(NSDate*)remoteModified
                             interactiveVC:(VIEW_CONTROLLER_PTR)interactiveVC
                                completion:(SyncAndMergeCompletionBlock)completion {
@@ -643,7 +682,7 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
     database.outstandingUpdateId = nil;
     
     [self logMessage:databaseUuid syncId:syncId message:@"Sync Conflict Resolution: Use Theirs/Source DB - Pulling from Source DB and overwriting Working Copy."];
-    [self setLocalAndComplete:remoteData dateModified:remoteModified database:databaseUuid syncId:syncId localWasChanged:YES takeABackup:YES completion:completion];
+    [self setLocalAndComplete:remoteUrl remoteDigest:remoteDigest dateModified:remoteModified database:databaseUuid syncId:syncId localWasChanged:YES takeABackup:YES completion:completion];
 }
 
 - (void)conflictResolutionCancel:(NSString*)databaseUuid
@@ -660,8 +699,8 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
 - (void)conflictResolutionMerge:(NSString*)databaseUuid
                          syncId:(NSUUID*)syncId
                      parameters:(SyncParameters*)parameters
-                      localData:(NSData*)localData
-                     remoteData:(NSData*)remoteData
+                       localUrl:(NSURL*)localUrl
+                      remoteUrl:(NSURL*)remoteUrl
                    compareFirst:(BOOL)compareFirst
                      completion:(SyncAndMergeCompletionBlock)completion {
     NSLog(@"⚠️ Sync - conflictResolutionMerge...");
@@ -696,13 +735,13 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
         return;
     }
     
-    NSUUID* syncMergeId = NSUUID.UUID;
-    NSString* dirPath = StrongboxFilesManager.sharedInstance.syncManagerMergeWorkingDirectory.path;
-    NSString* local = [dirPath stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.local", syncMergeId.UUIDString]];
-    NSString* remote = [dirPath stringByAppendingPathComponent:[NSString stringWithFormat:@"%@.remote", syncMergeId.UUIDString]];
-        
-    BOOL writeOk = [localData writeToFile:local atomically:YES] && [remoteData writeToFile:remote atomically:YES];
+    NSURL* localMergeUrl = [self getMergeWorkingFileUrl:@"local"];
+    
+    NSError* copyError;
+    BOOL writeOk = [NSFileManager.defaultManager copyItemAtURL:localUrl toURL:localMergeUrl error:&copyError];
     if ( !writeOk ) {
+        NSLog(@"🔴 Could not copy working copy for merge: [%@]", copyError);
+        
         NSError* error = [Utils createNSError:NSLocalizedString(@"model_error_could_not_write_local_merge", @"Technical Error - Could not write local copies for comparison/merge.") errorCode:-1];
         [self logAndPublishStatusChange:databaseUuid
                                  syncId:syncId
@@ -713,9 +752,7 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
         return;
     }
         
-    NSURL* localUrl = [NSURL fileURLWithPath:local];
-    NSURL* remoteUrl = [NSURL fileURLWithPath:remote];
-    [self mergeLocalAndRemoteUrls:databaseUuid syncId:syncId localUrl:localUrl remoteUrl:remoteUrl parameters:parameters compareFirst:compareFirst completion:completion];
+    [self mergeLocalAndRemoteUrls:databaseUuid syncId:syncId localUrl:localMergeUrl remoteUrl:remoteUrl parameters:parameters compareFirst:compareFirst completion:completion];
 }
 
 - (void)requestCredentials:(VIEW_CONTROLLER_PTR)vc
@@ -1117,7 +1154,8 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
     }
     
     dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0L), ^{
-        NSOutputStream* outputStream = [NSOutputStream outputStreamToMemory]; 
+        NSURL* mergedUrl = [self getMergeWorkingFileUrl:@"merged"];
+        NSOutputStream* outputStream = [NSOutputStream outputStreamToFileAtPath:mergedUrl.path append:NO];
         [outputStream open];
         
         [Serializator getAsData:merged
@@ -1126,13 +1164,16 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
                      completion:^(BOOL userCancelled, NSString * _Nullable debugXml, NSError * _Nullable error) {
             
             [outputStream close];
-            NSData* mergedData = [outputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey];
 
             dispatch_async(dispatch_get_main_queue(), ^{
                 if ( interactiveVC ) {
                     [self.spinnerUi dismiss];
                 }
                 
+                if (userCancelled || error) {
+                    [NSFileManager.defaultManager removeItemAtURL:mergedUrl error:nil];
+                }
+                
                 if (userCancelled) {
                     [self conflictResolutionCancel:databaseUuid syncId:syncId completion:completion];
                 }
@@ -1146,7 +1187,10 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
                 }
                 else {
                     [self logMessage:databaseUuid syncId:syncId message:@"Encrypted Merge Result... pushing to Source DB and setting local..."];
-                    [self setRemoteAndComplete:mergedData database:databaseUuid syncId:syncId localWasChanged:YES interactiveVC:interactiveVC completion:completion];
+                    [self setRemoteAndComplete:mergedUrl database:databaseUuid syncId:syncId localWasChanged:YES interactiveVC:interactiveVC completion:^(SyncAndMergeResult result, BOOL localWasChanged, NSError * _Nullable error) {
+                        [NSFileManager.defaultManager removeItemAtURL:mergedUrl error:nil];
+                        completion(result, localWasChanged, error);
+                    }];
                 }
             });
         }];
@@ -1155,7 +1199,7 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
 
 
 
-- (void)setRemoteAndComplete:(NSData*)data
+- (void)setRemoteAndComplete:(NSURL*)url
                     database:(NSString*)databaseUuid
                       syncId:(NSUUID*)syncId
              localWasChanged:(BOOL)localWasChanged
@@ -1175,10 +1219,11 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
     }
     
     id <SafeStorageProvider> provider = [SafeStorageProviderFactory getStorageProviderFromProviderId:database.storageProvider];
-    [provider pushDatabase:database
-             interactiveVC:interactiveVC
-                      data:data
-                completion:^(StorageProviderUpdateResult result, NSDate * _Nullable newRemoteModDate, const NSError * _Nullable error) {
+    [SafeStorageProviderStreamAdapter pushDatabase:provider
+                                          database:database
+                                     interactiveVC:interactiveVC
+                                            source:url
+                                        completion:^(StorageProviderUpdateResult result, NSData * _Nullable sha256, NSDate * _Nullable newRemoteModDate, const NSError * _Nullable error) {
         if (result == kUpdateResultError) {
             [self logAndPublishStatusChange:databaseUuid
                                      syncId:syncId
@@ -1207,7 +1252,8 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
             
             
             
-            [self setLocalAndComplete:data
+            [self setLocalAndComplete:url
+                         remoteDigest:sha256
                          dateModified:newRemoteModDate
                              database:databaseUuid
                                syncId:syncId
@@ -1218,7 +1264,8 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
     }];
 }
 
-- (void)setLocalAndComplete:(NSData*)data
+- (void)setLocalAndComplete:(NSURL*)url
+               remoteDigest:(NSData*)remoteDigest
                dateModified:(NSDate*)dateModified
                    database:(NSString*)databaseUuid
                      syncId:(NSUUID*)syncId
@@ -1226,7 +1273,7 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
                 takeABackup:(BOOL)takeABackup
                  completion:(SyncAndMergeCompletionBlock)completion {
     NSError* error;
-    if(![self setWorkingCache:data dateModified:dateModified database:databaseUuid takeABackup:takeABackup error:&error]) {
+    if(![self setWorkingCache:url dateModified:dateModified database:databaseUuid takeABackup:takeABackup error:&error]) {
         [self logMessage:databaseUuid syncId:syncId message:@"Could not sync working copy from source."];
 
         [self logAndPublishStatusChange:databaseUuid
@@ -1249,7 +1296,9 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
 
         METADATA_PTR database = [self databaseMetadataFromDatabaseId:databaseUuid];
         database.lastSyncRemoteModDate = dateModified;
-                
+        
+        [self getOperationData:databaseUuid].lastSyncRemoteDigest = remoteDigest;
+        
         completion(kSyncAndMergeSuccess, localWasChanged, nil);
     }
 }
@@ -1261,7 +1310,7 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
     return [WorkingCopyManager.sharedInstance getLocalWorkingCache:databaseUuid modified:modified];
 }
 
-- (NSURL*)setWorkingCache:(NSData*)data
+- (NSURL*)setWorkingCache:(NSURL*)url
              dateModified:(NSDate*)dateModified
                  database:(NSString*)databaseUuid
               takeABackup:(BOOL)takeABackup
@@ -1283,7 +1332,17 @@ NSString* const kSyncManagerDatabaseSyncStatusChanged = @"syncManagerDatabaseSyn
         }
     }
     
-    return [WorkingCopyManager.sharedInstance setWorkingCacheWithData:data dateModified:dateModified database:databaseUuid error:error];
+    return [WorkingCopyManager.sharedInstance setWorkingCacheWithFile:url.path dateModified:dateModified database:databaseUuid error:error];
+}
+
+- (NSURL*)getMergeWorkingFileUrl:(NSString*)extension {
+    NSURL* dir = StrongboxFilesManager.sharedInstance.syncManagerMergeWorkingDirectory;
+    return [dir URLByAppendingPathComponent:[NSString stringWithFormat:@"%@.%@", NSUUID.UUID.UUIDString, extension]];
+}
+
+- (BOOL)isSameAsLastSyncRemoteDigest:(NSString*)databaseUuid digest:(NSData*)digest {
+    NSData* lastSyncRemoteDigest = [self getOperationData:databaseUuid].lastSyncRemoteDigest;
+    return digest != nil && lastSyncRemoteDigest != nil && [digest isEqualToData:lastSyncRemoteDigest];
 }
 
 - (void)publishSyncStatusChangeNotification:(SyncStatus*)info {
@@ -25,6 +25,7 @@
 #import "AppPreferences.h"
 #import "Serializator.h"
 #import "WorkingCopyManager.h"
+#import "KeyFileParser.h"
 
 @interface SyncManager ()
 
@@ -188,6 +189,7 @@
     }
 
     [WorkingCopyManager.sharedInstance deleteLocalWorkingCache:database.uuid];
+    [KeyFileParser clearDigestCache];
 }
 
 
@@ -24,7 +24,11 @@ NS_ASSUME_NONNULL_BEGIN
 - (NSURL*_Nullable)setWorkingCacheWithData:(NSData*)data dateModified:(NSDate*)dateModified database:(NSString*)databaseUuid error:(NSError**)error;
 - (NSURL*_Nullable)setWorkingCacheWithFile:(NSString*)file dateModified:(NSDate*)dateModified database:(NSString*)databaseUuid error:(NSError**)error;
 
++ (NSData*_Nullable)sha256OfFile:(NSURL*)url;
+
 - (NSURL*)getLocalWorkingCacheUrlForDatabase:(NSString*)databaseUuid;
+- (NSURL*)getUnlockSnapshotUrlForDatabase:(NSString*)databaseUuid;
+- (void)deleteUnlockSnapshot:(NSString*)databaseUuid;
 
 - (void)deleteLocalWorkingCache:(NSString*)databaseUuid;
 
@@ -8,6 +8,7 @@
 
 #import "WorkingCopyManager.h"
 #import "Utils.h"
+#import "HashingInputStream.h"
 
 #if TARGET_OS_IPHONE
 #import "StrongboxiOSFilesManager.h"
@@ -15,6 +16,8 @@
 #import "StrongboxMacFilesManager.h"
 #endif
 
+static const NSUInteger kDigestChunkSize = 64 * 1024;
+
 @implementation WorkingCopyManager
 
 + (instancetype)sharedInstance {
@@ -62,7 +65,17 @@
     if ( file ) {
         NSURL* fileUrl = [NSURL fileURLWithPath:file];
     
-        BOOL success = [NSFileManager.defaultManager replaceItemAtURL:localWorkingCacheUrl withItemAtURL:fileUrl backupItemName:nil options:kNilOptions resultingItemURL:nil error:error];
+        BOOL success;
+        if ( [fileUrl.URLByStandardizingPath isEqual:localWorkingCacheUrl.URLByStandardizingPath] ) {
+            success = YES; 
+        }
+        else if ( ![NSFileManager.defaultManager fileExistsAtPath:localWorkingCacheUrl.path] ) {
+            success = [NSFileManager.defaultManager moveItemAtURL:fileUrl toURL:localWorkingCacheUrl error:error];
+        }
+        else {
+            success = [NSFileManager.defaultManager replaceItemAtURL:localWorkingCacheUrl withItemAtURL:fileUrl backupItemName:nil options:kNilOptions resultingItemURL:nil error:error];
+        }
+        
         if ( !success ) {
             NSLog(@"SyncManager::replaceItemAtURL - failed with %@", error ? *error : nil);
             return nil;
@@ -104,6 +117,21 @@
             NSLog(@"Error delete local working cache: [%@]", error);
         }
     }
+    
+    [self deleteUnlockSnapshot:databaseUuid];
+}
+
+- (void)deleteUnlockSnapshot:(NSString *)databaseUuid {
+    NSURL* snapshot = [self getUnlockSnapshotUrlForDatabase:databaseUuid];
+    
+    if ( snapshot && [NSFileManager.defaultManager fileExistsAtPath:snapshot.path] ) {
+        NSError* error;
+        [NSFileManager.defaultManager removeItemAtURL:snapshot error:&error];
+        
+        if (error) {
+            NSLog(@"Error deleting unlock snapshot: [%@]", error);
+        }
+    }
 }
 
 - (BOOL)isLocalWorkingCacheAvailable:(NSString*)databaseUuid modified:(NSDate**)modified {
@@ -119,6 +147,15 @@
     return [StrongboxFilesManager.sharedInstance.syncManagerLocalWorkingCachesDirectory URLByAppendingPathComponent:databaseUuid];
 }
 
+- (NSURL *)getUnlockSnapshotUrlForDatabase:(NSString *)databaseUuid {
+    if ( databaseUuid == nil ) {
+        NSLog(@"🔴 databaseUuid is nil in WorkingCopyManager::getUnlockSnapshotUrlForDatabase?!");
+        return nil;
+    }
+    
+    return [StrongboxFilesManager.sharedInstance.syncManagerUnlockSnapshotsDirectory URLByAppendingPathComponent:databaseUuid];
+}
+
 - (NSURL*)getLocalWorkingCache:(NSString*)databaseUuid {
     return [self getLocalWorkingCache:databaseUuid modified:nil];
 }
@@ -152,4 +189,22 @@
     return url;
 }
 
++ (NSData *)sha256OfFile:(NSURL *)url {
+    NSInputStream* inner = [NSInputStream inputStreamWithURL:url];
+    if ( !inner ) {
+        return nil;
+    }
+    
+    HashingInputStream* stream = [[HashingInputStream alloc] initWithStream:inner];
+    [stream open];
+    
+    uint8_t chunk[kDigestChunkSize];
+    NSInteger read;
+    while ( (read = [stream read:chunk maxLength:kDigestChunkSize]) > 0 ) { }
+    
+    [stream close];
+    
+    return read == 0 ? stream.sha256 : nil;
+}
+
 @end
@@ -41,6 +41,7 @@ class BrowseViewController: NSViewController {
     private var database: ViewModel!
 
     private var sortedItemsCache: [Node]?
+    private var totpCodes: [UUID: String] = [:]
     var unsorted: [Node] = []
 
     override func viewDidLoad() {
@@ -395,6 +396,7 @@ class BrowseViewController: NSViewController {
     }
 
     func refresh(maintainSelectionIfPossible: Bool = true, selectFirstItemIfSelectionNotFound: Bool = false) {
+        totpCodes = [:]
         
 
 
@@ -983,7 +985,9 @@ extension BrowseViewController: NSOutlineViewDelegate {
             let remainingSeconds = otpToken.period - (NSDate().timeIntervalSince1970.truncatingRemainder(dividingBy: otpToken.period))
             let color: NSColor? = (remainingSeconds < 5) ? .systemRed : (remainingSeconds < 9) ? .systemOrange : nil
 
-            return getGenericCell(otpToken.password, node: item, plainTextColor: color)
+            let code = totpCodes[item.uuid] ?? database.database.totpGenerator.currentCode(forId: item.uuid) ?? otpToken.password
+
+            return getGenericCell(code, node: item, plainTextColor: color)
         } else {
             return getGenericCell("", node: item)
         }
@@ -1411,6 +1415,8 @@ extension BrowseViewController: NSOutlineViewDataSource {
         if !tableColumn.isHidden {
             guard let scrollView = outlineView.enclosingScrollView else { return }
 
+            totpCodes = database.database.totpGenerator.codes(at: Date())
+
             let visibleRect = scrollView.contentView.visibleRect
             let rowRange = outlineView.rows(in: visibleRect)
             let totpColumnIndex = outlineView.column(withIdentifier: BrowseViewColumn.totp.identifier)
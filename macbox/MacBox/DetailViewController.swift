@@ -1791,14 +1791,19 @@ extension DetailViewController: NSTableViewDelegate {
                 return nil
             }
 
+            let node = getNode()
+            let uuid = node.flatMap { database.getItemBy($0.uuid) === $0 ? $0.uuid : nil }
+
             cell.setContent(field,
                             popupMenuUpdater: { [weak self] menu, originalField in self?.onPopupMenuNeedsUpdate(menu, originalField) },
-                            onCopyButton: Settings.sharedInstance().showCopyFieldButton ? { [weak self] field in self?.onCopyField(field: field) } : nil)
-            { [weak self] field in
-                if let field {
-                    self?.showLargeTextView(field)
-                }
-            }
+                            onCopyButton: Settings.sharedInstance().showCopyFieldButton ? { [weak self] field in self?.onCopyField(field: field) } : nil,
+                            onQrCodeButton: { [weak self] field in
+                                if let field {
+                                    self?.showLargeTextView(field)
+                                }
+                            },
+                            uuid: uuid,
+                            totpGenerator: database.database.totpGenerator)
 
             return cell
         case .auditIssue:
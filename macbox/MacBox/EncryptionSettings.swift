@@ -42,6 +42,12 @@ class EncryptionSettings: NSViewController, NSMenuDelegate {
     @IBOutlet var buttonSave: NSButton!
     @IBOutlet var buttonDiscardChanges: NSButton!
 
+    lazy var buttonCalibrate: NSButton = {
+        let button = NSButton(title: NSLocalizedString("encryption_settings_calibrate_1_second", comment: "Calibrate"), target: self, action: #selector(onCalibrate(_:)))
+        button.bezelStyle = .rounded
+        return button
+    }()
+
     @objc var model: ViewModel! {
         didSet {
             savedSettings = EncryptionSettingsViewModel.fromDatabaseModel(model.database)
@@ -64,6 +70,8 @@ class EncryptionSettings: NSViewController, NSMenuDelegate {
         stepperParallelism.minValue = 1
         stepperParallelism.maxValue = 32
 
+        (stepperIterations.superview as? NSStackView)?.addArrangedSubview(buttonCalibrate)
+
         bindUI()
     }
 
@@ -238,6 +246,9 @@ class EncryptionSettings: NSViewController, NSMenuDelegate {
         sliderIterations.isEnabled = !model.isEffectivelyReadOnly
         stepperIterations.isEnabled = !model.isEffectivelyReadOnly
         textFieldIterations.isEnabled = !model.isEffectivelyReadOnly
+
+        buttonCalibrate.isHidden = currentSettings.kdfAlgorithm != .sha256
+        buttonCalibrate.isEnabled = !model.isEffectivelyReadOnly
     }
 
     func bindMemory() {
@@ -361,6 +372,12 @@ class EncryptionSettings: NSViewController, NSMenuDelegate {
         bindUI()
     }
 
+    @IBAction func onCalibrate(_: Any) {
+        currentSettings.calibrateFor1Second()
+
+        bindUI()
+    }
+
     @objc func applyCurrentChanges() {
         model.applyEncryptionSettingsViewModelChanges(currentSettings)
 
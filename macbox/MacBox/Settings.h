@@ -158,6 +158,7 @@ extern NSString* const kCustomFieldsColumn;
 
 @property BOOL autoFillWroteCleanly;
 @property BOOL atomicSftpWrite;
+@property BOOL useUnlockSnapshotCache;
 
 @end
 
@@ -121,6 +121,7 @@ static NSString* const kSshAgentRequestDatabaseUnlockAllowed = @"sshAgentRequest
 static NSString* const kSshAgentPreventRapidRepeatedUnlockRequests = @"sshAgentPreventRapidRepeatedUnlockRequests";
 static NSString* const kAutoFillWroteCleanly = @"autoFillWroteCleanly";
 static NSString* const kAtomicSftpWrite = @"atomicSftpWrite";
+static NSString* const kUseUnlockSnapshotCache = @"useUnlockSnapshotCache";
 static NSString* const kStripUnusedHistoricalIcons = @"stripUnusedHistoricalIcons";
 
 
@@ -251,6 +252,14 @@ static NSString* const kDefaultAppGroupName = @"group.strongbox.mac.mcguill";
 - (void)setAtomicSftpWrite:(BOOL)atomicSftpWrite {
     [self setBool:kAtomicSftpWrite value:atomicSftpWrite];
 }
+
+- (BOOL)useUnlockSnapshotCache {
+    return [self getBool:kUseUnlockSnapshotCache];
+}
+
+- (void)setUseUnlockSnapshotCache:(BOOL)useUnlockSnapshotCache {
+    [self setBool:kUseUnlockSnapshotCache value:useUnlockSnapshotCache];
+}
 - (BOOL)autoFillWroteCleanly {
     return [self getBool:kAutoFillWroteCleanly fallback:YES]; 
 }
@@ -30,6 +30,8 @@ class TotpTableCellView: NSTableCellView, DetailTableCellViewPopupButton, NSMenu
 
     override func prepareForReuse() {
         super.prepareForReuse()
+        uuid = nil
+        totpGenerator = nil
         token = nil
     }
 
@@ -38,11 +40,15 @@ class TotpTableCellView: NSTableCellView, DetailTableCellViewPopupButton, NSMenu
     var onQrCodeButton: ((DetailsViewField?) -> Void)?
 
     var field: DetailsViewField?
+    var uuid: UUID?
+    var totpGenerator: TotpBatchGenerator?
 
     func setContent(_ field: DetailsViewField,
                     popupMenuUpdater: ((NSMenu, DetailsViewField) -> Void)? = nil,
                     onCopyButton: ((DetailsViewField?) -> Void)? = nil,
-                    onQrCodeButton: ((DetailsViewField?) -> Void)? = nil)
+                    onQrCodeButton: ((DetailsViewField?) -> Void)? = nil,
+                    uuid: UUID? = nil,
+                    totpGenerator: TotpBatchGenerator? = nil)
     {
         self.field = field
         labelFieldName.stringValue = field.name
@@ -54,6 +60,8 @@ class TotpTableCellView: NSTableCellView, DetailTableCellViewPopupButton, NSMenu
 
         self.onQrCodeButton = onQrCodeButton
 
+        self.uuid = uuid
+        self.totpGenerator = totpGenerator
         token = field.object as? OTPToken
     }
 
@@ -70,7 +78,7 @@ class TotpTableCellView: NSTableCellView, DetailTableCellViewPopupButton, NSMenu
 
             let remainingSeconds = period - (current.truncatingRemainder(dividingBy: period))
 
-            labelTotp.stringValue = totp.password
+            labelTotp.stringValue = uuid.flatMap { totpGenerator?.currentCode(forId: $0) } ?? totp.password
             labelTotp.textColor = (remainingSeconds < 5) ? .systemRed : (remainingSeconds < 9) ? .systemOrange : .controlTextColor
 
             progressTotp.minValue = 0
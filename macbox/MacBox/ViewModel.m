@@ -2289,6 +2289,8 @@ NSString* const kModelUpdateNotificationNextGenSearchContextChanged = @"kModelUp
 }
 
 - (void)cacheKeeAgentPublicKeysOffline {
+    [SSHAgentRequestHandler.shared invalidateIdentitiesWithDatabaseUuid:self.databaseUuid];
+    
     if ( !Settings.sharedInstance.runSshAgent ) {
         
         return;
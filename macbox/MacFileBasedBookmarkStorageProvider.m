@@ -11,6 +11,7 @@
 #import "Utils.h"
 #import "MacUrlSchemes.h"
 #import "NSDate+Extensions.h"
+#import "StreamUtils.h"
 
 @implementation MacFileBasedBookmarkStorageProvider
 
@@ -112,6 +113,110 @@
     }
 }
 
+- (void)pullDatabaseStream:(METADATA_PTR)safeMetaData
+             interactiveVC:(VIEW_CONTROLLER_PTR)viewController
+                   options:(StorageProviderReadOptions *)options
+                completion:(StorageProviderStreamReadCompletionBlock)completion {
+    NSError *error;
+    NSURL* url = [self directFileUrlForDatabase:safeMetaData ppError:&error];
+    
+    if(error || !url) {
+        NSLog(@"Error or nil URL in Files App Provider: %@", error);
+        completion(kReadResultError, nil, nil, error);
+        return;
+    }
+
+    BOOL securitySucceeded = [url startAccessingSecurityScopedResource];
+    if (!securitySucceeded) {
+        NSLog(@"Could not access secure scoped resource! Will try get attributes anyway...");
+    }
+    
+    NSDictionary* attr = [NSFileManager.defaultManager attributesOfItemAtPath:url.path error:&error];
+    NSDate* modDate = attr ? attr.fileModificationDate : nil;
+    if (error) {
+        NSLog(@"Error getting attributes for files based Database, will try open anyway: [%@] - Attributes: [%@]", error, attr);
+    }
+    else {
+        if ( options && options.onlyIfModifiedDifferentFrom && modDate && [modDate isEqualToDateWithinEpsilon:options.onlyIfModifiedDifferentFrom] ) {
+            if ( securitySucceeded ) {
+                [self stopAccessingSecurityScopedResource:url];
+            }
+
+            completion(kReadResultModifiedIsSameAsLocal, nil, nil, nil);
+
+            return;
+        }
+    }
+
+    // Open before relinquishing security scoped access, the descriptor stays valid afterwards.
+    NSInputStream* stream = [NSInputStream inputStreamWithURL:url];
+    [stream open];
+    
+    if ( securitySucceeded ) {
+        [self stopAccessingSecurityScopedResource:url];
+    }
+    
+    if ( stream && stream.streamStatus == NSStreamStatusOpen ) {
+        completion(kReadResultSuccess, stream, modDate, nil);
+    }
+    else {
+        [stream close];
+        completion(kReadResultError, nil, nil, stream.streamError);
+    }
+}
+
+- (void)pushDatabaseStream:(METADATA_PTR)safeMetaData
+             interactiveVC:(VIEW_CONTROLLER_PTR)viewController
+                    stream:(NSInputStream *)stream
+                completion:(StorageProviderUpdateCompletionBlock)completion {
+    NSError *error;
+    NSURL* url = [self directFileUrlForDatabase:safeMetaData ppError:&error];
+    
+    if(error || !url || url.absoluteString.length == 0) {
+        NSLog(@"Error or nil URL in Files App provider: [%@]", error);
+        completion(kUpdateResultError, nil, error ? error : [Utils createNSError:[NSString stringWithFormat:@"Invalid URL in Files App Provider: %@", url] errorCode:-1]);
+        return;
+    }
+    
+    BOOL securitySucceeded = [url startAccessingSecurityScopedResource];
+    if (!securitySucceeded) {
+        NSLog(@"Could not access secure scoped resource! Will try get attributes anyway...");
+    }
+    
+    NSURL* tmpDirectory = [NSFileManager.defaultManager URLForDirectory:NSItemReplacementDirectory inDomain:NSUserDomainMask appropriateForURL:url create:YES error:nil];
+    NSURL* tmp = [(tmpDirectory ? tmpDirectory : url.URLByDeletingLastPathComponent) URLByAppendingPathComponent:[NSString stringWithFormat:@".%@.tmp", NSUUID.UUID.UUIDString]];
+    
+    NSOutputStream* outputStream = [NSOutputStream outputStreamToFileAtPath:tmp.path append:NO];
+    BOOL success = [StreamUtils pipeFromStream:stream to:outputStream] && outputStream.streamError == nil;
+    
+    if ( success ) {
+        success = [NSFileManager.defaultManager replaceItemAtURL:url withItemAtURL:tmp backupItemName:nil options:kNilOptions resultingItemURL:nil error:&error];
+    }
+    else {
+        error = outputStream.streamError ? outputStream.streamError : stream.streamError;
+    }
+    
+    [NSFileManager.defaultManager removeItemAtURL:tmp error:nil];
+    if ( tmpDirectory ) {
+        [NSFileManager.defaultManager removeItemAtURL:tmpDirectory error:nil];
+    }
+    
+    NSDictionary* attr = success ? [NSFileManager.defaultManager attributesOfItemAtPath:url.path error:nil] : nil;
+
+    if ( securitySucceeded ) {
+        [self stopAccessingSecurityScopedResource:url];
+    }
+    
+    if ( success ) {
+        completion(kUpdateResultSuccess, attr ? attr.fileModificationDate : nil, nil);
+    }
+    else {
+        NSLog(@"🔴 Error streaming to file: [%@]", error);
+        NSError *err = [Utils createNSError:NSLocalizedString(@"files_provider_problem_saving", @"Problem Saving to External File") errorCode:-1];
+        completion(kUpdateResultError, nil, err);
+    }
+}
+
 - (void)getModDate:(METADATA_PTR)safeMetaData completion:(StorageProviderGetModDateCompletionBlock)completion {
     NSError *error;
     NSURL* url = [self directFileUrlForDatabase:safeMetaData ppError:&error];
@@ -0,0 +1,120 @@
+//
+//  ApplePasswordManagerQuirksTests.swift
+//  MacUnitTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+@testable import Strongbox
+import XCTest
+
+final class ApplePasswordManagerQuirksTests: XCTestCase {
+    private var shippedGroups: [[String]] = []
+
+    override func setUpWithError() throws {
+        let url = URL(fileURLWithPath: #filePath)
+            .deletingLastPathComponent()
+            .appendingPathComponent("../../model/quirks/websites-with-shared-credential-backends.json")
+            .standardized
+
+        shippedGroups = try JSONDecoder().decode([[String]].self, from: Data(contentsOf: url))
+    }
+
+    func testCompiledTableMatchesShippedJson() {
+        let quirks = ApplePasswordManagerQuirks.shared
+
+        XCTAssertEqual(quirks.groupCount, shippedGroups.count)
+
+        for group in shippedGroups {
+            let expected = Set(group.map { $0.lowercased() })
+
+            for domain in group {
+                XCTAssertEqual(quirks.getEquivalentDomains(domain), expected, domain)
+                XCTAssertEqual(quirks.getEquivalentDomains(domain.uppercased()), expected, domain)
+
+                for other in group {
+                    XCTAssertTrue(quirks.areEquivalent(domain, other), "\(domain) \(other)")
+                }
+            }
+        }
+    }
+
+    func testDomainsInDifferentGroupsAreNotEquivalent() {
+        let quirks = ApplePasswordManagerQuirks.shared
+
+        for (i, group) in shippedGroups.enumerated() {
+            let next = shippedGroups[(i + 1) % shippedGroups.count]
+
+            XCTAssertFalse(quirks.areEquivalent(group[0], next[0]), "\(group[0]) \(next[0])")
+        }
+
+        XCTAssertFalse(quirks.areEquivalent("example.com", "example.com"))
+        XCTAssertTrue(quirks.getEquivalentDomains("example.com").isEmpty)
+    }
+
+    func testAssociatedDomainsExcludeHost() {
+        let group = shippedGroups.first { $0.contains("aa.com") }!
+
+        XCTAssertEqual(BrowserAutoFillManager.getAssociatedDomains(url: "https://aa.com/login"), Set(group).subtracting(["aa.com"]))
+        XCTAssertEqual(BrowserAutoFillManager.getAssociatedDomains(url: "https://www.aa.com/login"), Set(group))
+    }
+
+    func testIndexReturnsNodesAcrossEquivalenceGroup() {
+        let root = Node.rootGroup()
+        let index = BrowserAutoFillDomainIndex()
+
+        var expected: Set<UUID> = []
+        for (i, url) in ["https://www.aa.com", "https://americanairlines.com/login", "https://americanairlines.jp", "https://example.com"].enumerated() {
+            let node = Node(asRecord: "Entry \(i)", parent: root)
+            node.fields.url = url
+            index.add(uuid: node.uuid, primaryUrl: url, urls: [url])
+
+            if i < 3 {
+                expected.insert(node.uuid)
+            }
+        }
+
+        XCTAssertEqual(BrowserAutoFillManager.getMatchingNodes(url: "https://aa.com", index: index, includeEquivalentDomains: true), expected)
+        XCTAssertEqual(BrowserAutoFillManager.getMatchingNodes(url: "https://aa.com", index: index, includeEquivalentDomains: false).count, 1)
+        XCTAssertEqual(BrowserAutoFillManager.getMatchingNodes(url: "https://example.com", index: index, includeEquivalentDomains: true).count, 1)
+    }
+
+    func testIndexIncludesSubdomainMembersOfMixedGroup() {
+        let root = Node.rootGroup()
+        let index = BrowserAutoFillDomainIndex()
+
+        var nodes: [String: UUID] = [:]
+        for url in ["https://www.aetna.com", "https://banneraetna.myplanportal.com/login", "https://sso.banneraetna.myplanportal.com", "https://www.myplanportal.com"] {
+            let node = Node(asRecord: url, parent: root)
+            node.fields.url = url
+            index.add(uuid: node.uuid, primaryUrl: url, urls: [url])
+            nodes[url] = node.uuid
+        }
+
+        let multi = Node(asRecord: "Multiple", parent: root)
+        index.add(uuid: multi.uuid, primaryUrl: "https://www.myplanportal.com", urls: ["https://www.myplanportal.com", "https://banneraetna.myplanportal.com"])
+
+        let expected: Set<UUID> = [nodes["https://www.aetna.com"]!, nodes["https://banneraetna.myplanportal.com/login"]!, nodes["https://sso.banneraetna.myplanportal.com"]!, multi.uuid]
+
+        XCTAssertEqual(BrowserAutoFillManager.getMatchingNodes(url: "https://aetna.com", index: index, includeEquivalentDomains: true), expected)
+        XCTAssertEqual(BrowserAutoFillManager.getMatchingNodes(url: "https://www.myplanportal.com", index: index, includeEquivalentDomains: true).count, 4)
+    }
+
+    func testPerformanceEquivalenceLookups() {
+        let domains = shippedGroups.flatMap { $0 } + (0 ..< 200).map { "unknown\($0).example.com" }
+        let quirks = ApplePasswordManagerQuirks.shared
+
+        measure {
+            var equivalent = 0
+
+            for i in 0 ..< 100_000 {
+                if quirks.areEquivalent(domains[i % domains.count], domains[(i * 7 + 1) % domains.count]) {
+                    equivalent += 1
+                }
+            }
+
+            XCTAssertGreaterThanOrEqual(equivalent, 0)
+        }
+    }
+}
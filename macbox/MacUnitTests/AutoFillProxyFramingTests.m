@@ -0,0 +1,129 @@
+//
+//  AutoFillProxyFramingTests.m
+//  MacUnitTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "AutoFillProxy.h"
+
+#include <sys/socket.h>
+
+static const NSUInteger kLargeResponseLength = 10 * 1024 * 1024;
+
+@interface AutoFillProxyFramingTests : XCTestCase
+
+@property int client;
+@property int server;
+
+@end
+
+@implementation AutoFillProxyFramingTests
+
+- (void)setUp {
+    int fds[2];
+    XCTAssertEqual(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    self.client = fds[0];
+    self.server = fds[1];
+}
+
+- (void)tearDown {
+    close(self.client);
+    close(self.server);
+}
+
+- (NSData*)largeJsonResponse {
+    NSMutableArray* credentials = NSMutableArray.array;
+    NSUInteger approx = 0;
+
+    while ( approx < kLargeResponseLength ) {
+        NSString* uuid = NSUUID.UUID.UUIDString;
+        [credentials addObject:@{ @"uuid" : uuid, @"title" : uuid, @"username" : uuid, @"password" : uuid, @"url" : uuid }];
+        approx += 5 * uuid.length + 64;
+    }
+
+    return [NSJSONSerialization dataWithJSONObject:@{ @"credentials" : credentials } options:kNilOptions error:nil];
+}
+
+- (void)serveResponses:(NSArray<NSData*>*)responses {
+    int server = self.server;
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        for ( NSData* response in responses ) {
+            if ( !readFramedMessage(server) || !writeFramedMessage(server, response) ) {
+                break;
+            }
+        }
+    });
+}
+
+- (void)testTenMegabyteResponseParsedOnce {
+    NSData* response = [self largeJsonResponse];
+    XCTAssertGreaterThanOrEqual(response.length, kLargeResponseLength);
+
+    [self serveResponses:@[response]];
+
+    NSDate* start = NSDate.date;
+
+    XCTAssertTrue(writeFramedMessage(self.client, [@"{}" dataUsingEncoding:NSUTF8StringEncoding]));
+    NSData* received = readFramedMessage(self.client);
+
+    id object = [NSJSONSerialization JSONObjectWithData:received options:kNilOptions error:nil];
+
+    NSLog(@"Received and parsed %lu bytes in %f seconds", (unsigned long)received.length, -start.timeIntervalSinceNow);
+
+    XCTAssertEqualObjects(received, response);
+    XCTAssertNotNil(object);
+}
+
+- (void)testManyMessagesOverOnePersistentConnection {
+    NSMutableArray<NSData*>* responses = NSMutableArray.array;
+    for ( int i = 0; i < 50; i++ ) {
+        [responses addObject:[[NSString stringWithFormat:@"{\"i\":%d}", i] dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+
+    [self serveResponses:responses];
+
+    for ( NSData* expected in responses ) {
+        XCTAssertTrue(writeFramedMessage(self.client, [@"{}" dataUsingEncoding:NSUTF8StringEncoding]));
+        XCTAssertEqualObjects(readFramedMessage(self.client), expected);
+    }
+}
+
+- (void)testEmptyMessage {
+    XCTAssertTrue(writeFramedMessage(self.client, NSData.data));
+    XCTAssertEqualObjects(readFramedMessage(self.server), NSData.data);
+}
+
+- (void)testTruncatedMessageReturnsNil {
+    uint32_t length = OSSwapHostToLittleInt32(100);
+    write(self.client, &length, sizeof(length));
+    write(self.client, "abc", 3);
+    shutdown(self.client, SHUT_WR);
+
+    XCTAssertNil(readFramedMessage(self.server));
+}
+
+- (void)testOversizedLengthRejected {
+    uint32_t length = OSSwapHostToLittleInt32(UINT32_MAX);
+    write(self.client, &length, sizeof(length));
+
+    XCTAssertNil(readFramedMessage(self.server));
+}
+
+- (void)testPerformanceTenMegabyteRoundTrip {
+    NSData* response = [self largeJsonResponse];
+
+    [self measureBlock:^{
+        [self serveResponses:@[response]];
+
+        writeFramedMessage(self.client, [@"{}" dataUsingEncoding:NSUTF8StringEncoding]);
+        NSData* received = readFramedMessage(self.client);
+        [NSJSONSerialization JSONObjectWithData:received options:kNilOptions error:nil];
+    }];
+}
+
+@end
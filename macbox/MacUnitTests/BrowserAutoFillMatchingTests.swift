@@ -0,0 +1,96 @@
+//
+//  BrowserAutoFillMatchingTests.swift
+//  MacUnitTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+@testable import Strongbox
+import XCTest
+
+final class BrowserAutoFillMatchingTests: XCTestCase {
+    private let entryCount = 20000
+    private let matchCount = 200
+
+    private var root: Node!
+    private var entries: [Node] = []
+    private var index: BrowserAutoFillDomainIndex!
+
+    override func setUp() {
+        root = Node.rootGroup()
+
+        entries = (0 ..< entryCount).map { i in
+            let node = Node(asRecord: "Entry \(i)", parent: root)
+
+            if i < matchCount {
+                let subdomains = ["", "www.", "login.", "accounts.eu."]
+                node.fields.url = "https://\(subdomains[i % subdomains.count])example.co.uk/path/\(i)"
+            } else {
+                node.fields.url = "https://site\(i).example\(i % 97).com/login"
+            }
+
+            return node
+        }
+
+        index = BrowserAutoFillDomainIndex()
+        for node in entries {
+            index.add(uuid: node.uuid, primaryUrl: node.fields.url, urls: [node.fields.url])
+        }
+    }
+
+    func testPslDomainLookupMatchesExistingBehaviour() {
+        let matches = BrowserAutoFillManager.getMatchingNodes(url: "https://www.example.co.uk/signin", index: index)
+
+        XCTAssertEqual(matches, Set(entries.prefix(matchCount).map { $0.uuid }))
+    }
+
+    func testUnknownDomainHasNoMatches() {
+        XCTAssertTrue(BrowserAutoFillManager.getMatchingNodes(url: "https://nothing.example.org", index: index).isEmpty)
+        XCTAssertTrue(BrowserAutoFillManager.getMatchingNodes(url: "https://nothing.example.org", index: nil).isEmpty)
+    }
+
+    func testCachedSortAgreesWithUncachedComparator() {
+        let url = "https://login.example.co.uk/path/5"
+        let matches = Array(entries.prefix(matchCount)).shuffled()
+        let isFavourite: (Node) -> Bool = { $0.title.hasSuffix("7") }
+
+        let sorted = BrowserAutoFillManager.sortMatches(matches, url: url, index: index, isFavourite: isFavourite)
+        let expected = matches.sorted { BrowserAutoFillManager.compareMatches(node1: $0, node2: $1, url: url, isFavourite: isFavourite) == .orderedAscending }
+
+        XCTAssertEqual(sorted.map { $0.uuid }, expected.map { $0.uuid })
+    }
+
+    func testStaleMatchKeyIsRecomputed() {
+        let node = entries[0]
+        node.fields.url = "https://other.example.net"
+
+        XCTAssertEqual(index.matchKey(for: node).fullDomain, "other.example.net")
+    }
+
+    func testPerformanceBuildIndex() {
+        measure {
+            let index = BrowserAutoFillDomainIndex()
+            for node in entries {
+                index.add(uuid: node.uuid, primaryUrl: node.fields.url, urls: [node.fields.url])
+            }
+        }
+    }
+
+    func testPerformanceLookupAndSort() {
+        measure {
+            let matches = BrowserAutoFillManager.getMatchingNodes(url: "https://www.example.co.uk/signin", index: index)
+            let nodes = entries.filter { matches.contains($0.uuid) }
+
+            _ = BrowserAutoFillManager.sortMatches(nodes, url: "https://www.example.co.uk/signin", index: index, isFavourite: { _ in false })
+        }
+    }
+
+    func testPerformanceUncachedSort() {
+        let nodes = Array(entries.prefix(matchCount))
+
+        measure {
+            _ = nodes.sorted { BrowserAutoFillManager.compareMatches(node1: $0, node2: $1, url: "https://www.example.co.uk/signin", isFavourite: { _ in false }) == .orderedAscending }
+        }
+    }
+}
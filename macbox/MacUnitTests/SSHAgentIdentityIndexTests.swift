@@ -0,0 +1,109 @@
+//
+//  SSHAgentIdentityIndexTests.swift
+//  MacUnitTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+@testable import Strongbox
+import XCTest
+
+final class SSHAgentIdentityIndexTests: XCTestCase {
+    private let databaseCount = 5
+    private let keysPerDatabase = 100
+
+    private var databases: [(uuid: String, entries: [Node])] = []
+    private var entriesRequested = 0
+
+    override func setUp() {
+        databases = (0 ..< databaseCount).map { _ in
+            let root = Node.rootGroup()
+            let entries = (0 ..< keysPerDatabase).map { i in
+                let node = Node(asRecord: "Key \(i)", parent: root)
+                let key = OpenSSHPrivateKey.newEd25519()!
+                node.keeAgentSshKeyViewModel = KeeAgentSshKeyViewModel.withKey(key, filename: "id_ed25519", enabled: true)
+                return node
+            }
+
+            return (uuid: UUID().uuidString, entries: entries)
+        }
+
+        entriesRequested = 0
+    }
+
+    private func makeIndex() -> SSHAgentIdentityIndex {
+        SSHAgentIdentityIndex(unlockedDatabases: { [unowned self] in
+            self.databases.map { database in
+                (uuid: database.uuid, entries: {
+                    self.entriesRequested += 1
+                    return database.entries
+                })
+            }
+        }, offlinePublicKeys: { [] })
+    }
+
+    func testIdentitiesAndLookup() {
+        let index = makeIndex()
+
+        XCTAssertEqual(index.knownPublicKeys.count, databaseCount * keysPerDatabase)
+
+        let target = databases[3].entries[42]
+        let blob = target.keeAgentSshKeyViewModel!.openSshKey.publicKeySerializationBlobBase64
+
+        let identity = index.identity(blobBase64: blob)
+        XCTAssertEqual(identity?.node, target)
+        XCTAssertEqual(identity?.databaseUuid, databases[3].uuid)
+        XCTAssertNil(index.identity(blobBase64: "AAAA"))
+    }
+
+    func testIndexIsBuiltOnceUntilInvalidated() {
+        let index = makeIndex()
+
+        _ = index.knownPublicKeys
+        _ = index.knownPublicKeys
+        _ = index.identity(blobBase64: "AAAA")
+
+        XCTAssertEqual(entriesRequested, databaseCount)
+
+        let removed = databases[0].entries.removeLast()
+        index.invalidate(databaseUuid: databases[0].uuid)
+
+        let keys = index.knownPublicKeys
+        XCTAssertEqual(entriesRequested, databaseCount + 1)
+        XCTAssertEqual(keys.count, databaseCount * keysPerDatabase - 1)
+        XCTAssertNil(index.identity(blobBase64: removed.keeAgentSshKeyViewModel!.openSshKey.publicKeySerializationBlobBase64))
+    }
+
+    func testInvalidationBumpsVersion() {
+        let index = makeIndex()
+        let before = index.version
+
+        index.invalidate(databaseUuid: databases[0].uuid)
+
+        XCTAssertNotEqual(index.version, before)
+    }
+
+    func testPerformanceRequestIdentities() {
+        let index = makeIndex()
+        _ = index.knownPublicKeys
+
+        measure {
+            for _ in 0 ..< 1000 {
+                _ = index.knownPublicKeys
+            }
+        }
+    }
+
+    func testPerformanceLookup() {
+        let index = makeIndex()
+        let blobs = databases.flatMap { $0.entries }.map { $0.keeAgentSshKeyViewModel!.openSshKey.publicKeySerializationBlobBase64 }
+        _ = index.knownPublicKeys
+
+        measure {
+            for blob in blobs {
+                _ = index.identity(blobBase64: blob)
+            }
+        }
+    }
+}
@@ -0,0 +1,217 @@
+//
+//  SSHAgentServerTests.m
+//  MacUnitTests
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "SSHAgentServer.h"
+#import "SSHAgentKeyCache.h"
+#import "OpenSSHPrivateKey.h"
+#import "Constants.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#import <openssh-portable/sshkey.h>
+#import <openssh-portable/sshbuf.h>
+#import <openssh-portable/authfd.h>
+
+static const NSUInteger kParallelSignRequests = 100;
+
+@interface SSHAgentServerTests : XCTestCase
+
+@property NSString* socketPath;
+@property SSHAgentServer* server;
+@property OpenSSHPrivateKey* key;
+
+@end
+
+@implementation SSHAgentServerTests
+
+- (void)setUp {
+    self.socketPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%u.sock", arc4random()]];
+
+    OpenSSHPrivateKey* plain = [OpenSSHPrivateKey newEd25519];
+    self.key = [OpenSSHPrivateKey fromData:[plain exportFileBlob:@"" exportPassphrase:@"passphrase"]];
+
+    self.server = [[SSHAgentServer alloc] initWithSocketPath:self.socketPath];
+
+    XCTAssertTrue([self.server start]);
+}
+
+- (void)tearDown {
+    [self.server stop];
+    [SSHAgentKeyCache.sharedInstance clearDatabase:@"test-database"];
+    unlink(self.socketPath.fileSystemRepresentation);
+}
+
+- (int)connect {
+    struct sockaddr_un sun = { 0 };
+    sun.sun_family = AF_UNIX;
+    strlcpy(sun.sun_path, self.socketPath.fileSystemRepresentation, sizeof(sun.sun_path));
+    sun.sun_len = SUN_LEN(&sun);
+
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ( connect(sock, (struct sockaddr*)&sun, sun.sun_len) != 0 ) {
+        close(sock);
+        return -1;
+    }
+
+    return sock;
+}
+
+- (NSData*)signRequest:(NSData*)challenge {
+    struct sshbuf *msg = sshbuf_new();
+
+    NSData* blob = self.key.publicKeySerializationBlob;
+
+    sshbuf_put_u32(msg, (u_int32_t)(1 + 4 + blob.length + 4 + challenge.length + 4));
+    sshbuf_put_u8(msg, SSH2_AGENTC_SIGN_REQUEST);
+    sshbuf_put_string(msg, blob.bytes, blob.length);
+    sshbuf_put_string(msg, challenge.bytes, challenge.length);
+    sshbuf_put_u32(msg, 0);
+
+    NSData* ret = [NSData dataWithBytes:sshbuf_ptr(msg) length:sshbuf_len(msg)];
+    sshbuf_free(msg);
+
+    return ret;
+}
+
+- (NSData*)readResponse:(int)sock {
+    uint32_t length;
+    if ( recv(sock, &length, sizeof(length), MSG_WAITALL) != sizeof(length) ) {
+        return nil;
+    }
+
+    length = CFSwapInt32BigToHost(length);
+    NSMutableData* data = [NSMutableData dataWithLength:length];
+
+    if ( recv(sock, data.mutableBytes, length, MSG_WAITALL) != length ) {
+        return nil;
+    }
+
+    return data;
+}
+
+- (NSData*)identitiesRequest {
+    uint8_t request[] = { 0, 0, 0, 1, SSH2_AGENTC_REQUEST_IDENTITIES };
+    return [NSData dataWithBytes:request length:sizeof(request)];
+}
+
+- (BOOL)isFailure:(NSData*)response {
+    return response.length == 1 && ((const uint8_t*)response.bytes)[0] == SSH_AGENT_FAILURE;
+}
+
+- (BOOL)verify:(NSData*)signature challenge:(NSData*)challenge {
+    struct sshkey* public = NULL;
+    NSData* blob = self.key.publicKeySerializationBlob;
+    sshkey_from_blob(blob.bytes, blob.length, &public);
+
+    int ret = sshkey_verify(public, signature.bytes, signature.length, challenge.bytes, challenge.length, NULL, 0, NULL);
+
+    sshkey_free(public);
+
+    return ret == 0;
+}
+
+- (void)testParallelSignRequestsWithIdleClient {
+    int idle = [self connect];
+    XCTAssertNotEqual(idle, -1);
+
+    __block NSUInteger answered = 0;
+
+    dispatch_apply(kParallelSignRequests, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        NSMutableData* challenge = [NSMutableData dataWithLength:64];
+        arc4random_buf(challenge.mutableBytes, challenge.length);
+
+        int sock = [self connect];
+        NSData* request = [self signRequest:challenge];
+
+        send(sock, request.bytes, request.length, 0);
+        NSData* response = [self readResponse:sock];
+        close(sock);
+
+        if ( [self isFailure:response] ) {
+            @synchronized (self) {
+                answered++;
+            }
+        }
+    });
+
+    close(idle);
+
+    XCTAssertEqual(answered, kParallelSignRequests);
+}
+
+- (void)testPipelinedRequestsOnOneConnection {
+    int sock = [self connect];
+
+    NSMutableData* challenge = [NSMutableData dataWithLength:32];
+    arc4random_buf(challenge.mutableBytes, challenge.length);
+
+    NSMutableData* both = [self identitiesRequest].mutableCopy;
+    [both appendData:[self signRequest:challenge]];
+    send(sock, both.bytes, both.length, 0);
+
+    NSData* identities = [self readResponse:sock];
+    XCTAssertGreaterThan(identities.length, 0);
+    XCTAssertEqual(((const uint8_t*)identities.bytes)[0], SSH2_AGENT_IDENTITIES_ANSWER);
+    XCTAssertTrue([self isFailure:[self readResponse:sock]]);
+
+    close(sock);
+}
+
+- (void)testOversizedMessageClosesConnection {
+    int sock = [self connect];
+
+    uint32_t length = CFSwapInt32HostToBig(64 * 1024 * 1024);
+    send(sock, &length, sizeof(length), 0);
+
+    uint8_t byte;
+    XCTAssertEqual(recv(sock, &byte, 1, 0), 0);
+
+    close(sock);
+}
+
+- (void)testParallelSigningSharesCachedKey {
+    __block NSUInteger verified = 0;
+
+    dispatch_apply(kParallelSignRequests, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        NSMutableData* challenge = [NSMutableData dataWithLength:64];
+        arc4random_buf(challenge.mutableBytes, challenge.length);
+
+        NSData* signature = [SSHAgentKeyCache.sharedInstance sign:challenge key:self.key passphrase:@"passphrase" flags:0 databaseUuid:@"test-database"];
+
+        if ( [self verify:signature challenge:challenge] ) {
+            @synchronized (self) {
+                verified++;
+            }
+        }
+    });
+
+    XCTAssertEqual(verified, kParallelSignRequests);
+    XCTAssertEqual(SSHAgentKeyCache.sharedInstance.count, 1);
+}
+
+- (void)testCacheClearedOnDatabaseLock {
+    NSData* challenge = [@"challenge" dataUsingEncoding:NSUTF8StringEncoding];
+
+    XCTAssertNotNil([SSHAgentKeyCache.sharedInstance sign:challenge key:self.key passphrase:@"passphrase" flags:0 databaseUuid:@"test-database"]);
+    XCTAssertEqual(SSHAgentKeyCache.sharedInstance.count, 1);
+
+    [NSNotificationCenter.defaultCenter postNotificationName:kDatabasesCollectionLockStateChangedNotification object:@"test-database"];
+
+    XCTAssertEqual(SSHAgentKeyCache.sharedInstance.count, 0);
+}
+
+- (void)testWrongPassphraseIsNotServedFromCache {
+    NSData* challenge = [@"challenge" dataUsingEncoding:NSUTF8StringEncoding];
+
+    XCTAssertNotNil([SSHAgentKeyCache.sharedInstance sign:challenge key:self.key passphrase:@"passphrase" flags:0 databaseUuid:@"test-database"]);
+    XCTAssertNil([SSHAgentKeyCache.sharedInstance sign:challenge key:self.key passphrase:@"wrong" flags:0 databaseUuid:@"test-database"]);
+}
+
+@end
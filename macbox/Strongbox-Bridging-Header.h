@@ -97,6 +97,7 @@
 #import "Node+KeeAgentSSH.h"
 #import "OpenSSHPrivateKey.h"
 #import "SSHAgentServer.h"
+#import "SSHAgentKeyCache.h"
 #import "XMLWriter.h"
 
 #import "ConcurrentCircularBuffer.h"
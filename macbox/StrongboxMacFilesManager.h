@@ -25,6 +25,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly) NSString* tmpAttachmentPreviewPath;
 @property (readonly) NSURL* syncManagerLocalWorkingCachesDirectory;
 @property (readonly) NSURL* syncManagerMergeWorkingDirectory;
+@property (readonly) NSURL* syncManagerUnlockSnapshotsDirectory;
 
 @property (readonly, nonnull) NSString* tmpEncryptionStreamPath;
 
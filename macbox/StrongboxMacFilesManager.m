@@ -131,6 +131,15 @@ static NSString* const kStrongboxICloudContainerIdentifier = @"iCloud.com.strong
     return ret;
 }
 
+- (NSURL *)syncManagerUnlockSnapshotsDirectory {
+    NSURL* url = StrongboxFilesManager.sharedInstance.sharedAppGroupDirectory;
+    NSURL* ret = [url URLByAppendingPathComponent:@"sync-manager/snapshots"];
+    
+    [self createIfNecessary:ret];
+    
+    return ret;
+}
+
 - (NSURL *)backupFilesDirectory {
     NSURL* url = StrongboxFilesManager.sharedInstance.sharedAppGroupDirectory;
     NSURL* ret = [url URLByAppendingPathComponent:@"backups"];
@@ -725,7 +725,7 @@ import Foundation
             return
         }
 
-        copyString(token.password)
+        copyString(model.database.totpGenerator.currentCode(forId: itemId) ?? token.password)
     }
 
     func dereferenceAndCopy(model: Model, text: String, item: Node) {
@@ -13,7 +13,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 NSString* _Nullable getSocketPath(BOOL hardcodeSandboxTestingPath);
 NSString* _Nullable sendMessageOverSocket (NSString* request, BOOL hardcodeSandboxTestingPath, NSError** error);
-id readJsonObjectFromInputStream (NSInputStream* inputStream, BOOL returnJsonInsteadOfObject );
+
+extern const uint32_t kMaxFramedMessageLength;
+
+NSData* _Nullable readFramedMessage (int socket); // 4 byte little endian length prefix, same as Native Messaging on stdio
+BOOL writeFramedMessage (int socket, NSData* message);
 
 NS_ASSUME_NONNULL_END
 
@@ -8,7 +8,6 @@
 
 #import <Foundation/Foundation.h>
 #import "AutoFillProxy.h"
-#import "StreamUtils.h"
 
 #import <signal.h>
 #include <sys/types.h>
@@ -18,7 +17,6 @@
 #include <errno.h>
 
 #import "Utils.h"
-#import "NSData+Extensions.h"
 
 static const int MAX_PATH = 103;
 
@@ -52,57 +50,86 @@ NSString* _Nullable getSocketPath(BOOL hardcodeSandboxTestingPath) {
     return path;
 }
 
-id readJsonObjectFromInputStream (NSInputStream* inputStream, BOOL returnJsonInsteadOfObject ) {
-    const int BUFFER_LEN = 16*1024;
-    NSMutableData* tmpBuffer = [NSMutableData dataWithLength:BUFFER_LEN];
-    
-    NSInteger read = 0;
-    NSMutableData* inBuf = NSMutableData.data;
+const uint32_t kMaxFramedMessageLength = 64 * 1024 * 1024;
+
+static BOOL readFully (int socket, void* buffer, size_t length) {
+    uint8_t* p = buffer;
     
-    id object = nil;
-    while ( 1 ) {
-        read = [inputStream read:tmpBuffer.mutableBytes maxLength:BUFFER_LEN];
-        if ( read < 0 ) {
-            NSLog(@"🔴 read error");
-            return nil;
-        }
+    while ( length > 0 ) {
+        ssize_t got = read(socket, p, length);
         
-        if ( read > 0 ) {
-
-            [inBuf appendBytes:tmpBuffer.bytes length:read];
-        }
-        else {
-            NSLog(@"🔴 Read 0 Bytes?!");
+        if ( got < 0 && errno == EINTR ) {
+            continue;
         }
         
-        NSError* error;
-        object = [NSJSONSerialization JSONObjectWithData:inBuf options:kNilOptions error:&error];
+        if ( got <= 0 ) {
+            return NO;
+        }
         
-        if ( object ) {
+        p += got;
+        length -= got;
+    }
+    
+    return YES;
+}
 
-            break;
-        }
-        else {
-#ifdef DEBUG
-            NSLog(@"🔴 Incomplete Buffer = %@",  [[NSString alloc] initWithData:inBuf encoding:NSUTF8StringEncoding]);
-            NSLog(@"🔴 Incomplete Buffer = %@",  inBuf.hexString);
-#endif
+static BOOL writeFully (int socket, const void* buffer, size_t length) {
+    const uint8_t* p = buffer;
+    
+    while ( length > 0 ) {
+        ssize_t written = write(socket, p, length);
+        
+        if ( written < 0 && errno == EINTR ) {
+            continue;
         }
         
-        if ( read == 0 ) {
-            NSLog(@"🔴 Read entire message but couldn't get object!");
-            break;
+        if ( written <= 0 ) {
+            NSLog(@"🔴 write error: %s", strerror(errno));
+            return NO;
         }
+        
+        p += written;
+        length -= written;
     }
+    
+    return YES;
+}
 
-    NSString* json = object ? [[NSString alloc] initWithData:inBuf encoding:NSUTF8StringEncoding] : nil;
+NSData* readFramedMessage (int socket) {
+    uint32_t length;
+    if ( !readFully(socket, &length, sizeof(length)) ) {
+        return nil; 
+    }
     
+    length = OSSwapLittleToHostInt32(length);
+    
+    if ( length > kMaxFramedMessageLength ) {
+        NSLog(@"🔴 Framed message length [%u] exceeds maximum", length);
+        return nil;
+    }
+    
+    NSMutableData* message = [NSMutableData dataWithLength:length];
+    
+    if ( !readFully(socket, message.mutableBytes, length) ) {
+        NSLog(@"🔴 read error - connection closed mid message");
+        return nil;
+    }
+    
+    return message;
+}
 
+BOOL writeFramedMessage (int socket, NSData* message) {
+    if ( message.length > kMaxFramedMessageLength ) {
+        NSLog(@"🔴 Framed message length [%lu] exceeds maximum", (unsigned long)message.length);
+        return NO;
+    }
+    
+    uint32_t length = OSSwapHostToLittleInt32((uint32_t)message.length);
     
-    return returnJsonInsteadOfObject ? json : object;
+    return writeFully(socket, &length, sizeof(length)) && writeFully(socket, message.bytes, message.length);
 }
 
-NSString* sendMessageOverSocket (NSString* request, BOOL hardcodeSandboxTestingPath, NSError** error) {
+static int connectToSocket (BOOL hardcodeSandboxTestingPath, NSError** error) {
     NSString* path = getSocketPath(hardcodeSandboxTestingPath);
     if ( !path ) {
         NSLog(@"🔴 Socket path too long to create. Check Users Home Path length");
@@ -111,7 +138,7 @@ NSString* sendMessageOverSocket (NSString* request, BOOL hardcodeSandboxTestingP
             *error = [Utils createNSError:[NSString stringWithFormat:@"Socket path too long to create. > %d chars. Check Users Home Path length.", MAX_PATH] errorCode:-1];
         }
 
-        return nil;
+        return -1;
     }
     
     struct sockaddr_un sun;
@@ -120,7 +147,16 @@ NSString* sendMessageOverSocket (NSString* request, BOOL hardcodeSandboxTestingP
     sun.sun_len = SUN_LEN(&sun);
 
     int s = socket (AF_UNIX, SOCK_STREAM, 0);
-
+    if ( s == -1 ) {
+        NSString* errMsg = [NSString stringWithFormat:@"socket failed! [%s]", strerror(errno)];
+        NSLog(@"%@", errMsg);
+        
+        if ( error ) {
+            *error = [Utils createNSError:errMsg errorCode:-1];
+        }
+        
+        return -1;
+    }
     
     const int kBufferSize = 2 * 1024 * 1024;
     if (setsockopt(s, SOL_SOCKET, SO_RCVBUF, &kBufferSize, sizeof(int)) == -1) {
@@ -130,6 +166,9 @@ NSString* sendMessageOverSocket (NSString* request, BOOL hardcodeSandboxTestingP
         NSLog(@"🔴 Error setting socket SO_SNDBUF opts: %s\n", strerror(errno));
     }
     
+    int on = 1;
+    setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+    
     int connectReturn = connect (s, (struct sockaddr *)&sun, sun.sun_len);
     if ( connectReturn < 0 ) {
         NSString* errMsg = [NSString stringWithFormat:@"connect failed! [%s]", strerror(errno)];
@@ -138,35 +177,55 @@ NSString* sendMessageOverSocket (NSString* request, BOOL hardcodeSandboxTestingP
         if ( error ) {
             *error = [Utils createNSError:errMsg errorCode:-1];
         }
-                
-        return nil;
+        
+        close(s);
+        return -1;
     }
-
-    NSData* data = [request dataUsingEncoding:NSUTF8StringEncoding];
-
-
     
-    CFReadStreamRef readStream;
-    CFWriteStreamRef writeStream;
-    CFStreamCreatePairWithSocket (kCFAllocatorDefault, s, &readStream, &writeStream);
-
-    NSOutputStream *outputStream = (__bridge_transfer NSOutputStream *)writeStream;
-
-    [outputStream open];
-    [outputStream write:data.bytes maxLength:data.length];
-
-    NSInputStream *inputStream = (__bridge_transfer NSInputStream *)readStream;
-    
-    [inputStream open];
+    return s;
+}
 
-    id json = readJsonObjectFromInputStream(inputStream, YES);
+NSString* sendMessageOverSocket (NSString* request, BOOL hardcodeSandboxTestingPath, NSError** error) {
+    static int persistentSocket = -1; 
     
-    [inputStream close];
+    NSData* data = [request dataUsingEncoding:NSUTF8StringEncoding];
     
-    [outputStream close];
-
-    shutdown(s, SHUT_RDWR);
-    close(s);
+    for ( int attempt = 0; attempt < 2; attempt++ ) {
+        BOOL reused = persistentSocket != -1;
+        
+        if ( !reused ) {
+            persistentSocket = connectToSocket(hardcodeSandboxTestingPath, error);
+            
+            if ( persistentSocket == -1 ) {
+                return nil;
+            }
+        }
+        
+        BOOL written = writeFramedMessage(persistentSocket, data);
+        int writeErrno = errno;
+        
+        NSData* response = written ? readFramedMessage(persistentSocket) : nil;
+        
+        if ( response ) {
+            return [[NSString alloc] initWithData:response encoding:NSUTF8StringEncoding];
+        }
+        
+        shutdown(persistentSocket, SHUT_RDWR);
+        close(persistentSocket);
+        persistentSocket = -1;
+        
+        // Only a failed write on a reused connection is safe to retry, the server cannot have seen the request.
+        if ( reused && !written ) {
+            continue;
+        }
+        
+        if ( error ) {
+            NSString* errMsg = written ? @"No response from Strongbox, connection closed" : [NSString stringWithFormat:@"Could not send message to Strongbox [%s]", strerror(writeErrno)];
+            *error = [Utils createNSError:errMsg errorCode:-1];
+        }
+        
+        return nil;
+    }
     
-    return json;
+    return nil;
 }
@@ -22,7 +22,7 @@
 static const int kMaxResponseLength = 1024*1024; 
 
 void onGotBrowserExtensionMessage(NSData* data);
-void decodeBrowserExtensionMessage(void);
+BOOL decodeBrowserExtensionMessage(void);
 
 NSString* jsonErrorMessage(NSString* message);
 NSString* jsonMessage(BOOL success, NSString* message);
@@ -49,13 +49,13 @@ int main(int argc, const char * argv[]) {
 
         
         
-        decodeBrowserExtensionMessage();
+        while ( decodeBrowserExtensionMessage() ) { } 
 
         NSLog(@"✅ Strongbox AutoFill Proxy is Exiting...");
     }
 }
 
-void decodeBrowserExtensionMessage(void) {
+BOOL decodeBrowserExtensionMessage(void) {
     NSFileHandle *stdIn = NSFileHandle.fileHandleWithStandardInput;
 
     NSError * stdinError = nil;
@@ -66,6 +66,10 @@ void decodeBrowserExtensionMessage(void) {
         exit(1);
     }
     
+    if ( rawReqLen.length < 4 ) { 
+        return NO;
+    }
+    
     uint32_t reqLen;
     [rawReqLen getBytes:&reqLen length:4];
     reqLen = OSSwapLittleToHostInt32(reqLen);
@@ -79,10 +83,12 @@ void decodeBrowserExtensionMessage(void) {
     
     if ( req.length == 0 ) {
         NSLog(@"⚠️ Zero Length STDIN Notify?");
-        return;
+        return NO;
     }
     
     onGotBrowserExtensionMessage(req);
+    
+    return YES;
 }
 
 void onGotBrowserExtensionMessage(NSData* data) {
@@ -108,27 +114,24 @@ void onGotBrowserExtensionMessage(NSData* data) {
         }
     }
     
-    NSUInteger len = message.length;
-    NSLog(@"Got Response from main Strongbox APP of length [%lu]:\n%@\n", len, message);
+    NSLog(@"Got Response from main Strongbox APP of length [%lu]:\n%@\n", message.length, message);
     
     
     
     if ( [message containsString:@"🔴"] || [message containsString:@"✅"] || [message containsString:@"⚠️"] ) {
         NSLog(@"🔴 Response contains an emoji which will crash Chrome! Not sending.");
         message = jsonErrorMessage(@"🔴 Response contains an emoji which will crash Chrome! Not sending.");
-        len = message.length;
     }
     
+    NSData* messageData = [message dataUsingEncoding:NSUTF8StringEncoding];
     
-    
-    if ( len > kMaxResponseLength ) {
+    if ( messageData.length > kMaxResponseLength ) {
         NSLog(@"🔴 Response length is greater than NativeMessaging limit of 1MB. Cannot respond.");
-        message = jsonErrorMessage(@"Response length is greater than NativeMessaging limit of 1MB. Cannot respond.");
-        len = message.length;
+        messageData = [jsonErrorMessage(@"Response length is greater than NativeMessaging limit of 1MB. Cannot respond.") dataUsingEncoding:NSUTF8StringEncoding];
     }
     
+    uint32_t len = OSSwapHostToLittleInt32((uint32_t)messageData.length);
     NSData* dataLen = [NSData dataWithBytes:&len length:4];
-    NSData* messageData = [message dataUsingEncoding:NSUTF8StringEncoding];
     [NSFileHandle.fileHandleWithStandardOutput writeData:dataLen];
     [NSFileHandle.fileHandleWithStandardOutput writeData:messageData];
 }
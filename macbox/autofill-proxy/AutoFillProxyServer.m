@@ -8,7 +8,6 @@
 
 #import "AutoFillProxyServer.h"
 #import "AutoFillProxy.h"
-#import "StreamUtils.h"
 #include <sys/types.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
@@ -20,9 +19,12 @@
 @interface AutoFillProxyServer ()
 
 @property int server_sock;
+@property NSMutableSet<dispatch_source_t>* clientSources;
 
 @end
 
+static const size_t kReadChunkSize = 64 * 1024;
+
 @implementation AutoFillProxyServer
 
 + (instancetype)sharedInstance {
@@ -36,6 +38,15 @@
     return sharedInstance;
 }
 
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        self.server_sock = -1;
+        self.clientSources = NSMutableSet.set;
+    }
+    return self;
+}
+
 - (void)stop {
 
 
@@ -51,9 +62,11 @@
         self.server_sock = -1;
     }
     
-
-    
-
+    @synchronized (self.clientSources) {
+        for ( dispatch_source_t client in self.clientSources.allObjects ) {
+            dispatch_source_cancel(client);
+        }
+    }
     
     _isRunning = NO;
 }
@@ -140,71 +153,96 @@
             break;
         }
         
-
-
-        
         
 
-            [self handleNewConnection:socket];
-
+        [self handleNewConnection:socket];
     }
-    
-
 }
 
 - (void)handleNewConnection:(int)socket {
+    int on = 1;
+    setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
     
+    // Reads are driven by the source, so only responses block and a persistent but idle connection holds no thread.
+    dispatch_queue_t queue = dispatch_queue_create("AutoFillProxyServer-Client", DISPATCH_QUEUE_SERIAL);
+    dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, socket, 0, queue);
     
-
+    NSMutableData* pending = NSMutableData.data;
     
-    CFReadStreamRef readStream;
-    CFWriteStreamRef writeStream;
-    CFStreamCreatePairWithSocket (kCFAllocatorDefault, socket, &readStream, &writeStream);
-
-    NSInputStream *inputStream = (__bridge_transfer NSInputStream *)readStream;
+    __weak AutoFillProxyServer* weakSelf = self;
+    __weak dispatch_source_t weakSource = source;
     
-    [inputStream open];
-    
-    NSString* jsonRequest = readJsonObjectFromInputStream(inputStream, YES);
-    
-    [inputStream close];
+    dispatch_source_set_event_handler(source, ^{
+        if ( ![weakSelf onClientReadable:socket pending:pending] ) {
+            dispatch_source_cancel(weakSource);
+        }
+    });
     
-    if ( !jsonRequest ) {
-        
-        NSLog(@"🔴 Could not read valid JSON object! Connection done.");
+    dispatch_source_set_cancel_handler(source, ^{
         shutdown(socket, SHUT_RDWR);
         close(socket);
-        return;
-    }
-    
-    
         
-    NSString* jsonResponse = [AutoFillRequestHandler.shared handleJsonRequestWithJson:jsonRequest];
-    
-    
-    
+        AutoFillProxyServer* strongSelf = weakSelf;
+        dispatch_source_t strongSource = weakSource;
+        if ( strongSelf && strongSource ) {
+            @synchronized (strongSelf.clientSources) {
+                [strongSelf.clientSources removeObject:strongSource];
+            }
+        }
+    });
     
+    @synchronized (self.clientSources) {
+        [self.clientSources addObject:source];
+    }
     
-    NSOutputStream *outputStream = (__bridge_transfer NSOutputStream *)writeStream;
-
-    [outputStream open];
+    dispatch_resume(source);
+}
 
-    NSData* msg = [jsonResponse dataUsingEncoding:NSUTF8StringEncoding];
-    
+- (BOOL)onClientReadable:(int)socket pending:(NSMutableData*)pending {
+    uint8_t buf[kReadChunkSize];
     
-    NSUInteger len = msg.length;
+    ssize_t bytesRead = read(socket, buf, kReadChunkSize);
+    if ( bytesRead == 0 ) {
+        return NO; 
+    }
     
-    [outputStream write:msg.bytes maxLength:len];
-    [outputStream close];
+    if ( bytesRead < 0 ) {
+        return errno == EINTR || errno == EAGAIN;
+    }
     
-    shutdown(socket, SHUT_RDWR);
-    close(socket);
-    
-
-
-
+    [pending appendBytes:buf length:bytesRead];
     
+    while ( pending.length >= sizeof(uint32_t) ) {
+        uint32_t length;
+        [pending getBytes:&length length:sizeof(uint32_t)];
+        length = OSSwapLittleToHostInt32(length);
+        
+        if ( length > kMaxFramedMessageLength ) {
+            NSLog(@"🔴 Framed message length [%u] exceeds maximum", length);
+            return NO;
+        }
+        
+        if ( pending.length < sizeof(uint32_t) + length ) {
+            break; 
+        }
+        
+        NSString* jsonRequest = [[NSString alloc] initWithBytes:(const uint8_t*)pending.bytes + sizeof(uint32_t) length:length encoding:NSUTF8StringEncoding];
+        
+        [pending replaceBytesInRange:NSMakeRange(0, sizeof(uint32_t) + length) withBytes:NULL length:0];
+        
+        if ( !jsonRequest ) {
+            NSLog(@"🔴 Could not read valid UTF8 request! Connection done.");
+            return NO;
+        }
+        
+        NSString* jsonResponse = [AutoFillRequestHandler.shared handleJsonRequestWithJson:jsonRequest];
+        
+        if ( !writeFramedMessage(socket, [jsonResponse dataUsingEncoding:NSUTF8StringEncoding]) ) {
+            return NO;
+        }
+    }
     
+    return YES;
 }
 
 @end
@@ -30,7 +30,7 @@ int main(int argc, const char * argv[]) {
             
             NSLog(@"Sending... [%@]", request);
             
-            NSString* response = sendMessageOverSocket(request, YES);
+            NSString* response = sendMessageOverSocket(request, YES, nil);
             
             NSLog(@"Got response => \n%@\n", response);
 
@@ -0,0 +1,105 @@
+//
+//  BrowserAutoFillDomainIndex.swift
+//  MacBox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+import Foundation
+
+@objc
+public class BrowserAutoFillMatchKey: NSObject {
+    let url: String
+    let fullDomain: String
+    let pslDomain: String
+
+    init(url: String, fullDomain: String, pslDomain: String) {
+        self.url = url
+        self.fullDomain = fullDomain
+        self.pslDomain = pslDomain
+    }
+
+    convenience init(url: String) {
+        let domains = BrowserAutoFillManager.extractDomains(url: url)
+        self.init(url: url, fullDomain: domains.fullDomain, pslDomain: domains.pslDomain)
+    }
+}
+
+@objc
+public class BrowserAutoFillDomainIndex: NSObject {
+    private var pslDomainNodes: [String: Set<UUID>] = [:]
+    private var matchKeys: [UUID: BrowserAutoFillMatchKey] = [:]
+    private var equivalentGroupNodes: [Int: Set<UUID>] = [:]
+
+    @objc public private(set) var domainCount: Int = 0
+
+    func add(uuid: UUID, primaryUrl: String, urls: Set<String>) {
+        var primaryKey: BrowserAutoFillMatchKey? = nil
+        var pslDomains: Set<String> = []
+
+        for url in urls {
+            let key = BrowserAutoFillMatchKey(url: url)
+
+            if url == primaryUrl {
+                primaryKey = key
+            }
+
+            if pslDomains.insert(key.pslDomain).inserted {
+                insert(uuid: uuid, key: key)
+            }
+
+            addToEquivalentGroups(uuid: uuid, key: key)
+        }
+
+        matchKeys[uuid] = primaryKey ?? BrowserAutoFillMatchKey(url: primaryUrl)
+    }
+
+    func matchKey(for node: Node) -> BrowserAutoFillMatchKey {
+        if let cached = matchKeys[node.uuid], cached.url == node.fields.url {
+            return cached
+        }
+
+        return BrowserAutoFillMatchKey(url: node.fields.url)
+    }
+
+    func nodes(pslDomain: String) -> Set<UUID> {
+        pslDomainNodes[pslDomain] ?? []
+    }
+
+    func nodes(equivalentTo pslDomain: String) -> Set<UUID> {
+        guard let groupId = ApplePasswordManagerQuirks.shared.groupId(pslDomain) else {
+            return nodes(pslDomain: pslDomain)
+        }
+
+        return equivalentGroupNodes[groupId] ?? []
+    }
+
+    private func insert(uuid: UUID, key: BrowserAutoFillMatchKey) {
+        if pslDomainNodes[key.pslDomain] == nil {
+            domainCount += 1
+        }
+        pslDomainNodes[key.pslDomain, default: []].insert(uuid)
+    }
+
+    private func addToEquivalentGroups(uuid: UUID, key: BrowserAutoFillMatchKey) {
+        let quirks = ApplePasswordManagerQuirks.shared
+
+        if let groupId = quirks.groupId(key.pslDomain) {
+            equivalentGroupNodes[groupId, default: []].insert(uuid)
+        }
+
+        guard key.fullDomain.count > key.pslDomain.count, key.fullDomain.hasSuffix("." + key.pslDomain) else {
+            return
+        }
+
+        var domain = key.pslDomain
+        for label in key.fullDomain.dropLast(key.pslDomain.count + 1).split(separator: ".").reversed() {
+            domain = "\(label).\(domain)"
+
+            if let groupId = quirks.groupId(domain) {
+                equivalentGroupNodes[groupId, default: []].insert(uuid)
+            }
+        }
+    }
+}
@@ -21,32 +21,29 @@ public class BrowserAutoFillManager: NSObject {
     }
 
     @objc public class func extractFullDomainFromUrl(url: String) -> String {
-        guard let urlProcessed = url.urlExtendedParseAddingDefaultScheme else {
-            return url.lowercased()
-        }
-
-        if let components = URLComponents(url: urlProcessed, resolvingAgainstBaseURL: false),
-           let host = components.host
-        {
-            return host.lowercased()
-        } else {
-            return url.lowercased()
-        }
+        extractDomains(url: url).fullDomain
     }
 
     @objc public class func extractPSLDomainFromUrl(url: String) -> String {
+        extractDomains(url: url).pslDomain
+    }
+
+    class func extractDomains(url: String) -> (fullDomain: String, pslDomain: String) {
         guard let urlProcessed = url.urlExtendedParseAddingDefaultScheme else {
-            return url.lowercased()
+            let lowercased = url.lowercased()
+            return (lowercased, lowercased)
         }
 
         if let components = URLComponents(url: urlProcessed, resolvingAgainstBaseURL: false),
            let host = components.host
         {
+            let fullDomain = host.lowercased()
             let parsed = domainParser.parse(host: host)
-            return parsed?.domain?.lowercased() ?? host.lowercased()
+            return (fullDomain, parsed?.domain?.lowercased() ?? fullDomain)
         } else {
+            let lowercased = url.lowercased()
             let parsed = domainParser.parse(host: url)
-            return parsed?.domain?.lowercased() ?? url.lowercased()
+            return (lowercased, parsed?.domain?.lowercased() ?? lowercased)
         }
     }
 
@@ -57,54 +54,83 @@ public class BrowserAutoFillManager: NSObject {
 
         
 
-        if let u = URL(string: url), let host = u.host, equivs.contains(host.lowercased()) {
-            equivs.remove(host)
+        if !equivs.isEmpty, let u = URL(string: url), let host = u.host {
+            equivs.remove(host.lowercased())
         }
 
         return equivs
     }
 
-    @objc class func getMatchingNodes(url: String, domainNodeMap: [String: Set<UUID>]) -> Set<UUID> {
+    @objc class func getMatchingNodes(url: String, index: BrowserAutoFillDomainIndex?) -> Set<UUID> {
+        getMatchingNodes(url: url, index: index, includeEquivalentDomains: false)
+    }
 
+    @objc class func getMatchingNodes(url: String, index: BrowserAutoFillDomainIndex?, includeEquivalentDomains: Bool) -> Set<UUID> {
+        guard let index else {
+            return []
+        }
 
         let domain = extractPSLDomainFromUrl(url: url)
 
-        let ret: Set<UUID> = domainNodeMap[domain] ?? Set()
-
-
-
-
-
-
-        return ret
+        return includeEquivalentDomains ? index.nodes(equivalentTo: domain) : index.nodes(pslDomain: domain)
     }
 
-    @objc class func loadDomainNodeMap(_ model: Model) -> [String: Set<UUID>] {
+    @objc class func loadDomainNodeIndex(_ model: Model) -> BrowserAutoFillDomainIndex {
         let startTime = CFAbsoluteTimeGetCurrent()
 
         let allSearchable = model.database.allSearchableNoneExpiredEntries
         let all = allSearchable.filter { !model.isExcluded(fromAutoFill: $0.uuid) }
 
-        var mutableRet: [String: Set<UUID>] = [:]
+        let ret = BrowserAutoFillDomainIndex()
 
         for node in all {
             let uniqueUrls = AutoFillCommon.getUniqueUrls(forNode: model, node: node)
 
-            let domains = Set(uniqueUrls.map { extractPSLDomainFromUrl(url: $0) })
-
-            for domain in domains {
-                mutableRet[domain, default: Set<UUID>()].insert(node.uuid)
-            }
+            ret.add(uuid: node.uuid, primaryUrl: node.fields.url, urls: uniqueUrls)
         }
 
         let timeElapsed = CFAbsoluteTimeGetCurrent() - startTime
 
-        NSLog("🐞 ⏱ loadDomainNodeMap: Loaded \(mutableRet.count) domains from \(all.count) entries in \(timeElapsed) s.")
+        NSLog("🐞 ⏱ loadDomainNodeIndex: Loaded \(ret.domainCount) domains from \(all.count) entries in \(timeElapsed) s.")
 
-        return mutableRet
+        return ret
+    }
+
+    @objc class func sortMatches(_ nodes: [Node], url: String, index: BrowserAutoFillDomainIndex?, isFavourite: (Node) -> Bool) -> [Node] {
+        let target = BrowserAutoFillMatchKey(url: url)
+
+        let keys = Dictionary(nodes.map { ($0.uuid, index?.matchKey(for: $0) ?? BrowserAutoFillMatchKey(url: $0.fields.url)) }, uniquingKeysWith: { first, _ in first })
+        let favourites = Set(nodes.filter { isFavourite($0) }.map { $0.uuid })
+
+        var distances: [UUID: Int] = [:]
+        let distance: (Node) -> Int = { node in
+            if let cached = distances[node.uuid] {
+                return cached
+            }
+
+            let computed = Int(node.fields.url.levenshteinDistance(url))
+            distances[node.uuid] = computed
+            return computed
+        }
+
+        return nodes.sorted { node1, node2 in
+            compareMatches(node1: node1, key1: keys[node1.uuid]!, node2: node2, key2: keys[node2.uuid]!, target: target, isFavourite: { favourites.contains($0.uuid) }, distance: distance) == .orderedAscending
+        }
     }
 
     @objc public class func compareMatches(node1: Node, node2: Node, url: String, isFavourite: (Node) -> Bool) -> ComparisonResult {
+        compareMatches(node1: node1,
+                       key1: BrowserAutoFillMatchKey(url: node1.fields.url),
+                       node2: node2,
+                       key2: BrowserAutoFillMatchKey(url: node2.fields.url),
+                       target: BrowserAutoFillMatchKey(url: url),
+                       isFavourite: isFavourite,
+                       distance: { Int($0.fields.url.levenshteinDistance(url)) })
+    }
+
+    class func compareMatches(node1: Node, key1: BrowserAutoFillMatchKey, node2: Node, key2: BrowserAutoFillMatchKey, target: BrowserAutoFillMatchKey, isFavourite: (Node) -> Bool, distance: (Node) -> Int) -> ComparisonResult {
+        let url = target.url
+
         
 
         if isFavourite(node1) {
@@ -137,9 +163,9 @@ public class BrowserAutoFillManager: NSObject {
 
             
 
-            let targetDomain = extractFullDomainFromUrl(url: url)
-            let fullDomain1 = extractFullDomainFromUrl(url: node1.fields.url)
-            let fullDomain2 = extractFullDomainFromUrl(url: node2.fields.url)
+            let targetDomain = target.fullDomain
+            let fullDomain1 = key1.fullDomain
+            let fullDomain2 = key2.fullDomain
 
             if fullDomain1 != fullDomain2 { 
                 if fullDomain1 == targetDomain {
@@ -154,9 +180,9 @@ public class BrowserAutoFillManager: NSObject {
 
                 
 
-                let targetPslDomain = extractPSLDomainFromUrl(url: url)
-                let pslDomain1 = extractPSLDomainFromUrl(url: node1.fields.url)
-                let pslDomain2 = extractPSLDomainFromUrl(url: node2.fields.url)
+                let targetPslDomain = target.pslDomain
+                let pslDomain1 = key1.pslDomain
+                let pslDomain2 = key2.pslDomain
 
                 if pslDomain1 == pslDomain2, pslDomain1 == targetPslDomain {
                     
@@ -176,8 +202,8 @@ public class BrowserAutoFillManager: NSObject {
 
             
 
-            let distance1 = node1.fields.url.levenshteinDistance(url)
-            let distance2 = node2.fields.url.levenshteinDistance(url)
+            let distance1 = distance(node1)
+            let distance2 = distance(node2)
 
 
 
@@ -10,6 +10,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+struct sshkey;
+
 @interface OpenSSHPrivateKey : NSObject
 
 + (instancetype _Nullable)fromData:(NSData*)data;
@@ -34,6 +36,9 @@ NS_ASSUME_NONNULL_BEGIN
 - (BOOL)validatePassphrase:(NSString*)passphrase;
 - (NSData*_Nullable)sign:(NSData*)challenge passphrase:(NSString*)passphrase flags:(u_int)flags;
 
+- (struct sshkey*_Nullable)parsePrivateKey:(NSString*)passphrase; // Caller owns the result - sshkey_free
++ (NSData*_Nullable)sign:(NSData*)challenge key:(struct sshkey*)key flags:(u_int)flags;
+
 - (NSData*_Nullable)exportFileBlob:(NSString*)originalPassphrase exportPassphrase:(NSString*)exportPassphrase;
 
 @end
@@ -244,16 +244,29 @@ static const u_int kDefaultEd25519Bits = 256;
 }
 
 - (NSData*)sign:(NSData*)challenge passphrase:(NSString*)passphrase flags:(u_int)flags {
+    struct sshkey *thePrivateKey = [self parsePrivateKey:passphrase];
+    if ( thePrivateKey == NULL ) {
+        return nil;
+    }
+    
+    NSData* sig = [OpenSSHPrivateKey sign:challenge key:thePrivateKey flags:flags];
+    
+    sshkey_free(thePrivateKey);
+    
+    return sig;
+}
+
+- (struct sshkey*)parsePrivateKey:(NSString*)passphrase {
     const char* cPassphrase = [passphrase cStringUsingEncoding:NSUTF8StringEncoding];
     if ( cPassphrase == nil ) {
         NSLog(@"🔴 sign: Could not get s String passphrase");
-        return nil;
+        return NULL;
     }
     
     struct sshbuf *blob = sshbuf_from(self.fileBlobData.bytes, self.fileBlobData.length);
     if ( blob == NULL ) {
         NSLog(@"🔴 sign: Could not allocate blob for private key.");
-        return nil;
+        return NULL;
     }
     
     struct sshkey *thePrivateKey = nil;
@@ -262,23 +275,23 @@ static const u_int kDefaultEd25519Bits = 256;
     
     if ( ret != SSH_ERR_SUCCESS ) {
         NSLog(@"🔴 Could not parse Private Key...");
-        return nil;
+        return NULL;
     }
     
-    
-    
+    return thePrivateKey;
+}
+
++ (NSData*)sign:(NSData*)challenge key:(struct sshkey*)key flags:(u_int)flags {
     u_char *signature = NULL;
     size_t slen = 0;
-    if (sshkey_sign(thePrivateKey, &signature, &slen, challenge.bytes, challenge.length, agent_decode_alg(thePrivateKey, flags), NULL, NULL, 0) != 0) {
+    if (sshkey_sign(key, &signature, &slen, challenge.bytes, challenge.length, agent_decode_alg(key, flags), NULL, NULL, 0) != 0) {
         NSLog(@"🔴 Could not sign the challenge");
-        sshkey_free(thePrivateKey);
         return nil;
     }
 
     NSData* sig = [NSData dataWithBytes:signature length:slen];
     
     free(signature);
-    sshkey_free(thePrivateKey);
     
     return sig;
 }
@@ -0,0 +1,150 @@
+//
+//  SSHAgentIdentityIndex.swift
+//  MacBox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+import Foundation
+
+class SSHAgentIdentity: NSObject {
+    let node: Node
+    let databaseUuid: String
+    let key: OpenSSHPrivateKey
+
+    init(node: Node, databaseUuid: String, key: OpenSSHPrivateKey) {
+        self.node = node
+        self.databaseUuid = databaseUuid
+        self.key = key
+    }
+}
+
+class SSHAgentDatabaseIdentities: NSObject {
+    let publicKeyBlobs: [Data]
+    let identitiesByBlobBase64: [String: SSHAgentIdentity]
+
+    init(databaseUuid: String, entries: [Node]) {
+        var blobs: [Data] = []
+        var map: [String: SSHAgentIdentity] = [:]
+
+        for node in entries {
+            guard let kaKey = node.keeAgentSshKeyViewModel, kaKey.enabled else {
+                continue
+            }
+            let key = kaKey.openSshKey
+
+            if map[key.publicKeySerializationBlobBase64] == nil {
+                map[key.publicKeySerializationBlobBase64] = SSHAgentIdentity(node: node, databaseUuid: databaseUuid, key: key)
+                blobs.append(key.publicKeySerializationBlob)
+            }
+        }
+
+        publicKeyBlobs = blobs
+        identitiesByBlobBase64 = map
+    }
+}
+
+class SSHAgentIdentityIndex: NSObject {
+    typealias UnlockedDatabasesProvider = () -> [(uuid: String, entries: () -> [Node])]
+    typealias OfflinePublicKeysProvider = () -> [Data]
+
+    private let unlockedDatabases: UnlockedDatabasesProvider
+    private let offlinePublicKeys: OfflinePublicKeysProvider
+
+    private let databases = ConcurrentMutableDictionary<NSString, SSHAgentDatabaseIdentities>()
+    private let queue = DispatchQueue(label: "SSHAgentIdentityIndex")
+    private var mergedPublicKeys: [Data]? = nil
+    private var _version: Int = 0
+
+    init(unlockedDatabases: @escaping UnlockedDatabasesProvider, offlinePublicKeys: @escaping OfflinePublicKeysProvider) {
+        self.unlockedDatabases = unlockedDatabases
+        self.offlinePublicKeys = offlinePublicKeys
+        super.init()
+    }
+
+    var version: Int {
+        queue.sync { _version }
+    }
+
+    func invalidate(databaseUuid: String) {
+        databases.removeObject(forKey: databaseUuid as NSString)
+        invalidateMerged()
+    }
+
+    func invalidateAll() {
+        databases.removeAllObjects()
+        invalidateMerged()
+    }
+
+    func invalidateMerged() {
+        queue.sync {
+            mergedPublicKeys = nil
+            _version += 1
+        }
+    }
+
+    var knownPublicKeys: [Data] {
+        if let cached = queue.sync(execute: { mergedPublicKeys }) {
+            return cached
+        }
+
+        let startVersion = version
+
+        var used: Set<Data> = []
+        var ret: [Data] = []
+
+        for database in unlockedDatabases() {
+            for pkBlob in identities(for: database.uuid, entries: database.entries).publicKeyBlobs {
+                if !used.contains(pkBlob) {
+                    ret.append(pkBlob)
+                    used.insert(pkBlob)
+                }
+            }
+        }
+
+
+
+        for pkBlob in offlinePublicKeys() {
+            if !used.contains(pkBlob) {
+                ret.append(pkBlob)
+                used.insert(pkBlob)
+            }
+        }
+
+        queue.sync {
+            if _version == startVersion {
+                mergedPublicKeys = ret
+            }
+        }
+
+        return ret
+    }
+
+    func identity(blobBase64: String) -> SSHAgentIdentity? {
+        for database in unlockedDatabases() {
+            if let found = identities(for: database.uuid, entries: database.entries).identitiesByBlobBase64[blobBase64] {
+                return found
+            }
+        }
+
+        return nil
+    }
+
+    private func identities(for databaseUuid: String, entries: () -> [Node]) -> SSHAgentDatabaseIdentities {
+        if let existing = databases.object(forKey: databaseUuid as NSString) {
+            return existing
+        }
+
+        let startVersion = version
+        let built = SSHAgentDatabaseIdentities(databaseUuid: databaseUuid, entries: entries())
+
+        queue.sync {
+            if _version == startVersion {
+                databases.setObject(built, forKey: databaseUuid as NSString)
+            }
+        }
+
+        return built
+    }
+}
@@ -0,0 +1,31 @@
+//
+//  SSHAgentKeyCache.h
+//  MacBox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "OpenSSHPrivateKey.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface SSHAgentKeyCache : NSObject
+
++ (instancetype)sharedInstance;
+
+- (NSData*_Nullable)sign:(NSData*)challenge
+                     key:(OpenSSHPrivateKey*)key
+              passphrase:(NSString*)passphrase
+                   flags:(u_int)flags
+            databaseUuid:(NSString*)databaseUuid;
+
+- (void)clearDatabase:(NSString*)databaseUuid;
+- (void)clearAll;
+
+@property (readonly) NSUInteger count;
+
+@end
+
+NS_ASSUME_NONNULL_END
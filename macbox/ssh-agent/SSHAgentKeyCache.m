@@ -0,0 +1,180 @@
+//
+//  SSHAgentKeyCache.m
+//  MacBox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "SSHAgentKeyCache.h"
+#import "ConcurrentMutableDictionary.h"
+#import "Constants.h"
+#import "Strongbox-Swift.h"
+
+#import <CommonCrypto/CommonHMAC.h>
+#include <sys/mman.h>
+
+#import <openssh-portable/sshkey.h>
+
+@interface SSHAgentCachedKey : NSObject
+
+@property (readonly) struct sshkey* key;
+@property (readonly) NSString* databaseUuid;
+
+@end
+
+@implementation SSHAgentCachedKey
+
+- (instancetype)initWithKey:(struct sshkey*)key databaseUuid:(NSString*)databaseUuid {
+    self = [super init];
+
+    if (self) {
+        _key = key;
+        _databaseUuid = databaseUuid;
+
+
+
+        if ( sshkey_shield_private(key) != 0 ) {
+            NSLog(@"⚠️ SSHAgentKeyCache: Could not shield private key in memory");
+        }
+
+        [self lockPages:YES];
+    }
+
+    return self;
+}
+
+- (void)lockPages:(BOOL)lock {
+    if ( self.key->shield_prekey ) {
+        lock ? mlock(self.key->shield_prekey, self.key->shield_prekey_len) : munlock(self.key->shield_prekey, self.key->shield_prekey_len);
+    }
+
+    if ( self.key->shielded_private ) {
+        lock ? mlock(self.key->shielded_private, self.key->shielded_len) : munlock(self.key->shielded_private, self.key->shielded_len);
+    }
+}
+
+- (NSData*)sign:(NSData*)challenge flags:(u_int)flags {
+
+
+    @synchronized (self) {
+        [self lockPages:NO];
+
+        NSData* sig = [OpenSSHPrivateKey sign:challenge key:self.key flags:flags];
+
+        [self lockPages:YES];
+
+        return sig;
+    }
+}
+
+- (void)dealloc {
+    [self lockPages:NO];
+    sshkey_free(_key);
+}
+
+@end
+
+@interface SSHAgentKeyCache ()
+
+@property ConcurrentMutableDictionary<NSData*, SSHAgentCachedKey*>* keys;
+
+@end
+
+@implementation SSHAgentKeyCache
+
++ (instancetype)sharedInstance {
+    static SSHAgentKeyCache *sharedInstance = nil;
+    static dispatch_once_t onceToken;
+
+    dispatch_once(&onceToken, ^{
+        sharedInstance = [[SSHAgentKeyCache alloc] init];
+    });
+
+    return sharedInstance;
+}
+
+- (instancetype)init {
+    self = [super init];
+
+    if (self) {
+        _keys = ConcurrentMutableDictionary.mutableDictionary;
+
+        [NSNotificationCenter.defaultCenter addObserver:self
+                                               selector:@selector(onLockStateChanged:)
+                                                   name:kDatabasesCollectionLockStateChangedNotification
+                                                 object:nil];
+    }
+
+    return self;
+}
+
+- (void)onLockStateChanged:(NSNotification*)notification {
+    NSString* databaseUuid = notification.object;
+
+    if ( ![databaseUuid isKindOfClass:NSString.class] ) {
+        return;
+    }
+
+    if ( ![DatabasesCollection.shared isUnlockedWithUuid:databaseUuid] ) {
+        [self clearDatabase:databaseUuid];
+    }
+}
+
+- (NSUInteger)count {
+    return self.keys.count;
+}
+
+- (void)clearDatabase:(NSString *)databaseUuid {
+    for ( NSData* identifier in self.keys.allKeys ) {
+        if ( [self.keys[identifier].databaseUuid isEqualToString:databaseUuid] ) {
+            [self.keys removeObjectForKey:identifier];
+        }
+    }
+}
+
+- (void)clearAll {
+    [self.keys removeAllObjects];
+}
+
+- (NSData*)sign:(NSData *)challenge
+            key:(OpenSSHPrivateKey *)key
+     passphrase:(NSString *)passphrase
+          flags:(u_int)flags
+   databaseUuid:(NSString *)databaseUuid {
+    NSData* identifier = [self identifierForKey:key passphrase:passphrase databaseUuid:databaseUuid];
+
+    SSHAgentCachedKey* cached = self.keys[identifier];
+
+    if ( cached == nil ) {
+        struct sshkey* parsed = [key parsePrivateKey:passphrase];
+        if ( parsed == NULL ) {
+            return nil;
+        }
+
+        cached = [[SSHAgentCachedKey alloc] initWithKey:parsed databaseUuid:databaseUuid];
+        self.keys[identifier] = cached;
+    }
+
+    return [cached sign:challenge flags:flags];
+}
+
+- (NSData*)identifierForKey:(OpenSSHPrivateKey *)key passphrase:(NSString *)passphrase databaseUuid:(NSString *)databaseUuid {
+
+
+    NSData* pw = [passphrase dataUsingEncoding:NSUTF8StringEncoding];
+    NSData* blob = key.data;
+    NSData* db = [databaseUuid dataUsingEncoding:NSUTF8StringEncoding];
+
+    CCHmacContext ctx;
+    CCHmacInit(&ctx, kCCHmacAlgSHA256, pw.bytes, pw.length);
+    CCHmacUpdate(&ctx, db.bytes, db.length);
+    CCHmacUpdate(&ctx, blob.bytes, blob.length);
+
+    NSMutableData* ret = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+    CCHmacFinal(&ctx, ret.mutableBytes);
+
+    return ret;
+}
+
+@end
@@ -46,17 +46,63 @@ class SSHAgentRequestHandler: NSObject {
 
     }
 
+    let identityIndex: SSHAgentIdentityIndex
+
     override private init() {
+        identityIndex = SSHAgentIdentityIndex(unlockedDatabases: {
+            MacDatabasePreferences.allDatabases.compactMap { meta in
+                guard let model = DatabasesCollection.shared.getUnlocked(uuid: meta.uuid) else {
+                    return nil
+                }
+
+                return (uuid: meta.uuid, entries: { model.keeAgentSSHKeyEntries })
+            }
+        }, offlinePublicKeys: {
+            Array(SSHAgentRequestHandler.loadOfflinePublicKeys().keys)
+        })
+
         super.init()
+
+        listenToDatabaseChanges()
+    }
+
+    @objc var identityIndexVersion: Int {
+        identityIndex.version
+    }
+
+    @objc public func invalidateIdentities(databaseUuid: String) {
+        identityIndex.invalidate(databaseUuid: databaseUuid)
+    }
+
+    private func listenToDatabaseChanges() {
+        NotificationCenter.default.addObserver(forName: .DatabasesCollection.lockStateChanged, object: nil, queue: nil) { [weak self] notification in
+            guard let self, let uuid = notification.object as? String else { return }
+
+            self.identityIndex.invalidate(databaseUuid: uuid)
+        }
+
+        NotificationCenter.default.addObserver(forName: NSNotification.Name(kDatabaseReloadedNotificationKey), object: nil, queue: nil) { [weak self] notification in
+            guard let self else { return }
+
+            if let uuid = notification.object as? String {
+                self.identityIndex.invalidate(databaseUuid: uuid)
+            } else {
+                self.identityIndex.invalidateAll()
+            }
+        }
     }
 
     var signRequests = ConcurrentCircularBuffer<SSHAgentSignRequest>(capacity: 512)
 
-    var rawApprovals: [SSHAgentApproval] = []
+    private let stateQueue = DispatchQueue(label: "SSHAgentRequestHandler")
+    private let authorizationQueue = DispatchQueue(label: "SSHAgentRequestHandler-Authorization")
+
+    private var rawApprovals: [SSHAgentApproval] = []
+    private var rawRecentUnlockFailure: Date? = nil
 
     var approvals: [SSHAgentApproval] {
-        get {
-            let ret = rawApprovals.filter { approval in
+        stateQueue.sync {
+            rawApprovals = rawApprovals.filter { approval in
                 if case let .timed(time: date) = approval.expiry {
                     return (date as NSDate).isInFuture
                 } else {
@@ -64,12 +110,16 @@ class SSHAgentRequestHandler: NSObject {
                 }
             }
 
-            rawApprovals = ret
+            return rawApprovals
+        }
+    }
 
-            return ret
+    var recentUnlockFailure: Date? {
+        get {
+            stateQueue.sync { rawRecentUnlockFailure }
         }
         set {
-            rawApprovals = newValue
+            stateQueue.sync { rawRecentUnlockFailure = newValue }
         }
     }
 
@@ -95,7 +145,10 @@ class SSHAgentRequestHandler: NSObject {
         }
 
         let approval = SSHAgentApproval(processName: processName, processId: processId, expiry: expiry)
-        approvals.append(approval)
+
+        stateQueue.sync {
+            rawApprovals.append(approval)
+        }
     }
 
     @objc
@@ -119,13 +172,21 @@ class SSHAgentRequestHandler: NSObject {
         }
 
         SecretStore.sharedInstance().setSecureObject(pkMap, forIdentifier: Constants.SecureOfflinePkMapKey)
+
+        identityIndex.invalidate(databaseUuid: databaseUuid)
     }
 
     @objc public func clearAllOfflinePublicKeys() {
         SecretStore.sharedInstance().deleteSecureItem(Constants.SecureOfflinePkMapKey)
+
+        identityIndex.invalidateMerged()
     }
 
     public func getOfflinePublicKeys() -> [Data: String] {
+        SSHAgentRequestHandler.loadOfflinePublicKeys()
+    }
+
+    private static func loadOfflinePublicKeys() -> [Data: String] {
         if let map = SecretStore.sharedInstance().getSecureObject(Constants.SecureOfflinePkMapKey),
            let typed = map as? [Data: String]
         {
@@ -137,70 +198,33 @@ class SSHAgentRequestHandler: NSObject {
 
     @objc
     public func getKnownPublicKeys() -> [Data] {
-
-
-        let unlockedDatabases = MacDatabasePreferences.allDatabases.filter { database in
-            DatabasesCollection.shared.isUnlocked(uuid: database.uuid)
-        }
-
-        var used: Set<Data> = []
-        var ret: [Data] = []
-        for meta in unlockedDatabases {
-            guard let model = DatabasesCollection.shared.getUnlocked(uuid: meta.uuid) else {
-                continue
-            }
-
-            for node in model.keeAgentSSHKeyEntries {
-                guard let kaKey = node.keeAgentSshKeyViewModel, kaKey.enabled else {
-                    continue
-                }
-                let key = kaKey.openSshKey
-
-                
-
-                let pkBlob = key.publicKeySerializationBlob
-                if !used.contains(pkBlob) {
-                    ret.append(pkBlob)
-                    used.insert(pkBlob)
-                }
-            }
-        }
-
-        
-
-        let offlinePks = getOfflinePublicKeys().keys
-        for pkBlob in offlinePks {
-            if !used.contains(pkBlob) {
-                ret.append(pkBlob)
-                used.insert(pkBlob)
-            }
-        }
-
-        return ret
+        identityIndex.knownPublicKeys
     }
 
     @objc
     public func signChallenge(_ challenge: Data, requestedKeyBlobB64: String, processName: String?, processId: String?, flags: u_int) -> Data? {
-        if let (node, databaseUuid) = getNodeBySerializationBlobBase64(requestedKeyBlobB64) {
-            return signChallengeWithNode(node, databaseUuid, challenge, requestedKeyBlobB64: requestedKeyBlobB64, processName: processName, processId: processId, flags: flags)
+        if let identity = identityIndex.identity(blobBase64: requestedKeyBlobB64) {
+            return signChallengeWithIdentity(identity, challenge, processName: processName, processId: processId, flags: flags)
         } else if Settings.sharedInstance().sshAgentRequestDatabaseUnlockAllowed {
             NSLog("Could not find requested key in Unlocked Databases to sign in with... Checking Offline Map")
 
-            guard let (node, databaseUuid) = getNodeFromOfflinePublicKeyWithUnlock(requestedKeyBlobB64, processName: processName) else {
+            let unlocked = authorizationQueue.sync {
+                getIdentityFromOfflinePublicKeyWithUnlock(requestedKeyBlobB64, processName: processName)
+            }
+
+            guard let identity = unlocked else {
                 NSLog("🔴 Unsuccessful Unlock or find the request key in the unlocked database")
                 return nil
             }
 
-            return signChallengeWithNode(node, databaseUuid, challenge, requestedKeyBlobB64: requestedKeyBlobB64, processName: processName, processId: processId, flags: flags, preAuthorized: true)
+            return signChallengeWithIdentity(identity, challenge, processName: processName, processId: processId, flags: flags, preAuthorized: true)
         } else {
             NSLog("Could not find requested key in Unlocked Databases and not allowed to request Unlock.")
             return nil
         }
     }
 
-    var recentUnlockFailure: Date? = nil
-
-    private func getNodeFromOfflinePublicKeyWithUnlock(_ requestedKeyBlobB64: String, processName: String?) -> (Node, String)? {
+    private func getIdentityFromOfflinePublicKeyWithUnlock(_ requestedKeyBlobB64: String, processName: String?) -> SSHAgentIdentity? {
         let offlinePks = getOfflinePublicKeys()
 
         guard let requestKeyData = requestedKeyBlobB64.dataFromBase64,
@@ -249,29 +273,40 @@ class SSHAgentRequestHandler: NSObject {
                 NSApp.hide(nil)
             }
 
-            return getNodeBySerializationBlobBase64(requestedKeyBlobB64)
+            return identityIndex.identity(blobBase64: requestedKeyBlobB64)
         } else {
             recentUnlockFailure = Date()
             return nil
         }
     }
 
-    private func signChallengeWithNode(_ node: Node, _ databaseUuid: String, _ challenge: Data, requestedKeyBlobB64 _: String, processName: String?, processId: String?, flags: u_int, preAuthorized: Bool = false) -> Data? {
-        
+    private func signChallengeWithIdentity(_ identity: SSHAgentIdentity, _ challenge: Data, processName: String?, processId: String?, flags: u_int, preAuthorized: Bool = false) -> Data? {
+        let node = identity.node
+        let databaseUuid = identity.databaseUuid
+
+        let approved = authorizationQueue.sync {
+            guard requiresApproval(processName) else {
+                return true
+            }
 
-        if requiresApproval(processName) {
             if !preAuthorized {
                 guard requestSignatureAuthorization(node, processName: processName) else {
-                    NSLog("⚠️ Authorization Denied - Will not sign request")
-
-                    signRequests.add(SSHAgentSignRequest(processName: processName, processId: processId, databaseUuid: databaseUuid, nodeId: node.uuid, approved: false, timestamp: Date()))
-
-                    return nil
+                    return false
                 }
             }
 
             addApproval(processName ?? NSLocalizedString("generic_unknown", comment: "Unknown"),
                         processId: processId ?? NSLocalizedString("generic_unknown", comment: "Unknown"))
+
+            return true
+        }
+
+        guard approved else {
+            NSLog("⚠️ Authorization Denied - Will not sign request")
+
+            signRequests.add(SSHAgentSignRequest(processName: processName, processId: processId, databaseUuid: databaseUuid, nodeId: node.uuid, approved: false, timestamp: Date()))
+
+            return nil
         }
 
         signRequests.add(SSHAgentSignRequest(processName: processName,
@@ -283,37 +318,7 @@ class SSHAgentRequestHandler: NSObject {
 
         
 
-        guard let kaKey = node.keeAgentSshKeyViewModel, kaKey.enabled else {
-            return nil
-        }
-        let theKey = kaKey.openSshKey
-
-        return theKey.sign(challenge, passphrase: node.fields.password, flags: flags)
-    }
-
-    private func getNodeBySerializationBlobBase64(_ blobBase64: String) -> (Node, String)? {
-        let unlockedDatabases = MacDatabasePreferences.allDatabases.filter { database in
-            DatabasesCollection.shared.isUnlocked(uuid: database.uuid)
-        }
-
-        for meta in unlockedDatabases {
-            guard let model = DatabasesCollection.shared.getUnlocked(uuid: meta.uuid) else {
-                continue
-            }
-
-            for node in model.keeAgentSSHKeyEntries {
-                guard let kaKey = node.keeAgentSshKeyViewModel, kaKey.enabled else {
-                    continue
-                }
-                let theKey = kaKey.openSshKey
-
-                if theKey.publicKeySerializationBlobBase64 == blobBase64 {
-                    return (node, meta.uuid)
-                }
-            }
-        }
-
-        return nil
+        return SSHAgentKeyCache.sharedInstance().sign(challenge, key: identity.key, passphrase: node.fields.password, flags: flags, databaseUuid: databaseUuid)
     }
 
     private func requestSignatureAuthorization(_ node: Node, processName: String?) -> Bool {
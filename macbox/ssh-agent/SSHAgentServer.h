@@ -13,6 +13,7 @@ NS_ASSUME_NONNULL_BEGIN
 @interface SSHAgentServer : NSObject
 
 + (instancetype)sharedInstance;
+- (instancetype)initWithSocketPath:(NSString*)socketPath; 
 
 - (void)stop;
 - (BOOL)start; 
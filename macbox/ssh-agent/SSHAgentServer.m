@@ -16,6 +16,7 @@
 #include <sys/ucred.h>
 
 #include <errno.h>
+#include <fcntl.h>
 #import "NSData+Extensions.h"
 #import "NSString+Extensions.h"
 
@@ -35,6 +36,11 @@
 
 
 @property int server_sock;
+@property (nullable) dispatch_source_t acceptSource;
+@property NSMutableSet<dispatch_source_t>* clientSources;
+@property (nullable) NSString* socketPathOverride;
+@property (nullable) NSData* cachedIdentitiesResponse;
+@property NSInteger cachedIdentitiesVersion;
 
 @property (readonly) NSString* symlinkFullPath;
 @property (readonly) NSString* symlinkWithTildeInPath;
@@ -43,6 +49,8 @@
 
 static NSString* const kSocketFileName = @"agent.sock";
 static NSString* const kSymlinkDirectory = @".strongbox";
+static const uint32_t kMaxMessageLength = 256 * 1024; 
+static const size_t kReadChunkSize = 16 * 1024;
 
 @implementation SSHAgentServer
 
@@ -57,6 +65,27 @@ static NSString* const kSymlinkDirectory = @".strongbox";
     return sharedInstance;
 }
 
+- (instancetype)init {
+    self = [super init];
+    
+    if (self) {
+        _server_sock = -1;
+        _clientSources = NSMutableSet.set;
+    }
+    
+    return self;
+}
+
+- (instancetype)initWithSocketPath:(NSString *)socketPath {
+    self = [self init];
+    
+    if (self) {
+        _socketPathOverride = socketPath;
+    }
+    
+    return self;
+}
+
 - (NSString *)symlinkFullPath {
     NSURL* home = [Utils userHomeDirectoryEvenInSandbox];
     NSString* homePath = home.path;
@@ -166,6 +195,10 @@ static NSString* const kSymlinkDirectory = @".strongbox";
 - (NSString*)getSocketPath {
     static const int MAX_PATH = 103;
     
+    if ( self.socketPathOverride ) {
+        return self.socketPathOverride;
+    }
+    
     NSURL* url = [NSFileManager.defaultManager containerURLForSecurityApplicationGroupIdentifier:@"group.strongbox.mac.mcguill"];
     
     
@@ -198,15 +231,22 @@ static NSString* const kSymlinkDirectory = @".strongbox";
     
     
     
-    if ( self.server_sock != -1 ) {
+    if ( self.acceptSource ) {
+        dispatch_source_cancel(self.acceptSource); 
+        self.acceptSource = nil;
+    }
+    else if ( self.server_sock != -1 ) {
         shutdown(self.server_sock, SHUT_RDWR);
         close(self.server_sock);
-        self.server_sock = -1;
     }
     
+    self.server_sock = -1;
     
-    
-    
+    @synchronized (self.clientSources) {
+        for ( dispatch_source_t client in self.clientSources.allObjects ) {
+            dispatch_source_cancel(client);
+        }
+    }
     
     _isRunning = NO;
 }
@@ -273,38 +313,48 @@ static NSString* const kSymlinkDirectory = @".strongbox";
         return NO;
     }
     
-    [NSThread detachNewThreadWithBlock:^{
-        [self acceptNewConnections];
-    }];
+    int flags = fcntl(self.server_sock, F_GETFL);
+    if ( flags == -1 || fcntl(self.server_sock, F_SETFL, flags | O_NONBLOCK) == -1 ) {
+        NSLog(@"🔴 Error setting socket non blocking: %s\n", strerror(errno));
+        return NO;
+    }
     
-
+    int sock = self.server_sock;
+    dispatch_queue_t acceptQueue = dispatch_queue_create("SSHAgentServer-Accept", DISPATCH_QUEUE_SERIAL);
+    
+    self.acceptSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, sock, 0, acceptQueue);
+    
+    __weak SSHAgentServer* weakSelf = self;
+    dispatch_source_set_event_handler(self.acceptSource, ^{
+        [weakSelf acceptNewConnections:sock];
+    });
+    dispatch_source_set_cancel_handler(self.acceptSource, ^{
+        shutdown(sock, SHUT_RDWR);
+        close(sock);
+    });
+    
+    dispatch_resume(self.acceptSource);
     
     _isRunning = YES;
     return YES;
 }
 
-- (void)acceptNewConnections {
+- (void)acceptNewConnections:(int)serverSocket {
     while ( 1 ) {
-
-        
-        int socket = accept (self.server_sock, NULL, NULL);
+        int socket = accept (serverSocket, NULL, NULL);
         
         if ( socket == -1 ) {
-            NSLog(@"⚠️ SSHAgentServer failed to accept new connection (possibly due to shutdown...)");
+            if ( errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR ) {
+                NSLog(@"⚠️ SSHAgentServer failed to accept new connection (possibly due to shutdown...)");
+            }
             break;
         }
         
-
-        
-
-        [self handleNewConnection:socket]; 
-
+        [self handleNewConnection:socket];
     }
-    
-    
 }
 
-- (void)sendResponse:(NSOutputStream*)outputStream response:(NSData*)response {
+- (BOOL)sendResponse:(int)socket response:(NSData*)response {
     
     
     uint32_t messageLength = (uint32_t)response.length; 
@@ -315,16 +365,35 @@ static NSString* const kSymlinkDirectory = @".strongbox";
     [wrapped appendBytes:&bigEndianLength length:4];
     [wrapped appendData:response];
     
-    [outputStream write:wrapped.bytes maxLength:wrapped.length];
+    const uint8_t* bytes = wrapped.bytes;
+    size_t remaining = wrapped.length;
+    
+    while ( remaining > 0 ) {
+        ssize_t written = write(socket, bytes, remaining);
+        
+        if ( written < 0 ) {
+            if ( errno == EINTR ) {
+                continue;
+            }
+            
+            NSLog(@"⚠️ SSHAgentServer write error: %s", strerror(errno));
+            return NO;
+        }
+        
+        bytes += written;
+        remaining -= written;
+    }
+    
+    return YES;
 }
 
-- (void)sendUnsupportedRequestResponse:(NSOutputStream*)outputStream {
+- (BOOL)sendUnsupportedRequestResponse:(int)socket {
     
     
     uint8_t resp[] = { SSH_AGENT_FAILURE };
     
     NSData* data = [NSData dataWithBytes:resp length:1];
-    [self sendResponse:outputStream response:data];
+    return [self sendResponse:socket response:data];
 }
 
 - (pid_t)getSocketCallerPid:(int)socket {
@@ -381,91 +450,127 @@ static NSString* const kSymlinkDirectory = @".strongbox";
 }
 
 - (void)handleNewConnection:(int)socket {
+    
 
-
-    CFReadStreamRef readStream;
-    CFWriteStreamRef writeStream;
-    CFStreamCreatePairWithSocket (kCFAllocatorDefault, socket, &readStream, &writeStream);
+    int flags = fcntl(socket, F_GETFL);
+    if ( flags != -1 ) {
+        fcntl(socket, F_SETFL, flags & ~O_NONBLOCK);
+    }
     
-    NSInputStream *inputStream = (__bridge_transfer NSInputStream *)readStream;
-    NSOutputStream *outputStream = (__bridge_transfer NSOutputStream *)writeStream;
+    int on = 1;
+    setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
     
-    [outputStream open];
-    [inputStream open];
+    dispatch_queue_t queue = dispatch_queue_create("SSHAgentServer-Client", DISPATCH_QUEUE_SERIAL);
+    dispatch_source_t source = dispatch_source_create(DISPATCH_SOURCE_TYPE_READ, socket, 0, queue);
     
-    do {
-        NSData* response;
-        BOOL success = [self readFromInputStream:inputStream response:&response socket:socket];
-        if ( !success ) {
-            break;
+    NSMutableData* pending = NSMutableData.data;
+    
+    __weak SSHAgentServer* weakSelf = self;
+    __weak dispatch_source_t weakSource = source;
+    
+    dispatch_source_set_event_handler(source, ^{
+        if ( ![weakSelf onClientReadable:socket pending:pending] ) {
+            dispatch_source_cancel(weakSource);
         }
+    });
+    
+    dispatch_source_set_cancel_handler(source, ^{
+        shutdown(socket, SHUT_RDWR);
+        close(socket);
         
-        if ( response == nil ) {
-            [self sendUnsupportedRequestResponse:outputStream];
-        }
-        else {
-            [self sendResponse:outputStream response:response];
+        SSHAgentServer* strongSelf = weakSelf;
+        dispatch_source_t strongSource = weakSource;
+        if ( strongSelf && strongSource ) {
+            @synchronized (strongSelf.clientSources) {
+                [strongSelf.clientSources removeObject:strongSource];
+            }
         }
-    } while ( YES );
-        
-    [inputStream close];
-    [outputStream close];
-    shutdown(socket, SHUT_RDWR);
-    close(socket);
+    });
     
+    @synchronized (self.clientSources) {
+        [self.clientSources addObject:source];
+    }
     
+    dispatch_resume(source);
 }
 
-- (BOOL)readFromInputStream:(NSInputStream*)inputStream response:(NSData**)response socket:(int)socket {
-    uint32_t length;
-    if ( [inputStream read:((uint8_t*)(&length)) maxLength:sizeof(uint32_t)] != sizeof(uint32_t)) {
-        
-        return NO;
-    }
-    
-    length = CFSwapInt32BigToHost(length);
+- (BOOL)onClientReadable:(int)socket pending:(NSMutableData*)pending {
+    uint8_t buf[kReadChunkSize];
     
-    
-    
-    uint8_t requestId;
-    if ( [inputStream read:&requestId maxLength:sizeof(uint8_t)] != sizeof(uint8_t)) {
-        NSLog(@"🔴 read error - could not read request id!");
-        return NO;
+    ssize_t bytesRead = read(socket, buf, kReadChunkSize);
+    if ( bytesRead == 0 ) {
+        return NO; 
     }
-
     
+    if ( bytesRead < 0 ) {
+        return errno == EINTR || errno == EAGAIN;
+    }
     
-    uint32_t messageLength = length - 1;
-    NSMutableData* message = [NSMutableData dataWithLength:messageLength];
+    [pending appendBytes:buf length:bytesRead];
     
-    if ( messageLength > 0 ) {
-        if ( [inputStream read:message.mutableBytes maxLength:messageLength] != messageLength) {
-            NSLog(@"🔴 read error - could not message after length and id...");
+    while ( pending.length >= sizeof(uint32_t) ) {
+        uint32_t length;
+        [pending getBytes:&length length:sizeof(uint32_t)];
+        length = CFSwapInt32BigToHost(length);
+        
+        if ( length == 0 || length > kMaxMessageLength ) {
+            NSLog(@"🔴 read error - invalid message length %u", length);
             return NO;
         }
         
+        if ( pending.length < sizeof(uint32_t) + length ) {
+            break; 
+        }
+        
+        
+        
+        uint8_t requestId = ((const uint8_t*)pending.bytes)[sizeof(uint32_t)];
+        NSData* message = [pending subdataWithRange:NSMakeRange(sizeof(uint32_t) + 1, length - 1)];
+        
+        [pending replaceBytesInRange:NSMakeRange(0, sizeof(uint32_t) + length) withBytes:NULL length:0];
         
+        NSData* response = [self getResponse:requestId message:message socket:socket];
+        
+        BOOL sent = response == nil ? [self sendUnsupportedRequestResponse:socket] : [self sendResponse:socket response:response];
+        if ( !sent ) {
+            return NO;
+        }
     }
     
+    return YES;
+}
+
+- (NSData*)getResponse:(uint8_t)requestId message:(NSData*)message socket:(int)socket {
     switch ( requestId ) {
         case SSH2_AGENTC_REQUEST_IDENTITIES:
-
-            *response = [self getRequestIdentitiesResponse];
-            return YES;
-            break;
+            return [self getRequestIdentitiesResponse];
         case SSH2_AGENTC_SIGN_REQUEST:
-
-            *response = [self getSignRequestResponse:message socket:socket];
-            return YES;
-            break;
+            return [self getSignRequestResponse:message socket:socket];
         default:
-
-            *response = nil;
-            return YES;
+            return nil;
     }
 }
 
 - (NSData*)getRequestIdentitiesResponse {
+    NSInteger version = SSHAgentRequestHandler.shared.identityIndexVersion;
+    
+    @synchronized (self) {
+        if ( self.cachedIdentitiesResponse && self.cachedIdentitiesVersion == version ) {
+            return self.cachedIdentitiesResponse;
+        }
+    }
+    
+    NSData* response = [self buildRequestIdentitiesResponse];
+    
+    @synchronized (self) {
+        self.cachedIdentitiesResponse = response;
+        self.cachedIdentitiesVersion = version;
+    }
+    
+    return response;
+}
+
+- (NSData*)buildRequestIdentitiesResponse {
     struct sshbuf *msg, *keys;
     if ((msg = sshbuf_new()) == NULL || (keys = sshbuf_new()) == NULL) {
         NSLog(@"🔴 Could not create buffers");
@@ -570,10 +675,13 @@ static NSString* const kSymlinkDirectory = @".strongbox";
 
     pid_t pid = [self getSocketCallerPid:socket];
     
+    NSString* processName = [self getSocketCallerId:socket];
+    NSString* processId = pid == -1 ? nil : @(pid).stringValue;
+    
     NSData* signatureData = [SSHAgentRequestHandler.shared signChallenge:challengeData
                                                      requestedKeyBlobB64:publicKeyBlob.base64String
-                                                             processName:[self getSocketCallerId:socket]
-                                                               processId:pid == -1 ? nil : @(pid).stringValue
+                                                             processName:processName
+                                                               processId:processId
                                                                    flags:flags];
     
     if ( signatureData == nil ) {
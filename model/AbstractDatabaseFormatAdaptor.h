@@ -10,6 +10,7 @@
 #import "Node.h"
 #import "CompositeKeyFactors.h"
 #import "DatabaseModel.h"
+#import "SerializationMetrics.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -28,9 +29,11 @@ typedef void (^SaveCompletionBlock)(BOOL userCancelled, NSString*_Nullable debug
          ckf:(CompositeKeyFactors*)ckf
 xmlDumpStream:(NSOutputStream*_Nullable)xmlDumpStream
 sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+     metrics:(SerializationMetrics*_Nullable)metrics
   completion:(OpenCompletionBlock)completion;
 
 + (void)save:(DatabaseModel*)database outputStream:(NSOutputStream*)outputStream completion:(SaveCompletionBlock)completion;
++ (void)save:(DatabaseModel*)database outputStream:(NSOutputStream*)outputStream metrics:(SerializationMetrics*_Nullable)metrics completion:(SaveCompletionBlock)completion;
 
 @property (nonatomic, class, readonly) DatabaseFormat format;
 @property (nonatomic, class, readonly) NSString* fileExtension;
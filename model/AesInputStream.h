@@ -10,10 +10,15 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+extern const size_t kAesStreamDefaultChunkSize;
+
 @interface AesInputStream : NSInputStream
 
 - (instancetype)init NS_UNAVAILABLE;
 - (instancetype)initWithStream:(NSInputStream*)inputStream key:(NSData*)key iv:(NSData*)iv;
+- (instancetype)initWithStream:(NSInputStream*)inputStream key:(NSData*)key iv:(NSData*)iv chunkSize:(size_t)chunkSize;
+
+@property (readonly) size_t chunkSize;
 
 @end
 
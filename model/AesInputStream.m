@@ -9,46 +9,59 @@
 #import "AesInputStream.h"
 #import <CommonCrypto/CommonCrypto.h>
 #import "Utils.h"
-#import "Constants.h"
+
+const size_t kAesStreamDefaultChunkSize = 1024 * 1024;
+
+static const size_t kMinimumDirectDecryptLength = 16 * 1024;
 
 @interface AesInputStream ()
 
 @property NSInputStream* inputStream;
 @property CCCryptorRef *cryptor;
-@property uint8_t* workChunk;
-@property size_t workChunkLength;
-@property size_t workingChunkOffset;
-@property size_t readFromStreamTotal;
-@property size_t writtenSoFar;
-@property size_t writtenToStreamSoFar;
+@property size_t chunkSize;
 
-@property NSError* error;
+@property uint8_t* cipherBuffer;
+@property uint8_t* plainBuffer;
+@property size_t plainLength;
+@property size_t plainOffset;
 
-@property BOOL lastReadZeroBytes;
+@property BOOL finished;
+@property NSError* error;
 
 @end
 
 @implementation AesInputStream
 
 - (instancetype)initWithStream:(NSInputStream*)inputStream key:(NSData*)key iv:(NSData*)iv {
+    return [self initWithStream:inputStream key:key iv:iv chunkSize:kAesStreamDefaultChunkSize];
+}
+
+- (instancetype)initWithStream:(NSInputStream *)inputStream key:(NSData *)key iv:(NSData *)iv chunkSize:(size_t)chunkSize {
     self = [super init];
     if (self) {
         self.inputStream = inputStream;
+        self.chunkSize = MAX(kCCBlockSizeAES128, chunkSize - (chunkSize % kCCBlockSizeAES128));
         
         _cryptor = malloc(sizeof(CCCryptorRef));
         
         CCCryptorStatus status = CCCryptorCreate(kCCDecrypt, kCCAlgorithmAES, kCCOptionPKCS7Padding, key.bytes, kCCKeySizeAES256, iv.bytes, _cryptor);
         if (status != kCCSuccess) {
             NSLog(@"Crypto Error: %d", status);
+            free(_cryptor);
+            _cryptor = nil;
             return nil;
         }
-        self.workingChunkOffset = 0;
-        self.workChunk = nil;
-        self.workChunkLength = 0;
+        
+        self.cipherBuffer = malloc(self.chunkSize);
+        self.plainBuffer = malloc(self.chunkSize + kCCBlockSizeAES128);
     }
     return self;
 }
 
+- (void)dealloc {
+    [self releaseResources];
+}
+
 - (void)open {
     [self.inputStream open];
 }
@@ -56,10 +69,23 @@
 - (void)close {
     [self.inputStream close];
     
-    if (self.workChunk) {
-        free(self.workChunk);
-        self.workChunk = nil;
+    [self releaseResources];
+}
+
+- (void)releaseResources {
+    if (self.plainBuffer) {
+        memset(self.plainBuffer, 0, self.chunkSize + kCCBlockSizeAES128);
+        free(self.plainBuffer);
+        self.plainBuffer = nil;
+    }
+    
+    if (self.cipherBuffer) {
+        free(self.cipherBuffer);
+        self.cipherBuffer = nil;
     }
+    
+    self.plainLength = 0;
+    self.plainOffset = 0;
 
     if (self.cryptor) {
         CCCryptorRelease(*_cryptor);
@@ -69,108 +95,107 @@
 }
 
 - (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
-    if (self.workChunk != nil && self.workChunkLength == 0) { 
-        return 0L;
+    if ( self.error ) {
+        return -1L;
     }
     
-    size_t bufferOffset = 0;
     size_t bufferWritten = 0;
         
     while ( bufferWritten < len ) {
-        size_t workingAvailable = self.workChunkLength - self.workingChunkOffset;
-
-        if (workingAvailable == 0) {
-            [self loadNextWorkingChunk];
+        size_t plainAvailable = self.plainLength - self.plainOffset;
+        
+        if ( plainAvailable > 0 ) {
+            size_t bytesToWrite = MIN(plainAvailable, len - bufferWritten);
+            
+            memcpy(&buffer[bufferWritten], &self.plainBuffer[self.plainOffset], bytesToWrite);
+            
+            bufferWritten += bytesToWrite;
+            self.plainOffset += bytesToWrite;
+            continue;
+        }
+        
+        if ( self.finished ) {
+            break;
+        }
+        
+        if ( self.cryptor == nil ) {
+            self.error = [Utils createNSError:@"AES: Stream is closed" errorCode:-1];
+            return -1L;
+        }
         
-            if (self.workChunk == nil) {
+        size_t bufferAvailable = len - bufferWritten;
+        size_t directLength = [self directDecryptLength:bufferAvailable];
+        
+        if ( directLength ) {
+            NSInteger decrypted = [self decryptNext:directLength into:&buffer[bufferWritten] capacity:bufferAvailable];
+            if ( decrypted < 0 ) {
                 return -1L;
             }
-        
-            workingAvailable = self.workChunkLength - self.workingChunkOffset;
-            if ( workingAvailable == 0 && self.lastReadZeroBytes ) {
-                return bufferWritten; 
+            
+            bufferWritten += decrypted;
+        }
+        else {
+            NSInteger decrypted = [self decryptNext:self.chunkSize into:self.plainBuffer capacity:self.chunkSize + kCCBlockSizeAES128];
+            if ( decrypted < 0 ) {
+                return -1L;
             }
+            
+            self.plainOffset = 0;
+            self.plainLength = decrypted;
         }
-
-        size_t bufferAvailable = len - bufferOffset;
-        size_t bytesToWrite = MIN(workingAvailable, bufferAvailable);
-
-        uint8_t* src = &self.workChunk[self.workingChunkOffset];
-        uint8_t* dst = &buffer[bufferOffset];
-
-        memcpy(dst, src, bytesToWrite);
-    
-        self.writtenToStreamSoFar += bytesToWrite;
-        
-
-        bufferWritten += bytesToWrite;
-        bufferOffset += bytesToWrite;
-        self.workingChunkOffset += bytesToWrite;
     }
         
     return bufferWritten;
 }
 
-- (void)loadNextWorkingChunk {
-    self.workChunkLength = 0;
-    self.workingChunkOffset = 0;
-    
-    uint8_t *block = malloc(kStreamingSerializationChunkSize);
-    NSInteger bytesRead = [self.inputStream read:block maxLength:kStreamingSerializationChunkSize];
-    if (bytesRead < 0) {
-        self.error = self.inputStream.streamError;
-        self.workChunk = nil;
-        self.workChunkLength = 0;
-        free(block);
-        return;
+- (size_t)directDecryptLength:(size_t)bufferAvailable {
+    if ( bufferAvailable < kMinimumDirectDecryptLength ) {
+        return 0;
     }
     
-    self.readFromStreamTotal += bytesRead;
+    // The cryptor holds back a block until it knows it isn't the padded final one, so leave room for it.
+    size_t length = MIN(self.chunkSize, (bufferAvailable - kCCBlockSizeAES128) & ~(kCCBlockSizeAES128 - 1));
+    
+    return CCCryptorGetOutputLength(*self.cryptor, length, NO) <= bufferAvailable ? length : 0;
+}
 
-    if (self.workChunk == nil) {
-        self.workChunk = malloc(kStreamingSerializationChunkSize);
+- (NSInteger)decryptNext:(size_t)length into:(uint8_t*)dst capacity:(size_t)capacity {
+    NSInteger bytesRead = [self.inputStream read:self.cipherBuffer maxLength:length];
+    if (bytesRead < 0) {
+        self.error = self.inputStream.streamError ? self.inputStream.streamError : [Utils createNSError:@"AES: Could not read from inner stream" errorCode:-1];
+        return -1L;
     }
-
+    
+    size_t decrypted = 0;
+    
     if ( bytesRead > 0 ) {
-        CCCryptorStatus status = CCCryptorUpdate(*self.cryptor, block, bytesRead, self.workChunk, kStreamingSerializationChunkSize, &_workChunkLength);
+        CCCryptorStatus status = CCCryptorUpdate(*self.cryptor, self.cipherBuffer, bytesRead, dst, capacity, &decrypted);
         
         if (status != kCCSuccess) {
             NSLog(@"Crypto Error: %d", status);
             self.error = [Utils createNSError:@"AES: Crypto Error" errorCode:status];
-            self.workChunk = nil;
-            self.workChunkLength = 0;
-            free(block);
-            return;
+            return -1L;
         }
-
-        self.writtenSoFar += self.workChunkLength;
-        
     }
     else {
-        self.lastReadZeroBytes = YES;
+        self.finished = YES;
         
-        CCCryptorStatus status = CCCryptorFinal(*self.cryptor, self.workChunk, kStreamingSerializationChunkSize, &_workChunkLength);
+        CCCryptorStatus status = CCCryptorFinal(*self.cryptor, dst, capacity, &decrypted);
         
         if (status != kCCSuccess) {
             size_t req = CCCryptorGetOutputLength(*self.cryptor, 0, YES);
             if (status == kCCBufferTooSmall && req == 0) { 
-
+                decrypted = 0;
             }
             else {
                 NSLog(@"Crypto Error: %d-%zu", status, req);
                 self.error = [Utils createNSError:@"AES: Crypto Error" errorCode:status];
-                self.workChunk = nil;
-                self.workChunkLength = 0;
-                free(block);
-                return;
+                return -1L;
             }
         }
-        
-        self.writtenSoFar += self.workChunkLength;
-        
     }
-
-    free(block);
+    
+    return decrypted;
 }
 
 - (NSError *)streamError {
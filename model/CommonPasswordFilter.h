@@ -0,0 +1,30 @@
+//
+//  CommonPasswordFilter.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface CommonPasswordFilter : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
++ (instancetype _Nullable)filterWithContentsOfFile:(NSString*)path; // Memory mapped
++ (instancetype _Nullable)filterWithData:(NSData*)data;
++ (instancetype _Nullable)filterWithWords:(NSArray<NSString*>*)words;
+
++ (NSData* _Nullable)serializeWords:(NSArray<NSString*>*)words;
+
+@property (readonly) NSUInteger count;
+@property (readonly) NSUInteger sizeInBytes;
+
+- (BOOL)contains:(NSString*)password;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,118 @@
+//
+//  CommonPasswordFilter.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "CommonPasswordFilter.h"
+#import "xor16_filter.h"
+
+@interface CommonPasswordFilter ()
+
+@property NSData* data;
+@property xor16_filter_t filter;
+
+@end
+
+@implementation CommonPasswordFilter
+
++ (instancetype)filterWithContentsOfFile:(NSString *)path {
+    NSError* error;
+    NSData* data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedAlways error:&error];
+    
+    if ( !data ) {
+        NSLog(@"WARNWARN: Could not map common password filter: %@ - %@", path, error);
+        return nil;
+    }
+    
+    return [CommonPasswordFilter filterWithData:data];
+}
+
++ (instancetype)filterWithData:(NSData *)data {
+    xor16_filter_t filter;
+    
+    if ( !xor16_deserialize(data.bytes, data.length, &filter) ) {
+        NSLog(@"WARNWARN: Invalid common password filter");
+        return nil;
+    }
+    
+    CommonPasswordFilter* ret = [[CommonPasswordFilter alloc] initInternal];
+    ret.data = data;
+    ret.filter = filter;
+    
+    return ret;
+}
+
++ (instancetype)filterWithWords:(NSArray<NSString *> *)words {
+    NSData* data = [CommonPasswordFilter serializeWords:words];
+    
+    return data ? [CommonPasswordFilter filterWithData:data] : nil;
+}
+
++ (NSData *)serializeWords:(NSArray<NSString *> *)words {
+    NSMutableData* keys = [NSMutableData dataWithLength:words.count * sizeof(uint64_t)];
+    uint64_t* p = keys.mutableBytes;
+    
+    NSUInteger count = 0;
+    for ( NSString* word in words ) {
+        if ( word.length ) {
+            p[count++] = [CommonPasswordFilter key:word];
+        }
+    }
+    
+    xor16_filter_t filter;
+    uint16_t* fingerprints;
+    
+    if ( !xor16_populate(p, count, &filter, &fingerprints) ) {
+        NSLog(@"WARNWARN: Could not build common password filter");
+        return nil;
+    }
+    
+    NSMutableData* ret = [NSMutableData dataWithLength:xor16_serialized_size(&filter)];
+    xor16_serialize(&filter, ret.mutableBytes);
+    free(fingerprints);
+    
+    return ret;
+}
+
++ (uint64_t)key:(NSString*)password {
+    NSString* lower = password.lowercaseString;
+    
+    char stackBuffer[256];
+    NSUInteger used = 0;
+    NSRange remaining;
+    
+    if ( [lower getBytes:stackBuffer maxLength:sizeof(stackBuffer) usedLength:&used encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, lower.length) remainingRange:&remaining] && remaining.length == 0 ) {
+        return xor16_hash_bytes(stackBuffer, used);
+    }
+    
+    NSData* utf8 = [lower dataUsingEncoding:NSUTF8StringEncoding];
+    
+    return xor16_hash_bytes(utf8.bytes, utf8.length);
+}
+
+- (instancetype)initInternal {
+    return [super init];
+}
+
+- (NSUInteger)count {
+    return self.filter.keyCount;
+}
+
+- (NSUInteger)sizeInBytes {
+    return self.data.length;
+}
+
+- (BOOL)contains:(NSString *)password {
+    if ( password.length == 0 ) {
+        return NO;
+    }
+    
+    xor16_filter_t filter = self.filter;
+    
+    return xor16_contains(&filter, [CommonPasswordFilter key:password]);
+}
+
+@end
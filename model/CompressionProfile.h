@@ -0,0 +1,18 @@
+//
+//  CompressionProfile.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#ifndef CompressionProfile_h
+#define CompressionProfile_h
+
+typedef NS_ENUM (NSInteger, CompressionProfile) {
+    kCompressionProfileDefault,
+    kCompressionProfileFast,
+    kCompressionProfileMax,
+};
+
+#endif /* CompressionProfile_h */
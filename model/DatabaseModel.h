@@ -8,6 +8,11 @@
 #import "UnifiedDatabaseMetadata.h"
 #import "NodeHierarchyReconstructionData.h"
 #import "CompositeKeyFactors.h"
+#import "FieldReferenceIndex.h"
+#import "TotpBatchGenerator.h"
+#import "SerializationMetrics.h"
+
+@class FastMaps;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -53,10 +58,25 @@ NS_ASSUME_NONNULL_BEGIN
                 deletedObjects:(NSDictionary<NSUUID *, NSDate *> *)deletedObjects
                       iconPool:(NSDictionary<NSUUID *, NodeIcon *> *)iconPool;
 
+- (instancetype)initWithFormat:(DatabaseFormat)format
+           compositeKeyFactors:(CompositeKeyFactors *)compositeKeyFactors
+                      metadata:(UnifiedDatabaseMetadata*)metadata
+                          root:(Node *_Nullable)root
+                deletedObjects:(NSDictionary<NSUUID *, NSDate *> *)deletedObjects
+                      iconPool:(NSDictionary<NSUUID *, NodeIcon *> *)iconPool
+                      fastMaps:(FastMaps*_Nullable)fastMaps;
+
+
 
+@property (readonly) FastMaps* fastMaps;
 
 - (void)rebuildFastMaps; 
 
+@property (readonly) FieldReferenceIndex* fieldReferenceIndex;
+@property (readonly) TotpBatchGenerator* totpGenerator;
+
+@property (nullable) SerializationMetrics* serializationMetrics;
+
 - (BOOL)isInRecycled:(NSUUID *)itemId;
 - (void)emptyRecycleBin;
 
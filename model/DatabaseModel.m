@@ -39,7 +39,8 @@ static NSString* const kPrintingStylesheet = @"<head><style type=\"text/css\"> \
 @property (nonatomic) NSDictionary<NSUUID*, NodeIcon*> *backingIconPool;
 @property (nonatomic) DatabaseFormat format;
 @property (nonatomic, nonnull, readonly) UnifiedDatabaseMetadata* metadata;
-@property (readonly) FastMaps* fastMaps;
+@property (nullable) FieldReferenceIndex* cachedFieldReferenceIndex;
+@property (nullable) TotpBatchGenerator* cachedTotpGenerator;
 
 @property (readonly) id<ApplicationPreferences> preferences;
 
@@ -109,13 +110,35 @@ static NSString* const kPrintingStylesheet = @"<head><style type=\"text/css\"> \
                           root:(Node *_Nullable)root
                 deletedObjects:(NSDictionary<NSUUID *,NSDate *> *)deletedObjects
                       iconPool:(NSDictionary<NSUUID *,NodeIcon *> *)iconPool {
+    return [self initWithFormat:format
+            compositeKeyFactors:compositeKeyFactors
+                       metadata:metadata
+                           root:root
+                 deletedObjects:deletedObjects
+                       iconPool:iconPool
+                       fastMaps:nil];
+}
+
+- (instancetype)initWithFormat:(DatabaseFormat)format
+           compositeKeyFactors:(CompositeKeyFactors *)compositeKeyFactors
+                      metadata:(UnifiedDatabaseMetadata*)metadata
+                          root:(Node *_Nullable)root
+                deletedObjects:(NSDictionary<NSUUID *,NSDate *> *)deletedObjects
+                      iconPool:(NSDictionary<NSUUID *,NodeIcon *> *)iconPool
+                      fastMaps:(FastMaps *)fastMaps {
     if (self = [super init]) {
         _format = format;
         _ckfs = compositeKeyFactors;
         _metadata = metadata;
         
         _rootNode = root ? root : [self initializeRoot];
-        [self rebuildFastMaps];
+        
+        if ( fastMaps && root ) {
+            _fastMaps = fastMaps;
+        }
+        else {
+            [self rebuildFastMaps];
+        }
         
         _mutableDeletedObjects = deletedObjects.mutableCopy;
         _backingIconPool = iconPool.mutableCopy;
@@ -989,7 +1012,31 @@ static NSString* const kPrintingStylesheet = @"<head><style type=\"text/css\"> \
 
 
 
+- (FieldReferenceIndex *)fieldReferenceIndex {
+    @synchronized (self) {
+        if ( self.cachedFieldReferenceIndex == nil ) {
+            self.cachedFieldReferenceIndex = [[FieldReferenceIndex alloc] initWithRootNode:self.rootNode];
+        }
+        
+        return self.cachedFieldReferenceIndex;
+    }
+}
+
+- (TotpBatchGenerator *)totpGenerator {
+    @synchronized (self) {
+        if ( self.cachedTotpGenerator == nil ) {
+            self.cachedTotpGenerator = [[TotpBatchGenerator alloc] initWithFastMaps:self.fastMaps];
+        }
+        
+        return self.cachedTotpGenerator;
+    }
+}
+
 - (void)rebuildFastMaps {
+    @synchronized (self) {
+        self.cachedFieldReferenceIndex = nil;
+        self.cachedTotpGenerator = nil;
+    }
 
               
     NSMutableDictionary<NSUUID*, Node*>* uuidMap = NSMutableDictionary.dictionary;
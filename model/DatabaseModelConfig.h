@@ -14,8 +14,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (instancetype)defaults;
 + (instancetype)withSanityCheckInnerStream:(BOOL)sanityCheckInnerStream;
++ (instancetype)withSnapshotUrl:(NSURL*)snapshotUrl sourceSha256:(NSData*)sourceSha256;
 
 @property (readonly) BOOL sanityCheckInnerStream;
+@property (readonly, nullable) NSURL* snapshotUrl;
+@property (readonly, nullable) NSData* sourceSha256;
 
 @end
 
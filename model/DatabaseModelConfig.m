@@ -20,6 +20,15 @@
     return config;
 }
 
++ (instancetype)withSnapshotUrl:(NSURL *)snapshotUrl sourceSha256:(NSData *)sourceSha256 {
+    DatabaseModelConfig* config = [[DatabaseModelConfig alloc] initWithSanityCheckInnerStream:YES];
+    
+    config->_snapshotUrl = snapshotUrl;
+    config->_sourceSha256 = sourceSha256;
+    
+    return config;
+}
+
 - (instancetype)initWithSanityCheckInnerStream:(BOOL)sanityCheckInnerStream {
     self = [super init];
     if (self) {
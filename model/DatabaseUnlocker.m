@@ -206,6 +206,7 @@
         else {
             [Serializator fromUrl:url
                               ckf:key
+                           config:[self getOpenConfig:url format:format]
                        completion:^(BOOL userCancelled, DatabaseModel * _Nullable model, NSError * _Nullable error) {
                 [self onGotDatabaseModelFromData:userCancelled model:model key:key error:error];
             }];
@@ -213,6 +214,18 @@
     });
 }
 
+- (DatabaseModelConfig*)getOpenConfig:(NSURL*)url format:(DatabaseFormat)format {
+    if ( !self.applicationPreferences.useUnlockSnapshotCache || format != kKeePass4 ) {
+        [WorkingCopyManager.sharedInstance deleteUnlockSnapshot:self.database.uuid];
+        return DatabaseModelConfig.defaults;
+    }
+    
+    NSData* sourceSha256 = [WorkingCopyManager sha256OfFile:url];
+    NSURL* snapshotUrl = [WorkingCopyManager.sharedInstance getUnlockSnapshotUrlForDatabase:self.database.uuid];
+    
+    return sourceSha256 && snapshotUrl ? [DatabaseModelConfig withSnapshotUrl:snapshotUrl sourceSha256:sourceSha256] : DatabaseModelConfig.defaults;
+}
+
 - (void)onGotDatabaseModelFromData:(BOOL)userCancelled
                              model:(DatabaseModel*)model
                                key:(CompositeKeyFactors*)key
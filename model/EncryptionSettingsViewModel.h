@@ -82,6 +82,7 @@ typedef NS_ENUM (NSUInteger, InnerStreamAlgorithm) {
 
 
 - (void)calibrateFor1Second;
+- (void)calibrateForTargetTime:(NSTimeInterval)targetTime;
 - (void)applyToDatabaseModel:(DatabaseModel*)model;
 - (BOOL)isDifferentFrom:(EncryptionSettingsViewModel*)other;
 - (BOOL)isEncryptionParamsDifferentFrom:(EncryptionSettingsViewModel*)other;
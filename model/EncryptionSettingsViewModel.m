@@ -411,7 +411,20 @@
 
 
 - (void)calibrateFor1Second {
+    [self calibrateForTargetTime:1.0f];
+}
+
+- (void)calibrateForTargetTime:(NSTimeInterval)targetTime {
+    if ( self.kdfAlgorithm != kKdfAlgorithmSha256 ) {
+        return;
+    }
+    
+    uint64_t iterations = [PwSafeSerialization keyStretchIterationsForTargetTime:targetTime];
+    
+    uint64_t min = pow(2.0f, self.minKdfIterations);
+    uint64_t max = pow(2.0f, self.maxKdfIterations);
     
+    self.iterations = MIN(MAX(iterations, min), max);
 }
 
 - (BOOL)isDifferentFrom:(EncryptionSettingsViewModel*)other {
@@ -0,0 +1,32 @@
+//
+//  FieldReferenceIndex.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "Node.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM (NSInteger, FieldReferenceIndexField) {
+    kFieldReferenceIndexFieldTitle,
+    kFieldReferenceIndexFieldUsername,
+    kFieldReferenceIndexFieldPassword,
+    kFieldReferenceIndexFieldUrl,
+    kFieldReferenceIndexFieldNotes,
+    kFieldReferenceIndexFieldCustomFields,
+};
+
+@interface FieldReferenceIndex : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithRootNode:(Node*)rootNode;
+
+- (Node*_Nullable)firstEntryWhereField:(FieldReferenceIndexField)field contains:(NSString*)searchTarget;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,200 @@
+//
+//  FieldReferenceIndex.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "FieldReferenceIndex.h"
+
+static const NSUInteger kTrigramLength = 3;
+
+@interface FieldValueIndex : NSObject
+
+@property (readonly) NSDictionary<NSString*, NSIndexSet*>* trigrams;
+
+@end
+
+@implementation FieldValueIndex
+
+- (instancetype)initWithValues:(NSArray<NSArray<NSString*>*>*)values {
+    if (self = [super init]) {
+        NSMutableDictionary<NSString*, NSMutableIndexSet*>* trigrams = NSMutableDictionary.dictionary;
+
+        [values enumerateObjectsUsingBlock:^(NSArray<NSString *> * _Nonnull entryValues, NSUInteger idx, BOOL * _Nonnull stop) {
+            for ( NSString* value in entryValues ) {
+                NSString* folded = [FieldValueIndex fold:value];
+
+                for ( NSUInteger i = 0; i + kTrigramLength <= folded.length; i++ ) {
+                    NSString* trigram = [folded substringWithRange:NSMakeRange(i, kTrigramLength)];
+
+                    NSMutableIndexSet* set = trigrams[trigram];
+                    if ( set == nil ) {
+                        set = NSMutableIndexSet.indexSet;
+                        trigrams[trigram] = set;
+                    }
+
+                    [set addIndex:idx];
+                }
+            }
+        }];
+
+        _trigrams = trigrams;
+    }
+
+    return self;
+}
+
++ (NSString*)fold:(NSString*)value {
+    return [[value stringByFoldingWithOptions:NSCaseInsensitiveSearch locale:NSLocale.currentLocale] precomposedStringWithCanonicalMapping];
+}
+
+- (NSIndexSet*_Nullable)candidatesFor:(NSString*)searchTarget {
+    NSString* folded = [FieldValueIndex fold:searchTarget];
+
+    if ( folded.length < kTrigramLength ) {
+        return nil;
+    }
+
+    NSMutableIndexSet* ret = nil;
+
+    for ( NSUInteger i = 0; i + kTrigramLength <= folded.length; i++ ) {
+        NSIndexSet* set = self.trigrams[[folded substringWithRange:NSMakeRange(i, kTrigramLength)]];
+
+        if ( set == nil ) {
+            return [NSIndexSet indexSet];
+        }
+
+        if ( ret == nil ) {
+            ret = set.mutableCopy;
+        }
+        else {
+            NSMutableIndexSet* intersection = [NSMutableIndexSet indexSet];
+            [ret enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL * _Nonnull stop) {
+                if ( [set containsIndex:idx] ) {
+                    [intersection addIndex:idx];
+                }
+            }];
+            ret = intersection;
+        }
+
+        if ( ret.count == 0 ) {
+            break;
+        }
+    }
+
+    return ret;
+}
+
+@end
+
+@interface FieldReferenceIndex ()
+
+@property (readonly) NSArray<Node*>* entries;
+@property (readonly) NSMutableDictionary<NSNumber*, FieldValueIndex*>* fieldIndexes;
+
+@end
+
+@implementation FieldReferenceIndex
+
+- (instancetype)initWithRootNode:(Node *)rootNode {
+    if (self = [super init]) {
+        NSMutableArray<Node*>* entries = NSMutableArray.array;
+
+        [FieldReferenceIndex addEntries:rootNode to:entries];
+
+        _entries = entries;
+        _fieldIndexes = NSMutableDictionary.dictionary;
+    }
+
+    return self;
+}
+
++ (void)addEntries:(Node*)group to:(NSMutableArray<Node*>*)entries {
+    NSArray<Node*>* children = group.children;
+
+    for ( Node* child in children ) {
+        if ( !child.isGroup ) {
+            [entries addObject:child];
+        }
+    }
+
+    for ( Node* child in children ) {
+        if ( child.isGroup ) {
+            [FieldReferenceIndex addEntries:child to:entries];
+        }
+    }
+}
+
++ (NSArray<NSString*>*)values:(Node*)node field:(FieldReferenceIndexField)field {
+    switch ( field ) {
+        case kFieldReferenceIndexFieldTitle:
+            return node.title ? @[node.title] : @[];
+        case kFieldReferenceIndexFieldUsername:
+            return node.fields.username ? @[node.fields.username] : @[];
+        case kFieldReferenceIndexFieldPassword:
+            return node.fields.password ? @[node.fields.password] : @[];
+        case kFieldReferenceIndexFieldUrl:
+            return node.fields.url ? @[node.fields.url] : @[];
+        case kFieldReferenceIndexFieldNotes:
+            return node.fields.notes ? @[node.fields.notes] : @[];
+        case kFieldReferenceIndexFieldCustomFields:
+        {
+            NSMutableArray<NSString*>* ret = NSMutableArray.array;
+            for ( StringValue* value in node.fields.customFields.allValues ) {
+                if ( value.value ) {
+                    [ret addObject:value.value];
+                }
+            }
+            return ret;
+        }
+    }
+
+    return @[];
+}
+
+- (FieldValueIndex*)indexForField:(FieldReferenceIndexField)field {
+    @synchronized (self) {
+        FieldValueIndex* ret = self.fieldIndexes[@(field)];
+
+        if ( ret == nil ) {
+            NSMutableArray<NSArray<NSString*>*>* values = [NSMutableArray arrayWithCapacity:self.entries.count];
+
+            for ( Node* entry in self.entries ) {
+                [values addObject:[FieldReferenceIndex values:entry field:field]];
+            }
+
+            ret = [[FieldValueIndex alloc] initWithValues:values];
+            self.fieldIndexes[@(field)] = ret;
+        }
+
+        return ret;
+    }
+}
+
+- (Node *)firstEntryWhereField:(FieldReferenceIndexField)field contains:(NSString *)searchTarget {
+    NSIndexSet* candidates = [[self indexForField:field] candidatesFor:searchTarget];
+
+    if ( candidates == nil ) {
+        candidates = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, self.entries.count)];
+    }
+
+    __block Node* ret = nil;
+
+    [candidates enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL * _Nonnull stop) {
+        Node* entry = self.entries[idx];
+
+        for ( NSString* value in [FieldReferenceIndex values:entry field:field] ) {
+            if ( [value localizedCaseInsensitiveContainsString:searchTarget] ) {
+                ret = entry;
+                *stop = YES;
+                break;
+            }
+        }
+    }];
+
+    return ret;
+}
+
+@end
@@ -0,0 +1,23 @@
+//
+//  HashingInputStream.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface HashingInputStream : NSInputStream
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithStream:(NSInputStream*)stream;
+
+@property (readonly) unsigned long long totalBytesRead;
+@property (readonly, nullable) NSData* sha256; 
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,72 @@
+//
+//  HashingInputStream.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "HashingInputStream.h"
+#import <CommonCrypto/CommonCrypto.h>
+
+@interface HashingInputStream ()
+
+@property NSInputStream* inner;
+@property BOOL finished;
+
+@end
+
+@implementation HashingInputStream {
+    CC_SHA256_CTX _context;
+}
+
+- (instancetype)initWithStream:(NSInputStream *)stream {
+    self = [super init];
+    if (self) {
+        self.inner = stream;
+        CC_SHA256_Init(&_context);
+    }
+    return self;
+}
+
+- (void)open {
+    if ( self.inner.streamStatus == NSStreamStatusNotOpen ) {
+        [self.inner open];
+    }
+}
+
+- (void)close {
+    [self.inner close];
+}
+
+- (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
+    NSInteger ret = [self.inner read:buffer maxLength:len];
+    
+    if ( ret > 0 ) {
+        CC_SHA256_Update(&_context, buffer, (CC_LONG)ret);
+        _totalBytesRead += ret;
+    }
+    else if ( ret == 0 && !self.finished ) {
+        uint8_t digest[CC_SHA256_DIGEST_LENGTH];
+        CC_SHA256_Final(digest, &_context);
+        
+        _sha256 = [NSData dataWithBytes:digest length:CC_SHA256_DIGEST_LENGTH];
+        self.finished = YES;
+    }
+    
+    return ret;
+}
+
+- (BOOL)hasBytesAvailable {
+    return self.inner.hasBytesAvailable;
+}
+
+- (NSStreamStatus)streamStatus {
+    return self.inner.streamStatus;
+}
+
+- (NSError *)streamError {
+    return self.inner.streamError;
+}
+
+@end
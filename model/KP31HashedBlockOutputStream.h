@@ -0,0 +1,21 @@
+//
+//  KP31HashedBlockOutputStream.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface KP31HashedBlockOutputStream : NSOutputStream
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithStream:(NSOutputStream*)stream;
+- (instancetype)initWithStream:(NSOutputStream*)stream blockSize:(NSUInteger)blockSize;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,171 @@
+//
+//  KP31HashedBlockOutputStream.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2026 Mark McGuill. All rights reserved.
+//
+
+#import "KP31HashedBlockOutputStream.h"
+#import "KdbxSerialization.h"
+#import "KeePassConstants.h"
+#import "Utils.h"
+#import <CommonCrypto/CommonCrypto.h>
+
+@interface KP31HashedBlockOutputStream ()
+
+@property NSOutputStream* outputStream;
+@property NSError* error;
+@property uint32_t blockNumber;
+
+@property NSUInteger blockSize;
+@property uint8_t* pendingBlock;
+@property NSUInteger pendingLength;
+
+@property BOOL wasOpened, wasClosed;
+
+@end
+
+@implementation KP31HashedBlockOutputStream
+
+- (instancetype)initWithStream:(NSOutputStream *)stream {
+    return [self initWithStream:stream blockSize:kDefaultBlockifySize];
+}
+
+- (instancetype)initWithStream:(NSOutputStream *)stream blockSize:(NSUInteger)blockSize {
+    if (self = [super init]) {
+        if (stream == nil || blockSize == 0) {
+            return nil;
+        }
+
+        self.outputStream = stream;
+        self.blockSize = blockSize;
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    [self cleanup];
+}
+
+- (void)cleanup {
+    if ( self.pendingBlock ) {
+        free(self.pendingBlock);
+        self.pendingBlock = nil;
+    }
+}
+
+- (NSError *)streamError {
+    return self.outputStream.streamError ? self.outputStream.streamError : self.error;
+}
+
+- (void)open {
+    if ( self.wasOpened ){
+        return;
+    }
+    self.wasOpened = YES;
+
+    self.blockNumber = 0;
+    self.pendingLength = 0;
+    self.pendingBlock = malloc(self.blockSize);
+}
+
+- (void)close {
+    if ( self.wasClosed ){
+        return;
+    }
+    self.wasClosed = YES;
+
+    if ( self.pendingLength > 0 ) {
+        if ( ![self writeBlock:self.pendingBlock length:self.pendingLength] ) {
+            NSLog(@"WARNWARN: Error writing Last KP31 Block");
+            [self cleanup];
+            return;
+        }
+    }
+
+    [self cleanup];
+
+    if ( ![self writeBlock:NULL length:0] ) {
+        NSLog(@"WARNWARN: Error writing KP31 Terminator Block");
+        return;
+    }
+
+    self.outputStream = nil;
+}
+
+- (NSInteger)write:(const uint8_t *)buffer maxLength:(NSUInteger)len {
+    if ( !self.wasOpened || self.wasClosed ) {
+        NSLog(@"WARNWARN: Unopen or not closed. KP31 Hashed Block Output Stream");
+        return -1;
+    }
+
+    NSUInteger consumed = 0;
+
+    while ( consumed < len ) {
+        if ( self.pendingLength == 0 && (len - consumed) >= self.blockSize ) {
+            if ( ![self writeBlock:&buffer[consumed] length:self.blockSize] ) {
+                return -1;
+            }
+
+            consumed += self.blockSize;
+            continue;
+        }
+
+        NSUInteger toCopy = MIN(self.blockSize - self.pendingLength, len - consumed);
+        memcpy(&self.pendingBlock[self.pendingLength], &buffer[consumed], toCopy);
+
+        self.pendingLength += toCopy;
+        consumed += toCopy;
+
+        if ( self.pendingLength == self.blockSize ) {
+            if ( ![self writeBlock:self.pendingBlock length:self.blockSize] ) {
+                return -1;
+            }
+
+            self.pendingLength = 0;
+        }
+    }
+
+    return len;
+}
+
+- (BOOL)writeBlock:(const uint8_t*)block length:(NSUInteger)length {
+    BlockHeader header = { 0 };
+
+    [Utils integerTolittleEndian4Bytes:self.blockNumber bytes:header.id];
+    [Utils integerTolittleEndian4Bytes:(uint32_t)length bytes:header.size];
+
+    if ( length > 0 ) {
+        CC_SHA256(block, (CC_LONG)length, header.hash);
+    }
+
+    NSInteger wrote = [self.outputStream write:(const uint8_t*)&header maxLength:SIZE_OF_BLOCK_HEADER];
+    if ( wrote < 0 ) {
+        NSLog(@"WARNWARN: Error writing KP31 Block Header");
+
+        if ( self.outputStream.streamError == nil ) {
+            self.error = [Utils createNSError:@"Could not write KP31 Block Header to output stream and no output stream error" errorCode:wrote];
+        }
+        return NO;
+    }
+
+    if ( length > 0 ) {
+        wrote = [self.outputStream write:block maxLength:length];
+        if ( wrote < 0 ) {
+            NSLog(@"WARNWARN: Error writing KP31 Block");
+
+            if ( self.outputStream.streamError == nil ) {
+                self.error = [Utils createNSError:@"Could not write KP31 Block to output stream and no output stream error" errorCode:wrote];
+            }
+            return NO;
+        }
+    }
+
+    self.blockNumber++;
+
+    return YES;
+}
+
+@end
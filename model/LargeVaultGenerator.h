@@ -0,0 +1,47 @@
+//
+//  LargeVaultGenerator.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "DatabaseModel.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface LargeVaultGeneratorConfig : NSObject
+
++ (instancetype)defaults;
+
+@property uint64_t seed;
+@property DatabaseFormat format;
+@property NSString* password;
+
+@property NSUInteger entryCount;
+@property NSUInteger groupDepth;
+@property NSUInteger groupsPerGroup;
+@property NSUInteger customFieldsPerEntry;
+@property NSUInteger historyDepth;
+
+@property double attachmentProbability;
+@property NSUInteger minAttachmentSize;
+@property NSUInteger maxAttachmentSize;
+
+@property double totpProbability;
+
+@property NSUInteger tagPoolSize;
+@property NSUInteger maxTagsPerEntry;
+
+- (NSDictionary<NSString*, id>*)jsonDictionary;
+
+@end
+
+@interface LargeVaultGenerator : NSObject
+
++ (DatabaseModel*)generate:(LargeVaultGeneratorConfig*)config;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,271 @@
+//
+//  LargeVaultGenerator.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "LargeVaultGenerator.h"
+#import "KeePassAttachmentAbstractionLayer.h"
+#import "NSData+Extensions.h"
+
+static NSString* const kWords[] = { @"alpha", @"bank", @"cloud", @"delta", @"email", @"forum", @"git", @"home", @"infra", @"jira",
+                                    @"kiosk", @"login", @"mail", @"news", @"office", @"portal", @"quota", @"router", @"shop", @"travel" };
+static const NSUInteger kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+
+static const NSTimeInterval kBaseDate = 1577836800;
+
+@implementation LargeVaultGeneratorConfig
+
++ (instancetype)defaults {
+    LargeVaultGeneratorConfig* ret = [[LargeVaultGeneratorConfig alloc] init];
+
+    ret.seed = 1;
+    ret.format = kKeePass4;
+    ret.password = @"benchmark";
+    ret.entryCount = 1000;
+    ret.groupDepth = 3;
+    ret.groupsPerGroup = 4;
+    ret.customFieldsPerEntry = 2;
+    ret.historyDepth = 2;
+    ret.attachmentProbability = 0.05;
+    ret.minAttachmentSize = 1024;
+    ret.maxAttachmentSize = 64 * 1024;
+    ret.totpProbability = 0.1;
+    ret.tagPoolSize = 20;
+    ret.maxTagsPerEntry = 3;
+
+    return ret;
+}
+
+- (NSDictionary<NSString *,id> *)jsonDictionary {
+    return @{ @"seed" : @(self.seed),
+              @"format" : @(self.format),
+              @"entryCount" : @(self.entryCount),
+              @"groupDepth" : @(self.groupDepth),
+              @"groupsPerGroup" : @(self.groupsPerGroup),
+              @"customFieldsPerEntry" : @(self.customFieldsPerEntry),
+              @"historyDepth" : @(self.historyDepth),
+              @"attachmentProbability" : @(self.attachmentProbability),
+              @"minAttachmentSize" : @(self.minAttachmentSize),
+              @"maxAttachmentSize" : @(self.maxAttachmentSize),
+              @"totpProbability" : @(self.totpProbability),
+              @"tagPoolSize" : @(self.tagPoolSize),
+              @"maxTagsPerEntry" : @(self.maxTagsPerEntry) };
+}
+
+@end
+
+@interface LargeVaultGenerator ()
+
+@property LargeVaultGeneratorConfig* config;
+@property uint64_t state;
+
+@end
+
+@implementation LargeVaultGenerator
+
++ (DatabaseModel *)generate:(LargeVaultGeneratorConfig *)config {
+    LargeVaultGenerator* generator = [[LargeVaultGenerator alloc] init];
+
+    generator.config = config;
+    generator.state = config.seed;
+
+    return [generator generate];
+}
+
+- (uint64_t)next {
+    uint64_t z = (self.state += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+- (NSUInteger)uniform:(NSUInteger)upperBound {
+    return upperBound ? (NSUInteger)([self next] % upperBound) : 0;
+}
+
+- (BOOL)chance:(double)probability {
+    return ([self next] >> 11) * (1.0 / 9007199254740992.0) < probability;
+}
+
+- (NSUUID*)uuid {
+    uuid_t bytes;
+    uint64_t hi = [self next], lo = [self next];
+
+    memcpy(bytes, &hi, sizeof(hi));
+    memcpy(&bytes[8], &lo, sizeof(lo));
+
+    bytes[6] = (bytes[6] & 0x0F) | 0x40;
+    bytes[8] = (bytes[8] & 0x3F) | 0x80;
+
+    return [[NSUUID alloc] initWithUUIDBytes:bytes];
+}
+
+- (NSString*)word {
+    return kWords[[self uniform:kWordCount]];
+}
+
+- (NSString*)password {
+    static const char kAlphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789!@#$%^&*";
+    char buffer[21];
+
+    for ( int i = 0; i < 20; i++ ) {
+        buffer[i] = kAlphabet[[self uniform:sizeof(kAlphabet) - 1]];
+    }
+    buffer[20] = 0;
+
+    return [NSString stringWithUTF8String:buffer];
+}
+
+- (NSString*)base32Secret {
+    static const char kBase32[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+    char buffer[33];
+
+    for ( int i = 0; i < 32; i++ ) {
+        buffer[i] = kBase32[[self uniform:32]];
+    }
+    buffer[32] = 0;
+
+    return [NSString stringWithUTF8String:buffer];
+}
+
+- (NSData*)bytes:(NSUInteger)length {
+    NSMutableData* ret = [NSMutableData dataWithLength:length];
+    uint8_t* p = ret.mutableBytes;
+
+    for ( NSUInteger i = 0; i < length; i += sizeof(uint64_t) ) {
+        uint64_t v = [self next];
+        memcpy(&p[i], &v, MIN(sizeof(v), length - i));
+    }
+
+    return ret;
+}
+
+- (NSDate*)date {
+    return [NSDate dateWithTimeIntervalSince1970:kBaseDate + [self uniform:3 * 365 * 24 * 60 * 60]];
+}
+
+- (void)setDates:(Node*)node {
+    NSDate* created = [self date];
+    NSDate* modified = [created dateByAddingTimeInterval:[self uniform:180 * 24 * 60 * 60]];
+
+    [node.fields setTouchPropertiesWithCreated:created accessed:modified modified:modified locationChanged:created usageCount:@(0)];
+}
+
+- (DatabaseModel*)generate {
+    DatabaseFormat format = self.config.format;
+    DatabaseModel* database = [[DatabaseModel alloc] initWithFormat:format compositeKeyFactors:[CompositeKeyFactors password:self.config.password]];
+    BOOL keePass2 = database.isKeePass2Format;
+
+    NSArray<Node*>* groups = [self generateGroups:database];
+    NSArray<NSString*>* tags = [self tagPool];
+
+    for ( NSUInteger i = 0; i < self.config.entryCount; i++ ) {
+        Node* parent = groups[[self uniform:groups.count]];
+
+        NSString* service = [self word];
+        NSString* title = [NSString stringWithFormat:@"%@ %@ %lu", service.capitalizedString, [self word], (unsigned long)i];
+
+        NodeFields* fields = [[NodeFields alloc] initWithUsername:[NSString stringWithFormat:@"%@.%lu", [self word], (unsigned long)[self uniform:100000]]
+                                                              url:[NSString stringWithFormat:@"https://%@.%@%lu.example.com/login", [self word], service, (unsigned long)[self uniform:1000]]
+                                                         password:[self password]
+                                                            notes:[NSString stringWithFormat:@"%@ %@ %@", [self word], [self word], [self word]]
+                                                            email:[NSString stringWithFormat:@"%@%lu@example.com", [self word], (unsigned long)[self uniform:1000]]];
+
+        Node* entry = [[Node alloc] initAsRecord:title parent:parent fields:fields uuid:[self uuid]];
+        [self setDates:entry];
+
+        if ( keePass2 ) {
+            for ( NSUInteger j = 0; j < self.config.customFieldsPerEntry; j++ ) {
+                [entry.fields setCustomField:[NSString stringWithFormat:@"Field %lu", (unsigned long)j]
+                                       value:[StringValue valueWithString:[NSString stringWithFormat:@"%@-%lu", [self word], (unsigned long)[self uniform:1000000]] protected:(j % 2) == 1]];
+            }
+
+            NSUInteger tagCount = [self uniform:self.config.maxTagsPerEntry + 1];
+            for ( NSUInteger j = 0; j < tagCount && tags.count; j++ ) {
+                [entry.fields.tags addObject:tags[[self uniform:tags.count]]];
+            }
+        }
+
+        if ( format != kPasswordSafe && [self chance:self.config.attachmentProbability] ) {
+            NSUInteger range = self.config.maxAttachmentSize > self.config.minAttachmentSize ? self.config.maxAttachmentSize - self.config.minAttachmentSize : 0;
+            NSData* data = [self bytes:self.config.minAttachmentSize + [self uniform:range + 1]];
+
+            entry.fields.attachments[[NSString stringWithFormat:@"%@.bin", service]] = [[KeePassAttachmentAbstractionLayer alloc] initNonPerformantWithData:data compressed:YES protectedInMemory:NO];
+        }
+
+        if ( [self chance:self.config.totpProbability] ) {
+            NSString* otpauth = [NSString stringWithFormat:@"otpauth://totp/%@:%@?secret=%@&issuer=%@", service, entry.fields.username, [self base32Secret], service];
+
+            [entry setTotpWithString:otpauth appendUrlToNotes:!keePass2 forceSteam:NO addLegacyFields:NO addOtpAuthUrl:keePass2];
+        }
+
+        if ( keePass2 ) {
+            for ( NSUInteger j = 0; j < self.config.historyDepth; j++ ) {
+                Node* historical = [entry cloneForHistory];
+                historical.fields.password = [self password];
+                [self setDates:historical];
+
+                [entry.fields.keePassHistory addObject:historical];
+            }
+        }
+
+        [database addChildren:@[entry] destination:parent suppressFastMapsRebuild:YES];
+    }
+
+    [database rebuildFastMaps];
+
+    return database;
+}
+
+- (NSArray<Node*>*)generateGroups:(DatabaseModel*)database {
+    NSMutableArray<Node*>* all = NSMutableArray.array;
+    NSArray<Node*>* level = @[database.effectiveRootGroup];
+
+    if ( database.originalFormat != kKeePass1 ) {
+        [all addObject:database.effectiveRootGroup];
+    }
+
+    for ( NSUInteger depth = 0; depth < self.config.groupDepth; depth++ ) {
+        NSMutableArray<Node*>* next = NSMutableArray.array;
+
+        for ( Node* parent in level ) {
+            for ( NSUInteger i = 0; i < self.config.groupsPerGroup; i++ ) {
+                NSString* title = [NSString stringWithFormat:@"%@ %lu.%lu", [self word].capitalizedString, (unsigned long)depth, (unsigned long)i];
+
+                Node* group = [[Node alloc] initAsGroup:title parent:parent keePassGroupTitleRules:database.isKeePass2Format uuid:[self uuid]];
+                [self setDates:group];
+
+                [database addChildren:@[group] destination:parent suppressFastMapsRebuild:YES];
+                [next addObject:group];
+            }
+        }
+
+        [all addObjectsFromArray:next];
+        level = next;
+    }
+
+    if ( all.count == 0 ) { // KeePass 1 does not allow entries at the root
+        Node* group = [[Node alloc] initAsGroup:@"General" parent:database.effectiveRootGroup keePassGroupTitleRules:NO uuid:[self uuid]];
+        [database addChildren:@[group] destination:database.effectiveRootGroup suppressFastMapsRebuild:YES];
+        [all addObject:group];
+    }
+
+    return all;
+}
+
+- (NSArray<NSString*>*)tagPool {
+    NSMutableArray<NSString*>* ret = NSMutableArray.array;
+
+    for ( NSUInteger i = 0; i < self.config.tagPoolSize; i++ ) {
+        [ret addObject:[NSString stringWithFormat:@"%@-%lu", [self word], (unsigned long)i]];
+    }
+
+    return ret;
+}
+
+@end
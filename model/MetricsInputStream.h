@@ -0,0 +1,23 @@
+//
+//  MetricsInputStream.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "SerializationMetrics.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface MetricsInputStream : NSInputStream
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithStream:(NSInputStream*)stream metrics:(SerializationMetrics*)metrics stage:(NSString*)stage;
+
++ (NSInputStream*)wrap:(NSInputStream*)stream metrics:(SerializationMetrics*_Nullable)metrics stage:(NSString*)stage;
+
+@end
+
+NS_ASSUME_NONNULL_END
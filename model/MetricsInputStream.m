@@ -0,0 +1,75 @@
+//
+//  MetricsInputStream.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "MetricsInputStream.h"
+
+@interface MetricsInputStream ()
+
+@property NSInputStream* inner;
+@property SerializationMetrics* metrics;
+@property NSString* stage;
+
+@end
+
+@implementation MetricsInputStream
+
++ (NSInputStream *)wrap:(NSInputStream *)stream metrics:(SerializationMetrics *)metrics stage:(NSString *)stage {
+    return metrics ? [[MetricsInputStream alloc] initWithStream:stream metrics:metrics stage:stage] : stream;
+}
+
+- (instancetype)initWithStream:(NSInputStream *)stream metrics:(SerializationMetrics *)metrics stage:(NSString *)stage {
+    self = [super init];
+    if (self) {
+        self.inner = stream;
+        self.metrics = metrics;
+        self.stage = stage;
+    }
+    return self;
+}
+
+- (void)open {
+    [self.metrics beginStage:self.stage];
+    [self.inner open];
+    [self.metrics endStage:self.stage];
+}
+
+- (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)len {
+    [self.metrics beginStage:self.stage];
+    NSInteger ret = [self.inner read:buffer maxLength:len];
+    [self.metrics endStage:self.stage];
+
+    if (ret > 0) {
+        [self.metrics addBytes:ret stage:self.stage];
+    }
+
+    return ret;
+}
+
+- (BOOL)getBuffer:(uint8_t * _Nullable *)buffer length:(NSUInteger *)len {
+    return NO;
+}
+
+- (BOOL)hasBytesAvailable {
+    return self.inner.hasBytesAvailable;
+}
+
+- (NSStreamStatus)streamStatus {
+    return self.inner.streamStatus;
+}
+
+- (NSError *)streamError {
+    return self.inner.streamError;
+}
+
+- (void)close {
+    [self.metrics beginStage:self.stage];
+    [self.inner close];
+    [self.metrics endStage:self.stage];
+}
+
+@end
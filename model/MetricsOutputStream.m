@@ -0,0 +1,75 @@
+//
+//  MetricsOutputStream.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "MetricsOutputStream.h"
+
+@interface MetricsOutputStream ()
+
+@property NSOutputStream* inner;
+@property SerializationMetrics* metrics;
+@property NSString* stage;
+
+@end
+
+@implementation MetricsOutputStream
+
++ (NSOutputStream *)wrap:(NSOutputStream *)stream metrics:(SerializationMetrics *)metrics stage:(NSString *)stage {
+    return metrics ? [[MetricsOutputStream alloc] initWithStream:stream metrics:metrics stage:stage] : stream;
+}
+
+- (instancetype)initWithStream:(NSOutputStream *)stream metrics:(SerializationMetrics *)metrics stage:(NSString *)stage {
+    self = [super init];
+    if (self) {
+        self.inner = stream;
+        self.metrics = metrics;
+        self.stage = stage;
+    }
+    return self;
+}
+
+- (void)open {
+    [self.metrics beginStage:self.stage];
+    [self.inner open];
+    [self.metrics endStage:self.stage];
+}
+
+- (NSInteger)write:(const uint8_t *)buffer maxLength:(NSUInteger)len {
+    [self.metrics beginStage:self.stage];
+    NSInteger ret = [self.inner write:buffer maxLength:len];
+    [self.metrics endStage:self.stage];
+
+    if (ret > 0) {
+        [self.metrics addBytes:ret stage:self.stage];
+    }
+
+    return ret;
+}
+
+- (BOOL)hasSpaceAvailable {
+    return self.inner.hasSpaceAvailable;
+}
+
+- (NSStreamStatus)streamStatus {
+    return self.inner.streamStatus;
+}
+
+- (NSError *)streamError {
+    return self.inner.streamError;
+}
+
+- (id)propertyForKey:(NSStreamPropertyKey)key {
+    return [self.inner propertyForKey:key];
+}
+
+- (void)close {
+    [self.metrics beginStage:self.stage];
+    [self.inner close];
+    [self.metrics endStage:self.stage];
+}
+
+@end
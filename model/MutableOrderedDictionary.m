@@ -8,26 +8,71 @@
 
 #import "MutableOrderedDictionary.h"
 #import "NSDictionary+Extensions.h"
-#import "NSArray+Extensions.h"
 
-@interface MutableOrderedDictionary ()
+// Insertion ordered open addressing table, same layout as CPython's compact dict. Keys, values and hashes are held in
+// insertion order in the entry arrays, slots is a power of two sized index into those entries. Removal leaves a
+// tombstone in the entries and a dummy in the slot, both are cleaned up by compaction once they outnumber live entries.
 
-@property NSMutableArray<NSString*> *orderedKeys;
-@property NSMutableDictionary<NSString*, NSObject*> *kvps;
+static const int32_t kSlotEmpty = -1;
+static const int32_t kSlotDummy = -2;
+static const NSUInteger kMinimumSlots = 8;
+static const NSUInteger kPerturbShift = 5;
+
+static id kTombstone;
+
+@interface MutableOrderedDictionary () {
+    NSMutableArray* _entryKeys;
+    NSMutableArray* _entryValues;
+    NSUInteger* _entryHashes;
+    NSUInteger _entryCapacity;
+    
+    int32_t* _slots;
+    NSUInteger _slotCount;
+    NSUInteger _usedSlots;
+    
+    NSUInteger _count;
+}
 
 @end
 
 @implementation MutableOrderedDictionary
 
++ (void)initialize {
+    if ( self == [MutableOrderedDictionary class] ) {
+        kTombstone = [[NSObject alloc] init];
+    }
+}
+
 - (instancetype)init {
     self = [super init];
     if (self) {
-        self.orderedKeys = [NSMutableArray array];
-        self.kvps = [NSMutableDictionary dictionary];
+        [self reset];
     }
     return self;
 }
 
+- (void)dealloc {
+    free(_entryHashes);
+    free(_slots);
+}
+
+- (void)reset {
+    free(_entryHashes);
+    free(_slots);
+    
+    _entryKeys = [NSMutableArray array];
+    _entryValues = [NSMutableArray array];
+    _entryCapacity = kMinimumSlots;
+    _entryHashes = malloc(_entryCapacity * sizeof(NSUInteger));
+    
+    _slotCount = kMinimumSlots;
+    _slots = malloc(_slotCount * sizeof(int32_t));
+    memset(_slots, 0xFF, _slotCount * sizeof(int32_t));
+    _usedSlots = 0;
+    
+    _count = 0;
+}
+
 - (id)copy {
     return [self clone];
 }
@@ -39,25 +84,243 @@
 - (instancetype)clone {
     MutableOrderedDictionary *ret = [[MutableOrderedDictionary alloc] init];
     
-    for (id key in self.allKeys) {
-        id value = self.kvps[key];
-        [ret addKey:key andValue:value];
+    NSUInteger entryCount = _entryKeys.count;
+    
+    if ( entryCount == _count ) {
+        ret->_entryKeys = _entryKeys.mutableCopy;
+        ret->_entryValues = _entryValues.mutableCopy;
+        
+        ret->_entryCapacity = _entryCapacity;
+        ret->_entryHashes = realloc(ret->_entryHashes, _entryCapacity * sizeof(NSUInteger));
+        memcpy(ret->_entryHashes, _entryHashes, entryCount * sizeof(NSUInteger));
+        
+        ret->_slotCount = _slotCount;
+        ret->_slots = realloc(ret->_slots, _slotCount * sizeof(int32_t));
+        memcpy(ret->_slots, _slots, _slotCount * sizeof(int32_t));
+        ret->_usedSlots = _usedSlots;
+        
+        ret->_count = _count;
+    }
+    else {
+        for ( NSUInteger i = 0; i < entryCount; i++ ) {
+            id key = _entryKeys[i];
+            
+            if ( key != kTombstone ) {
+                [ret appendKey:key value:_entryValues[i] hash:_entryHashes[i]];
+            }
+        }
     }
     
     return ret;
 }
 
+#pragma mark - Table
+
+- (NSInteger)entryIndexForKey:(id)key hash:(NSUInteger)hash slot:(NSUInteger*)slot {
+    NSUInteger mask = _slotCount - 1;
+    NSUInteger i = hash & mask;
+    NSUInteger perturb = hash;
+    NSUInteger firstDummy = NSNotFound;
+    
+    while ( YES ) {
+        int32_t ix = _slots[i];
+        
+        if ( ix == kSlotEmpty ) {
+            if ( slot ) {
+                *slot = firstDummy != NSNotFound ? firstDummy : i;
+            }
+            return -1;
+        }
+        
+        if ( ix == kSlotDummy ) {
+            if ( firstDummy == NSNotFound ) {
+                firstDummy = i;
+            }
+        }
+        else if ( _entryHashes[ix] == hash ) {
+            id candidate = _entryKeys[ix];
+            
+            if ( candidate == key || [candidate isEqual:key] ) {
+                if ( slot ) {
+                    *slot = i;
+                }
+                return ix;
+            }
+        }
+        
+        perturb >>= kPerturbShift;
+        i = (i * 5 + perturb + 1) & mask;
+    }
+}
+
+- (NSInteger)entryIndexForKey:(id)key {
+    if ( key == nil || _count == 0 ) {
+        return -1;
+    }
+    
+    return [self entryIndexForKey:key hash:[key hash] slot:nil];
+}
+
+- (void)appendKey:(id)key value:(id)value hash:(NSUInteger)hash {
+    if ( (_usedSlots + 1) * 3 >= _slotCount * 2 ) {
+        [self compactAndRehash:_count + 1];
+    }
+    
+    NSUInteger slot;
+    [self entryIndexForKey:key hash:hash slot:&slot];
+    
+    NSUInteger entryIndex = _entryKeys.count;
+    
+    if ( entryIndex == _entryCapacity ) {
+        _entryCapacity *= 2;
+        _entryHashes = realloc(_entryHashes, _entryCapacity * sizeof(NSUInteger));
+    }
+    
+    [_entryKeys addObject:key];
+    [_entryValues addObject:value];
+    _entryHashes[entryIndex] = hash;
+    
+    if ( _slots[slot] == kSlotEmpty ) {
+        _usedSlots++;
+    }
+    _slots[slot] = (int32_t)entryIndex;
+    
+    _count++;
+}
+
+- (void)removeEntryAtSlot:(NSUInteger)slot entryIndex:(NSInteger)entryIndex {
+    _slots[slot] = kSlotDummy;
+    
+    _entryKeys[entryIndex] = kTombstone;
+    _entryValues[entryIndex] = kTombstone;
+    
+    _count--;
+    
+    if ( _count == 0 ) {
+        [self reset];
+    }
+    else if ( _entryKeys.count - _count > MAX(_count, kMinimumSlots) ) {
+        [self compactAndRehash:_count];
+    }
+}
+
+- (void)compactAndRehash:(NSUInteger)minimumCount {
+    NSUInteger entryCount = _entryKeys.count;
+    
+    if ( entryCount != _count ) {
+        NSUInteger live = 0;
+        NSMutableIndexSet* tombstones = [NSMutableIndexSet indexSet];
+        
+        for ( NSUInteger i = 0; i < entryCount; i++ ) {
+            if ( _entryKeys[i] == kTombstone ) {
+                [tombstones addIndex:i];
+            }
+            else {
+                _entryHashes[live++] = _entryHashes[i];
+            }
+        }
+        
+        [_entryKeys removeObjectsAtIndexes:tombstones];
+        [_entryValues removeObjectsAtIndexes:tombstones];
+    }
+    
+    NSUInteger slotCount = kMinimumSlots;
+    while ( slotCount * 2 <= minimumCount * 3 ) {
+        slotCount *= 2;
+    }
+    
+    if ( slotCount != _slotCount ) {
+        _slotCount = slotCount;
+        _slots = realloc(_slots, _slotCount * sizeof(int32_t));
+    }
+    
+    [self rebuildSlots];
+}
+
+- (void)rebuildSlots {
+    memset(_slots, 0xFF, _slotCount * sizeof(int32_t));
+    
+    NSUInteger mask = _slotCount - 1;
+    NSUInteger entryCount = _entryKeys.count;
+    
+    for ( NSUInteger ix = 0; ix < entryCount; ix++ ) {
+        NSUInteger hash = _entryHashes[ix];
+        NSUInteger i = hash & mask;
+        NSUInteger perturb = hash;
+        
+        while ( _slots[i] != kSlotEmpty ) {
+            perturb >>= kPerturbShift;
+            i = (i * 5 + perturb + 1) & mask;
+        }
+        
+        _slots[i] = (int32_t)ix;
+    }
+    
+    _usedSlots = entryCount;
+}
+
+- (BOOL)removeKey:(id)key {
+    if ( key == nil || _count == 0 ) {
+        return NO;
+    }
+    
+    NSUInteger slot;
+    NSInteger entryIndex = [self entryIndexForKey:key hash:[key hash] slot:&slot];
+    
+    if ( entryIndex < 0 ) {
+        return NO;
+    }
+    
+    [self removeEntryAtSlot:slot entryIndex:entryIndex];
+    
+    return YES;
+}
+
+- (NSUInteger)entryIndexForPosition:(NSUInteger)position {
+    if ( _entryKeys.count == _count ) {
+        return position;
+    }
+    
+    NSUInteger entryCount = _entryKeys.count;
+    
+    for ( NSUInteger i = 0; i < entryCount; i++ ) {
+        if ( _entryKeys[i] != kTombstone && position-- == 0 ) {
+            return i;
+        }
+    }
+    
+    return NSNotFound;
+}
+
+- (NSArray*)liveObjectsOf:(NSArray*)entries {
+    if ( _entryKeys.count == _count ) {
+        return [entries copy];
+    }
+    
+    NSMutableArray* ret = [NSMutableArray arrayWithCapacity:_count];
+    NSUInteger entryCount = _entryKeys.count;
+    
+    for ( NSUInteger i = 0; i < entryCount; i++ ) {
+        if ( _entryKeys[i] != kTombstone ) {
+            [ret addObject:entries[i]];
+        }
+    }
+    
+    return ret;
+}
+
+#pragma mark - Public
+
 - (void)remove:(id)key {
     self[key] = nil;
 }
 
 - (id)removeObjectAtIndex:(NSUInteger)atIndex {
-    if ( atIndex >= 0 && atIndex < self.orderedKeys.count ) {
-        id key = self.orderedKeys[atIndex];
-        id value = self.kvps[key];
+    if ( atIndex >= 0 && atIndex < _count ) {
+        NSUInteger entryIndex = [self entryIndexForPosition:atIndex];
+        id value = _entryValues[entryIndex];
         
-        [self.orderedKeys removeObjectAtIndex:atIndex];
-        [self.kvps removeObjectForKey:key];
+        [self removeKey:_entryKeys[entryIndex]];
         
         return value;
     }
@@ -76,44 +339,67 @@
 }
 
 - (void)updateOrAddKey:(id)key andValue:(id)value {
-    if ( self.kvps[key] ) {
+    NSInteger entryIndex = [self entryIndexForKey:key];
+    
+    if ( entryIndex >= 0 ) {
         if(value != nil) {
-            [self.kvps setValue:value forKey:key];
+            _entryValues[entryIndex] = value;
         }
         else {
-            [self.orderedKeys removeObject:key];
-            [self.kvps removeObjectForKey:key];
+            [self removeKey:key];
         }
     }
     else {
         if(value != nil) {
-            [self.orderedKeys addObject:key];
-            [self.kvps setValue:value forKey:key];
+            id copied = [key copy];
+            [self appendKey:copied value:value hash:[copied hash]];
         }
     }
 }
 
 - (void)addKey:(id)key andValue:(id)value {
-    if(self.kvps[key]) {
-        [self.orderedKeys removeObject:key];
-        [self.kvps removeObjectForKey:key];
-    }
+    [self removeKey:key];
 
     if(value != nil) {
-        [self.orderedKeys addObject:key];
-        [self.kvps setValue:value forKey:key];
+        id copied = [key copy];
+        [self appendKey:copied value:value hash:[copied hash]];
     }
 }
 
 - (void)insertKey:(id)key withValue:(id)value atIndex:(NSUInteger)atIndex {
-    if ( self.kvps[key] ) {
+    if ( [self entryIndexForKey:key] >= 0 ) {
         NSLog(@"🔴 insertKey - Key already exists");
         return;
     }
 
     if ( value != nil ) {
-        [self.orderedKeys insertObject:key atIndex:atIndex];
-        [self.kvps setValue:value forKey:key];
+        if ( atIndex == _count ) {
+            id copied = [key copy];
+            [self appendKey:copied value:value hash:[copied hash]];
+            return;
+        }
+        
+        if ( _entryKeys.count != _count ) {
+            [self compactAndRehash:_count];
+        }
+        
+        id copied = [key copy];
+        NSUInteger hash = [copied hash];
+        
+        [_entryKeys insertObject:copied atIndex:atIndex];
+        [_entryValues insertObject:value atIndex:atIndex];
+        
+        if ( _count == _entryCapacity ) {
+            _entryCapacity *= 2;
+            _entryHashes = realloc(_entryHashes, _entryCapacity * sizeof(NSUInteger));
+        }
+        
+        memmove(_entryHashes + atIndex + 1, _entryHashes + atIndex, (_count - atIndex) * sizeof(NSUInteger));
+        _entryHashes[atIndex] = hash;
+        
+        _count++;
+        
+        [self compactAndRehash:_count];
     }
 }
 
@@ -122,54 +408,56 @@
 }
 
 - (NSArray<id>*)allKeys {
-    return [self.orderedKeys copy];
+    return [self liveObjectsOf:_entryKeys];
 }
 
 - (NSArray<id>*)allValues {
-    return [self.allKeys map:^id _Nonnull(id  _Nonnull obj, NSUInteger idx) {
-        return self.kvps[obj];
-    }];
+    return [self liveObjectsOf:_entryValues];
 }
 
 - (id)objectForKey:(id)key {
-    return [self.kvps objectForKey:key];
+    NSInteger entryIndex = [self entryIndexForKey:key];
+    
+    return entryIndex >= 0 ? _entryValues[entryIndex] : nil;
 }
 
 - (id)objectForCaseInsensitiveKey:(id)key {
-    return [self.kvps objectForCaseInsensitiveKey:key];
+    return [self.dictionary objectForCaseInsensitiveKey:key];
 }
 
 - (id)objectForKeyedSubscript:(id)key {
-    return [self.kvps objectForKey:key];
+    return [self objectForKey:key];
 }
 
 - (void)addAll:(MutableOrderedDictionary *)other {
     if (other) {
-        for (id key in other.allKeys) {
-            self[key] = other[key];
+        NSArray* keys = other.allKeys;
+        NSArray* values = other.allValues;
+        
+        for ( NSUInteger i = 0; i < keys.count; i++ ) {
+            self[keys[i]] = values[i];
         }
     }
 }
 
 - (void)removeAllObjects {
-    [self.orderedKeys removeAllObjects];
-    [self.kvps removeAllObjects];
+    [self reset];
 }
 
 - (BOOL)containsKey:(id)key {
-    return [self.kvps objectForKey:key] != nil;
+    return [self entryIndexForKey:key] >= 0;
 }
 
 - (NSUInteger)count {
-    return [self.kvps count];
+    return _count;
 }
 
 - (NSDictionary *)dictionary {
-    return self.kvps.copy;
+    return [NSDictionary dictionaryWithObjects:self.allValues forKeys:self.allKeys];
 }
 
 - (NSString *)description {
-    return [_kvps description];
+    return [self.dictionary description];
 }
 
 - (BOOL)isEqual:(id)object {
@@ -187,17 +475,15 @@
     
     MutableOrderedDictionary* other = (MutableOrderedDictionary*)object;
     
-    if(![self.allKeys isEqualToArray:other.allKeys]) {
+    if ( self.count != other.count ) {
         return NO;
     }
     
-    BOOL ret = [self.kvps isEqualToDictionary:other.kvps];
-    
-    if ( ret ) {
-        return YES;
+    if(![self.allKeys isEqualToArray:other.allKeys]) {
+        return NO;
     }
     
-    return NO;
+    return [self.allValues isEqualToArray:other.allValues];
 }
 
 @end
@@ -8,6 +8,56 @@
 
 #import <Foundation/Foundation.h>
 #import "NSDate+Extensions.h"
+#include <stdatomic.h>
+
+// Formatters are expensive to create and these are called per row when lists render thousands of dates, so keep one
+// per style per thread. The cache is thrown away when the locale, time zone or day changes (relative formatting).
+
+static NSString* const kFormatterCacheThreadKey = @"NSDate+Extensions.formatterCache";
+static atomic_uint_fast64_t formatterGeneration;
+
+@interface DateFormatterCache : NSObject
+
+@property uint64_t generation;
+@property NSMutableDictionary<NSString*, NSDateFormatter*>* formatters;
+
+@end
+
+@implementation DateFormatterCache
+
+@end
+
+static NSDateFormatter* cachedDateFormatter(NSString* style, void (^configure)(NSDateFormatter* df)) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        for ( NSNotificationName name in @[NSCurrentLocaleDidChangeNotification, NSSystemTimeZoneDidChangeNotification, NSCalendarDayChangedNotification] ) {
+            [NSNotificationCenter.defaultCenter addObserverForName:name object:nil queue:nil usingBlock:^(NSNotification * _Nonnull note) {
+                atomic_fetch_add(&formatterGeneration, 1);
+            }];
+        }
+    });
+    
+    NSMutableDictionary* threadDictionary = NSThread.currentThread.threadDictionary;
+    DateFormatterCache* cache = threadDictionary[kFormatterCacheThreadKey];
+    uint64_t generation = atomic_load(&formatterGeneration);
+    
+    if ( !cache || cache.generation != generation ) {
+        cache = [[DateFormatterCache alloc] init];
+        cache.generation = generation;
+        cache.formatters = NSMutableDictionary.dictionary;
+        threadDictionary[kFormatterCacheThreadKey] = cache;
+    }
+    
+    NSDateFormatter* df = cache.formatters[style];
+    
+    if ( !df ) {
+        df = [[NSDateFormatter alloc] init];
+        configure(df);
+        cache.formatters[style] = df;
+    }
+    
+    return df;
+}
 
 @implementation NSDate (Extensions)
 
@@ -85,116 +135,117 @@
 }
 
 - (NSString *)friendlyDateString {
-    NSDateFormatter *df = [[NSDateFormatter alloc] init];
+    NSDateFormatter *df = cachedDateFormatter(@"friendlyDateString", ^(NSDateFormatter *formatter) {
+        formatter.dateStyle = NSDateFormatterMediumStyle;
+        formatter.doesRelativeDateFormatting = YES;
+        formatter.locale = NSLocale.currentLocale;
+    });
 
-    df.dateStyle = NSDateFormatterMediumStyle;
-    df.doesRelativeDateFormatting = YES;
-    df.locale = NSLocale.currentLocale;
-    
     return [df stringFromDate:self];
 }
 
 - (NSString *)friendlyDateTimeString {
-    NSDateFormatter *df = [[NSDateFormatter alloc] init];
-    df.timeStyle = NSDateFormatterShortStyle;
-    df.dateStyle = NSDateFormatterMediumStyle;
-    df.doesRelativeDateFormatting = YES;
-    df.locale = NSLocale.currentLocale;
-    
+    NSDateFormatter *df = cachedDateFormatter(@"friendlyDateTimeString", ^(NSDateFormatter *formatter) {
+        formatter.timeStyle = NSDateFormatterShortStyle;
+        formatter.dateStyle = NSDateFormatterMediumStyle;
+        formatter.doesRelativeDateFormatting = YES;
+        formatter.locale = NSLocale.currentLocale;
+    });
+
     return [df stringFromDate:self];
 }
 
 - (NSString *)friendlyDateStringVeryShort {
-    NSDateFormatter *df = [[NSDateFormatter alloc] init];
-    df.timeStyle = NSDateFormatterShortStyle;
-    df.dateStyle = NSDateFormatterShortStyle;
-    df.doesRelativeDateFormatting = YES;
-    df.locale = NSLocale.currentLocale;
-    
+    NSDateFormatter *df = cachedDateFormatter(@"friendlyDateStringVeryShort", ^(NSDateFormatter *formatter) {
+        formatter.timeStyle = NSDateFormatterShortStyle;
+        formatter.dateStyle = NSDateFormatterShortStyle;
+        formatter.doesRelativeDateFormatting = YES;
+        formatter.locale = NSLocale.currentLocale;
+    });
+
     return [df stringFromDate:self];
 }
 
 - (NSString *)friendlyDateStringVeryShortDateOnly {
-    NSDateFormatter *df = [[NSDateFormatter alloc] init];
-    df.timeStyle = NSDateFormatterNoStyle;
-    df.dateStyle = NSDateFormatterShortStyle;
-    df.locale = NSLocale.currentLocale;
-    
+    NSDateFormatter *df = cachedDateFormatter(@"friendlyDateStringVeryShortDateOnly", ^(NSDateFormatter *formatter) {
+        formatter.timeStyle = NSDateFormatterNoStyle;
+        formatter.dateStyle = NSDateFormatterShortStyle;
+        formatter.locale = NSLocale.currentLocale;
+    });
+
     return [df stringFromDate:self];
 }
 
 - (NSString *)friendlyDateTimeStringPrecise {
-    NSDateFormatter *df = [[NSDateFormatter alloc] init];
-    
-    df.timeStyle = NSDateFormatterMediumStyle;
-    df.dateStyle = NSDateFormatterShortStyle;
-    df.doesRelativeDateFormatting = YES;
-    df.locale = NSLocale.currentLocale;
+    NSDateFormatter *df = cachedDateFormatter(@"friendlyDateTimeStringPrecise", ^(NSDateFormatter *formatter) {
+        formatter.timeStyle = NSDateFormatterMediumStyle;
+        formatter.dateStyle = NSDateFormatterShortStyle;
+        formatter.doesRelativeDateFormatting = YES;
+        formatter.locale = NSLocale.currentLocale;
+    });
 
     return [df stringFromDate:self];
 }
 
 - (NSString *)fileNameCompatibleDateTime {
-    NSDateFormatter *df = [[NSDateFormatter alloc] init];
-    NSLocale *enUSPOSIXLocale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-    [df setLocale:enUSPOSIXLocale];
-    [df setDateFormat:@"yyyyMMdd_HHmmss"];
+    NSDateFormatter *df = cachedDateFormatter(@"fileNameCompatibleDateTime", ^(NSDateFormatter *formatter) {
+        formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        formatter.dateFormat = @"yyyyMMdd_HHmmss";
+    });
 
     return [df stringFromDate:self];
 }
 
 - (NSString *)fileNameCompatibleDateTimePrecise {
-    NSDateFormatter *df = [[NSDateFormatter alloc] init];
-    NSLocale *enUSPOSIXLocale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-    [df setLocale:enUSPOSIXLocale];
-    [df setDateFormat:@"yyyyMMdd_HHmmss_SSS"];
+    NSDateFormatter *df = cachedDateFormatter(@"fileNameCompatibleDateTimePrecise", ^(NSDateFormatter *formatter) {
+        formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        formatter.dateFormat = @"yyyyMMdd_HHmmss_SSS";
+    });
 
     return [df stringFromDate:self];
 }
 
 - (NSString *)friendlyTimeStringPrecise {
-    NSDateFormatter *df = [[NSDateFormatter alloc] init];
-    NSLocale *enUSPOSIXLocale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-    [df setLocale:enUSPOSIXLocale];
-    [df setDateFormat:@"HH:mm:ss.SSS"];
+    NSDateFormatter *df = cachedDateFormatter(@"friendlyTimeStringPrecise", ^(NSDateFormatter *formatter) {
+        formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        formatter.dateFormat = @"HH:mm:ss.SSS";
+    });
 
     return [df stringFromDate:self];
 }
 
 - (NSString *)friendlyDateTimeStringBothPrecise {
-    NSDateFormatter *df = [[NSDateFormatter alloc] init];
-    NSLocale *enUSPOSIXLocale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-    [df setLocale:enUSPOSIXLocale];
-    [df setDateFormat:@"yyyy-MM-dd HH:mm:ss.SSS"];
+    NSDateFormatter *df = cachedDateFormatter(@"friendlyDateTimeStringBothPrecise", ^(NSDateFormatter *formatter) {
+        formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        formatter.dateFormat = @"yyyy-MM-dd HH:mm:ss.SSS";
+    });
 
     return [df stringFromDate:self];
 }
 
 - (NSString *)iso8601DateString {
-    NSDateFormatter *dateFormatter = [[NSDateFormatter alloc] init];
-    NSLocale *enUSPOSIXLocale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-    [dateFormatter setLocale:enUSPOSIXLocale];
-    [dateFormatter setDateFormat:@"yyyy-MM-dd'T'HH:mm:ssZZZZZ"];
+    NSDateFormatter *df = cachedDateFormatter(@"iso8601DateString", ^(NSDateFormatter *formatter) {
+        formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        formatter.dateFormat = @"yyyy-MM-dd'T'HH:mm:ssZZZZZ";
+    });
 
-    return [dateFormatter stringFromDate:self];
+    return [df stringFromDate:self];
 }
 
 + (instancetype)fromYYYY_MM_DDString:(NSString *)string {
-    NSDateFormatter *dateFormatter = [[NSDateFormatter alloc] init];
-    NSLocale *enUSPOSIXLocale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-    [dateFormatter setLocale:enUSPOSIXLocale];
-    [dateFormatter setDateFormat:@"yyyy-MM-dd"];
+    NSDateFormatter *dateFormatter = cachedDateFormatter(@"fromYYYY_MM_DDString", ^(NSDateFormatter *formatter) {
+        formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        formatter.dateFormat = @"yyyy-MM-dd";
+    });
 
     return [dateFormatter dateFromString:string];
 }
 
 + (instancetype)fromYYYY_MM_DD_London_Noon_Time_String:(NSString *)string {
-    NSTimeZone* sourceTimeZone = [NSTimeZone timeZoneWithName:@"Europe/London"];
-    
-    NSDateFormatter *dateFormatter = [[NSDateFormatter alloc] init];
-
-    [dateFormatter setDateFormat:@"yyyy-MM-dd"];
-    [dateFormatter setTimeZone:sourceTimeZone];
+    NSDateFormatter *dateFormatter = cachedDateFormatter(@"fromYYYY_MM_DD_London_Noon_Time_String", ^(NSDateFormatter *formatter) {
+        formatter.dateFormat = @"yyyy-MM-dd";
+        formatter.timeZone = [NSTimeZone timeZoneWithName:@"Europe/London"];
+    });
     
     NSDate* ret = [dateFormatter dateFromString:string];
     
@@ -219,15 +270,18 @@ static NSString *dateFormatWithoutMillis = @"yyyy-MM-dd'T'HH:mm:ssZZZZZ";
     NSDate *date = nil;
     if (dateString)
     {
-        NSDateFormatter *dateFormatter = [[NSDateFormatter alloc] init];
-        [dateFormatter setDateFormat:dateFormatWithMillis];
-        NSLocale *posix = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
-        [dateFormatter setLocale:posix];
+        NSDateFormatter *dateFormatter = cachedDateFormatter(@"microsoftGraphDateWithMillis", ^(NSDateFormatter *formatter) {
+            formatter.dateFormat = dateFormatWithMillis;
+            formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        });
         date = [dateFormatter dateFromString:dateString];
         
         if (!date)
         {
-            [dateFormatter setDateFormat:dateFormatWithoutMillis];
+            dateFormatter = cachedDateFormatter(@"microsoftGraphDateWithoutMillis", ^(NSDateFormatter *formatter) {
+                formatter.dateFormat = dateFormatWithoutMillis;
+                formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+            });
             date = [dateFormatter dateFromString:dateString];
         }
     }
@@ -9,6 +9,7 @@
 #import "PasswordMaker.h"
 #import "NSArray+Extensions.h"
 #import "Utils.h"
+#import "CommonPasswordFilter.h"
 
 static NSString* const kAllSymbols = @"+-=_@#$%^&;:,.<>/~\\[](){}?!|*'\"";
 static NSString* const kAllUppercase = @"ABCDEFGHIJKLMNOPQRSTUVWXYZ";
@@ -41,7 +42,7 @@ static NSString* const kEmojis = @"😀😃😄😁😆😅";
 @property NSArray<NSString*> *firstNamesCache;
 @property NSArray<NSString*> *surnamesCache;
 
-@property NSSet<NSString*>* commonPasswordsSetCache;
+@property CommonPasswordFilter* commonPasswordsFilter;
 
 @end
 
@@ -235,14 +236,27 @@ const static NSArray<NSString*> *kEmailDomains;
 #endif
 
 - (BOOL)isCommonPassword:(NSString *)password {
-    if(!self.commonPasswordsSetCache) {
-        NSMutableArray<NSString*>* common = [self getWordsForList:@"10-million-password-list-top-10000"].mutableCopy;
-        [common addObjectsFromArray:[self getWordsForList:@"eff_large_wordlist.utf8"]];
+    return [[self getCommonPasswordsFilter] contains:password];
+}
+
+- (CommonPasswordFilter*)getCommonPasswordsFilter {
+    @synchronized (self) {
+        if(!self.commonPasswordsFilter) {
+            NSString* path = [[NSBundle mainBundle] pathForResource:@"common-passwords" ofType:@"xor16"];
+            self.commonPasswordsFilter = path ? [CommonPasswordFilter filterWithContentsOfFile:path] : nil;
+            
+            if (!self.commonPasswordsFilter) {
+                NSLog(@"WARNWARN: Common password filter not bundled, building from word lists");
+                
+                NSMutableArray<NSString*>* common = [self loadWordsForList:@"10-million-password-list-top-10000"].mutableCopy;
+                [common addObjectsFromArray:[self getWordsForList:@"eff_large_wordlist.utf8"]];
+                
+                self.commonPasswordsFilter = [CommonPasswordFilter filterWithWords:common];
+            }
+        }
         
-        self.commonPasswordsSetCache = [NSSet setWithArray:common];
+        return self.commonPasswordsFilter;
     }
-    
-    return [self.commonPasswordsSetCache containsObject:password.lowercaseString]; 
 }
 
 - (NSString*)generateName {
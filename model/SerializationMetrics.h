@@ -0,0 +1,55 @@
+//
+//  SerializationMetrics.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+static NSString* const kSerializationStageIo = @"io";
+static NSString* const kSerializationStageKdf = @"kdf";
+static NSString* const kSerializationStageIntegrity = @"integrity";
+static NSString* const kSerializationStageCipher = @"cipher";
+static NSString* const kSerializationStageCompression = @"compression";
+static NSString* const kSerializationStageDocument = @"document";
+static NSString* const kSerializationStageModel = @"model";
+static NSString* const kSerializationStageFastMaps = @"fastMaps";
+
+@interface SerializationStageMetrics : NSObject
+
+@property (readonly) NSTimeInterval wallTime;
+@property (readonly) NSTimeInterval cpuTime;
+@property (readonly) unsigned long long bytes;
+@property (readonly) NSUInteger calls;
+
+- (NSDictionary<NSString*, id>*)jsonDictionary;
+
+@end
+
+// Opt-in per-stage timing for a single open or save. Stages nest (a decrypting stream reads from
+// an HMAC block stream which reads from the file) and each stage records only its own time, so the
+// stage totals add up to the operation total. CPU time is process wide so that worker threads
+// (parallel deflate, multi-lane Argon2) are attributed to the stage that is waiting on them.
+
+@interface SerializationMetrics : NSObject
+
+- (void)start;
+- (void)stop;
+
+- (void)beginStage:(NSString*)stage;
+- (void)endStage:(NSString*)stage;
+- (void)addBytes:(unsigned long long)bytes stage:(NSString*)stage;
+
+@property (readonly) NSTimeInterval wallTime;
+@property (readonly) NSTimeInterval cpuTime;
+@property (readonly) NSDictionary<NSString*, SerializationStageMetrics*>* stages;
+
+- (NSDictionary<NSString*, id>*)jsonDictionary;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,173 @@
+//
+//  SerializationMetrics.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "SerializationMetrics.h"
+#include <time.h>
+
+static NSTimeInterval clockSeconds(clockid_t clock) {
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+
+    return (NSTimeInterval)ts.tv_sec + (NSTimeInterval)ts.tv_nsec / 1e9;
+}
+
+@interface SerializationStageMetrics ()
+
+@property NSTimeInterval wallTime;
+@property NSTimeInterval cpuTime;
+@property unsigned long long bytes;
+@property NSUInteger calls;
+
+@end
+
+@implementation SerializationStageMetrics
+
+- (NSDictionary<NSString*, id>*)jsonDictionary {
+    return @{ @"wallMs" : @(self.wallTime * 1000.0),
+              @"cpuMs" : @(self.cpuTime * 1000.0),
+              @"bytes" : @(self.bytes),
+              @"calls" : @(self.calls) };
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"wall = %.3fms, cpu = %.3fms, bytes = %llu, calls = %lu", self.wallTime * 1000.0, self.cpuTime * 1000.0, self.bytes, (unsigned long)self.calls];
+}
+
+@end
+
+@interface SerializationMetricsFrame : NSObject
+
+@property NSString* stage;
+@property NSTimeInterval wallStart;
+@property NSTimeInterval cpuStart;
+@property NSTimeInterval childWall;
+@property NSTimeInterval childCpu;
+
+@end
+
+@implementation SerializationMetricsFrame
+
+@end
+
+@interface SerializationMetrics ()
+
+@property NSMutableDictionary<NSString*, SerializationStageMetrics*>* mutableStages;
+@property NSMutableArray<SerializationMetricsFrame*>* frames;
+@property NSTimeInterval wallStart;
+@property NSTimeInterval cpuStart;
+@property NSTimeInterval wallTime;
+@property NSTimeInterval cpuTime;
+
+@end
+
+@implementation SerializationMetrics
+
+- (instancetype)init {
+    if (self = [super init]) {
+        self.mutableStages = NSMutableDictionary.dictionary;
+        self.frames = NSMutableArray.array;
+    }
+
+    return self;
+}
+
+- (void)start {
+    @synchronized (self) {
+        self.wallStart = clockSeconds(CLOCK_MONOTONIC);
+        self.cpuStart = clockSeconds(CLOCK_PROCESS_CPUTIME_ID);
+    }
+}
+
+- (void)stop {
+    @synchronized (self) {
+        self.wallTime = clockSeconds(CLOCK_MONOTONIC) - self.wallStart;
+        self.cpuTime = clockSeconds(CLOCK_PROCESS_CPUTIME_ID) - self.cpuStart;
+    }
+}
+
+- (SerializationStageMetrics*)metricsForStage:(NSString*)stage {
+    SerializationStageMetrics* ret = self.mutableStages[stage];
+
+    if ( ret == nil ) {
+        ret = [[SerializationStageMetrics alloc] init];
+        self.mutableStages[stage] = ret;
+    }
+
+    return ret;
+}
+
+- (void)beginStage:(NSString *)stage {
+    @synchronized (self) {
+        SerializationMetricsFrame* frame = [[SerializationMetricsFrame alloc] init];
+
+        frame.stage = stage;
+        frame.wallStart = clockSeconds(CLOCK_MONOTONIC);
+        frame.cpuStart = clockSeconds(CLOCK_PROCESS_CPUTIME_ID);
+
+        [self.frames addObject:frame];
+    }
+}
+
+- (void)endStage:(NSString *)stage {
+    @synchronized (self) {
+        SerializationMetricsFrame* frame = self.frames.lastObject;
+
+        if ( frame == nil || ![frame.stage isEqualToString:stage] ) {
+            NSLog(@"🔴 SerializationMetrics: Unbalanced end of stage [%@] - expected [%@]", stage, frame.stage);
+            return;
+        }
+
+        [self.frames removeLastObject];
+
+        NSTimeInterval wall = clockSeconds(CLOCK_MONOTONIC) - frame.wallStart;
+        NSTimeInterval cpu = clockSeconds(CLOCK_PROCESS_CPUTIME_ID) - frame.cpuStart;
+
+        SerializationStageMetrics* metrics = [self metricsForStage:stage];
+
+        metrics.wallTime += MAX(0, wall - frame.childWall);
+        metrics.cpuTime += MAX(0, cpu - frame.childCpu);
+        metrics.calls++;
+
+        SerializationMetricsFrame* parent = self.frames.lastObject;
+        if ( parent ) {
+            parent.childWall += wall;
+            parent.childCpu += cpu;
+        }
+    }
+}
+
+- (void)addBytes:(unsigned long long)bytes stage:(NSString *)stage {
+    @synchronized (self) {
+        [self metricsForStage:stage].bytes += bytes;
+    }
+}
+
+- (NSDictionary<NSString *,SerializationStageMetrics *> *)stages {
+    @synchronized (self) {
+        return self.mutableStages.copy;
+    }
+}
+
+- (NSDictionary<NSString *,id> *)jsonDictionary {
+    NSMutableDictionary<NSString*, id>* stages = NSMutableDictionary.dictionary;
+
+    [self.stages enumerateKeysAndObjectsUsingBlock:^(NSString * _Nonnull key, SerializationStageMetrics * _Nonnull obj, BOOL * _Nonnull stop) {
+        stages[key] = [obj jsonDictionary];
+    }];
+
+    return @{ @"wallMs" : @(self.wallTime * 1000.0),
+              @"cpuMs" : @(self.cpuTime * 1000.0),
+              @"stages" : stages };
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"wall = %.3fms, cpu = %.3fms, stages = %@", self.wallTime * 1000.0, self.cpuTime * 1000.0, self.stages];
+}
+
+@end
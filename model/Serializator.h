@@ -32,6 +32,8 @@ typedef void (^DeserializeCompletionBlock)(BOOL userCancelled, DatabaseModel *_N
 
 + (DatabaseModel*_Nullable)expressFromData:(NSData*)data password:(NSString*)password config:(DatabaseModelConfig*)config xml:(NSString*_Nullable*_Nullable)xml;
 
++ (DatabaseModel*_Nullable)expressFromData:(NSData*)data password:(NSString*)password metrics:(SerializationMetrics*_Nullable)metrics;
+
 + (NSString *_Nullable)expressToXml:(NSData*)data password:(NSString*)password;
 
 + (void)fromLegacyData:legacyData
@@ -54,6 +56,13 @@ typedef void (^DeserializeCompletionBlock)(BOOL userCancelled, DatabaseModel *_N
   xmlDumpStream:(NSOutputStream*_Nullable)xmlDumpStream
      completion:(DeserializeCompletionBlock)completion;
 
++ (void)fromUrl:(NSURL *)url
+            ckf:(CompositeKeyFactors *)ckf
+         config:(DatabaseModelConfig*)config
+  xmlDumpStream:(NSOutputStream*_Nullable)xmlDumpStream
+        metrics:(SerializationMetrics*_Nullable)metrics
+     completion:(DeserializeCompletionBlock)completion;
+
 + (void)fromUrlOrLegacyData:(NSURL *)url
                  legacyData:(NSData *)legacyData
                         ckf:(CompositeKeyFactors *)ckf
@@ -63,8 +72,10 @@ typedef void (^DeserializeCompletionBlock)(BOOL userCancelled, DatabaseModel *_N
 
 
 + (NSData*_Nullable)expressToData:(DatabaseModel*)database format:(DatabaseFormat)format;
++ (NSData*_Nullable)expressToData:(DatabaseModel*)database format:(DatabaseFormat)format metrics:(SerializationMetrics*_Nullable)metrics;
 
 + (void)getAsData:(DatabaseModel*)database format:(DatabaseFormat)format outputStream:(NSOutputStream*)outputStream completion:(SaveCompletionBlock)completion;
++ (void)getAsData:(DatabaseModel*)database format:(DatabaseFormat)format outputStream:(NSOutputStream*)outputStream metrics:(SerializationMetrics*_Nullable)metrics completion:(SaveCompletionBlock)completion;
 
 @end
 
@@ -175,6 +175,10 @@
 
 
 + (NSData *)expressToData:(DatabaseModel *)database format:(DatabaseFormat)format {
+    return [Serializator expressToData:database format:format metrics:nil];
+}
+
++ (NSData *)expressToData:(DatabaseModel *)database format:(DatabaseFormat)format metrics:(SerializationMetrics *)metrics {
     __block NSData* ret;
 
     dispatch_group_t group = dispatch_group_create();
@@ -186,6 +190,7 @@
     [Serializator getAsData:database
                      format:format
                outputStream:memStream
+                    metrics:metrics
                  completion:^(BOOL userCancelled, NSString * _Nullable debugXml, NSError * _Nullable error) {
         [memStream close];
 
@@ -207,18 +212,38 @@
            format:(DatabaseFormat)format
      outputStream:(NSOutputStream*)outputStream
        completion:(SaveCompletionBlock)completion {
+    [Serializator getAsData:database format:format outputStream:outputStream metrics:nil completion:completion];
+}
+
++ (void)getAsData:(DatabaseModel *)database
+           format:(DatabaseFormat)format
+     outputStream:(NSOutputStream*)outputStream
+          metrics:(SerializationMetrics*)metrics
+       completion:(SaveCompletionBlock)completion {
     [database preSerializationPerformMaintenanceOrMigrations]; 
 
     id<AbstractDatabaseFormatAdaptor> adaptor = [Serializator getAdaptor:format];
 
     NSTimeInterval startTime = NSDate.timeIntervalSinceReferenceDate;
+    
+    [metrics start];
             
     [adaptor save:database
      outputStream:outputStream
+          metrics:metrics
        completion:^(BOOL userCancelled, NSString*_Nullable debugXml, NSError*_Nullable error){
 
         NSLog(@"🐞 Serializator::SERIALIZE [%f] seconds", NSDate.timeIntervalSinceReferenceDate - startTime);
 
+        if ( metrics ) {
+            [metrics stop];
+            NSLog(@"🐞 Serializator::SERIALIZE metrics [%@]", metrics);
+            
+            if ( !userCancelled && !error ) {
+                database.serializationMetrics = metrics;
+            }
+        }
+
         
         completion(userCancelled, nil, error);
     }];
@@ -236,7 +261,15 @@
     return xml;
 }
 
++ (DatabaseModel *)expressFromData:(NSData *)data password:(NSString *)password metrics:(SerializationMetrics *)metrics {
+    return [self expressFromData:data password:password config:DatabaseModelConfig.defaults xml:nil metrics:metrics];
+}
+
 + (DatabaseModel *)expressFromData:(NSData *)data password:(NSString *)password config:(DatabaseModelConfig *)config xml:(NSString**)xml {
+    return [self expressFromData:data password:password config:config xml:xml metrics:nil];
+}
+
++ (DatabaseModel *)expressFromData:(NSData *)data password:(NSString *)password config:(DatabaseModelConfig *)config xml:(NSString**)xml metrics:(SerializationMetrics*)metrics {
     DatabaseFormat format = [Serializator getDatabaseFormatWithPrefix:data];
     id<AbstractDatabaseFormatAdaptor> adaptor = [Serializator getAdaptor:format];
     if (adaptor == nil) {
@@ -252,12 +285,15 @@
 
     NSInputStream* stream = [NSInputStream inputStreamWithData:data];
     [stream open];
+    [metrics start];
     [adaptor read:stream
               ckf:[CompositeKeyFactors password:password]
     xmlDumpStream:xmlDumpStream
 sanityCheckInnerStream:config.sanityCheckInnerStream
+          metrics:metrics
        completion:^(BOOL userCancelled, DatabaseModel * _Nullable database, NSError * _Nullable innerStreamError, NSError * _Nullable error) {
         [stream close];
+        [metrics stop];
       
         if( userCancelled || database == nil || error || innerStreamError ) {
             NSLog(@"Error: expressFromData = [%@]", error);
@@ -265,6 +301,7 @@ sanityCheckInnerStream:config.sanityCheckInnerStream
         }
         else {
             model = database;
+            model.serializationMetrics = metrics;
         }
         
         dispatch_group_leave(group);
@@ -315,6 +352,7 @@ sanityCheckInnerStream:config.sanityCheckInnerStream
                                  config:config
                                  format:format
                           xmlDumpStream:nil
+                                metrics:nil
                              completion:completion];
 }
 
@@ -334,6 +372,15 @@ sanityCheckInnerStream:config.sanityCheckInnerStream
          config:(DatabaseModelConfig *)config
   xmlDumpStream:(NSOutputStream *)xmlDumpStream
      completion:(nonnull DeserializeCompletionBlock)completion {
+    [Serializator fromUrl:url ckf:ckf config:config xmlDumpStream:xmlDumpStream metrics:nil completion:completion];
+}
+
++ (void)fromUrl:(NSURL *)url
+            ckf:(CompositeKeyFactors *)ckf
+         config:(DatabaseModelConfig *)config
+  xmlDumpStream:(NSOutputStream *)xmlDumpStream
+        metrics:(SerializationMetrics *)metrics
+     completion:(nonnull DeserializeCompletionBlock)completion {
     DatabaseFormat format = [Serializator getDatabaseFormat:url];
      
     NSInputStream* stream = [NSInputStream inputStreamWithURL:url];
@@ -346,6 +393,7 @@ sanityCheckInnerStream:config.sanityCheckInnerStream
                                  config:config
                                  format:format
                           xmlDumpStream:xmlDumpStream
+                                metrics:metrics
                              completion:completion];
 }
 
@@ -354,6 +402,7 @@ sanityCheckInnerStream:config.sanityCheckInnerStream
                       config:(DatabaseModelConfig*)config
                       format:(DatabaseFormat)format
                xmlDumpStream:(NSOutputStream*_Nullable)xmlDumpStream
+                     metrics:(SerializationMetrics*_Nullable)metrics
                   completion:(nonnull DeserializeCompletionBlock)completion {
     id<AbstractDatabaseFormatAdaptor> adaptor = [Serializator getAdaptor:format];
 
@@ -365,17 +414,20 @@ sanityCheckInnerStream:config.sanityCheckInnerStream
     NSTimeInterval startDecryptTime = NSDate.timeIntervalSinceReferenceDate;
     
     [stream open];
+    [metrics start];
         
-    [adaptor read:stream
-              ckf:ckf
-    xmlDumpStream:xmlDumpStream
-     sanityCheckInnerStream:config.sanityCheckInnerStream
-       completion:^(BOOL userCancelled, DatabaseModel * _Nullable database, NSError * _Nullable innerStreamError, NSError * _Nullable error) {
+    OpenCompletionBlock onRead = ^(BOOL userCancelled, DatabaseModel * _Nullable database, NSError * _Nullable innerStreamError, NSError * _Nullable error) {
         [stream close];
         
 
         NSLog(@"🐞 Serializator::DESERIALIZE [%f] seconds", NSDate.timeIntervalSinceReferenceDate - startDecryptTime);
 
+        if ( metrics ) {
+            [metrics stop];
+            NSLog(@"🐞 Serializator::DESERIALIZE metrics [%@]", metrics);
+            database.serializationMetrics = metrics;
+        }
+
 
         if(userCancelled || database == nil || error || innerStreamError ) {
             completion(userCancelled, nil, error ? error : innerStreamError);
@@ -383,7 +435,19 @@ sanityCheckInnerStream:config.sanityCheckInnerStream
         else {
             completion(NO, database, nil);
         }
-    }];
+    };
+    
+    if ( format == kKeePass4 && config.snapshotUrl && config.sourceSha256 && xmlDumpStream == nil ) {
+        [Kdbx4Database read:stream ckf:ckf snapshotUrl:config.snapshotUrl sourceSha256:config.sourceSha256 metrics:metrics completion:onRead];
+    }
+    else {
+        [adaptor read:stream
+                  ckf:ckf
+        xmlDumpStream:xmlDumpStream
+sanityCheckInnerStream:config.sanityCheckInnerStream
+              metrics:metrics
+           completion:onRead];
+    }
 }
 
 
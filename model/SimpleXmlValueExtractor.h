@@ -23,6 +23,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 
 + (NSDate *_Nullable)getDate:(id<XmlParsingDomainObject>)xmlObject v4Format:(BOOL)v4Format;
++ (NSDate *_Nullable)dateFromString:(NSString *_Nullable)text v4Format:(BOOL)v4Format;
 
 + (NSString *)getV4String:(NSDate *)date;
 + (NSString *)getV3String:(NSDate *)date;
@@ -30,6 +31,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 
 + (NSUUID*_Nullable)getUuid:(id<XmlParsingDomainObject>)xmlObject;
++ (NSUUID*_Nullable)uuidFromString:(NSString*_Nullable)text;
++ (NSString*)getUuidString:(NSUUID*)uuid;
 
 
 
@@ -23,6 +23,200 @@ static const NSISO8601DateFormatter *formatter;
 
 static NSDate* dotNetBaseEpochDate;
 
+static const char kBase64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static int8_t kBase64Decode[256];
+
+static const NSUInteger kDateBase64Length = 12;
+static const NSUInteger kUuidBase64Length = 24;
+static const NSUInteger kRfc3339Length = 20; // 2018-10-17T19:28:42Z
+
+// The fast paths below only handle the canonical forms we and KeePass write. Anything else returns NO and
+// the caller falls back to the Foundation implementation, so odd inputs behave exactly as they always have.
+
+static BOOL getAscii(NSString* text, char* buffer, NSUInteger length) {
+    if ( text.length != length ) {
+        return NO;
+    }
+    
+    NSUInteger used = 0;
+    BOOL ok = [text getBytes:buffer maxLength:length usedLength:&used encoding:NSASCIIStringEncoding options:0 range:NSMakeRange(0, length) remainingRange:NULL];
+    
+    return ok && used == length;
+}
+
+static BOOL decodeFixedBase64(const char* in, NSUInteger inLength, uint8_t* out, NSUInteger outLength) {
+    NSUInteger o = 0;
+    
+    for ( NSUInteger i = 0; i + 4 <= inLength; i += 4 ) {
+        int a = kBase64Decode[(uint8_t)in[i]];
+        int b = kBase64Decode[(uint8_t)in[i + 1]];
+        
+        if ( a < 0 || b < 0 || o + 1 > outLength ) {
+            return NO;
+        }
+        
+        uint32_t v = (a << 18) | (b << 12);
+        
+        if ( in[i + 2] == '=' ) {
+            if ( in[i + 3] != '=' || i + 4 != inLength || (b & 0x0F) ) {
+                return NO;
+            }
+            
+            out[o++] = (uint8_t)(v >> 16);
+            break;
+        }
+        
+        int c = kBase64Decode[(uint8_t)in[i + 2]];
+        if ( c < 0 || o + 2 > outLength ) {
+            return NO;
+        }
+        
+        v |= (c << 6);
+        
+        if ( in[i + 3] == '=' ) {
+            if ( i + 4 != inLength || (c & 0x03) ) {
+                return NO;
+            }
+            
+            out[o++] = (uint8_t)(v >> 16);
+            out[o++] = (uint8_t)(v >> 8);
+            break;
+        }
+        
+        int d = kBase64Decode[(uint8_t)in[i + 3]];
+        if ( d < 0 || o + 3 > outLength ) {
+            return NO;
+        }
+        
+        v |= d;
+        
+        out[o++] = (uint8_t)(v >> 16);
+        out[o++] = (uint8_t)(v >> 8);
+        out[o++] = (uint8_t)v;
+    }
+    
+    return o == outLength;
+}
+
+static NSString* encodeBase64(const uint8_t* in, NSUInteger length) {
+    char buffer[32];
+    NSUInteger o = 0;
+    
+    for ( NSUInteger i = 0; i < length; i += 3 ) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        NSUInteger remaining = length - i;
+        
+        if ( remaining > 1 ) {
+            v |= (uint32_t)in[i + 1] << 8;
+        }
+        if ( remaining > 2 ) {
+            v |= in[i + 2];
+        }
+        
+        buffer[o++] = kBase64Alphabet[(v >> 18) & 0x3F];
+        buffer[o++] = kBase64Alphabet[(v >> 12) & 0x3F];
+        buffer[o++] = remaining > 1 ? kBase64Alphabet[(v >> 6) & 0x3F] : '=';
+        buffer[o++] = remaining > 2 ? kBase64Alphabet[v & 0x3F] : '=';
+    }
+    
+    return [[NSString alloc] initWithBytes:buffer length:o encoding:NSASCIIStringEncoding];
+}
+
+// Proleptic Gregorian day arithmetic (Howard Hinnant's days_from_civil / civil_from_days). The formatter switches
+// to the Julian calendar before 1582 so the fast paths are limited to 1600-9999.
+
+static const int kMinFastYear = 1600;
+static const int kMaxFastYear = 9999;
+
+static int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+static void civilFromDays(int64_t z, int64_t* y, unsigned* m, unsigned* d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = (unsigned)(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = mp < 10 ? mp + 3 : mp - 9;
+    *y = (int64_t)yoe + era * 400 + (*m <= 2);
+}
+
+static unsigned daysInMonth(int64_t y, unsigned m) {
+    static const unsigned kDays[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    BOOL leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    
+    return m == 2 && leap ? 29 : kDays[m - 1];
+}
+
+static BOOL parseDigits(const char* s, int count, unsigned* value) {
+    unsigned v = 0;
+    
+    for ( int i = 0; i < count; i++ ) {
+        if ( s[i] < '0' || s[i] > '9' ) {
+            return NO;
+        }
+        v = v * 10 + (s[i] - '0');
+    }
+    
+    *value = v;
+    return YES;
+}
+
+static BOOL parseRfc3339(const char* s, NSTimeInterval* since1970) {
+    unsigned year, month, day, hour, minute, second;
+    
+    if ( s[4] != '-' || s[7] != '-' || s[10] != 'T' || s[13] != ':' || s[16] != ':' || s[19] != 'Z' ) {
+        return NO;
+    }
+    
+    if ( !parseDigits(s, 4, &year) || !parseDigits(&s[5], 2, &month) || !parseDigits(&s[8], 2, &day) ||
+         !parseDigits(&s[11], 2, &hour) || !parseDigits(&s[14], 2, &minute) || !parseDigits(&s[17], 2, &second) ) {
+        return NO;
+    }
+    
+    if ( year < kMinFastYear || year > kMaxFastYear || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month) ||
+         hour > 23 || minute > 59 || second > 59 ) {
+        return NO;
+    }
+    
+    *since1970 = (NSTimeInterval)(daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second);
+    return YES;
+}
+
+static NSString* formatRfc3339(NSTimeInterval since1970) {
+    if ( since1970 != floor(since1970) || fabs(since1970) > 1e12 ) {
+        return nil;
+    }
+    
+    int64_t seconds = (int64_t)since1970;
+    int64_t days = (seconds >= 0 ? seconds : seconds - 86399) / 86400;
+    int64_t secondOfDay = seconds - days * 86400;
+    
+    int64_t year;
+    unsigned month, day;
+    civilFromDays(days, &year, &month, &day);
+    
+    if ( year < kMinFastYear || year > kMaxFastYear ) {
+        return nil;
+    }
+    
+    char buffer[kRfc3339Length + 1];
+    snprintf(buffer, sizeof(buffer), "%04d-%02u-%02uT%02d:%02d:%02dZ", (int)year, month, day,
+             (int)(secondOfDay / 3600), (int)((secondOfDay / 60) % 60), (int)(secondOfDay % 60));
+    
+    return [[NSString alloc] initWithBytes:buffer length:kRfc3339Length encoding:NSASCIIStringEncoding];
+}
+
 @implementation SimpleXmlValueExtractor
 
 + (void) initialize {
@@ -42,6 +236,11 @@ static NSDate* dotNetBaseEpochDate;
         formatter.formatOptions = kFormatOptions;
         formatter.timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
         dotNetBaseEpochDate = [formatter dateFromString:@"0001-01-03T00:00:00Z"];
+        
+        memset(kBase64Decode, -1, sizeof(kBase64Decode));
+        for ( int i = 0; i < 64; i++ ) {
+            kBase64Decode[(uint8_t)kBase64Alphabet[i]] = i;
+        }
     }
 }
 
@@ -72,9 +271,19 @@ static NSDate* dotNetBaseEpochDate;
 
 
 + (NSDate *)getDate:(id<XmlParsingDomainObject>)xmlObject v4Format:(BOOL)v4Format {
+    return [self dateFromString:xmlObject.originalText v4Format:v4Format];
+}
+
++ (NSDate *)dateFromString:(NSString *)text v4Format:(BOOL)v4Format {
     if(v4Format) {
-        NSString* text = xmlObject.originalText;
-        NSData* dateData = [[NSData alloc] initWithBase64EncodedString:text options:NSDataBase64DecodingIgnoreUnknownCharacters];
+        char chars[kDateBase64Length];
+        uint8_t bytes[8];
+        
+        if ( getAscii(text, chars, kDateBase64Length) && decodeFixedBase64(chars, kDateBase64Length, bytes, sizeof(bytes)) ) {
+            return [NSDate dateWithTimeInterval:littleEndian8BytesToUInt64(bytes) sinceDate:dotNetBaseEpochDate];
+        }
+        
+        NSData* dateData = text ? [[NSData alloc] initWithBase64EncodedString:text options:NSDataBase64DecodingIgnoreUnknownCharacters] : nil;
         
         if(dateData.length != 8) {
             NSLog(@"DateData != 8!!");
@@ -85,25 +294,51 @@ static NSDate* dotNetBaseEpochDate;
         return [NSDate dateWithTimeInterval:c sinceDate:dotNetBaseEpochDate];
     }
     else {
-        return [formatter dateFromString:xmlObject.originalText];
+        char chars[kRfc3339Length];
+        NSTimeInterval since1970;
+        
+        if ( getAscii(text, chars, kRfc3339Length) && parseRfc3339(chars, &since1970) ) {
+            return [NSDate dateWithTimeIntervalSince1970:since1970];
+        }
+        
+        return text ? [formatter dateFromString:text] : nil;
     }
 }
 
 + (NSString *)getV4String:(NSDate *)date {
     NSTimeInterval interval = [date timeIntervalSinceDate:dotNetBaseEpochDate];
-    NSData* dateData = Uint64ToLittleEndianData(interval);
-    return [dateData base64EncodedStringWithOptions:kNilOptions];
+    
+    uint8_t bytes[8];
+    uint64_t ticks = interval;
+    for ( int i = 0; i < 8; i++ ) {
+        bytes[i] = (uint8_t)(ticks >> (i * 8));
+    }
+    
+    return encodeBase64(bytes, sizeof(bytes));
 }
 
 + (NSString *)getV3String:(NSDate *)date {
-    return [formatter stringFromDate:date];
+    NSString* ret = date ? formatRfc3339(date.timeIntervalSince1970) : nil;
+    
+    return ret ? ret : [formatter stringFromDate:date];
 }
 
 
 
 + (NSUUID *)getUuid:(id<XmlParsingDomainObject>)xmlObject {
-    NSData *uuidData = xmlObject.originalText ? [[NSData alloc] initWithBase64EncodedString:xmlObject.originalText
-                                                                                    options:NSDataBase64DecodingIgnoreUnknownCharacters] : nil;
+    return [self uuidFromString:xmlObject.originalText];
+}
+
++ (NSUUID *)uuidFromString:(NSString *)text {
+    char chars[kUuidBase64Length];
+    uuid_t bytes;
+    
+    if ( getAscii(text, chars, kUuidBase64Length) && decodeFixedBase64(chars, kUuidBase64Length, bytes, sizeof(uuid_t)) ) {
+        return [[NSUUID alloc] initWithUUIDBytes:bytes];
+    }
+    
+    NSData *uuidData = text ? [[NSData alloc] initWithBase64EncodedString:text
+                                                                 options:NSDataBase64DecodingIgnoreUnknownCharacters] : nil;
     
     if(uuidData && uuidData.length == sizeof(uuid_t)) {
         return [[NSUUID alloc] initWithUUIDBytes:uuidData.bytes];
@@ -113,6 +348,13 @@ static NSDate* dotNetBaseEpochDate;
     }
 }
 
++ (NSString *)getUuidString:(NSUUID *)uuid {
+    uuid_t bytes;
+    [uuid getUUIDBytes:bytes];
+    
+    return encodeBase64(bytes, sizeof(uuid_t));
+}
+
 
 
 + (NSNumber*)getNumber:(id<XmlParsingDomainObject>)xmlObject {
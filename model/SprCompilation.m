@@ -77,14 +77,14 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
 }
 
 - (NSString *)sprCompile:(NSString *)test node:(Node *)node database:(DatabaseModel*)database error:(NSError **)error {
-    return [self sprCompile:test node:node database:database depth:0 noRecurse:NO error:error];
+    return [self sprCompile:test node:node database:database depth:0 noRecurse:NO references:NSMutableDictionary.dictionary error:error];
 }
 
 - (NSString *)sprCompile:(NSString *)test node:(Node *)node database:(DatabaseModel*)database noRecurse:(BOOL)noRecurse error:(NSError **)error {
-    return [self sprCompile:test node:node database:database depth:0 noRecurse:noRecurse error:error];
+    return [self sprCompile:test node:node database:database depth:0 noRecurse:noRecurse references:NSMutableDictionary.dictionary error:error];
 }
 
-- (NSString *)sprCompile:(NSString *)test node:(Node *)node database:(DatabaseModel*)database depth:(NSUInteger)depth noRecurse:(BOOL)noRecurse error:(NSError **)error {
+- (NSString *)sprCompile:(NSString *)test node:(Node *)node database:(DatabaseModel*)database depth:(NSUInteger)depth noRecurse:(BOOL)noRecurse references:(NSMutableDictionary<NSString*, id>*)references error:(NSError **)error {
     if(!test.length || !node) {
         return @"";
     }
@@ -95,7 +95,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
     if(match) {
         if(depth < 10 && !noRecurse) { 
             NSError* matchError;
-            NSString* compiled = [self sprCompileRegexMatch:match test:test node:node database:database error:&matchError];
+            NSString* compiled = [self sprCompileRegexMatch:match test:test node:node database:database references:references error:&matchError];
 
             if(!compiled) {
 #ifdef DEBUG
@@ -110,7 +110,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
                 ret = [test stringByReplacingCharactersInRange:match.range withString:compiled];
                 
                 if(depth < 10 && !noRecurse) { 
-                    ret = [self sprCompile:ret node:node database:database depth:depth+1 noRecurse:noRecurse error:error];
+                    ret = [self sprCompile:ret node:node database:database depth:depth+1 noRecurse:noRecurse references:references error:error];
                 }
                 else {
                     NSLog(@"Depth/Recurse Limit Exceeded in SPR Compile... Will not attempt Further.");
@@ -125,7 +125,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
     return ret;
 }
 
-- (NSString*)sprCompileRegexMatch:(NSTextCheckingResult*)match test:(NSString*)test node:(Node*)node database:(DatabaseModel*)database error:(NSError**)error {
+- (NSString*)sprCompileRegexMatch:(NSTextCheckingResult*)match test:(NSString*)test node:(Node*)node database:(DatabaseModel*)database references:(NSMutableDictionary<NSString*, id>*)references error:(NSError**)error {
 
 
 
@@ -182,7 +182,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
         return [self sprCompileUrl:match test:test node:node database:database error:error]; 
     }
     else if([operation hasPrefix:kReferenceOperation]) {
-        return [self sprCompileReference:match test:test node:node database:database error:error];
+        return [self sprCompileReference:match test:test node:node database:database references:references error:error];
     }
     else {
         if(error) {
@@ -194,7 +194,7 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
     return nil;
 }
 
--(NSString*)sprCompileReference:(NSTextCheckingResult*)match test:(NSString*)test node:(Node*)node database:(DatabaseModel*)database error:(NSError**)error {
+-(NSString*)sprCompileReference:(NSTextCheckingResult*)match test:(NSString*)test node:(Node*)node database:(DatabaseModel*)database references:(NSMutableDictionary<NSString*, id>*)references error:(NSError**)error {
     NSString* desiredField = ([match rangeAtIndex:6].location == NSNotFound) ? nil : [test substringWithRange:[match rangeAtIndex:6]];
     NSString* searchByField = ([match rangeAtIndex:7].location == NSNotFound) ? nil : [test substringWithRange:[match rangeAtIndex:7]];
     NSString* searchTarget = ([match rangeAtIndex:8].location == NSNotFound) ? nil : [test substringWithRange:[match rangeAtIndex:8]];
@@ -208,7 +208,26 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
     
 
     
-    Node* target = [self findReferencedNode:searchByField searchTarget:searchTarget database:database error:error];
+    NSString* referenceKey = [NSString stringWithFormat:@"%@:%@", searchByField, searchTarget];
+    id cached = references[referenceKey];
+    
+    Node* target = nil;
+    if ( cached ) {
+        target = cached == NSNull.null ? nil : cached;
+    }
+    else {
+        NSError* findError;
+        target = [self findReferencedNode:searchByField searchTarget:searchTarget database:database error:&findError];
+        
+        if ( findError ) {
+            if ( error ) {
+                *error = findError;
+            }
+        }
+        else {
+            references[referenceKey] = target ? target : NSNull.null;
+        }
+    }
     
     if(!target) {
         return test; 
@@ -256,43 +275,22 @@ static NSString* const kSprCompilerRegex = @"\\{(TITLE|USERNAME|URL(:(RMVSCM|HOS
         target = [database getItemById:uuidTarget];
     }
     else if([searchByField isEqualToString:kReferenceFieldTitle]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            return !node.isGroup && [node.title localizedCaseInsensitiveContainsString:searchTarget];
-        }];
+        target = [database.fieldReferenceIndex firstEntryWhereField:kFieldReferenceIndexFieldTitle contains:searchTarget];
     }
     else if([searchByField isEqualToString:kReferenceFieldUsername]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            return !node.isGroup && [node.fields.username localizedCaseInsensitiveContainsString:searchTarget];
-        }];
+        target = [database.fieldReferenceIndex firstEntryWhereField:kFieldReferenceIndexFieldUsername contains:searchTarget];
     }
     else if([searchByField isEqualToString:kReferenceFieldPassword]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            return !node.isGroup && [node.fields.password localizedCaseInsensitiveContainsString:searchTarget];
-        }];
+        target = [database.fieldReferenceIndex firstEntryWhereField:kFieldReferenceIndexFieldPassword contains:searchTarget];
     }
     else if([searchByField isEqualToString:kReferenceFieldUrl]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            return !node.isGroup && [node.fields.url localizedCaseInsensitiveContainsString:searchTarget];
-        }];
+        target = [database.fieldReferenceIndex firstEntryWhereField:kFieldReferenceIndexFieldUrl contains:searchTarget];
     }
     else if([searchByField isEqualToString:kReferenceFieldNotes]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            return !database.rootNode.isGroup && [node.fields.notes localizedCaseInsensitiveContainsString:searchTarget];
-        }];
+        target = [database.fieldReferenceIndex firstEntryWhereField:kFieldReferenceIndexFieldNotes contains:searchTarget];
     }
     else if([searchByField isEqualToString:kReferenceFieldCustomFields]) {
-        target = [database.rootNode firstOrDefault:YES predicate:^BOOL(Node * _Nonnull node) {
-            if(node.isGroup) {
-                return NO;
-            }
-            else {
-                StringValue* strValue = [node.fields.customFields.allValues firstOrDefault:^BOOL(StringValue * _Nonnull obj) {
-                    return [obj.value localizedCaseInsensitiveContainsString:searchTarget];
-                }];
-                
-                return strValue != nil;
-            }
-        }];
+        target = [database.fieldReferenceIndex firstEntryWhereField:kFieldReferenceIndexFieldCustomFields contains:searchTarget];
     }
     
     return target;
@@ -0,0 +1,36 @@
+//
+//  TotpBatchGenerator.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "OTPToken.h"
+#import "FastMaps.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface TotpBatchGenerator : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithFastMaps:(FastMaps*)fastMaps;
+- (instancetype)initWithTokens:(NSDictionary<NSUUID*, OTPToken*>*)tokens;
+
+@property (readonly) NSUInteger count;
+
+// SHA-1/256/512 timer tokens are generated here from key schedules prepared once per token, and the code is reused
+// until that token's period rolls over. Steam, Yandex and counter tokens are delegated to OTPToken for the current time.
+
+- (NSDictionary<NSUUID*, NSString*>*)currentCodes;
+- (NSDictionary<NSUUID*, NSString*>*)codesAtDate:(NSDate*)date;
+
+- (NSString*_Nullable)currentCodeForId:(NSUUID*)uuid;
+- (NSString*_Nullable)codeForId:(NSUUID*)uuid date:(NSDate*)date;
+
++ (NSString*_Nullable)codeForToken:(OTPToken*)token date:(NSDate*)date;
+
+@end
+
+NS_ASSUME_NONNULL_END
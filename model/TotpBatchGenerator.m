@@ -0,0 +1,281 @@
+//
+//  TotpBatchGenerator.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "TotpBatchGenerator.h"
+#import "OTPToken+Generation.h"
+#import <CommonCrypto/CommonDigest.h>
+
+static const NSUInteger kMaxFastPathDigits = 9;
+static const uint32_t kPowersOfTen[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+typedef union {
+    CC_SHA1_CTX sha1;
+    CC_SHA256_CTX sha256;
+    CC_SHA512_CTX sha512;
+} TotpDigestContext;
+
+@interface TotpPreparedToken : NSObject {
+@public
+    OTPToken* _token;
+    Node* _node;
+    
+    BOOL _fastPath;
+    OTPAlgorithm _algorithm;
+    TotpDigestContext _inner;
+    TotpDigestContext _outer;
+    
+    uint64_t _cachedCounter;
+    NSString* _cachedCode;
+}
+
+@end
+
+@implementation TotpPreparedToken
+
+- (instancetype)initWithToken:(OTPToken*)token node:(Node*_Nullable)node {
+    if (self = [super init]) {
+        _node = node;
+        [self prepare:token];
+    }
+    
+    return self;
+}
+
+- (void)dealloc {
+    memset_s(&_inner, sizeof(_inner), 0, sizeof(_inner));
+    memset_s(&_outer, sizeof(_outer), 0, sizeof(_outer));
+}
+
+- (void)prepare:(OTPToken*)token {
+    _token = token;
+    _algorithm = token.algorithm;
+    _cachedCode = nil;
+    
+    BOOL supportedAlgorithm = _algorithm == OTPAlgorithmSHA1 || _algorithm == OTPAlgorithmSHA256 || _algorithm == OTPAlgorithmSHA512;
+    
+    _fastPath = token.type == OTPTokenTypeTimer && supportedAlgorithm && token.period >= 1 && token.digits >= 1 && token.digits <= kMaxFastPathDigits;
+    
+    if ( !_fastPath ) {
+        return;
+    }
+    
+    size_t blockSize = _algorithm == OTPAlgorithmSHA512 ? CC_SHA512_BLOCK_BYTES : CC_SHA1_BLOCK_BYTES;
+    uint8_t key[CC_SHA512_BLOCK_BYTES] = { 0 };
+    NSData* secret = token.secret;
+    
+    if ( secret.length > blockSize ) {
+        if ( _algorithm == OTPAlgorithmSHA1 ) {
+            CC_SHA1(secret.bytes, (CC_LONG)secret.length, key);
+        }
+        else if ( _algorithm == OTPAlgorithmSHA256 ) {
+            CC_SHA256(secret.bytes, (CC_LONG)secret.length, key);
+        }
+        else {
+            CC_SHA512(secret.bytes, (CC_LONG)secret.length, key);
+        }
+    }
+    else if ( secret.length ) {
+        memcpy(key, secret.bytes, secret.length);
+    }
+    
+    uint8_t ipad[CC_SHA512_BLOCK_BYTES];
+    uint8_t opad[CC_SHA512_BLOCK_BYTES];
+    
+    for ( size_t i = 0; i < blockSize; i++ ) {
+        ipad[i] = key[i] ^ 0x36;
+        opad[i] = key[i] ^ 0x5c;
+    }
+    
+    if ( _algorithm == OTPAlgorithmSHA1 ) {
+        CC_SHA1_Init(&_inner.sha1);
+        CC_SHA1_Update(&_inner.sha1, ipad, (CC_LONG)blockSize);
+        CC_SHA1_Init(&_outer.sha1);
+        CC_SHA1_Update(&_outer.sha1, opad, (CC_LONG)blockSize);
+    }
+    else if ( _algorithm == OTPAlgorithmSHA256 ) {
+        CC_SHA256_Init(&_inner.sha256);
+        CC_SHA256_Update(&_inner.sha256, ipad, (CC_LONG)blockSize);
+        CC_SHA256_Init(&_outer.sha256);
+        CC_SHA256_Update(&_outer.sha256, opad, (CC_LONG)blockSize);
+    }
+    else {
+        CC_SHA512_Init(&_inner.sha512);
+        CC_SHA512_Update(&_inner.sha512, ipad, (CC_LONG)blockSize);
+        CC_SHA512_Init(&_outer.sha512);
+        CC_SHA512_Update(&_outer.sha512, opad, (CC_LONG)blockSize);
+    }
+    
+    memset_s(key, sizeof(key), 0, sizeof(key));
+    memset_s(ipad, sizeof(ipad), 0, sizeof(ipad));
+    memset_s(opad, sizeof(opad), 0, sizeof(opad));
+}
+
+- (NSString*)codeAtDate:(NSDate*)date {
+    if ( _node && _node.fields.otpToken != _token ) {
+        OTPToken* edited = _node.fields.otpToken;
+        
+        if ( !edited ) {
+            return nil;
+        }
+        
+        [self prepare:edited];
+    }
+    
+    if ( !_fastPath ) {
+        return _token.password;
+    }
+    
+    uint64_t counter = (uint64_t)(date.timeIntervalSince1970 / _token.period);
+    
+    if ( _cachedCode == nil || counter != _cachedCounter ) {
+        _cachedCode = [self generate:counter];
+        _cachedCounter = counter;
+    }
+    
+    return _cachedCode;
+}
+
+- (NSString*)generate:(uint64_t)counter {
+    uint8_t message[sizeof(uint64_t)];
+    for ( int i = 0; i < sizeof(message); i++ ) {
+        message[i] = (uint8_t)(counter >> (56 - 8 * i));
+    }
+    
+    uint8_t digest[CC_SHA512_DIGEST_LENGTH];
+    size_t digestLength;
+    TotpDigestContext ctx;
+    
+    if ( _algorithm == OTPAlgorithmSHA1 ) {
+        digestLength = CC_SHA1_DIGEST_LENGTH;
+        ctx.sha1 = _inner.sha1;
+        CC_SHA1_Update(&ctx.sha1, message, sizeof(message));
+        CC_SHA1_Final(digest, &ctx.sha1);
+        ctx.sha1 = _outer.sha1;
+        CC_SHA1_Update(&ctx.sha1, digest, CC_SHA1_DIGEST_LENGTH);
+        CC_SHA1_Final(digest, &ctx.sha1);
+    }
+    else if ( _algorithm == OTPAlgorithmSHA256 ) {
+        digestLength = CC_SHA256_DIGEST_LENGTH;
+        ctx.sha256 = _inner.sha256;
+        CC_SHA256_Update(&ctx.sha256, message, sizeof(message));
+        CC_SHA256_Final(digest, &ctx.sha256);
+        ctx.sha256 = _outer.sha256;
+        CC_SHA256_Update(&ctx.sha256, digest, CC_SHA256_DIGEST_LENGTH);
+        CC_SHA256_Final(digest, &ctx.sha256);
+    }
+    else {
+        digestLength = CC_SHA512_DIGEST_LENGTH;
+        ctx.sha512 = _inner.sha512;
+        CC_SHA512_Update(&ctx.sha512, message, sizeof(message));
+        CC_SHA512_Final(digest, &ctx.sha512);
+        ctx.sha512 = _outer.sha512;
+        CC_SHA512_Update(&ctx.sha512, digest, CC_SHA512_DIGEST_LENGTH);
+        CC_SHA512_Final(digest, &ctx.sha512);
+    }
+    
+    memset_s(&ctx, sizeof(ctx), 0, sizeof(ctx));
+    
+    uint8_t offset = digest[digestLength - 1] & 0x0f;
+    uint32_t truncated = ((uint32_t)(digest[offset] & 0x7f) << 24) |
+                         ((uint32_t)digest[offset + 1] << 16) |
+                         ((uint32_t)digest[offset + 2] << 8) |
+                         (uint32_t)digest[offset + 3];
+    
+    NSUInteger digits = _token.digits;
+    
+    return [NSString stringWithFormat:@"%0*u", (int)digits, truncated % kPowersOfTen[digits]];
+}
+
+@end
+
+@interface TotpBatchGenerator ()
+
+@property (readonly) NSDictionary<NSUUID*, TotpPreparedToken*>* prepared;
+
+@end
+
+@implementation TotpBatchGenerator
+
+- (instancetype)initWithFastMaps:(FastMaps *)fastMaps {
+    if (self = [super init]) {
+        NSMutableDictionary<NSUUID*, TotpPreparedToken*>* prepared = [NSMutableDictionary dictionaryWithCapacity:fastMaps.withTotps.count];
+        
+        for ( NSUUID* uuid in fastMaps.withTotps ) {
+            Node* node = fastMaps.uuidMap[uuid];
+            OTPToken* token = node.fields.otpToken;
+            
+            if ( token ) {
+                prepared[uuid] = [[TotpPreparedToken alloc] initWithToken:token node:node];
+            }
+        }
+        
+        _prepared = prepared;
+    }
+    
+    return self;
+}
+
+- (instancetype)initWithTokens:(NSDictionary<NSUUID *,OTPToken *> *)tokens {
+    if (self = [super init]) {
+        NSMutableDictionary<NSUUID*, TotpPreparedToken*>* prepared = [NSMutableDictionary dictionaryWithCapacity:tokens.count];
+        
+        [tokens enumerateKeysAndObjectsUsingBlock:^(NSUUID * _Nonnull key, OTPToken * _Nonnull obj, BOOL * _Nonnull stop) {
+            prepared[key] = [[TotpPreparedToken alloc] initWithToken:obj node:nil];
+        }];
+        
+        _prepared = prepared;
+    }
+    
+    return self;
+}
+
+- (NSUInteger)count {
+    return self.prepared.count;
+}
+
+- (NSDictionary<NSUUID *,NSString *> *)currentCodes {
+    return [self codesAtDate:NSDate.date];
+}
+
+- (NSDictionary<NSUUID *,NSString *> *)codesAtDate:(NSDate *)date {
+    NSMutableDictionary<NSUUID*, NSString*>* ret = [NSMutableDictionary dictionaryWithCapacity:self.prepared.count];
+    
+    @synchronized (self) {
+        [self.prepared enumerateKeysAndObjectsUsingBlock:^(NSUUID * _Nonnull key, TotpPreparedToken * _Nonnull obj, BOOL * _Nonnull stop) {
+            NSString* code = [obj codeAtDate:date];
+            
+            if ( code ) {
+                ret[key] = code;
+            }
+        }];
+    }
+    
+    return ret;
+}
+
+- (NSString *)currentCodeForId:(NSUUID *)uuid {
+    return [self codeForId:uuid date:NSDate.date];
+}
+
+- (NSString *)codeForId:(NSUUID *)uuid date:(NSDate *)date {
+    TotpPreparedToken* prepared = self.prepared[uuid];
+    
+    if ( !prepared ) {
+        return nil;
+    }
+    
+    @synchronized (self) {
+        return [prepared codeAtDate:date];
+    }
+}
+
++ (NSString *)codeForToken:(OTPToken *)token date:(NSDate *)date {
+    return [[[TotpPreparedToken alloc] initWithToken:token node:nil] codeAtDate:date];
+}
+
+@end
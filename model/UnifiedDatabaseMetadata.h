@@ -11,6 +11,7 @@
 #import "KdfParameters.h"
 #import "DatabaseFormat.h"
 #import "ValueWithModDate.h"
+#import "CompressionProfile.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -68,6 +69,7 @@ extern const uint32_t kKP3DefaultInnerRandomStreamId;
 
 
 @property (nonatomic) uint32_t compressionFlags;
+@property (nonatomic) CompressionProfile compressionProfile;
 @property (nonatomic) uint32_t innerRandomStreamId;
 @property NSUUID* cipherUuid;
 
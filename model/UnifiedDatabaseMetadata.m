@@ -146,6 +146,35 @@ const uint32_t kKP3DefaultInnerRandomStreamId = kInnerStreamSalsa20;
     return ret;
 }
 
+- (CompressionProfile)compressionProfile {
+    NSString* value = self.customData[kCompressionProfileCustomDataKey].value;
+    
+    if ( [value isEqualToString:@"Fast"] ) {
+        return kCompressionProfileFast;
+    }
+    else if ( [value isEqualToString:@"Max"] ) {
+        return kCompressionProfileMax;
+    }
+    
+    return kCompressionProfileDefault;
+}
+
+- (void)setCompressionProfile:(CompressionProfile)compressionProfile {
+    if ( compressionProfile == self.compressionProfile ) {
+        return;
+    }
+    
+    if ( compressionProfile == kCompressionProfileFast ) {
+        self.customData[kCompressionProfileCustomDataKey] = [ValueWithModDate value:@"Fast" modified:NSDate.date];
+    }
+    else if ( compressionProfile == kCompressionProfileMax ) {
+        self.customData[kCompressionProfileCustomDataKey] = [ValueWithModDate value:@"Max" modified:NSDate.date];
+    }
+    else {
+        self.customData[kCompressionProfileCustomDataKey] = nil;
+    }
+}
+
 - (MutableOrderedDictionary<NSString *,NSString *> *)filteredKvpForUIWithFormat:(DatabaseFormat)format {
     if ( format == kKeePass1 ) {
         return [self kvpForUiKdb1];
@@ -0,0 +1,25 @@
+//
+//  VaultBenchmark.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "LargeVaultGenerator.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface VaultBenchmark : NSObject
+
+// Times generate, save, unlock, search, audit and merge for a generated vault. Stage timings are in
+// milliseconds and the result is suitable for NSJSONSerialization so runs can be diffed across commits.
+
++ (NSDictionary<NSString*, id>*)run:(LargeVaultGeneratorConfig*)config iterations:(NSUInteger)iterations;
+
++ (NSData*_Nullable)runAsJson:(LargeVaultGeneratorConfig*)config iterations:(NSUInteger)iterations;
+
+@end
+
+NS_ASSUME_NONNULL_END
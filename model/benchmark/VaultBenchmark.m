@@ -0,0 +1,171 @@
+//
+//  VaultBenchmark.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "VaultBenchmark.h"
+#import "Serializator.h"
+#import "DatabaseAuditor.h"
+#import "DatabaseMerger.h"
+
+static NSString* const kSearchTerms[] = { @"bank", @"example.com", @"login", @"travel 4", @"zzz-no-match" };
+static const NSUInteger kSearchTermCount = sizeof(kSearchTerms) / sizeof(kSearchTerms[0]);
+
+static const NSUInteger kMergeModifyEvery = 10;
+
+@implementation VaultBenchmark
+
++ (double)time:(void (^)(void))block {
+    NSTimeInterval start = NSDate.timeIntervalSinceReferenceDate;
+
+    block();
+
+    return (NSDate.timeIntervalSinceReferenceDate - start) * 1000.0;
+}
+
++ (NSDictionary<NSString*, id>*)run:(LargeVaultGeneratorConfig *)config iterations:(NSUInteger)iterations {
+    NSMutableDictionary<NSString*, NSMutableArray<NSNumber*>*>* timings = NSMutableDictionary.dictionary;
+    NSMutableDictionary<NSString*, id>* stats = NSMutableDictionary.dictionary;
+    NSArray<NSString*>* stages = @[@"generate", @"save", @"unlock", @"search", @"audit", @"merge"];
+
+    for ( NSString* stage in stages ) {
+        timings[stage] = NSMutableArray.array;
+    }
+
+    for ( NSUInteger i = 0; i < MAX(iterations, 1); i++ ) {
+        @autoreleasepool {
+            __block DatabaseModel* database;
+            __block NSData* data;
+            __block DatabaseModel* unlocked;
+
+            [timings[@"generate"] addObject:@([VaultBenchmark time:^{
+                database = [LargeVaultGenerator generate:config];
+            }])];
+
+            [timings[@"save"] addObject:@([VaultBenchmark time:^{
+                data = [Serializator expressToData:database format:config.format];
+            }])];
+
+            if ( data == nil ) {
+                return @{ @"config" : config.jsonDictionary, @"error" : @"Could not save generated vault" };
+            }
+
+            [timings[@"unlock"] addObject:@([VaultBenchmark time:^{
+                unlocked = [Serializator expressFromData:data password:config.password];
+            }])];
+
+            if ( unlocked == nil ) {
+                return @{ @"config" : config.jsonDictionary, @"error" : @"Could not unlock saved vault" };
+            }
+
+            __block NSUInteger searchHits = 0;
+            [timings[@"search"] addObject:@([VaultBenchmark time:^{
+                searchHits = [VaultBenchmark search:unlocked];
+            }])];
+
+            __block NSUInteger auditIssues = 0;
+            [timings[@"audit"] addObject:@([VaultBenchmark time:^{
+                auditIssues = [VaultBenchmark audit:unlocked];
+            }])];
+
+            __block BOOL merged = NO;
+            [timings[@"merge"] addObject:@([VaultBenchmark time:^{
+                merged = [VaultBenchmark merge:database theirs:unlocked];
+            }])];
+
+            stats[@"nodeCount"] = @(database.allSearchableIncludingRecycled.count);
+            stats[@"fileSize"] = @(data.length);
+            stats[@"searchHits"] = @(searchHits);
+            stats[@"auditIssueCount"] = @(auditIssues);
+            stats[@"merged"] = @(merged);
+        }
+    }
+
+    NSMutableDictionary<NSString*, id>* results = NSMutableDictionary.dictionary;
+    for ( NSString* stage in stages ) {
+        NSArray<NSNumber*>* samples = [timings[stage] sortedArrayUsingSelector:@selector(compare:)];
+
+        results[stage] = @{ @"samples" : timings[stage],
+                            @"min" : samples.firstObject,
+                            @"median" : samples[samples.count / 2],
+                            @"max" : samples.lastObject };
+    }
+
+    return @{ @"config" : config.jsonDictionary,
+              @"iterations" : @(MAX(iterations, 1)),
+              @"stats" : stats,
+              @"stagesMs" : results };
+}
+
++ (NSData *)runAsJson:(LargeVaultGeneratorConfig *)config iterations:(NSUInteger)iterations {
+    NSDictionary* results = [VaultBenchmark run:config iterations:iterations];
+
+    NSError* error;
+    NSData* json = [NSJSONSerialization dataWithJSONObject:results options:NSJSONWritingPrettyPrinted | NSJSONWritingSortedKeys error:&error];
+
+    if ( json == nil ) {
+        NSLog(@"🔴 VaultBenchmark: Could not serialize results [%@]", error);
+    }
+
+    return json;
+}
+
++ (NSUInteger)search:(DatabaseModel*)database {
+    NSUInteger hits = 0;
+    NSArray<Node*>* searchable = database.allSearchable;
+
+    for ( NSUInteger i = 0; i < kSearchTermCount; i++ ) {
+        for ( Node* node in searchable ) {
+            if ( [database isAllFieldsMatches:kSearchTerms[i] node:node dereference:YES checkPinYin:NO] ) {
+                hits++;
+            }
+        }
+    }
+
+    return hits;
+}
+
++ (NSUInteger)audit:(DatabaseModel*)database {
+    DatabaseAuditorConfiguration* config = DatabaseAuditorConfiguration.defaults;
+
+    config.checkHibp = NO;
+    config.checkForTwoFactorAvailable = NO;
+
+    DatabaseAuditor* auditor = [[DatabaseAuditor alloc] initWithPro:YES];
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+
+    BOOL started = [auditor start:database
+                           config:config
+                     nodesChanged:^{ }
+                         progress:^(double progress) { }
+                       completion:^(BOOL userStopped) {
+        dispatch_semaphore_signal(done);
+    }];
+
+    if ( !started ) {
+        return 0;
+    }
+
+    dispatch_semaphore_wait(done, DISPATCH_TIME_FOREVER);
+
+    return auditor.auditIssueCount;
+}
+
++ (BOOL)merge:(DatabaseModel*)mine theirs:(DatabaseModel*)theirs {
+    NSArray<Node*>* entries = theirs.allSearchable;
+    NSDate* now = NSDate.date;
+
+    for ( NSUInteger i = 0; i < entries.count; i += kMergeModifyEvery ) {
+        Node* entry = entries[i];
+
+        entry.fields.password = [NSString stringWithFormat:@"%@-rotated", entry.fields.password];
+        [entry touch:YES touchParents:NO date:now];
+    }
+
+    return [[DatabaseMerger mergerFor:mine theirs:theirs] merge];
+}
+
+@end
@@ -0,0 +1,105 @@
+//
+//  main.m
+//  vault-benchmark
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+//  Usage: vault-benchmark [-format kdbx4|kdbx3|kdb|psafe3] [-seed N] [-entries N] [-groupDepth N] [-groupsPerGroup N]
+//                         [-customFields N] [-historyDepth N] [-attachmentProbability P] [-minAttachmentSize N]
+//                         [-maxAttachmentSize N] [-totpProbability P] [-tagPoolSize N] [-maxTags N]
+//                         [-iterations N] [-output path]
+//
+//  macOS only. VaultBenchmark pulls in the model sources, which need CommonCrypto, Security, the Strongbox Swift
+//  module (Strongbox-Swift.h) and the Pods the app links, so this builds as a macOS Command Line Tool target that
+//  shares the MacBox model sources and settings. LargeVaultGeneratorTests runs the same harness from the
+//  existing test target.
+//
+
+#import <Foundation/Foundation.h>
+#import "VaultBenchmark.h"
+
+static DatabaseFormat formatFromString(NSString* string) {
+    NSString* lower = string.lowercaseString;
+
+    if ( [lower isEqualToString:@"kdbx3"] ) {
+        return kKeePass;
+    }
+    else if ( [lower isEqualToString:@"kdb"] ) {
+        return kKeePass1;
+    }
+    else if ( [lower isEqualToString:@"psafe3"] ) {
+        return kPasswordSafe;
+    }
+
+    return kKeePass4;
+}
+
+int main(int argc, const char * argv[]) {
+    @autoreleasepool {
+        NSUserDefaults* args = NSUserDefaults.standardUserDefaults;
+        LargeVaultGeneratorConfig* config = LargeVaultGeneratorConfig.defaults;
+
+        if ( [args stringForKey:@"format"] ) {
+            config.format = formatFromString([args stringForKey:@"format"]);
+        }
+        if ( [args objectForKey:@"seed"] ) {
+            config.seed = (uint64_t)[args integerForKey:@"seed"];
+        }
+        if ( [args objectForKey:@"entries"] ) {
+            config.entryCount = [args integerForKey:@"entries"];
+        }
+        if ( [args objectForKey:@"groupDepth"] ) {
+            config.groupDepth = [args integerForKey:@"groupDepth"];
+        }
+        if ( [args objectForKey:@"groupsPerGroup"] ) {
+            config.groupsPerGroup = [args integerForKey:@"groupsPerGroup"];
+        }
+        if ( [args objectForKey:@"customFields"] ) {
+            config.customFieldsPerEntry = [args integerForKey:@"customFields"];
+        }
+        if ( [args objectForKey:@"historyDepth"] ) {
+            config.historyDepth = [args integerForKey:@"historyDepth"];
+        }
+        if ( [args objectForKey:@"attachmentProbability"] ) {
+            config.attachmentProbability = [args doubleForKey:@"attachmentProbability"];
+        }
+        if ( [args objectForKey:@"minAttachmentSize"] ) {
+            config.minAttachmentSize = [args integerForKey:@"minAttachmentSize"];
+        }
+        if ( [args objectForKey:@"maxAttachmentSize"] ) {
+            config.maxAttachmentSize = [args integerForKey:@"maxAttachmentSize"];
+        }
+        if ( [args objectForKey:@"totpProbability"] ) {
+            config.totpProbability = [args doubleForKey:@"totpProbability"];
+        }
+        if ( [args objectForKey:@"tagPoolSize"] ) {
+            config.tagPoolSize = [args integerForKey:@"tagPoolSize"];
+        }
+        if ( [args objectForKey:@"maxTags"] ) {
+            config.maxTagsPerEntry = [args integerForKey:@"maxTags"];
+        }
+
+        NSUInteger iterations = [args objectForKey:@"iterations"] ? [args integerForKey:@"iterations"] : 3;
+
+        NSData* json = [VaultBenchmark runAsJson:config iterations:iterations];
+        if ( json == nil ) {
+            return 1;
+        }
+
+        NSString* output = [args stringForKey:@"output"];
+        if ( output.length ) {
+            NSError* error;
+            if ( ![json writeToFile:output options:NSDataWritingAtomic error:&error] ) {
+                NSLog(@"🔴 Could not write results to [%@] - [%@]", output, error);
+                return 1;
+            }
+        }
+        else {
+            [NSFileHandle.fileHandleWithStandardOutput writeData:json];
+            [NSFileHandle.fileHandleWithStandardOutput writeData:[@"\n" dataUsingEncoding:NSUTF8StringEncoding]];
+        }
+    }
+
+    return 0;
+}
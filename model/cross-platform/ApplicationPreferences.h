@@ -21,6 +21,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property PasswordStrengthConfig* passwordStrengthConfig;
 @property BOOL checkPinYin;
 @property BOOL atomicSftpWrite;
+@property BOOL useUnlockSnapshotCache;
 
 @property (nullable) NSDate* lastEntitlementCheckAttempt;
 @property NSUInteger numberOfEntitlementCheckFails;
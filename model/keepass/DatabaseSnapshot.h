@@ -0,0 +1,29 @@
+//
+//  DatabaseSnapshot.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "DatabaseModel.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// An encrypted, binary dump of an already parsed KDBX4 model (tree, metadata, attachments and the expensive
+// FastMaps sets) that lets us skip the XML parse on re-open. Bound to the SHA-256 of the source file and keyed
+// off the KDBX4 master key so it is only ever usable after the header HMAC has verified the credentials.
+
+@interface DatabaseSnapshot : NSObject
+
++ (NSData*)keyFromMasterKey:(NSData*)masterKey;
+
++ (NSData*_Nullable)serialize:(DatabaseModel*)database sourceSha256:(NSData*)sourceSha256 key:(NSData*)key;
++ (DatabaseModel*_Nullable)deserialize:(NSData*)snapshot sourceSha256:(NSData*)sourceSha256 key:(NSData*)key ckf:(CompositeKeyFactors*)ckf;
+
++ (void)writeSnapshot:(DatabaseModel*)database sourceSha256:(NSData*)sourceSha256 key:(NSData*)key url:(NSURL*)url;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,1208 @@
+//
+//  DatabaseSnapshot.m
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#import "DatabaseSnapshot.h"
+#import <CommonCrypto/CommonCrypto.h>
+#import "FastMaps.h"
+#import "KeePass2TagPackage.h"
+#import "KeePassAttachmentAbstractionLayer.h"
+#import "VariantObject.h"
+#import "Utils.h"
+
+static const uint8_t kSnapshotMagic[4] = { 'S', 'B', 'S', 'N' };
+static const uint8_t kSnapshotVersion = 1;
+static const size_t kSnapshotHeaderLength = sizeof(kSnapshotMagic) + 1 + CC_SHA256_DIGEST_LENGTH + kCCBlockSizeAES128;
+static const NSUInteger kSnapshotMaxAttachmentBytes = 32 * 1024 * 1024;
+
+static NSString* const kSnapshotKeyContext = @"Strongbox Snapshot v1";
+static NSString* const kSnapshotEncryptionKeyContext = @"encrypt";
+static NSString* const kSnapshotMacKeyContext = @"mac";
+
+typedef NS_ENUM(uint8_t, SnapshotIconKind) {
+    kSnapshotIconKindNone,
+    kSnapshotIconKindPreset,
+    kSnapshotIconKindPooled,
+    kSnapshotIconKindInline,
+};
+
+typedef NS_ENUM(uint8_t, SnapshotNumberKind) {
+    kSnapshotNumberKindNil,
+    kSnapshotNumberKindBool,
+    kSnapshotNumberKindSigned,
+    kSnapshotNumberKindUnsigned,
+    kSnapshotNumberKindDouble,
+};
+
+static const uint8_t kSnapshotNodeFlagGroup = 1;
+static const uint8_t kSnapshotNodeFlagChildRecordsAllowed = 2;
+
+static NSData* hmacSha256(NSData* key, NSData* data) {
+    NSMutableData* ret = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+    CCHmac(kCCHmacAlgSHA256, key.bytes, key.length, data.bytes, data.length, ret.mutableBytes);
+    return ret;
+}
+
+static NSData* subKey(NSData* key, NSString* context) {
+    return hmacSha256(key, [context dataUsingEncoding:NSUTF8StringEncoding]);
+}
+
+static BOOL constantTimeEquals(const uint8_t* a, const uint8_t* b, size_t length) {
+    uint8_t diff = 0;
+    for ( size_t i = 0; i < length; i++ ) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+
+
+@interface DatabaseSnapshotWriter : NSObject
+
+@property (readonly) NSMutableData* data;
+@property BOOL failed;
+@property NSDictionary<NSUUID*, NodeIcon*>* iconPool;
+@property (readonly) NSMutableArray<KeePassAttachmentAbstractionLayer*>* attachments;
+@property (readonly) NSMapTable<KeePassAttachmentAbstractionLayer*, NSNumber*>* attachmentIndices;
+
+@end
+
+@implementation DatabaseSnapshotWriter
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _data = [NSMutableData dataWithCapacity:1024 * 1024];
+        _attachments = NSMutableArray.array;
+        _attachmentIndices = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality valueOptions:NSPointerFunctionsStrongMemory];
+    }
+    return self;
+}
+
+- (void)byte:(uint8_t)value {
+    [self.data appendBytes:&value length:1];
+}
+
+- (void)varint:(uint64_t)value {
+    uint8_t buffer[10];
+    size_t n = 0;
+
+    while ( value >= 0x80 ) {
+        buffer[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buffer[n++] = (uint8_t)value;
+
+    [self.data appendBytes:buffer length:n];
+}
+
+- (void)string:(NSString*)string {
+    if ( string == nil ) {
+        [self varint:0];
+        return;
+    }
+
+    NSUInteger length = [string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    if ( length == 0 && string.length ) {
+        self.failed = YES;
+        return;
+    }
+
+    [self varint:length + 1];
+
+    NSUInteger offset = self.data.length;
+    NSUInteger used = 0;
+    [self.data increaseLengthBy:length];
+
+    BOOL ok = [string getBytes:(uint8_t*)self.data.mutableBytes + offset
+                     maxLength:length
+                    usedLength:&used
+                      encoding:NSUTF8StringEncoding
+                       options:0
+                         range:NSMakeRange(0, string.length)
+                remainingRange:NULL];
+
+    if ( !ok || used != length ) {
+        self.failed = YES;
+    }
+}
+
+- (void)bytes:(NSData*)data {
+    if ( data == nil ) {
+        [self varint:0];
+        return;
+    }
+
+    [self varint:data.length + 1];
+    [self.data appendData:data];
+}
+
+- (void)date:(NSDate*)date {
+    [self byte:date != nil];
+
+    if ( date ) {
+        NSTimeInterval interval = date.timeIntervalSinceReferenceDate;
+        [self.data appendBytes:&interval length:sizeof(interval)];
+    }
+}
+
+- (void)uuid:(NSUUID*)uuid {
+    [self byte:uuid != nil];
+
+    if ( uuid ) {
+        uuid_t bytes;
+        [uuid getUUIDBytes:bytes];
+        [self.data appendBytes:bytes length:sizeof(uuid_t)];
+    }
+}
+
+- (void)number:(NSNumber*)number {
+    if ( number == nil ) {
+        [self byte:kSnapshotNumberKindNil];
+        return;
+    }
+
+    if ( CFGetTypeID((__bridge CFTypeRef)number) == CFBooleanGetTypeID() ) {
+        [self byte:kSnapshotNumberKindBool];
+        [self byte:number.boolValue];
+        return;
+    }
+
+    switch ( number.objCType[0] ) {
+        case 'f':
+        case 'd':
+        {
+            double value = number.doubleValue;
+            [self byte:kSnapshotNumberKindDouble];
+            [self.data appendBytes:&value length:sizeof(value)];
+            break;
+        }
+        case 'C':
+        case 'S':
+        case 'I':
+        case 'L':
+        case 'Q':
+            [self byte:kSnapshotNumberKindUnsigned];
+            [self varint:number.unsignedLongLongValue];
+            break;
+        default:
+        {
+            int64_t value = number.longLongValue;
+            [self byte:kSnapshotNumberKindSigned];
+            [self varint:((uint64_t)value << 1) ^ (uint64_t)(value >> 63)];
+            break;
+        }
+    }
+}
+
+- (void)uuidSet:(NSSet<NSUUID*>*)set {
+    [self varint:set.count];
+
+    for ( NSUUID* uuid in set ) {
+        [self uuid:uuid];
+    }
+}
+
+- (void)countedSet:(NSCountedSet<NSString*>*)set {
+    [self varint:set.count];
+
+    for ( NSString* string in set ) {
+        [self string:string];
+        [self varint:[set countForObject:string]];
+    }
+}
+
+- (void)customData:(NSDictionary<NSString*, ValueWithModDate*>*)customData {
+    [self varint:customData.count];
+
+    for ( NSString* key in customData ) {
+        ValueWithModDate* value = customData[key];
+
+        [self string:key];
+        [self string:value.value];
+        [self date:value.modified];
+    }
+}
+
+- (void)metadata:(UnifiedDatabaseMetadata*)meta {
+    [self varint:meta.kdfIterations];
+    [self string:meta.generator];
+    [self varint:meta.compressionFlags];
+    [self uuid:meta.cipherUuid];
+    [self number:meta.historyMaxItems];
+    [self number:meta.historyMaxSize];
+    [self byte:meta.recycleBinEnabled];
+    [self uuid:meta.recycleBinGroup];
+    [self date:meta.recycleBinChanged];
+    [self date:meta.settingsChanged];
+    [self string:meta.databaseName];
+    [self date:meta.databaseNameChanged];
+    [self string:meta.databaseDescription];
+    [self date:meta.databaseDescriptionChanged];
+    [self string:meta.defaultUserName];
+    [self date:meta.defaultUserNameChanged];
+    [self string:meta.color];
+    [self uuid:meta.entryTemplatesGroup];
+    [self date:meta.entryTemplatesGroupChanged];
+    [self date:meta.lastUpdateTime];
+    [self string:meta.lastUpdateUser];
+    [self string:meta.lastUpdateHost];
+    [self string:meta.lastUpdateApp];
+    [self varint:meta.flags];
+    [self varint:meta.versionInt];
+    [self number:meta.maintenanceHistoryDays];
+    [self date:meta.masterKeyChanged];
+    [self number:meta.masterKeyChangeRec];
+    [self number:meta.masterKeyChangeForce];
+    [self number:meta.masterKeyChangeForceOnce];
+    [self uuid:meta.lastSelectedGroup];
+    [self uuid:meta.lastTopVisibleGroup];
+    [self number:meta.protectTitle];
+    [self number:meta.protectUsername];
+    [self number:meta.protectPassword];
+    [self number:meta.protectURL];
+    [self number:meta.protectNotes];
+    [self varint:meta.innerRandomStreamId];
+    [self string:meta.version];
+    [self customData:meta.customData];
+
+    NSDictionary<NSString*, VariantObject*>* kdfParameters = meta.kdfParameters.parameters;
+    [self byte:meta.kdfParameters != nil];
+    [self varint:kdfParameters.count];
+
+    for ( NSString* key in kdfParameters ) {
+        VariantObject* variant = kdfParameters[key];
+
+        [self string:key];
+        [self byte:variant.type];
+
+        if ( [variant.theObject isKindOfClass:NSNumber.class] ) {
+            [self byte:0];
+            [self number:(NSNumber*)variant.theObject];
+        }
+        else if ( [variant.theObject isKindOfClass:NSString.class] ) {
+            [self byte:1];
+            [self string:(NSString*)variant.theObject];
+        }
+        else if ( [variant.theObject isKindOfClass:NSData.class] ) {
+            [self byte:2];
+            [self bytes:(NSData*)variant.theObject];
+        }
+        else {
+            self.failed = YES;
+        }
+    }
+
+    KeePass2TagPackage* tag = [meta.adaptorTag isKindOfClass:KeePass2TagPackage.class] ? (KeePass2TagPackage*)meta.adaptorTag : nil;
+    [self varint:tag.unknownHeaders.count];
+
+    for ( NSNumber* key in tag.unknownHeaders ) {
+        NSObject* value = tag.unknownHeaders[key];
+
+        if ( ![value isKindOfClass:NSData.class] ) {
+            self.failed = YES;
+            return;
+        }
+
+        [self varint:key.unsignedLongLongValue];
+        [self bytes:(NSData*)value];
+    }
+}
+
+- (void)icon:(NodeIcon*)icon {
+    if ( icon == nil ) {
+        [self byte:kSnapshotIconKindNone];
+    }
+    else if ( !icon.isCustom ) {
+        [self byte:kSnapshotIconKindPreset];
+        [self varint:icon.preset];
+    }
+    else if ( icon.uuid && self.iconPool[icon.uuid] == icon ) {
+        [self byte:kSnapshotIconKindPooled];
+        [self uuid:icon.uuid];
+    }
+    else {
+        [self byte:kSnapshotIconKindInline];
+        [self customIcon:icon];
+    }
+}
+
+- (void)customIcon:(NodeIcon*)icon {
+    [self bytes:icon.custom];
+    [self uuid:icon.uuid];
+    [self string:icon.name];
+    [self date:icon.modified];
+    [self number:@(icon.preferredOrder)];
+}
+
+- (void)collectAttachments:(Node*)node {
+    for ( KeePassAttachmentAbstractionLayer* attachment in node.fields.attachments.allValues ) {
+        if ( [self.attachmentIndices objectForKey:attachment] == nil ) {
+            [self.attachmentIndices setObject:@(self.attachments.count) forKey:attachment];
+            [self.attachments addObject:attachment];
+        }
+    }
+
+    for ( Node* historical in node.fields.keePassHistory ) {
+        [self collectAttachments:historical];
+    }
+
+    for ( Node* child in node.children ) {
+        [self collectAttachments:child];
+    }
+}
+
+- (void)attachment:(KeePassAttachmentAbstractionLayer*)attachment {
+    [self byte:attachment.compressed];
+    [self byte:attachment.protectedInMemory];
+    [self varint:attachment.length];
+
+    NSInputStream* stream = [attachment getPlainTextInputStream];
+    if ( stream == nil ) {
+        self.failed = YES;
+        return;
+    }
+
+    NSUInteger offset = self.data.length;
+    [self.data increaseLengthBy:attachment.length];
+    uint8_t* p = (uint8_t*)self.data.mutableBytes + offset;
+
+    NSUInteger readSoFar = 0;
+    [stream open];
+    while ( readSoFar < attachment.length ) {
+        NSInteger read = [stream read:p + readSoFar maxLength:attachment.length - readSoFar];
+        if ( read <= 0 ) {
+            break;
+        }
+        readSoFar += read;
+    }
+    [stream close];
+
+    if ( readSoFar != attachment.length ) {
+        self.failed = YES;
+    }
+}
+
+- (void)fields:(NodeFields*)fields {
+    [self string:fields.username];
+    [self string:fields.url];
+    [self string:fields.password];
+    [self string:fields.notes];
+
+    MutableOrderedDictionary<NSString*, StringValue*>* customFields = fields.customFields;
+    [self varint:customFields.count];
+    for ( NSString* key in customFields.keys ) {
+        StringValue* value = customFields[key];
+
+        [self string:key];
+        [self string:value.value];
+        [self byte:value.protected];
+    }
+
+    [self date:fields.created];
+    [self date:fields.accessed];
+    [self date:fields.modified];
+    [self date:fields.locationChanged];
+    [self number:fields.usageCount];
+    [self date:fields.passwordModified];
+    [self date:fields.expires];
+
+    [self varint:fields.attachments.count];
+    for ( NSString* name in fields.attachments ) {
+        [self string:name];
+        [self varint:[self.attachmentIndices objectForKey:fields.attachments[name]].unsignedIntegerValue];
+    }
+
+    [self varint:fields.tags.count];
+    for ( NSString* tag in fields.tags ) {
+        [self string:tag];
+    }
+
+    [self customData:fields.customData];
+
+    [self string:fields.defaultAutoTypeSequence];
+    [self number:fields.enableAutoType];
+    [self number:fields.enableSearching];
+    [self uuid:fields.lastTopVisibleEntry];
+    [self string:fields.foregroundColor];
+    [self string:fields.backgroundColor];
+    [self string:fields.overrideURL];
+
+    AutoType* autoType = fields.autoType;
+    [self byte:autoType != nil];
+    if ( autoType ) {
+        [self byte:autoType.enabled];
+        [self number:@(autoType.dataTransferObfuscation)];
+        [self string:autoType.defaultSequence];
+        [self varint:autoType.asssociations.count];
+        for ( AutoTypeAssociation* association in autoType.asssociations ) {
+            [self string:association.window];
+            [self string:association.keystrokeSequence];
+        }
+    }
+
+    [self byte:fields.isExpanded];
+    [self byte:fields.qualityCheck];
+    [self uuid:fields.previousParentGroup];
+
+    [self varint:fields.keePassHistory.count];
+    for ( Node* historical in fields.keePassHistory ) {
+        [self node:historical];
+    }
+}
+
+- (void)node:(Node*)node {
+    [self byte:(node.isGroup ? kSnapshotNodeFlagGroup : 0) | (node.childRecordsAllowed ? kSnapshotNodeFlagChildRecordsAllowed : 0)];
+    [self uuid:node.uuid];
+    [self string:node.title];
+    [self icon:node.icon];
+    [self fields:node.fields];
+
+    NSArray<Node*>* children = node.children;
+    [self varint:children.count];
+    for ( Node* child in children ) {
+        [self node:child];
+    }
+}
+
+- (void)fastMaps:(FastMaps*)fastMaps {
+    [self uuidSet:fastMaps.withExpiryDates];
+    [self uuidSet:fastMaps.withAttachments];
+    [self uuidSet:fastMaps.withKeeAgentSshKeys];
+    [self uuidSet:fastMaps.withPasskeys];
+    [self uuidSet:fastMaps.withTotps];
+
+    [self varint:fastMaps.tagMap.count];
+    for ( NSString* tag in fastMaps.tagMap ) {
+        [self string:tag];
+        [self uuidSet:fastMaps.tagMap[tag]];
+    }
+
+    [self countedSet:fastMaps.usernameSet];
+    [self countedSet:fastMaps.emailSet];
+    [self countedSet:fastMaps.urlSet];
+    [self countedSet:fastMaps.customFieldKeySet];
+}
+
+@end
+
+
+
+typedef struct {
+    const uint8_t* bytes;
+    size_t length;
+    size_t offset;
+    BOOL failed;
+} SnapshotCursor;
+
+static const uint8_t* readBytes(SnapshotCursor* c, uint64_t length) {
+    if ( c->failed || length > c->length - c->offset ) {
+        c->failed = YES;
+        return NULL;
+    }
+
+    const uint8_t* ret = c->bytes + c->offset;
+    c->offset += length;
+    return ret;
+}
+
+static uint8_t readByte(SnapshotCursor* c) {
+    const uint8_t* p = readBytes(c, 1);
+    return p ? *p : 0;
+}
+
+static uint64_t readVarint(SnapshotCursor* c) {
+    uint64_t ret = 0;
+
+    for ( int shift = 0; shift < 64; shift += 7 ) {
+        const uint8_t* p = readBytes(c, 1);
+        if ( p == NULL ) {
+            return 0;
+        }
+
+        ret |= (uint64_t)(*p & 0x7F) << shift;
+
+        if ( (*p & 0x80) == 0 ) {
+            return ret;
+        }
+    }
+
+    c->failed = YES;
+    return 0;
+}
+
+static NSString* readString(SnapshotCursor* c) {
+    uint64_t length = readVarint(c);
+    if ( length == 0 ) {
+        return nil;
+    }
+
+    const uint8_t* p = readBytes(c, length - 1);
+    if ( p == NULL ) {
+        return nil;
+    }
+
+    NSString* ret = [[NSString alloc] initWithBytes:p length:length - 1 encoding:NSUTF8StringEncoding];
+    if ( ret == nil ) {
+        c->failed = YES;
+    }
+
+    return ret;
+}
+
+static NSString* readNonNullString(SnapshotCursor* c) {
+    NSString* ret = readString(c);
+    return ret ? ret : @"";
+}
+
+static NSData* readData(SnapshotCursor* c) {
+    uint64_t length = readVarint(c);
+    if ( length == 0 ) {
+        return nil;
+    }
+
+    const uint8_t* p = readBytes(c, length - 1);
+    return p ? [NSData dataWithBytes:p length:length - 1] : nil;
+}
+
+static NSDate* readDate(SnapshotCursor* c) {
+    if ( !readByte(c) ) {
+        return nil;
+    }
+
+    const uint8_t* p = readBytes(c, sizeof(NSTimeInterval));
+    if ( p == NULL ) {
+        return nil;
+    }
+
+    NSTimeInterval interval;
+    memcpy(&interval, p, sizeof(interval));
+    return [NSDate dateWithTimeIntervalSinceReferenceDate:interval];
+}
+
+static NSUUID* readUuid(SnapshotCursor* c) {
+    if ( !readByte(c) ) {
+        return nil;
+    }
+
+    const uint8_t* p = readBytes(c, sizeof(uuid_t));
+    return p ? [[NSUUID alloc] initWithUUIDBytes:p] : nil;
+}
+
+static NSNumber* readNumber(SnapshotCursor* c) {
+    switch ( readByte(c) ) {
+        case kSnapshotNumberKindNil:
+            return nil;
+        case kSnapshotNumberKindBool:
+            return @(readByte(c) != 0);
+        case kSnapshotNumberKindUnsigned:
+            return @(readVarint(c));
+        case kSnapshotNumberKindSigned:
+        {
+            uint64_t zigzag = readVarint(c);
+            return @((int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1));
+        }
+        case kSnapshotNumberKindDouble:
+        {
+            const uint8_t* p = readBytes(c, sizeof(double));
+            if ( p == NULL ) {
+                return nil;
+            }
+            double value;
+            memcpy(&value, p, sizeof(value));
+            return @(value);
+        }
+        default:
+            c->failed = YES;
+            return nil;
+    }
+}
+
+static NSSet<NSUUID*>* readUuidSet(SnapshotCursor* c) {
+    uint64_t count = readVarint(c);
+    NSMutableSet<NSUUID*>* ret = NSMutableSet.set;
+
+    for ( uint64_t i = 0; i < count && !c->failed; i++ ) {
+        NSUUID* uuid = readUuid(c);
+        if ( uuid ) {
+            [ret addObject:uuid];
+        }
+    }
+
+    return ret;
+}
+
+static NSCountedSet<NSString*>* readCountedSet(SnapshotCursor* c) {
+    uint64_t count = readVarint(c);
+    NSCountedSet<NSString*>* ret = NSCountedSet.set;
+
+    for ( uint64_t i = 0; i < count && !c->failed; i++ ) {
+        NSString* string = readNonNullString(c);
+        uint64_t occurrences = readVarint(c);
+
+        for ( uint64_t j = 0; j < occurrences && !c->failed; j++ ) {
+            [ret addObject:string];
+        }
+    }
+
+    return ret;
+}
+
+static NSMutableDictionary<NSString*, ValueWithModDate*>* readCustomData(SnapshotCursor* c) {
+    uint64_t count = readVarint(c);
+    NSMutableDictionary<NSString*, ValueWithModDate*>* ret = NSMutableDictionary.dictionary;
+
+    for ( uint64_t i = 0; i < count && !c->failed; i++ ) {
+        NSString* key = readNonNullString(c);
+        NSString* value = readNonNullString(c);
+
+        ret[key] = [ValueWithModDate value:value modified:readDate(c)];
+    }
+
+    return ret;
+}
+
+
+
+@interface DatabaseSnapshotReader : NSObject
+
+@property NSDictionary<NSUUID*, NodeIcon*>* iconPool;
+@property NSArray<KeePassAttachmentAbstractionLayer*>* attachments;
+
+@end
+
+@implementation DatabaseSnapshotReader
+
+- (UnifiedDatabaseMetadata*)metadata:(SnapshotCursor*)c {
+    UnifiedDatabaseMetadata* meta = [UnifiedDatabaseMetadata withDefaultsForFormat:kKeePass4];
+
+    meta.kdfIterations = readVarint(c);
+    meta.generator = readString(c);
+    meta.compressionFlags = (uint32_t)readVarint(c);
+    meta.cipherUuid = readUuid(c);
+    meta.historyMaxItems = readNumber(c);
+    meta.historyMaxSize = readNumber(c);
+    meta.recycleBinEnabled = readByte(c) != 0;
+    meta.recycleBinGroup = readUuid(c);
+    meta.recycleBinChanged = readDate(c);
+    meta.settingsChanged = readDate(c);
+    meta.databaseName = readString(c);
+    meta.databaseNameChanged = readDate(c);
+    meta.databaseDescription = readString(c);
+    meta.databaseDescriptionChanged = readDate(c);
+    meta.defaultUserName = readString(c);
+    meta.defaultUserNameChanged = readDate(c);
+    meta.color = readString(c);
+    meta.entryTemplatesGroup = readUuid(c);
+    meta.entryTemplatesGroupChanged = readDate(c);
+    meta.lastUpdateTime = readDate(c);
+    meta.lastUpdateUser = readString(c);
+    meta.lastUpdateHost = readString(c);
+    meta.lastUpdateApp = readString(c);
+    meta.flags = (uint32_t)readVarint(c);
+    meta.versionInt = (uint32_t)readVarint(c);
+    meta.maintenanceHistoryDays = readNumber(c);
+    meta.masterKeyChanged = readDate(c);
+    meta.masterKeyChangeRec = readNumber(c);
+    meta.masterKeyChangeForce = readNumber(c);
+    meta.masterKeyChangeForceOnce = readNumber(c);
+    meta.lastSelectedGroup = readUuid(c);
+    meta.lastTopVisibleGroup = readUuid(c);
+    meta.protectTitle = readNumber(c);
+    meta.protectUsername = readNumber(c);
+    meta.protectPassword = readNumber(c);
+    meta.protectURL = readNumber(c);
+    meta.protectNotes = readNumber(c);
+    meta.innerRandomStreamId = (uint32_t)readVarint(c);
+    meta.version = readString(c);
+    meta.customData = readCustomData(c);
+
+    BOOL hasKdfParameters = readByte(c) != 0;
+    uint64_t kdfParameterCount = readVarint(c);
+    NSMutableDictionary<NSString*, VariantObject*>* kdfParameters = NSMutableDictionary.dictionary;
+
+    for ( uint64_t i = 0; i < kdfParameterCount && !c->failed; i++ ) {
+        NSString* key = readNonNullString(c);
+        uint8_t type = readByte(c);
+        uint8_t kind = readByte(c);
+
+        NSObject* object = kind == 0 ? readNumber(c) : kind == 1 ? readString(c) : kind == 2 ? readData(c) : nil;
+        if ( object == nil ) {
+            c->failed = YES;
+            break;
+        }
+
+        kdfParameters[key] = [[VariantObject alloc] initWithType:type theObject:object];
+    }
+
+    meta.kdfParameters = hasKdfParameters ? [[KdfParameters alloc] initWithParameters:kdfParameters] : nil;
+
+    uint64_t unknownHeaderCount = readVarint(c);
+    NSMutableDictionary<NSNumber*, NSObject*>* unknownHeaders = NSMutableDictionary.dictionary;
+
+    for ( uint64_t i = 0; i < unknownHeaderCount && !c->failed; i++ ) {
+        NSNumber* key = @(readVarint(c));
+        NSData* value = readData(c);
+
+        unknownHeaders[key] = value ? value : NSData.data;
+    }
+
+    KeePass2TagPackage* tag = [[KeePass2TagPackage alloc] init];
+    tag.unknownHeaders = unknownHeaders;
+    meta.adaptorTag = tag;
+
+    return meta;
+}
+
+- (NodeIcon*)customIcon:(SnapshotCursor*)c {
+    NSData* custom = readData(c);
+    NSUUID* uuid = readUuid(c);
+    NSString* name = readString(c);
+    NSDate* modified = readDate(c);
+    NSNumber* preferredOrder = readNumber(c);
+
+    if ( custom == nil || uuid == nil ) {
+        c->failed = YES;
+        return nil;
+    }
+
+    return [NodeIcon withCustom:custom uuid:uuid name:name modified:modified preferredOrder:preferredOrder.integerValue];
+}
+
+- (NodeIcon*)icon:(SnapshotCursor*)c {
+    switch ( readByte(c) ) {
+        case kSnapshotIconKindNone:
+            return nil;
+        case kSnapshotIconKindPreset:
+            return [NodeIcon withPreset:(NSInteger)readVarint(c)];
+        case kSnapshotIconKindPooled:
+        {
+            NSUUID* uuid = readUuid(c);
+            NodeIcon* ret = uuid ? self.iconPool[uuid] : nil;
+            if ( ret == nil ) {
+                c->failed = YES;
+            }
+            return ret;
+        }
+        case kSnapshotIconKindInline:
+            return [self customIcon:c];
+        default:
+            c->failed = YES;
+            return nil;
+    }
+}
+
+- (NodeFields*)fields:(SnapshotCursor*)c parent:(Node*)parent {
+    NodeFields* fields = [[NodeFields alloc] init];
+
+    fields.username = readNonNullString(c);
+    fields.url = readNonNullString(c);
+    fields.password = readNonNullString(c);
+    fields.notes = readNonNullString(c);
+
+    uint64_t customFieldCount = readVarint(c);
+    MutableOrderedDictionary<NSString*, StringValue*>* customFields = [[MutableOrderedDictionary alloc] init];
+    for ( uint64_t i = 0; i < customFieldCount && !c->failed; i++ ) {
+        NSString* key = readNonNullString(c);
+        NSString* value = readNonNullString(c);
+
+        customFields[key] = [StringValue valueWithString:value protected:readByte(c) != 0];
+    }
+    fields.customFields = customFields;
+
+    NSDate* created = readDate(c);
+    NSDate* accessed = readDate(c);
+    NSDate* modified = readDate(c);
+    NSDate* locationChanged = readDate(c);
+    NSNumber* usageCount = readNumber(c);
+    [fields setTouchPropertiesWithCreated:created accessed:accessed modified:modified locationChanged:locationChanged usageCount:usageCount];
+
+    fields.passwordModified = readDate(c);
+    fields.expires = readDate(c);
+
+    uint64_t attachmentCount = readVarint(c);
+    for ( uint64_t i = 0; i < attachmentCount && !c->failed; i++ ) {
+        NSString* name = readNonNullString(c);
+        uint64_t index = readVarint(c);
+
+        if ( index >= self.attachments.count ) {
+            c->failed = YES;
+            break;
+        }
+
+        fields.attachments[name] = self.attachments[index];
+    }
+
+    uint64_t tagCount = readVarint(c);
+    for ( uint64_t i = 0; i < tagCount && !c->failed; i++ ) {
+        [fields.tags addObject:readNonNullString(c)];
+    }
+
+    fields.customData = readCustomData(c);
+
+    fields.defaultAutoTypeSequence = readString(c);
+    fields.enableAutoType = readNumber(c);
+    fields.enableSearching = readNumber(c);
+    fields.lastTopVisibleEntry = readUuid(c);
+    fields.foregroundColor = readString(c);
+    fields.backgroundColor = readString(c);
+    fields.overrideURL = readString(c);
+
+    if ( readByte(c) ) {
+        AutoType* autoType = [[AutoType alloc] init];
+
+        autoType.enabled = readByte(c) != 0;
+        autoType.dataTransferObfuscation = readNumber(c).integerValue;
+        autoType.defaultSequence = readString(c);
+
+        uint64_t associationCount = readVarint(c);
+        NSMutableArray<AutoTypeAssociation*>* associations = NSMutableArray.array;
+        for ( uint64_t i = 0; i < associationCount && !c->failed; i++ ) {
+            AutoTypeAssociation* association = [[AutoTypeAssociation alloc] init];
+
+            association.window = readString(c);
+            association.keystrokeSequence = readString(c);
+
+            [associations addObject:association];
+        }
+        autoType.asssociations = associations;
+
+        fields.autoType = autoType;
+    }
+
+    fields.isExpanded = readByte(c) != 0;
+    fields.qualityCheck = readByte(c) != 0;
+    fields.previousParentGroup = readUuid(c);
+
+    uint64_t historyCount = readVarint(c);
+    for ( uint64_t i = 0; i < historyCount && !c->failed; i++ ) {
+        Node* historical = [self node:c parent:parent];
+        if ( historical ) {
+            [fields.keePassHistory addObject:historical];
+        }
+    }
+
+    return fields;
+}
+
+- (Node*)node:(SnapshotCursor*)c parent:(Node*)parent {
+    uint8_t flags = readByte(c);
+    NSUUID* uuid = readUuid(c);
+    NSString* title = readNonNullString(c);
+    NodeIcon* icon = [self icon:c];
+
+    BOOL isGroup = (flags & kSnapshotNodeFlagGroup) != 0;
+    NodeFields* fields = [self fields:c parent:parent];
+
+    if ( c->failed || uuid == nil ) {
+        c->failed = YES;
+        return nil;
+    }
+
+    Node* node = [[Node alloc] initWithParent:parent
+                                        title:title
+                                      isGroup:isGroup
+                                         uuid:uuid
+                                       fields:fields
+                          childRecordsAllowed:(flags & kSnapshotNodeFlagChildRecordsAllowed) != 0];
+    node.icon = icon;
+
+    uint64_t childCount = readVarint(c);
+    for ( uint64_t i = 0; i < childCount && !c->failed; i++ ) {
+        Node* child = [self node:c parent:node];
+
+        if ( child == nil || ![node addChild:child keePassGroupTitleRules:YES] ) {
+            c->failed = YES;
+            return nil;
+        }
+    }
+
+    return node;
+}
+
+- (FastMaps*)fastMaps:(SnapshotCursor*)c root:(Node*)root {
+    NSSet<NSUUID*>* withExpiryDates = readUuidSet(c);
+    NSSet<NSUUID*>* withAttachments = readUuidSet(c);
+    NSSet<NSUUID*>* withKeeAgentSshKeys = readUuidSet(c);
+    NSSet<NSUUID*>* withPasskeys = readUuidSet(c);
+    NSSet<NSUUID*>* withTotps = readUuidSet(c);
+
+    uint64_t tagCount = readVarint(c);
+    NSMutableDictionary<NSString*, NSSet<NSUUID*>*>* tagMap = NSMutableDictionary.dictionary;
+    for ( uint64_t i = 0; i < tagCount && !c->failed; i++ ) {
+        NSString* tag = readNonNullString(c);
+        tagMap[tag] = readUuidSet(c);
+    }
+
+    NSCountedSet<NSString*>* usernameSet = readCountedSet(c);
+    NSCountedSet<NSString*>* emailSet = readCountedSet(c);
+    NSCountedSet<NSString*>* urlSet = readCountedSet(c);
+    NSCountedSet<NSString*>* customFieldKeySet = readCountedSet(c);
+
+    NSMutableDictionary<NSUUID*, Node*>* uuidMap = NSMutableDictionary.dictionary;
+    NSInteger entryTotalCount = 0;
+    NSInteger groupTotalCount = 0;
+
+    uuidMap[root.uuid] = root;
+
+    for ( Node* node in root.allChildren ) {
+        if ( uuidMap[node.uuid] == nil ) {
+            uuidMap[node.uuid] = node;
+        }
+
+        if ( node.isGroup ) {
+            groupTotalCount++;
+        }
+        else {
+            entryTotalCount++;
+        }
+    }
+
+    return [[FastMaps alloc] initWithUuidMap:uuidMap
+                             withExpiryDates:withExpiryDates
+                             withAttachments:withAttachments
+                         withKeeAgentSshKeys:withKeeAgentSshKeys
+                                withPasskeys:withPasskeys
+                                   withTotps:withTotps
+                                      tagMap:tagMap
+                                 usernameSet:usernameSet
+                                    emailSet:emailSet
+                                      urlSet:urlSet
+                           customFieldKeySet:customFieldKeySet
+                             entryTotalCount:entryTotalCount
+                             groupTotalCount:groupTotalCount];
+}
+
+- (DatabaseModel*)database:(SnapshotCursor*)c ckf:(CompositeKeyFactors*)ckf {
+    UnifiedDatabaseMetadata* metadata = [self metadata:c];
+
+    uint64_t deletedCount = readVarint(c);
+    NSMutableDictionary<NSUUID*, NSDate*>* deletedObjects = NSMutableDictionary.dictionary;
+    for ( uint64_t i = 0; i < deletedCount && !c->failed; i++ ) {
+        NSUUID* uuid = readUuid(c);
+        NSDate* date = readDate(c);
+
+        if ( uuid && date ) {
+            deletedObjects[uuid] = date;
+        }
+    }
+
+    uint64_t iconCount = readVarint(c);
+    NSMutableDictionary<NSUUID*, NodeIcon*>* iconPool = NSMutableDictionary.dictionary;
+    for ( uint64_t i = 0; i < iconCount && !c->failed; i++ ) {
+        NodeIcon* icon = [self customIcon:c];
+        if ( icon ) {
+            iconPool[icon.uuid] = icon;
+        }
+    }
+    self.iconPool = iconPool;
+
+    uint64_t attachmentCount = readVarint(c);
+    NSMutableArray<KeePassAttachmentAbstractionLayer*>* attachments = NSMutableArray.array;
+    for ( uint64_t i = 0; i < attachmentCount && !c->failed; i++ ) {
+        BOOL compressed = readByte(c) != 0;
+        BOOL protectedInMemory = readByte(c) != 0;
+        uint64_t length = readVarint(c);
+        const uint8_t* p = readBytes(c, length);
+
+        if ( p == NULL ) {
+            break;
+        }
+
+        NSData* data = [NSData dataWithBytesNoCopy:(void*)p length:length freeWhenDone:NO];
+        KeePassAttachmentAbstractionLayer* attachment = [[KeePassAttachmentAbstractionLayer alloc] initWithStream:[NSInputStream inputStreamWithData:data]
+                                                                                                           length:length
+                                                                                                protectedInMemory:protectedInMemory
+                                                                                                       compressed:compressed];
+        if ( attachment == nil ) {
+            c->failed = YES;
+            break;
+        }
+
+        [attachments addObject:attachment];
+    }
+    self.attachments = attachments;
+
+    Node* root = c->failed ? nil : [self node:c parent:nil];
+    FastMaps* fastMaps = root ? [self fastMaps:c root:root] : nil;
+
+    if ( c->failed || root == nil || c->offset != c->length ) {
+        NSLog(@"🔴 Database snapshot is malformed, ignoring.");
+        return nil;
+    }
+
+    return [[DatabaseModel alloc] initWithFormat:kKeePass4
+                             compositeKeyFactors:ckf
+                                        metadata:metadata
+                                            root:root
+                                  deletedObjects:deletedObjects
+                                        iconPool:iconPool
+                                        fastMaps:fastMaps];
+}
+
+@end
+
+
+
+@implementation DatabaseSnapshot
+
++ (NSData *)keyFromMasterKey:(NSData *)masterKey {
+    return subKey(masterKey, kSnapshotKeyContext);
+}
+
++ (NSData*)encode:(DatabaseModel*)database {
+    DatabaseSnapshotWriter* writer = [[DatabaseSnapshotWriter alloc] init];
+    writer.iconPool = database.iconPool;
+
+    [writer collectAttachments:database.rootNode];
+
+    NSUInteger attachmentBytes = 0;
+    for ( KeePassAttachmentAbstractionLayer* attachment in writer.attachments ) {
+        attachmentBytes += attachment.length;
+    }
+
+    if ( attachmentBytes > kSnapshotMaxAttachmentBytes ) {
+        NSLog(@"Not snapshotting database with [%lu] bytes of attachments.", (unsigned long)attachmentBytes);
+        return nil;
+    }
+
+    [writer metadata:database.meta];
+
+    [writer varint:database.deletedObjects.count];
+    for ( NSUUID* uuid in database.deletedObjects ) {
+        [writer uuid:uuid];
+        [writer date:database.deletedObjects[uuid]];
+    }
+
+    [writer varint:database.iconPool.count];
+    for ( NodeIcon* icon in database.iconPool.allValues ) {
+        [writer customIcon:icon];
+    }
+
+    [writer varint:writer.attachments.count];
+    for ( KeePassAttachmentAbstractionLayer* attachment in writer.attachments ) {
+        [writer attachment:attachment];
+    }
+
+    [writer node:database.rootNode];
+    [writer fastMaps:database.fastMaps];
+
+    if ( writer.failed ) {
+        NSLog(@"🔴 Could not encode database snapshot.");
+        memset(writer.data.mutableBytes, 0, writer.data.length);
+        return nil;
+    }
+
+    return writer.data;
+}
+
++ (NSData*)seal:(NSMutableData*)payload sourceSha256:(NSData*)sourceSha256 key:(NSData*)key {
+    NSData* iv = getRandomData(kCCBlockSizeAES128);
+    NSData* encryptionKey = subKey(key, kSnapshotEncryptionKeyContext);
+
+    NSMutableData* ret = [NSMutableData dataWithCapacity:kSnapshotHeaderLength + payload.length + kCCBlockSizeAES128 + CC_SHA256_DIGEST_LENGTH];
+
+    [ret appendBytes:kSnapshotMagic length:sizeof(kSnapshotMagic)];
+    [ret appendBytes:&kSnapshotVersion length:1];
+    [ret appendData:sourceSha256];
+    [ret appendData:iv];
+
+    NSUInteger headerLength = ret.length;
+    [ret increaseLengthBy:payload.length + kCCBlockSizeAES128];
+
+    size_t moved = 0;
+    CCCryptorStatus status = CCCrypt(kCCEncrypt, kCCAlgorithmAES, kCCOptionPKCS7Padding,
+                                     encryptionKey.bytes, kCCKeySizeAES256, iv.bytes,
+                                     payload.bytes, payload.length,
+                                     (uint8_t*)ret.mutableBytes + headerLength, payload.length + kCCBlockSizeAES128, &moved);
+
+    memset(payload.mutableBytes, 0, payload.length);
+
+    if ( status != kCCSuccess ) {
+        NSLog(@"🔴 Could not encrypt database snapshot: [%d]", status);
+        return nil;
+    }
+
+    ret.length = headerLength + moved;
+    [ret appendData:hmacSha256(subKey(key, kSnapshotMacKeyContext), ret)];
+
+    return ret;
+}
+
++ (NSData *)serialize:(DatabaseModel *)database sourceSha256:(NSData *)sourceSha256 key:(NSData *)key {
+    NSMutableData* payload = (NSMutableData*)[self encode:database];
+
+    return payload ? [self seal:payload sourceSha256:sourceSha256 key:key] : nil;
+}
+
++ (void)writeSnapshot:(DatabaseModel *)database sourceSha256:(NSData *)sourceSha256 key:(NSData *)key url:(NSURL *)url {
+    NSMutableData* payload = (NSMutableData*)[self encode:database];
+    if ( payload == nil ) {
+        return;
+    }
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSData* snapshot = [self seal:payload sourceSha256:sourceSha256 key:key];
+        if ( snapshot == nil ) {
+            return;
+        }
+
+        NSError* error;
+        if ( ![snapshot writeToURL:url options:NSDataWritingAtomic error:&error] ) {
+            NSLog(@"🔴 Could not write database snapshot: [%@]", error);
+        }
+    });
+}
+
++ (DatabaseModel *)deserialize:(NSData *)snapshot sourceSha256:(NSData *)sourceSha256 key:(NSData *)key ckf:(CompositeKeyFactors *)ckf {
+    if ( snapshot.length < kSnapshotHeaderLength + CC_SHA256_DIGEST_LENGTH || sourceSha256.length != CC_SHA256_DIGEST_LENGTH ) {
+        return nil;
+    }
+
+    const uint8_t* p = snapshot.bytes;
+
+    if ( memcmp(p, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 || p[sizeof(kSnapshotMagic)] != kSnapshotVersion ) {
+        return nil;
+    }
+
+    if ( memcmp(p + sizeof(kSnapshotMagic) + 1, sourceSha256.bytes, CC_SHA256_DIGEST_LENGTH) != 0 ) {
+        NSLog(@"Database snapshot is stale, ignoring.");
+        return nil;
+    }
+
+    NSUInteger macOffset = snapshot.length - CC_SHA256_DIGEST_LENGTH;
+    NSData* expectedMac = hmacSha256(subKey(key, kSnapshotMacKeyContext), [NSData dataWithBytesNoCopy:(void*)p length:macOffset freeWhenDone:NO]);
+
+    if ( !constantTimeEquals(expectedMac.bytes, p + macOffset, CC_SHA256_DIGEST_LENGTH) ) {
+        NSLog(@"🔴 Database snapshot failed authentication, ignoring.");
+        return nil;
+    }
+
+    NSData* encryptionKey = subKey(key, kSnapshotEncryptionKeyContext);
+    const uint8_t* iv = p + kSnapshotHeaderLength - kCCBlockSizeAES128;
+    size_t cipherTextLength = macOffset - kSnapshotHeaderLength;
+
+    NSMutableData* payload = [NSMutableData dataWithLength:cipherTextLength];
+    size_t moved = 0;
+    CCCryptorStatus status = CCCrypt(kCCDecrypt, kCCAlgorithmAES, kCCOptionPKCS7Padding,
+                                     encryptionKey.bytes, kCCKeySizeAES256, iv,
+                                     p + kSnapshotHeaderLength, cipherTextLength,
+                                     payload.mutableBytes, payload.length, &moved);
+
+    if ( status != kCCSuccess ) {
+        NSLog(@"🔴 Could not decrypt database snapshot: [%d]", status);
+        return nil;
+    }
+
+    SnapshotCursor cursor = { .bytes = payload.bytes, .length = moved };
+    DatabaseModel* ret = [[[DatabaseSnapshotReader alloc] init] database:&cursor ckf:ckf];
+
+    memset(payload.mutableBytes, 0, payload.length);
+
+    return ret;
+}
+
+@end
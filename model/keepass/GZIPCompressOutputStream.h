@@ -7,12 +7,20 @@
 //
 
 #import <Foundation/Foundation.h>
+#import "CompressionProfile.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface GZIPCompressOutputStream : NSOutputStream
 
 - (instancetype)initToOutputStream:(NSOutputStream*)outputStream;
+- (instancetype)initToOutputStream:(NSOutputStream*)outputStream threads:(NSUInteger)threads;
+- (instancetype)initToOutputStream:(NSOutputStream*)outputStream profile:(CompressionProfile)profile;
+- (instancetype)initToOutputStream:(NSOutputStream*)outputStream threads:(NSUInteger)threads profile:(CompressionProfile)profile;
+
+@property (readonly) NSUInteger threads;
+@property (readonly) int level;
+@property (readonly) int strategy;
 
 @end
 
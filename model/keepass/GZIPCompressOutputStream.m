@@ -10,6 +10,103 @@
 #import <zlib.h>
 #import "Utils.h"
 
+const int kChunkSize = 32 * 1024;
+const NSUInteger kParallelChunkSize = 128 * 1024;
+const NSUInteger kParallelDictionarySize = 32 * 1024;
+
+static const uint8_t kGzipHeader[] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, 3 };
+
+@interface GZIPCompressChunk : NSObject
+
+@property (readonly) NSData* input;
+@property (readonly, nullable) NSData* dictionary;
+@property (readonly) BOOL last;
+@property (readonly) int level;
+@property (readonly) int strategy;
+
+@property (readonly) NSMutableData* output;
+@property (readonly) uLong crc;
+@property (readonly) int status;
+@property (readonly) dispatch_semaphore_t done;
+
+@end
+
+@implementation GZIPCompressChunk
+
+- (instancetype)initWithInput:(NSData*)input dictionary:(NSData*)dictionary last:(BOOL)last level:(int)level strategy:(int)strategy {
+    if (self = [super init]) {
+        _input = input;
+        _dictionary = dictionary;
+        _last = last;
+        _level = level;
+        _strategy = strategy;
+        _done = dispatch_semaphore_create(0);
+    }
+    
+    return self;
+}
+
+- (void)compress {
+    _crc = crc32(0L, self.input.bytes, (uInt)self.input.length);
+    _status = [self deflateRaw];
+    _dictionary = nil;
+    
+    dispatch_semaphore_signal(self.done);
+}
+
+- (int)deflateRaw {
+    z_stream stream = { 0 };
+    
+    int status = deflateInit2(&stream, self.level, Z_DEFLATED, -MAX_WBITS, 8, self.strategy);
+    if ( status != Z_OK ) {
+        return status;
+    }
+    
+    if ( self.dictionary.length ) {
+        NSUInteger dictionaryLength = MIN(self.dictionary.length, kParallelDictionarySize);
+        const uint8_t* dictionary = &((const uint8_t*)self.dictionary.bytes)[self.dictionary.length - dictionaryLength];
+        
+        status = deflateSetDictionary(&stream, dictionary, (uInt)dictionaryLength);
+        if ( status != Z_OK ) {
+            deflateEnd(&stream);
+            return status;
+        }
+    }
+    
+    _output = [NSMutableData dataWithLength:deflateBound(&stream, self.input.length) + 16];
+    
+    stream.next_in = (Bytef*)self.input.bytes;
+    stream.avail_in = (uInt)self.input.length;
+    
+    size_t produced = 0;
+    
+    while ( YES ) {
+        stream.next_out = &((uint8_t*)self.output.mutableBytes)[produced];
+        stream.avail_out = (uInt)(self.output.length - produced);
+        
+        status = deflate(&stream, self.last ? Z_FINISH : Z_SYNC_FLUSH);
+        produced = self.output.length - stream.avail_out;
+        
+        if ( status == Z_STREAM_END || ( status == Z_OK && !self.last && stream.avail_out != 0 ) ) {
+            status = Z_OK;
+            break;
+        }
+        
+        if ( status != Z_OK && status != Z_BUF_ERROR ) {
+            break;
+        }
+        
+        self.output.length = self.output.length * 2;
+    }
+    
+    self.output.length = produced;
+    deflateEnd(&stream);
+    
+    return status;
+}
+
+@end
+
 @interface GZIPCompressOutputStream ()
 
 @property NSOutputStream* outputStream;
@@ -19,18 +116,63 @@
 @property BOOL closed;
 @property BOOL opened;
 
-@end
+@property NSUInteger threads;
+@property int level;
+@property int strategy;
+@property NSMutableData* pendingChunk;
+@property NSData* previousChunk;
+@property NSMutableArray<GZIPCompressChunk*>* inFlight;
+@property dispatch_semaphore_t workers;
+@property uLong crc;
+@property uint64_t totalIn;
+@property BOOL headerWritten;
 
-const int kChunkSize = 32 * 1024;
+@end
 
 @implementation GZIPCompressOutputStream
 
 - (instancetype)initToOutputStream:(NSOutputStream *)outputStream {
+    return [self initToOutputStream:outputStream profile:kCompressionProfileDefault];
+}
+
+- (instancetype)initToOutputStream:(NSOutputStream *)outputStream threads:(NSUInteger)threads {
+    return [self initToOutputStream:outputStream threads:threads profile:kCompressionProfileDefault];
+}
+
+- (instancetype)initToOutputStream:(NSOutputStream *)outputStream profile:(CompressionProfile)profile {
+    return [self initToOutputStream:outputStream threads:1 profile:profile];
+}
+
+- (instancetype)initToOutputStream:(NSOutputStream *)outputStream threads:(NSUInteger)threads profile:(CompressionProfile)profile {
     if (self = [super init]) {
         if (outputStream == nil) {
             return nil;
         }
         
+        self.outputStream = outputStream;
+        self.threads = MAX(threads, 1);
+        
+        if ( profile == kCompressionProfileFast ) {
+            self.level = Z_BEST_SPEED;
+            self.strategy = Z_DEFAULT_STRATEGY;
+        }
+        else if ( profile == kCompressionProfileMax ) {
+            self.level = Z_BEST_COMPRESSION;
+            self.strategy = Z_FILTERED;
+        }
+        else {
+            self.level = Z_DEFAULT_COMPRESSION;
+            self.strategy = Z_DEFAULT_STRATEGY;
+        }
+        
+        if ( self.threads > 1 ) {
+            self.pendingChunk = [NSMutableData dataWithCapacity:kParallelChunkSize];
+            self.inFlight = NSMutableArray.array;
+            self.workers = dispatch_semaphore_create(self.threads);
+            self.crc = crc32(0L, Z_NULL, 0);
+            return self;
+        }
+        
         self.stream = malloc(sizeof(z_stream));
      
         if (self.stream == NULL) {
@@ -47,14 +189,12 @@ const int kChunkSize = 32 * 1024;
         self.stream->total_out = 0;
         self.stream->avail_out = 0;
 
-        if (deflateInit2(self.stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        if (deflateInit2(self.stream, self.level, Z_DEFLATED, 31, 8, self.strategy) != Z_OK) {
             NSLog(@"Error initializing z_stream");
             free(self.stream);
             self.stream = nil;
             return nil;
         }
-        
-        self.outputStream = outputStream;
     }
     
     return self;
@@ -73,6 +213,11 @@ const int kChunkSize = 32 * 1024;
     }
     self.closed = YES;
     
+    if ( self.threads > 1 ) {
+        [self closeParallel];
+        return;
+    }
+    
     uint8_t finalBlock[kChunkSize]; 
 
     do {
@@ -112,6 +257,10 @@ const int kChunkSize = 32 * 1024;
 }
 
 - (NSInteger)write:(const uint8_t *)buffer maxLength:(NSUInteger)len {
+    if ( self.threads > 1 ) {
+        return [self writeParallel:buffer maxLength:len];
+    }
+    
     self.stream->avail_in = (uInt)len;
     self.stream->next_in = (uint8_t*)buffer;
 
@@ -149,6 +298,125 @@ const int kChunkSize = 32 * 1024;
     return totalWritten;
 }
 
+- (NSInteger)writeParallel:(const uint8_t *)buffer maxLength:(NSUInteger)len {
+    if ( self.error || ![self writeHeaderIfNecessary] ) {
+        return -1;
+    }
+    
+    NSUInteger consumed = 0;
+    
+    while ( consumed < len ) {
+        NSUInteger toCopy = MIN(kParallelChunkSize - self.pendingChunk.length, len - consumed);
+        [self.pendingChunk appendBytes:&buffer[consumed] length:toCopy];
+        consumed += toCopy;
+        
+        if ( self.pendingChunk.length == kParallelChunkSize ) {
+            [self submitPendingChunk:NO];
+            
+            if ( ![self writeCompletedChunks:NO] ) {
+                return -1;
+            }
+        }
+    }
+    
+    return len;
+}
+
+- (void)closeParallel {
+    if ( self.error || ![self writeHeaderIfNecessary] ) {
+        return;
+    }
+    
+    [self submitPendingChunk:YES];
+    
+    if ( ![self writeCompletedChunks:YES] ) {
+        return;
+    }
+    
+    uint8_t trailer[8];
+    OSWriteLittleInt32(trailer, 0, (uint32_t)self.crc);
+    OSWriteLittleInt32(trailer, 4, (uint32_t)self.totalIn);
+    
+    if ( [self.outputStream write:trailer maxLength:sizeof(trailer)] < 0 ) {
+        NSLog(@"GZIPCompressOutputStream: Could not write trailer to output stream.");
+    }
+}
+
+- (BOOL)writeHeaderIfNecessary {
+    if ( self.headerWritten ) {
+        return YES;
+    }
+    self.headerWritten = YES;
+    
+    if ( [self.outputStream write:kGzipHeader maxLength:sizeof(kGzipHeader)] < 0 ) {
+        NSLog(@"GZIPCompressOutputStream: Could not write header to output stream.");
+        return NO;
+    }
+    
+    return YES;
+}
+
+- (void)submitPendingChunk:(BOOL)last {
+    GZIPCompressChunk* chunk = [[GZIPCompressChunk alloc] initWithInput:self.pendingChunk dictionary:self.previousChunk last:last level:self.level strategy:self.strategy];
+    
+    self.previousChunk = self.pendingChunk;
+    self.pendingChunk = last ? nil : [NSMutableData dataWithCapacity:kParallelChunkSize];
+    
+    [self.inFlight addObject:chunk];
+    
+    dispatch_semaphore_t workers = self.workers;
+    dispatch_semaphore_wait(workers, DISPATCH_TIME_FOREVER);
+    
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        [chunk compress];
+        dispatch_semaphore_signal(workers);
+    });
+}
+
+- (BOOL)writeCompletedChunks:(BOOL)waitForAll {
+    NSUInteger maxInFlight = self.threads * 2;
+    
+    while ( self.inFlight.count ) {
+        GZIPCompressChunk* chunk = self.inFlight.firstObject;
+        
+        BOOL mustWait = waitForAll || self.inFlight.count > maxInFlight;
+        if ( dispatch_semaphore_wait(chunk.done, mustWait ? DISPATCH_TIME_FOREVER : DISPATCH_TIME_NOW) != 0 ) {
+            break;
+        }
+        
+        [self.inFlight removeObjectAtIndex:0];
+        
+        if ( chunk.status != Z_OK ) {
+            NSLog(@"Error: %d", chunk.status);
+            self.error = [Utils createNSError:[NSString stringWithFormat:@"ERROR deflate Error: %d GZIP!", chunk.status] errorCode:chunk.status];
+            [self waitForInFlight];
+            return NO;
+        }
+        
+        self.crc = crc32_combine(self.crc, chunk.crc, (z_off_t)chunk.input.length);
+        self.totalIn += chunk.input.length;
+        
+        if ( chunk.output.length > 0 ) {
+            NSInteger res = [self.outputStream write:chunk.output.bytes maxLength:chunk.output.length];
+            if ( res < 0 ) {
+                NSLog(@"GZIPCompressOutputStream: Could not write to output stream.");
+                [self waitForInFlight];
+                return NO;
+            }
+        }
+    }
+    
+    return YES;
+}
+
+- (void)waitForInFlight {
+    for ( GZIPCompressChunk* chunk in self.inFlight ) {
+        dispatch_semaphore_wait(chunk.done, DISPATCH_TIME_FOREVER);
+    }
+    
+    [self.inFlight removeAllObjects];
+}
+
 - (NSError *)streamError {
     return self.error ? self.error : self.outputStream.streamError;
 }
@@ -13,7 +13,8 @@
 #import "Utils.h"
 #import "Constants.h"
 #import "NSData+Extensions.h"
-#import "StreamUtils.h"
+#import "MetricsInputStream.h"
+#import "MetricsOutputStream.h"
 
 static const BOOL kLogVerbose = NO;
 
@@ -38,11 +39,34 @@ static const BOOL kLogVerbose = NO;
 + (void)open:(NSData *)data
          ckf:(CompositeKeyFactors *)ckf
   completion:(OpenCompletionBlock)completion {
+    [self open:data ckf:ckf metrics:nil completion:completion];
+}
+
++ (void)open:(NSData *)data
+         ckf:(CompositeKeyFactors *)ckf
+     metrics:(SerializationMetrics*)metrics
+  completion:(OpenCompletionBlock)completion {
+    [self read:[NSInputStream inputStreamWithData:data] ckf:ckf metrics:metrics completion:completion];
+}
+
++ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf xmlDumpStream:(NSOutputStream *)xmlDumpStream sanityCheckInnerStream:(BOOL)sanityCheckInnerStream metrics:(SerializationMetrics *)metrics completion:(OpenCompletionBlock)completion {
+    [self read:stream ckf:ckf metrics:metrics completion:completion];
+}
+
++ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf completion:(OpenCompletionBlock)completion {
+    [self read:stream ckf:ckf metrics:nil completion:completion];
+}
+
++ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf metrics:(SerializationMetrics*)metrics completion:(OpenCompletionBlock)completion {
     NSError* error;
-    KdbSerializationData *serializationData = [KdbSerialization deserialize:data
-                                                                   password:ckf.password
-                                                              keyFileDigest:ckf.keyFileDigest
-                                                                    ppError:&error];
+
+    [metrics beginStage:kSerializationStageDocument];
+    KdbSerializationData *serializationData = [KdbSerialization deserializeStream:[MetricsInputStream wrap:stream metrics:metrics stage:kSerializationStageIo]
+                                                                         password:ckf.password
+                                                                    keyFileDigest:ckf.keyFileDigest
+                                                                          metrics:metrics
+                                                                          ppError:&error];
+    [metrics endStage:kSerializationStageDocument];
     
     if(serializationData == nil) {
         NSLog(@"Error getting Decrypting KDB binary: [%@]", error);
@@ -55,7 +79,10 @@ static const BOOL kLogVerbose = NO;
     }
 
     NSArray<KeePassAttachmentAbstractionLayer*>* attachments;
+
+    [metrics beginStage:kSerializationStageModel];
     Node* rootGroup = [Kdb1Database buildStrongboxModel:serializationData attachments:&attachments];
+    [metrics endStage:kSerializationStageModel];
 
     if(kLogVerbose) {
         NSLog(@"Attachments: %@", attachments);
@@ -69,43 +96,20 @@ static const BOOL kLogVerbose = NO;
     metadata.kdfIterations = serializationData.transformRounds;
     metadata.flags = serializationData.flags;
 
+    [metrics beginStage:kSerializationStageFastMaps];
     DatabaseModel *ret = [[DatabaseModel alloc] initWithFormat:kKeePass1 compositeKeyFactors:ckf metadata:metadata root:rootGroup];
+    [metrics endStage:kSerializationStageFastMaps];
     
     ret.meta.adaptorTag = serializationData.metaEntries;
     
     completion(NO, ret, nil, nil);
 }
 
-+ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf xmlDumpStream:(NSOutputStream *)xmlDumpStream sanityCheckInnerStream:(BOOL)sanityCheckInnerStream completion:(OpenCompletionBlock)completion {
-    [self read:stream ckf:ckf completion:completion];
-}
-
-+ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf completion:(OpenCompletionBlock)completion {
-    NSMutableData* mutableData = [NSMutableData dataWithCapacity:kStreamingSerializationChunkSize];
-    
-    [stream open];
-    uint8_t* buf = malloc(kStreamingSerializationChunkSize);
-    NSInteger bytesRead;
-    
-    do {
-        bytesRead = [stream read:buf maxLength:kStreamingSerializationChunkSize];
-        if (bytesRead > 0) {
-            [mutableData appendBytes:buf length:bytesRead];
-        }
-    } while (bytesRead > 0);
-    
-    free(buf);
-    [stream close];
-    
-    if (bytesRead < 0) {
-        completion(NO, nil,  nil, stream.streamError);
-        return;
-    }
-    
-    [self open:mutableData ckf:ckf completion:completion];
++ (void)save:(DatabaseModel *)database outputStream:(NSOutputStream *)outputStream completion:(SaveCompletionBlock)completion {
+    [self save:database outputStream:outputStream metrics:nil completion:completion];
 }
 
-+ (void)save:(DatabaseModel *)database outputStream:(NSOutputStream *)outputStream completion:(SaveCompletionBlock)completion {
++ (void)save:(DatabaseModel *)database outputStream:(NSOutputStream *)outputStream metrics:(SerializationMetrics *)metrics completion:(SaveCompletionBlock)completion {
     if(!database.ckfs.password.length && !database.ckfs.keyFileDigest) {
         
         NSError* error = [Utils createNSError:@"Master Password or Key File not set." errorCode:-3];
@@ -120,10 +124,14 @@ static const BOOL kLogVerbose = NO;
         [Kdb1Database addKeePassDefaultRootGroup:database.rootNode];
     }
     
-    if ( ! [Kdb1Database nodeModelToGroupsAndEntries:0
-                                               group:database.rootNode
-                                   serializationData:serializationData
-                                    existingGroupIds:[NSMutableSet<NSNumber*> set]] ) {
+    [metrics beginStage:kSerializationStageModel];
+    BOOL converted = [Kdb1Database nodeModelToGroupsAndEntries:0
+                                                         group:database.rootNode
+                                             serializationData:serializationData
+                                              existingGroupIds:[NSMutableSet<NSNumber*> set]];
+    [metrics endStage:kSerializationStageModel];
+
+    if ( !converted ) {
         NSLog(@"WARNWARN: Could not convert to KDB.");
         NSError* error = [Utils createNSError:@"Could not convert to KDB." errorCode:-3];
         completion(NO, nil, error);
@@ -140,24 +148,19 @@ static const BOOL kLogVerbose = NO;
     }
     
     NSError* error;
-    NSData* ret = [KdbSerialization serialize:serializationData
-                              password:database.ckfs.password
-                         keyFileDigest:database.ckfs.keyFileDigest
-                               ppError:&error];
+
+    [metrics beginStage:kSerializationStageDocument];
+    BOOL success = [KdbSerialization serialize:serializationData
+                                      password:database.ckfs.password
+                                 keyFileDigest:database.ckfs.keyFileDigest
+                                  outputStream:[MetricsOutputStream wrap:outputStream metrics:metrics stage:kSerializationStageIo]
+                                       metrics:metrics
+                                       ppError:&error];
+    [metrics endStage:kSerializationStageDocument];
     
-    if(!ret) {
+    if ( !success ) {
         NSLog(@"Could not serialize Document to KDB");
         completion(NO, nil, error);
-        return;
-    }
-    
-    NSInputStream* inputStream = [NSInputStream inputStreamWithData:ret];
-    [inputStream open];
-    BOOL success = [StreamUtils pipeFromStream:inputStream to:outputStream openAndCloseStreams:NO];
-    [inputStream close];
-    
-    if ( !success ) {
-        completion(NO, nil, [Utils createNSError:@"Could not pipe data to stream!" errorCode:-1]);
     }
     else {
         completion(NO, nil, nil);
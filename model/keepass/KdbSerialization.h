@@ -8,6 +8,7 @@
 
 #import <Foundation/Foundation.h>
 #import "KdbSerializationData.h"
+#import "SerializationMetrics.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -18,6 +19,9 @@ NS_ASSUME_NONNULL_BEGIN
 + (nullable KdbSerializationData*)deserialize:(NSData*)safeData password:(NSString*)password keyFileDigest:(nullable NSData *)keyFileDigest ppError:(NSError**)ppError;
 + (nullable NSData*)serialize:(KdbSerializationData*)serializationData password:(NSString*)password keyFileDigest:(nullable NSData *)keyFileDigest ppError:(NSError**)error;
 
++ (nullable KdbSerializationData*)deserializeStream:(NSInputStream*)stream password:(NSString*)password keyFileDigest:(nullable NSData *)keyFileDigest metrics:(nullable SerializationMetrics*)metrics ppError:(NSError**)ppError;
++ (BOOL)serialize:(KdbSerializationData*)serializationData password:(NSString*)password keyFileDigest:(nullable NSData *)keyFileDigest outputStream:(NSOutputStream*)outputStream metrics:(nullable SerializationMetrics*)metrics ppError:(NSError**)error;
+
 @end
 
 NS_ASSUME_NONNULL_END
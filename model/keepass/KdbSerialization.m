@@ -16,9 +16,14 @@
 #import "KdbSerializationData.h"
 #import "KeePassConstants.h"
 #import <CommonCrypto/CommonDigest.h>
+#import <CommonCrypto/CommonCryptor.h>
 #import "NSString+Extensions.h"
 #import "NSData+Extensions.h"
 #import "StrongboxErrorCodes.h"
+#import "HashingInputStream.h"
+#import "MetricsInputStream.h"
+#import "MetricsOutputStream.h"
+#import "Constants.h"
 
 typedef struct _KdbHeader {
     uint8_t signature1[4];
@@ -35,20 +40,47 @@ typedef struct _KdbHeader {
 } KdbHeader;
 #define SIZE_OF_KDB_HEADER 124
 
-typedef struct _FieldHeader {
-    uint8_t type[2];
-    uint8_t length[4];
-    uint8_t data[];
-} FieldHeader;
 #define SIZE_OF_FIELD_HEADER 6
 
+typedef struct _KdbFieldReader {
+    __unsafe_unretained NSInputStream *stream;
+    uint8_t *buffer;
+    NSUInteger offset;
+    NSUInteger length;
+    uint8_t *field;
+    NSUInteger fieldCapacity;
+} KdbFieldReader;
+
+typedef struct _KdbFieldWriter {
+    CC_SHA256_CTX *hash;
+    __unsafe_unretained NSOutputStream *stream;
+    uint8_t *buffer;
+    NSUInteger used;
+    BOOL failed;
+} KdbFieldWriter;
+
 static const int kBlockSize = 16;
 static const int kKdbMasterSeedLength = 16;
 static const uint32_t kSignature1 = 0x9AA2D903;
 static const uint32_t kSignature2 = 0xB54BFB65;
 
+static const NSUInteger kInitialFieldCapacity = 1024;
+static const NSUInteger kFieldPadding = sizeof(uuid_t);
+
 static const BOOL kLogVerbose = NO;
 
+typedef void (*updateItemWithFieldFn)(uint16_t type, uint32_t length, uint8_t *data, id item);
+
+static BOOL readExactly(NSInputStream* stream, uint8_t* buffer, NSUInteger length);
+static BOOL writeExactly(NSOutputStream* stream, const uint8_t* buffer, NSUInteger length);
+static BOOL readItem(KdbFieldReader* reader, id item, updateItemWithFieldFn updateWithFieldFn);
+static void freeFieldReader(KdbFieldReader* reader);
+static void writeItems(KdbFieldWriter* writer, KdbSerializationData* serializationData);
+static void flushWriter(KdbFieldWriter* writer);
+static void updateGroupWithField(uint16_t type, uint32_t length, uint8_t *data, KdbGroup* group);
+static void updateEntryWithField(uint16_t type, uint32_t length, uint8_t *data, KdbEntry* entry);
+static void dateToKeePass1Bytes(NSDate* date, uint8_t* bytes);
+
 @implementation KdbSerialization
 
 + (BOOL)isAValidSafe:(nullable NSData *)candidate error:(NSError**)error {
@@ -113,25 +145,31 @@ static NSData *getComposite(NSString * _Nonnull password, NSData * _Nullable key
 }
 
 + (KdbSerializationData*)deserialize:(NSData*)data password:(NSString*)password keyFileDigest:(NSData *)keyFileDigest ppError:(NSError**)error {
-    if(data.length < SIZE_OF_KDB_HEADER) {
+    return [KdbSerialization deserializeStream:[NSInputStream inputStreamWithData:data] password:password keyFileDigest:keyFileDigest metrics:nil ppError:error];
+}
+
++ (KdbSerializationData*)deserializeStream:(NSInputStream*)stream password:(NSString*)password keyFileDigest:(NSData *)keyFileDigest metrics:(SerializationMetrics*)metrics ppError:(NSError**)error {
+    KdbHeader header;
+    
+    [stream open];
+    
+    if(!readExactly(stream, (uint8_t*)&header, SIZE_OF_KDB_HEADER)) {
         NSLog(@"Not a valid KDB file. Not long enough.");
         if(error) {
-            *error = [Utils createNSError:@"Not a valid KDB file. Not long enough" errorCode:-1];
+            *error = stream.streamError ? stream.streamError : [Utils createNSError:@"Not a valid KDB file. Not long enough" errorCode:-1];
         }
         return nil;
     }
     
-    KdbHeader *header = (KdbHeader*)data.bytes;
-
-    uint32_t flags = littleEndian4BytesToUInt32(header->flags);
-    uint32_t version = littleEndian4BytesToUInt32(header->version);
-    NSData* masterSeed = [NSData dataWithBytes:header->masterSeed length:kKdbMasterSeedLength];
-    NSData* encryptionIv = [NSData dataWithBytes:header->encryptionIv length:16];
-    uint32_t cGroups = littleEndian4BytesToUInt32(header->numberOfGroups);
-    uint32_t cEntries = littleEndian4BytesToUInt32(header->numberOfEntries);
-    NSData* contentsSha256 = [NSData dataWithBytes:header->contentsHash length:32];
-    NSData* transformSeed = [NSData dataWithBytes:header->transformSeed length:32];
-    uint32_t transformRounds = littleEndian4BytesToUInt32(header->transformRounds);
+    uint32_t flags = littleEndian4BytesToUInt32(header.flags);
+    uint32_t version = littleEndian4BytesToUInt32(header.version);
+    NSData* masterSeed = [NSData dataWithBytes:header.masterSeed length:kKdbMasterSeedLength];
+    NSData* encryptionIv = [NSData dataWithBytes:header.encryptionIv length:kBlockSize];
+    uint32_t cGroups = littleEndian4BytesToUInt32(header.numberOfGroups);
+    uint32_t cEntries = littleEndian4BytesToUInt32(header.numberOfEntries);
+    NSData* contentsSha256 = [NSData dataWithBytes:header.contentsHash length:CC_SHA256_DIGEST_LENGTH];
+    NSData* transformSeed = [NSData dataWithBytes:header.transformSeed length:kDefaultTransformSeedLength];
+    uint32_t transformRounds = littleEndian4BytesToUInt32(header.transformRounds);
 
     if(kLogVerbose) {
         NSLog(@"DESERIALIZE");
@@ -154,28 +192,6 @@ static NSData *getComposite(NSString * _Nonnull password, NSData * _Nullable key
         return nil;
     }
     
-    
-    
-    
-    size_t length = data.length - SIZE_OF_KDB_HEADER;
-    
-    if((length % kBlockSize) != 0) {
-        NSLog(@"Database Length is not a multiple of the blocksize. This file is likely corrupt.");
-        if(error) {
-            *error = [Utils createNSError:@"Database Length is not a multiple of the blocksize. This file is likely corrupt." errorCode:-4];
-        }
-        return nil;
-    }
-    
-    NSData* compositeKey = getComposite(password, keyFileDigest);
-    
-    
-    
-    
-    NSData *transformKey = getAesTransformKey(compositeKey, transformSeed, transformRounds);
-    NSData *masterKey = getMasterKey(masterSeed, transformKey);
-    NSData *ct = [data subdataWithRange:NSMakeRange(SIZE_OF_KDB_HEADER, length)];
-    
     id<Cipher> cipher = getCipher(flags);
     if(cipher == nil) {
         NSLog(@"Unknown Cipher. Cannot open this file.");
@@ -185,43 +201,46 @@ static NSData *getComposite(NSString * _Nonnull password, NSData * _Nullable key
         return nil;
     }
     
-    NSData *pt = [cipher decrypt:ct iv:encryptionIv key:masterKey];
-
+    [metrics beginStage:kSerializationStageKdf];
+    NSData* compositeKey = getComposite(password, keyFileDigest);
+    NSData *transformKey = getAesTransformKey(compositeKey, transformSeed, transformRounds);
+    NSData *masterKey = getMasterKey(masterSeed, transformKey);
+    [metrics endStage:kSerializationStageKdf];
     
-
-    if(![pt.sha256 isEqualToData:contentsSha256]) {
-        NSLog(@"Actual Database Contents Hash does not match expected. This file is corrupt or the password is incorect.");
-        if(error) {
-            *error = [Utils createNSError:@"Incorrect Passphrase/Key File (Composite Key) or Corrupt File." errorCode:StrongboxErrorCodes.incorrectCredentials];
-        }
-        return nil;
-    }
+    NSInputStream* decrypted = [MetricsInputStream wrap:[cipher getDecryptionStreamForStream:stream key:masterKey iv:encryptionIv] metrics:metrics stage:kSerializationStageCipher];
+    HashingInputStream* hashing = [[HashingInputStream alloc] initWithStream:decrypted];
+    NSInputStream* plaintext = [MetricsInputStream wrap:hashing metrics:metrics stage:kSerializationStageIntegrity];
+    
+    [plaintext open];
     
-    uint8_t *position = (uint8_t*)pt.bytes;
-    uint8_t *eof = (uint8_t*)pt.bytes + pt.length;
+    KdbFieldReader reader = { 0 };
+    reader.stream = plaintext;
+    reader.buffer = malloc(kStreamingSerializationChunkSize);
+    reader.fieldCapacity = kInitialFieldCapacity;
+    reader.field = malloc(reader.fieldCapacity);
     
     KdbSerializationData *ret = [[KdbSerializationData alloc] init];
+    NSError* parseError = nil;
     
-    for(int i=0;i<cGroups;i++) {
-        KdbGroup* group = readGroup(&position, eof);
-        if(!group) {
+    for(uint32_t i=0;i<cGroups && !parseError;i++) {
+        KdbGroup* group = [[KdbGroup alloc] init];
+        
+        if(!readItem(&reader, group, (updateItemWithFieldFn)updateGroupWithField)) {
             NSLog(@"Could not read group.");
-            if(error) {
-                *error = [Utils createNSError:@"Could not read group." errorCode:-6];
-            }
-            return nil;
+            parseError = [Utils createNSError:@"Could not read group." errorCode:-6];
+            break;
         }
+        
         [ret.groups addObject:group];
     }
 
-    for(int i=0;i<cEntries;i++) {
-        KdbEntry* entry = readEntry(&position, eof);
-        if(!entry) {
+    for(uint32_t i=0;i<cEntries && !parseError;i++) {
+        KdbEntry* entry = [[KdbEntry alloc] init];
+        
+        if(!readItem(&reader, entry, (updateItemWithFieldFn)updateEntryWithField)) {
             NSLog(@"Could not read entry.");
-            if(error) {
-                *error = [Utils createNSError:@"Could not read entry." errorCode:-7];
-            }
-            return nil;
+            parseError = [Utils createNSError:@"Could not read entry." errorCode:-7];
+            break;
         }
         
         if(entry.isMetaEntry) {
@@ -232,6 +251,44 @@ static NSData *getComposite(NSString * _Nonnull password, NSData * _Nullable key
         }
     }
     
+    // The contents hash covers the whole plaintext, so drain whatever follows the last entry (or follows the point a
+    // garbled item stopped parsing) before deciding between a bad key and a corrupt but authentic file.
+    
+    while ( [plaintext read:reader.buffer maxLength:kStreamingSerializationChunkSize] > 0 );
+    
+    // A failed read leaves the hash short, so report it rather than blaming the key. A cipher decode (padding) error is what a wrong key produces.
+    
+    NSError* readError = stream.streamError;
+    if ( readError == nil && decrypted.streamError.code != kCCDecodeError ) {
+        readError = decrypted.streamError;
+    }
+    
+    [plaintext close];
+    freeFieldReader(&reader);
+    
+    if ( readError ) {
+        NSLog(@"Could not read KDB contents: [%@]", readError);
+        if(error) {
+            *error = readError;
+        }
+        return nil;
+    }
+    
+    if(hashing.sha256 == nil || ![hashing.sha256 isEqualToData:contentsSha256]) {
+        NSLog(@"Actual Database Contents Hash does not match expected. This file is corrupt or the password is incorect.");
+        if(error) {
+            *error = [Utils createNSError:@"Incorrect Passphrase/Key File (Composite Key) or Corrupt File." errorCode:StrongboxErrorCodes.incorrectCredentials];
+        }
+        return nil;
+    }
+    
+    if(parseError) {
+        if(error) {
+            *error = parseError;
+        }
+        return nil;
+    }
+    
     ret.version = version;
     ret.flags = flags;
     ret.transformRounds = transformRounds;
@@ -240,6 +297,16 @@ static NSData *getComposite(NSString * _Nonnull password, NSData * _Nullable key
 }
 
 + (NSData*)serialize:(KdbSerializationData*)serializationData password:(NSString*)password keyFileDigest:(NSData *)keyFileDigest ppError:(NSError**)error {
+    NSOutputStream* outputStream = [NSOutputStream outputStreamToMemory];
+    
+    [outputStream open];
+    BOOL success = [KdbSerialization serialize:serializationData password:password keyFileDigest:keyFileDigest outputStream:outputStream metrics:nil ppError:error];
+    [outputStream close];
+    
+    return success ? [outputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey] : nil;
+}
+
++ (BOOL)serialize:(KdbSerializationData*)serializationData password:(NSString*)password keyFileDigest:(NSData *)keyFileDigest outputStream:(NSOutputStream*)outputStream metrics:(SerializationMetrics*)metrics ppError:(NSError**)error {
     if(kLogVerbose) {
         NSLog(@"SERIALIZE: %@", serializationData);
     }
@@ -249,42 +316,43 @@ static NSData *getComposite(NSString * _Nonnull password, NSData * _Nullable key
         if(error) {
             *error = [Utils createNSError:@"Not a valid database. Zero Groups." errorCode:-1];
         }
-        return nil;
+        return NO;
     }
     
-    NSMutableData *pt = [NSMutableData data];
-    for (KdbGroup* group in serializationData.groups) {
-        [pt appendData:writeGroup(group)];
+    id<Cipher> cipher = getCipher(serializationData.flags);
+    if(cipher == nil) {
+        NSLog(@"Unknown Cipher. Cannot save this file.");
+        if(error) {
+            *error = [Utils createNSError:@"Unknown Cipher. Cannot save this file." errorCode:-3];
+        }
+        return NO;
     }
     
-    for (KdbEntry* entry in serializationData.entries) {
-        [pt appendData:writeEntry(entry)];
-    }
+    // The contents hash goes in the header ahead of the ciphertext, so the items are written twice: once into the
+    // hash only and then through the cipher. Neither pass holds more than a chunk of plaintext.
     
-    for (KdbEntry* entry in serializationData.metaEntries) {
-        [pt appendData:writeEntry(entry)];
-    }
+    CC_SHA256_CTX context;
+    CC_SHA256_Init(&context);
     
-    NSData* contentsHash = pt.sha256;
+    KdbFieldWriter hashWriter = { 0 };
+    hashWriter.hash = &context;
     
+    [metrics beginStage:kSerializationStageIntegrity];
+    writeItems(&hashWriter, serializationData);
+    NSMutableData* contentsHash = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final(contentsHash.mutableBytes, &context);
+    [metrics endStage:kSerializationStageIntegrity];
     
+    [metrics beginStage:kSerializationStageKdf];
     NSData *compositeKey = getComposite(password, keyFileDigest);
-    
-    
-    
     NSData* transformSeed = getRandomData(kDefaultTransformSeedLength);
     NSData* transformKey = getAesTransformKey(compositeKey, transformSeed, serializationData.transformRounds);
     NSData* masterSeed = getRandomData(kKdbMasterSeedLength);
     NSData *masterKey = getMasterKey(masterSeed, transformKey);
-    
-    id<Cipher> cipher = getCipher(serializationData.flags);
+    [metrics endStage:kSerializationStageKdf];
     
     NSData* encryptionIv = [cipher generateIv];
 
-    NSData *ct = [cipher encrypt:pt iv:encryptionIv key:masterKey];
-
-    
-
     if(kLogVerbose) {
         NSLog(@"SERIALIZE");
         NSLog(@"flags = %0.8X", serializationData.flags);
@@ -312,11 +380,71 @@ static NSData *getComposite(NSString * _Nonnull password, NSData * _Nullable key
     [transformSeed getBytes:header.transformSeed length:kDefaultTransformSeedLength];
     [Uint32ToLittleEndianData(serializationData.transformRounds) getBytes:header.transformRounds length:4];
     
-    NSMutableData* ret = [NSMutableData dataWithBytes:&header length:SIZE_OF_KDB_HEADER];
+    if(!writeExactly(outputStream, (uint8_t*)&header, SIZE_OF_KDB_HEADER)) {
+        NSLog(@"Could not write KDB header.");
+        if(error) {
+            *error = outputStream.streamError ? outputStream.streamError : [Utils createNSError:@"Could not write KDB header." errorCode:-1];
+        }
+        return NO;
+    }
     
-    [ret appendData:ct];
+    NSOutputStream* encryptStream = [MetricsOutputStream wrap:[cipher getEncryptionOutputStreamForStream:outputStream key:masterKey iv:encryptionIv] metrics:metrics stage:kSerializationStageCipher];
     
-    return ret;
+    [encryptStream open];
+    
+    KdbFieldWriter writer = { 0 };
+    writer.stream = encryptStream;
+    writer.buffer = malloc(kStreamingSerializationChunkSize);
+    
+    writeItems(&writer, serializationData);
+    flushWriter(&writer);
+    
+    memset(writer.buffer, 0, kStreamingSerializationChunkSize);
+    free(writer.buffer);
+    
+    [encryptStream close];
+    
+    if(writer.failed || encryptStream.streamError) {
+        NSLog(@"Could not write encrypted KDB contents: [%@]", encryptStream.streamError);
+        if(error) {
+            *error = encryptStream.streamError ? encryptStream.streamError : [Utils createNSError:@"Could not write encrypted KDB contents." errorCode:-1];
+        }
+        return NO;
+    }
+    
+    return YES;
+}
+
+static BOOL readExactly(NSInputStream* stream, uint8_t* buffer, NSUInteger length) {
+    NSUInteger read = 0;
+    
+    while (read < length) {
+        NSInteger bytesRead = [stream read:&buffer[read] maxLength:length - read];
+        
+        if (bytesRead <= 0) {
+            return NO;
+        }
+        
+        read += bytesRead;
+    }
+    
+    return YES;
+}
+
+static BOOL writeExactly(NSOutputStream* stream, const uint8_t* buffer, NSUInteger length) {
+    NSUInteger written = 0;
+    
+    while (written < length) {
+        NSInteger wrote = [stream write:&buffer[written] maxLength:length - written];
+        
+        if (wrote <= 0) {
+            return NO;
+        }
+        
+        written += wrote;
+    }
+    
+    return YES;
 }
 
 static id<Cipher> getCipher(uint32_t flags) {
@@ -332,123 +460,248 @@ static id<Cipher> getCipher(uint32_t flags) {
 }
 
 
-NSData* writeField(uint16_t type, NSData* data) {
-    NSMutableData *ret = [NSMutableData data];
+static void flushWriter(KdbFieldWriter* writer) {
+    if (writer->used && !writer->failed) {
+        writer->failed = !writeExactly(writer->stream, writer->buffer, writer->used);
+    }
+    
+    writer->used = 0;
+}
+
+static void writeBytes(KdbFieldWriter* writer, const void* bytes, NSUInteger length) {
+    if (writer->hash) {
+        CC_SHA256_Update(writer->hash, bytes, (CC_LONG)length);
+        return;
+    }
     
-    [ret appendData:Uint16ToLittleEndianData(type)];
-    [ret appendData:Uint32ToLittleEndianData((uint32_t)data.length)];
-    [ret appendData:data];
+    const uint8_t* src = bytes;
     
-    return ret;
+    while (length > 0 && !writer->failed) {
+        NSUInteger available = MIN(length, kStreamingSerializationChunkSize - writer->used);
+        memcpy(&writer->buffer[writer->used], src, available);
+        
+        writer->used += available;
+        src += available;
+        length -= available;
+        
+        if (writer->used == kStreamingSerializationChunkSize) {
+            flushWriter(writer);
+        }
+    }
 }
 
-NSData* writeGroup(KdbGroup* group) {
-    NSMutableData *ret = [NSMutableData data];
-
-    [ret appendData:writeField(0x0001, Uint32ToLittleEndianData(group.groupId))];
-    [ret appendData:writeField(0x0002, stringtoKeePassData(group.name))];
-    if (group.creation) [ret appendData:writeField(0x0003, dateToKeePass1Data(group.creation))];
-    if (group.modification) [ret appendData:writeField(0x0004, dateToKeePass1Data(group.modification))];
-    if (group.lastAccess) [ret appendData:writeField(0x0005, dateToKeePass1Data(group.lastAccess))];
-    if (group.expiry) [ret appendData:writeField(0x0006, dateToKeePass1Data(group.expiry))];
-    if (group.imageId != nil) [ret appendData:writeField(0x0007, Uint32ToLittleEndianData(group.imageId.intValue))];
-    [ret appendData:writeField(0x0008, Uint16ToLittleEndianData(group.level))];
-    [ret appendData:writeField(0x0009, Uint32ToLittleEndianData(group.flags))];
-    [ret appendData:writeField(0xFFFF, [NSData data])];
-                               
-    return ret;
+static void writeField(KdbFieldWriter* writer, uint16_t type, const void* data, uint32_t length) {
+    uint8_t header[SIZE_OF_FIELD_HEADER];
+    
+    header[0] = type & 0xFF;
+    header[1] = type >> 8;
+    for (int i = 0; i < 4; i++) {
+        header[2 + i] = (length >> (8 * i)) & 0xFF;
+    }
+    
+    writeBytes(writer, header, SIZE_OF_FIELD_HEADER);
+    
+    if (length) {
+        writeBytes(writer, data, length);
+    }
+}
+
+static void writeUInt32Field(KdbFieldWriter* writer, uint16_t type, uint32_t value) {
+    uint8_t data[4] = { value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, (value >> 24) & 0xFF };
+    writeField(writer, type, data, sizeof(data));
+}
+
+static void writeUInt16Field(KdbFieldWriter* writer, uint16_t type, uint16_t value) {
+    uint8_t data[2] = { value & 0xFF, (value >> 8) & 0xFF };
+    writeField(writer, type, data, sizeof(data));
+}
+
+static void writeStringField(KdbFieldWriter* writer, uint16_t type, NSString* str) {
+    const char *utf8 = str ? str.UTF8String : "";
+    
+    writeField(writer, type, utf8, (uint32_t)strlen(utf8) + 1);
 }
 
-NSData* writeEntry(KdbEntry* entry) {
-    NSMutableData *ret = [NSMutableData data];
+static void writeDateField(KdbFieldWriter* writer, uint16_t type, NSDate* date) {
+    uint8_t data[5];
+    dateToKeePass1Bytes(date, data);
+    writeField(writer, type, data, sizeof(data));
+}
+
+static void writeGroup(KdbFieldWriter* writer, KdbGroup* group) {
+    writeUInt32Field(writer, 0x0001, group.groupId);
+    writeStringField(writer, 0x0002, group.name);
+    if (group.creation) writeDateField(writer, 0x0003, group.creation);
+    if (group.modification) writeDateField(writer, 0x0004, group.modification);
+    if (group.lastAccess) writeDateField(writer, 0x0005, group.lastAccess);
+    if (group.expiry) writeDateField(writer, 0x0006, group.expiry);
+    if (group.imageId != nil) writeUInt32Field(writer, 0x0007, group.imageId.intValue);
+    writeUInt16Field(writer, 0x0008, group.level);
+    writeUInt32Field(writer, 0x0009, group.flags);
+    writeField(writer, 0xFFFF, NULL, 0);
+}
 
+static void writeEntry(KdbFieldWriter* writer, KdbEntry* entry) {
     uuid_t uuid;
     [entry.uuid getUUIDBytes:(uint8_t*)&uuid];
     
-    [ret appendData:writeField(0x0001, [NSData dataWithBytes:uuid length:sizeof(uuid_t)])];
-    [ret appendData:writeField(0x0002, Uint32ToLittleEndianData(entry.groupId))];
+    writeField(writer, 0x0001, uuid, sizeof(uuid_t));
+    writeUInt32Field(writer, 0x0002, entry.groupId);
     
-    if (entry.imageId != nil) [ret appendData:writeField(0x0003, Uint32ToLittleEndianData(entry.imageId.intValue))];
+    if (entry.imageId != nil) writeUInt32Field(writer, 0x0003, entry.imageId.intValue);
     
-    [ret appendData:writeField(0x0004, stringtoKeePassData(entry.title))];
-    [ret appendData:writeField(0x0005, stringtoKeePassData(entry.url))];
-    [ret appendData:writeField(0x0006, stringtoKeePassData(entry.username))];
-    [ret appendData:writeField(0x0007, stringtoKeePassData(entry.password))];
-    [ret appendData:writeField(0x0008, stringtoKeePassData(entry.notes))];
-    if (entry.creation) [ret appendData:writeField(0x0009, dateToKeePass1Data(entry.creation))];
-    if (entry.modified) [ret appendData:writeField(0x000A, dateToKeePass1Data(entry.modified))];
-    if (entry.accessed) [ret appendData:writeField(0x000B, dateToKeePass1Data(entry.accessed))];
-    if (entry.expired) [ret appendData:writeField(0x000C, dateToKeePass1Data(entry.expired))];
+    writeStringField(writer, 0x0004, entry.title);
+    writeStringField(writer, 0x0005, entry.url);
+    writeStringField(writer, 0x0006, entry.username);
+    writeStringField(writer, 0x0007, entry.password);
+    writeStringField(writer, 0x0008, entry.notes);
+    if (entry.creation) writeDateField(writer, 0x0009, entry.creation);
+    if (entry.modified) writeDateField(writer, 0x000A, entry.modified);
+    if (entry.accessed) writeDateField(writer, 0x000B, entry.accessed);
+    if (entry.expired) writeDateField(writer, 0x000C, entry.expired);
     
     if(entry.binaryFileName) {
-        [ret appendData:writeField(0x000D,stringtoKeePassData(entry.binaryFileName))];
-        [ret appendData:writeField(0x000E, entry.binaryData)];
+        writeStringField(writer, 0x000D, entry.binaryFileName);
+        writeField(writer, 0x000E, entry.binaryData.bytes, (uint32_t)entry.binaryData.length);
     }
 
-    [ret appendData:writeField(0xFFFF, [NSData data])];
-                                   
-    return ret;
+    writeField(writer, 0xFFFF, NULL, 0);
 }
 
-static NSData* stringtoKeePassData(NSString* str) {
-    NSString *foo = str ? str : @"";
+static void writeItems(KdbFieldWriter* writer, KdbSerializationData* serializationData) {
+    for (KdbGroup* group in serializationData.groups) {
+        writeGroup(writer, group);
+    }
     
-    const char *utf8 = foo.UTF8String;
-    size_t len = strlen(utf8);
+    for (KdbEntry* entry in serializationData.entries) {
+        writeEntry(writer, entry);
+    }
     
-    return [NSData dataWithBytes:utf8 length:len + 1]; 
+    for (KdbEntry* entry in serializationData.metaEntries) {
+        writeEntry(writer, entry);
+    }
 }
 
 static NSString* keePassDataToString(uint8_t *data) {
     return [[NSString alloc] initWithCString:(char*)data encoding:NSUTF8StringEncoding];
 }
 
+static BOOL ensureFieldCapacity(KdbFieldReader* reader, NSUInteger capacity) {
+    if (capacity <= reader->fieldCapacity) {
+        return YES;
+    }
+    
+    NSUInteger newCapacity = MAX(capacity, reader->fieldCapacity * 2);
+    uint8_t* field = malloc(newCapacity);
+    
+    if (!field) {
+        return NO;
+    }
+    
+    memcpy(field, reader->field, reader->fieldCapacity);
+    memset(reader->field, 0, reader->fieldCapacity);
+    free(reader->field);
+    
+    reader->field = field;
+    reader->fieldCapacity = newCapacity;
+    
+    return YES;
+}
 
+static BOOL readBytes(KdbFieldReader* reader, uint8_t* dest, NSUInteger count) {
+    while (count > 0) {
+        if (reader->offset == reader->length) {
+            NSInteger bytesRead = [reader->stream read:reader->buffer maxLength:kStreamingSerializationChunkSize];
+            
+            if (bytesRead <= 0) {
+                return NO;
+            }
+            
+            reader->offset = 0;
+            reader->length = bytesRead;
+        }
+        
+        NSUInteger available = MIN(count, reader->length - reader->offset);
+        memcpy(dest, &reader->buffer[reader->offset], available);
+        
+        reader->offset += available;
+        dest += available;
+        count -= available;
+    }
+    
+    return YES;
+}
 
-typedef void (*updateItemWithFieldFn)(uint16_t type, uint32_t length, uint8_t *data, NSObject* item);
+// Reads the next field into reader->field, grown only as the data actually arrives so a garbled length cannot force
+// a huge allocation. The value is followed by zero padding, which terminates strings and covers the fixed size reads.
 
-KdbGroup* readGroup(uint8_t** position, uint8_t* eof) {
-    KdbGroup *group = [[KdbGroup alloc] init];
-    return (KdbGroup*)readItem(position, eof, group, updateGroupWithField);
+static BOOL readField(KdbFieldReader* reader, uint16_t* type, uint32_t* length) {
+    uint8_t header[SIZE_OF_FIELD_HEADER];
+    
+    if (!readBytes(reader, header, SIZE_OF_FIELD_HEADER)) {
+        return NO;
+    }
+    
+    *type = littleEndian2BytesToUInt16(header);
+    *length = littleEndian4BytesToUInt32(&header[2]);
+    
+    if (*type == 0xFFFF) {
+        return YES;
+    }
+    
+    NSUInteger received = 0;
+    
+    while (received < *length) {
+        NSUInteger next = MIN(*length - received, kStreamingSerializationChunkSize);
+        
+        if (!ensureFieldCapacity(reader, received + next + kFieldPadding) || !readBytes(reader, &reader->field[received], next)) {
+            return NO;
+        }
+        
+        received += next;
+    }
+    
+    if (!ensureFieldCapacity(reader, *length + kFieldPadding)) {
+        return NO;
+    }
+    
+    memset(&reader->field[*length], 0, kFieldPadding);
+    
+    return YES;
 }
 
-KdbEntry* readEntry(uint8_t** position, uint8_t* eof) {
-    KdbEntry* entry = [[KdbEntry alloc] init];
-    return (KdbEntry*)readItem(position, eof, entry, updateEntryWithField);
+static void freeFieldReader(KdbFieldReader* reader) {
+    if (reader->buffer) {
+        memset(reader->buffer, 0, kStreamingSerializationChunkSize);
+        free(reader->buffer);
+        reader->buffer = nil;
+    }
+    
+    if (reader->field) {
+        memset(reader->field, 0, reader->fieldCapacity);
+        free(reader->field);
+        reader->field = nil;
+    }
 }
 
-NSObject* readItem(uint8_t** position, uint8_t* eof, NSObject* item, updateItemWithFieldFn updateWithFieldFn) {
-    uint8_t *pos = *position;
-   
+static BOOL readItem(KdbFieldReader* reader, id item, updateItemWithFieldFn updateWithFieldFn) {
     while(YES) {
-        if((pos + SIZE_OF_FIELD_HEADER) > eof) {
-            return nil;
-        }
+        uint16_t type;
+        uint32_t length;
         
-        FieldHeader *fieldHeader = (FieldHeader*)pos;
-        uint16_t type = littleEndian2BytesToUInt16(fieldHeader->type);
-        uint32_t length = littleEndian4BytesToUInt32(fieldHeader->length);
-
-        if(type == 0xFFFF) {
-            break;
+        if(!readField(reader, &type, &length)) {
+            return NO;
         }
         
-        if((pos + SIZE_OF_FIELD_HEADER + length) > eof) {
-            return nil;
+        if(type == 0xFFFF) {
+            return YES;
         }
         
-        updateWithFieldFn(type, length, fieldHeader->data, item);
- 
-        pos += SIZE_OF_FIELD_HEADER + length;
+        updateWithFieldFn(type, length, reader->field, item);
     }
-    
-    pos += SIZE_OF_FIELD_HEADER;
-    *position = pos;
-    
-    return item;
 }
 
-void updateGroupWithField(uint16_t type, uint32_t length, uint8_t *data, KdbGroup* group) {
+static void updateGroupWithField(uint16_t type, uint32_t length, uint8_t *data, KdbGroup* group) {
     switch (type) {
         case 0x0000:
 
@@ -493,7 +746,7 @@ void updateGroupWithField(uint16_t type, uint32_t length, uint8_t *data, KdbGrou
     }
 }
 
-void updateEntryWithField(uint16_t type, uint32_t length, uint8_t *data, KdbEntry* entry) {
+static void updateEntryWithField(uint16_t type, uint32_t length, uint8_t *data, KdbEntry* entry) {
     switch (type) {
         case 0x0000:
             
@@ -545,24 +798,20 @@ void updateEntryWithField(uint16_t type, uint32_t length, uint8_t *data, KdbEntr
     }
 }
 
-NSData* dateToKeePass1Data(NSDate* date)
+static void dateToKeePass1Bytes(NSDate* date, uint8_t* bytes)
 {
     NSCalendar* calender = [[NSCalendar alloc] initWithCalendarIdentifier:NSCalendarIdentifierGregorian];
     uint32_t flags = NSCalendarUnitYear | NSCalendarUnitMonth |  NSCalendarUnitDay | NSCalendarUnitHour | NSCalendarUnitMinute | NSCalendarUnitSecond;
     NSDateComponents* c = [calender components:flags fromDate:date];
     
-    NSMutableData *ret = [NSMutableData dataWithLength:5];
-    
-    ((uint8_t*)ret.mutableBytes)[0] = (uint8_t)((c.year >> 6) & 0x0000003F);
-    ((uint8_t*)ret.mutableBytes)[1] = (uint8_t)(((c.year & 0x0000003F) << 2) | ((c.month >> 2) & 0x00000003));
-    ((uint8_t*)ret.mutableBytes)[2] = (uint8_t)(((c.month & 0x00000003) << 6) | ((c.day & 0x0000001F) << 1) | ((c.hour >> 4) & 0x00000001));
-    ((uint8_t*)ret.mutableBytes)[3] = (uint8_t)(((c.hour & 0x0000000F) << 4) | ((c.minute >> 2) & 0x0000000F));
-    ((uint8_t*)ret.mutableBytes)[4] = (uint8_t)(((c.minute & 0x00000003) << 6) | (c.second & 0x0000003F));
-
-    return ret;
+    bytes[0] = (uint8_t)((c.year >> 6) & 0x0000003F);
+    bytes[1] = (uint8_t)(((c.year & 0x0000003F) << 2) | ((c.month >> 2) & 0x00000003));
+    bytes[2] = (uint8_t)(((c.month & 0x00000003) << 6) | ((c.day & 0x0000001F) << 1) | ((c.hour >> 4) & 0x00000001));
+    bytes[3] = (uint8_t)(((c.hour & 0x0000000F) << 4) | ((c.minute >> 2) & 0x0000000F));
+    bytes[4] = (uint8_t)(((c.minute & 0x00000003) << 6) | (c.second & 0x0000003F));
 }
 
-NSDate* keePass1TimeToDate(const uint8_t *keePassTime)
+static NSDate* keePass1TimeToDate(const uint8_t *keePassTime)
 {
     uint32_t b1 = (uint32_t)keePassTime[0];
     uint32_t b2 = (uint32_t)keePassTime[1];
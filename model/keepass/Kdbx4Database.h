@@ -13,6 +13,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface Kdbx4Database : NSObject<AbstractDatabaseFormatAdaptor>
 
++ (void)read:(NSInputStream*)stream
+         ckf:(CompositeKeyFactors*)ckf
+ snapshotUrl:(NSURL*)snapshotUrl
+sourceSha256:(NSData*)sourceSha256
+     metrics:(SerializationMetrics*_Nullable)metrics
+  completion:(OpenCompletionBlock)completion;
+
 @end
 
 NS_ASSUME_NONNULL_END
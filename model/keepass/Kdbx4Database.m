@@ -18,6 +18,7 @@
 #import "NSArray+Extensions.h"
 #import "XmlSerializer.h"
 #import "InnerRandomStreamFactory.h"
+#import "DatabaseSnapshot.h"
 
 static const uint32_t kKdbx4MajorVersionNumber = 4;
 static const uint32_t kKdbx4MaximumAcceptableMinorVersionNumber = 1; 
@@ -37,18 +38,20 @@ static const uint32_t kKdbx4MaximumAcceptableMinorVersionNumber = 1;
 }
 
 + (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf completion:(OpenCompletionBlock)completion {
-    [self read:stream ckf:ckf xmlDumpStream:nil sanityCheckInnerStream:YES completion:completion];
+    [self read:stream ckf:ckf xmlDumpStream:nil sanityCheckInnerStream:YES metrics:nil completion:completion];
 }
 
 + (void)read:(NSInputStream *)stream
          ckf:(CompositeKeyFactors *)ckf
 xmlDumpStream:(NSOutputStream*_Nullable)xmlDumpStream
 sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+     metrics:(SerializationMetrics*)metrics
   completion:(OpenCompletionBlock)completion {
     [Kdbx4Serialization deserialize:stream
                 compositeKeyFactors:ckf
                       xmlDumpStream:xmlDumpStream
              sanityCheckInnerStream:sanityCheckInnerStream
+                            metrics:metrics
                          completion:^(BOOL userCancelled, Kdbx4SerializationData * _Nullable serializationData, NSError * _Nullable innerStreamError, NSError * _Nullable error) {
         if(userCancelled || serializationData == nil || serializationData.rootXmlObject == nil || error) {
             if(error) {
@@ -58,11 +61,64 @@ sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
             return;
         }
 
-        onDeserialized(serializationData, innerStreamError, ckf, completion);
+        onDeserialized(serializationData, innerStreamError, ckf, metrics, completion);
     }];
 }
 
-static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData, NSError * _Nullable innerStreamError, CompositeKeyFactors* ckf, OpenCompletionBlock completion) {
++ (void)read:(NSInputStream *)stream
+         ckf:(CompositeKeyFactors *)ckf
+ snapshotUrl:(NSURL *)snapshotUrl
+sourceSha256:(NSData *)sourceSha256
+     metrics:(SerializationMetrics *)metrics
+  completion:(OpenCompletionBlock)completion {
+    NSData* snapshot = [NSData dataWithContentsOfURL:snapshotUrl options:NSDataReadingMappedIfSafe error:nil];
+    
+    __block NSData* snapshotKey = nil;
+    __block DatabaseModel* restored = nil;
+    
+    [Kdbx4Serialization deserialize:stream
+                compositeKeyFactors:ckf
+                      xmlDumpStream:nil
+             sanityCheckInnerStream:YES
+                            metrics:metrics
+                       verifiedKeys:^BOOL(NSData * _Nonnull masterKey) {
+        snapshotKey = [DatabaseSnapshot keyFromMasterKey:masterKey];
+        
+        if ( snapshot ) {
+            [metrics beginStage:kSerializationStageModel];
+            restored = [DatabaseSnapshot deserialize:snapshot sourceSha256:sourceSha256 key:snapshotKey ckf:ckf];
+            [metrics endStage:kSerializationStageModel];
+        }
+        
+        return restored != nil;
+    }
+                         completion:^(BOOL userCancelled, Kdbx4SerializationData * _Nullable serializationData, NSError * _Nullable innerStreamError, NSError * _Nullable error) {
+        if ( restored ) {
+            completion(NO, restored, nil, nil);
+            return;
+        }
+        
+        if(userCancelled || serializationData == nil || serializationData.rootXmlObject == nil || error) {
+            if(error) {
+                NSLog(@"Error getting Decrypting KDBX4 binary: [%@]", error);
+            }
+            completion(userCancelled, nil, innerStreamError, error);
+            return;
+        }
+        
+        onDeserialized(serializationData, innerStreamError, ckf, metrics, ^(BOOL userCancelled, DatabaseModel * _Nullable database, NSError * _Nullable innerStreamError, NSError * _Nullable error) {
+            if ( database && snapshotKey && !innerStreamError && !error ) {
+                [DatabaseSnapshot writeSnapshot:database sourceSha256:sourceSha256 key:snapshotKey url:snapshotUrl];
+            }
+            
+            completion(userCancelled, database, innerStreamError, error);
+        });
+    }];
+}
+
+static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData, NSError * _Nullable innerStreamError, CompositeKeyFactors* ckf, SerializationMetrics* metrics, OpenCompletionBlock completion) {
+    [metrics beginStage:kSerializationStageModel];
+
     RootXmlDomainObject* xmlRoot = serializationData.rootXmlObject;
     Meta* meta = xmlRoot.keePassFile ? xmlRoot.keePassFile.meta : nil;
         
@@ -76,6 +132,7 @@ static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData,
     Node* rootGroup = [KeePassXmlModelAdaptor toStrongboxModel:xmlRoot attachments:serializationData.attachments customIconPool:customIcons error:&error];
     if(rootGroup == nil) {
         NSLog(@"Error converting Xml model to Strongbox model: [%@]", error);
+        [metrics endStage:kSerializationStageModel];
         completion(NO, nil, innerStreamError, error);
         return;
     }
@@ -97,6 +154,9 @@ static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData,
     metadata.compressionFlags = serializationData.compressionFlags;
     metadata.version = serializationData.fileVersion;
     
+    [metrics endStage:kSerializationStageModel];
+    [metrics beginStage:kSerializationStageFastMaps];
+
     DatabaseModel* ret = [[DatabaseModel alloc] initWithFormat:kKeePass4
                                            compositeKeyFactors:ckf
                                                       metadata:metadata
@@ -104,6 +164,8 @@ static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData,
                                                 deletedObjects:deletedObjects
                                                       iconPool:customIcons];
 
+    [metrics endStage:kSerializationStageFastMaps];
+
     KeePass2TagPackage* tag = [[KeePass2TagPackage alloc] init];
     tag.unknownHeaders = serializationData.extraUnknownHeaders; 
     
@@ -113,6 +175,10 @@ static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData,
 }
 
 + (void)save:(DatabaseModel *)database outputStream:(NSOutputStream *)outputStream completion:(SaveCompletionBlock)completion {
+    [self save:database outputStream:outputStream metrics:nil completion:completion];
+}
+
++ (void)save:(DatabaseModel *)database outputStream:(NSOutputStream *)outputStream metrics:(SerializationMetrics *)metrics completion:(SaveCompletionBlock)completion {
     if(!database.ckfs.password &&
        !database.ckfs.keyFileDigest &&
        !database.ckfs.yubiKeyCR) {
@@ -134,12 +200,15 @@ static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData,
     NSError* error;
     
     NSArray<KeePassAttachmentAbstractionLayer*>* minimalAttachmentPool = @[];
+
+    [metrics beginStage:kSerializationStageModel];
     RootXmlDomainObject *rootXmlDocument = [xmlAdaptor toKeePassModel:database.rootNode
                                                    databaseProperties:databaseProperties
                                                               context:[XmlProcessingContext standardV4Context]
                                                 minimalAttachmentPool:&minimalAttachmentPool
                                                              iconPool:database.iconPool
                                                                 error:&error];
+    [metrics endStage:kSerializationStageModel];
     
     if(!rootXmlDocument) {
         NSLog(@"Could not convert Database to Xml Model.");
@@ -185,6 +254,7 @@ static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData,
     
     serializationData.fileVersion = database.meta.version;
     serializationData.compressionFlags = database.meta.compressionFlags;
+    serializationData.compressionProfile = database.meta.compressionProfile;
     serializationData.innerRandomStreamId = database.meta.innerRandomStreamId;
     serializationData.innerRandomStreamKey = innerStream.key;
     serializationData.extraUnknownHeaders = unknownHeaders;
@@ -197,6 +267,7 @@ static void onDeserialized(Kdbx4SerializationData * _Nullable serializationData,
                       innerStream:innerStream
                               ckf:database.ckfs
                      outputStream:outputStream
+                          metrics:metrics
                        completion:^(BOOL userCancelled, NSError * _Nullable error) {
         if (userCancelled) {
             completion(userCancelled, nil, nil);
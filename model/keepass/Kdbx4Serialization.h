@@ -12,6 +12,7 @@
 #import "CompositeKeyFactors.h"
 #import "InnerRandomStream.h"
 #import "KeyDerivationCipher.h"
+#import "SerializationMetrics.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -37,6 +38,7 @@ typedef struct _InnerHeaderEntryHeader {
 
 typedef void (^Deserialize4CompletionBlock)(BOOL userCancelled, Kdbx4SerializationData *_Nullable serializationData, NSError*_Nullable innerStreamError, NSError*_Nullable error);
 typedef void (^Serialize4CompletionBlock)(BOOL userCancelled, NSError*_Nullable error);
+typedef BOOL (^Kdbx4VerifiedKeysBlock)(NSData* masterKey);
 
 id<KeyDerivationCipher> getKeyDerivationCipher(KdfParameters *kdfParameters, NSError** error);
 
@@ -48,6 +50,15 @@ id<KeyDerivationCipher> getKeyDerivationCipher(KdfParameters *kdfParameters, NSE
 compositeKeyFactors:(CompositeKeyFactors*)compositeKeyFactors
       xmlDumpStream:(NSOutputStream*_Nullable)xmlDumpStream
 sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+            metrics:(SerializationMetrics*_Nullable)metrics
+         completion:(Deserialize4CompletionBlock)completion;
+
++ (void)deserialize:(NSInputStream*)stream
+compositeKeyFactors:(CompositeKeyFactors*)compositeKeyFactors
+      xmlDumpStream:(NSOutputStream*_Nullable)xmlDumpStream
+sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+            metrics:(SerializationMetrics*_Nullable)metrics
+       verifiedKeys:(Kdbx4VerifiedKeysBlock _Nullable)verifiedKeys
          completion:(Deserialize4CompletionBlock)completion;
 
 + (void)serialize:(Kdbx4SerializationData*)serializationData
@@ -55,6 +66,7 @@ sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
       innerStream:(id<InnerRandomStream>)innerStream
               ckf:(CompositeKeyFactors*)ckf
      outputStream:(NSOutputStream*)outputStream
+          metrics:(SerializationMetrics*_Nullable)metrics
        completion:(Serialize4CompletionBlock)completion;
 
 @end
@@ -34,6 +34,8 @@
 #import "GzipDecompressOutputStream.h"
 #import "GZIPCompressOutputStream.h"
 #import "XmlSerializer.h"
+#import "MetricsInputStream.h"
+#import "MetricsOutputStream.h"
 
 static const uint8_t kInnerHeaderTypeEnd = 0;
 static const uint8_t kInnerHeaderTypeInnerRandomStreamId = 1;
@@ -65,6 +67,7 @@ static const BOOL kLogVerbose = NO;
       innerStream:(id<InnerRandomStream>)innerStream
               ckf:(CompositeKeyFactors *)ckf
      outputStream:(NSOutputStream *)outputStream
+          metrics:(SerializationMetrics *)metrics
        completion:(Serialize4CompletionBlock)completion {
     if(kLogVerbose) {
         NSLog(@"Serializing with [%@] and password [%@]", serializationData, ckf);
@@ -96,11 +99,15 @@ static const BOOL kLogVerbose = NO;
         return;
     }
     
+    [metrics beginStage:kSerializationStageKdf];
+
     [Kdbx4Serialization getKeys:yubiKeyChallenge
             compositeKeyFactors:ckf
                   kdfParameters:serializationData.kdfParameters
                      masterSeed:masterSeed
                      completion:^(BOOL userCancelled, Keys * _Nullable keys, NSError * _Nullable error) {
+        [metrics endStage:kSerializationStageKdf];
+
         if(userCancelled || error || keys == nil) {
             if(!keys && !userCancelled) {
                 NSLog(@"Could not get Keys.");
@@ -116,7 +123,8 @@ static const BOOL kLogVerbose = NO;
                               serializationData:serializationData
                                          cipher:cipher
                                      masterSeed:masterSeed
-                                   outputStream:outputStream
+                                   outputStream:[MetricsOutputStream wrap:outputStream metrics:metrics stage:kSerializationStageIo]
+                                        metrics:metrics
                                      completion:completion];
         }
     }];
@@ -130,6 +138,7 @@ static const BOOL kLogVerbose = NO;
                  cipher:(id<Cipher>)cipher
              masterSeed:(NSData*)masterSeed
            outputStream:(NSOutputStream *)outputStream
+                metrics:(SerializationMetrics*)metrics
              completion:(Serialize4CompletionBlock)completion {
 
     
@@ -192,9 +201,9 @@ static const BOOL kLogVerbose = NO;
     
     
     
-    HmacBlockOutputStream* hmacBlockifyStream = [[HmacBlockOutputStream alloc] initWithStream:outputStream hmacKey:keys.hmacKey];
-    NSOutputStream* encryptStream = [cipher getEncryptionOutputStreamForStream:hmacBlockifyStream key:keys.masterKey iv:encryptionIv];
-    NSOutputStream* compression = serializationData.compressionFlags == kGzipCompressionFlag ? [[GZIPCompressOutputStream alloc] initToOutputStream:encryptStream] : encryptStream;
+    NSOutputStream* hmacBlockifyStream = [MetricsOutputStream wrap:[[HmacBlockOutputStream alloc] initWithStream:outputStream hmacKey:keys.hmacKey] metrics:metrics stage:kSerializationStageIntegrity];
+    NSOutputStream* encryptStream = [MetricsOutputStream wrap:[cipher getEncryptionOutputStreamForStream:hmacBlockifyStream key:keys.masterKey iv:encryptionIv] metrics:metrics stage:kSerializationStageCipher];
+    NSOutputStream* compression = serializationData.compressionFlags == kGzipCompressionFlag ? [MetricsOutputStream wrap:[[GZIPCompressOutputStream alloc] initToOutputStream:encryptStream profile:serializationData.compressionProfile] metrics:metrics stage:kSerializationStageCompression] : encryptStream;
 
     [hmacBlockifyStream open];
     [encryptStream open];
@@ -203,8 +212,11 @@ static const BOOL kLogVerbose = NO;
     
     
     NSOutputStream* thePipeline = compression;
+
+    [metrics beginStage:kSerializationStageDocument];
     wrote = createInnerHeaders(serializationData.attachments, serializationData.innerRandomStreamId, serializationData.innerRandomStreamKey, thePipeline);
     if ( wrote < 0 ) {
+        [metrics endStage:kSerializationStageDocument];
         NSLog(@"Could not serialize inner headers (probably could not serialize attachments). KDBX4. = [%@]", thePipeline.streamError );
         completion(NO, thePipeline.streamError );
         return;
@@ -217,6 +229,7 @@ static const BOOL kLogVerbose = NO;
     [xmlSerializer beginDocument];
     BOOL writeXmlOk = [rootXmlDocument writeXml:xmlSerializer];
     [xmlSerializer endDocument];
+    [metrics endStage:kSerializationStageDocument];
     
     if( !writeXmlOk ) {
         NSLog(@"Could not serialize Xml to Document.:\n");
@@ -269,7 +282,26 @@ static BOOL readFileHeader(NSInputStream* stream, KeepassFileHeader *pFileHeader
 compositeKeyFactors:(CompositeKeyFactors *)compositeKeyFactors
       xmlDumpStream:(NSOutputStream*)xmlDumpStream
 sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+            metrics:(SerializationMetrics *)metrics
          completion:(Deserialize4CompletionBlock)completion {
+    [self deserialize:stream
+  compositeKeyFactors:compositeKeyFactors
+        xmlDumpStream:xmlDumpStream
+sanityCheckInnerStream:sanityCheckInnerStream
+              metrics:metrics
+         verifiedKeys:nil
+           completion:completion];
+}
+
++ (void)deserialize:(NSInputStream *)stream
+compositeKeyFactors:(CompositeKeyFactors *)compositeKeyFactors
+      xmlDumpStream:(NSOutputStream*)xmlDumpStream
+sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+            metrics:(SerializationMetrics *)metrics
+       verifiedKeys:(Kdbx4VerifiedKeysBlock)verifiedKeys
+         completion:(Deserialize4CompletionBlock)completion {
+    stream = [MetricsInputStream wrap:stream metrics:metrics stage:kSerializationStageIo];
+
     NSMutableData* headerDataForIntegrityCheck = [NSMutableData data];
     
     
@@ -311,11 +343,15 @@ sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
         return;
     }
     
+    [metrics beginStage:kSerializationStageKdf];
+
     [Kdbx4Serialization getKeys:yubiKeyChallenge
             compositeKeyFactors:compositeKeyFactors
                   kdfParameters:cryptoParams.kdfParameters
                      masterSeed:cryptoParams.masterSeed
                      completion:^(BOOL userCancelled, Keys * _Nullable keys, NSError * _Nullable error) {
+        [metrics endStage:kSerializationStageKdf];
+
         if(userCancelled || error || keys == nil) {
             completion(userCancelled, nil, nil, error);
         }
@@ -327,6 +363,8 @@ sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
                                      cryptoParams:cryptoParams
                                     xmlDumpStream:xmlDumpStream
                            sanityCheckInnerStream:sanityCheckInnerStream
+                                          metrics:metrics
+                                     verifiedKeys:verifiedKeys
                                        completion:completion];
         }
     }];
@@ -339,40 +377,52 @@ headerDataForIntegrityCheck:(NSData*)headerDataForIntegrityCheck
              cryptoParams:(CryptoParameters*)cryptoParams
             xmlDumpStream:(NSOutputStream*)xmlDumpStream
    sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+                  metrics:(SerializationMetrics*)metrics
+             verifiedKeys:(Kdbx4VerifiedKeysBlock)verifiedKeys
                completion:(Deserialize4CompletionBlock)completion {
-    if(!checkHeaderHash(headerDataForIntegrityCheck, inputStream)) {
+    [metrics beginStage:kSerializationStageIntegrity];
+    BOOL headerHashOk = checkHeaderHash(headerDataForIntegrityCheck, inputStream);
+    BOOL headerHmacOk = headerHashOk && checkHeaderHmac(headerDataForIntegrityCheck, keys.hmacKey, inputStream);
+    [metrics endStage:kSerializationStageIntegrity];
+
+    if(!headerHashOk) {
         NSError* error = [Utils createNSError:@"Actual Header HMAC or Hash does not match expected. Header has been corrupted." errorCode:-3];
         completion(NO, nil, nil, error);
         return;
     }
 
-    if(!checkHeaderHmac(headerDataForIntegrityCheck, keys.hmacKey, inputStream)) {
+    if(!headerHmacOk) {
         NSError* error = [Utils createNSError:@"Incorrect Passphrase/Key File (Composite Key)"
                                     errorCode:StrongboxErrorCodes.incorrectCredentials];
         completion(NO, nil, nil, error);
         return;
     }
 
-    
+    if ( verifiedKeys && verifiedKeys(keys.masterKey) ) {
+        completion(NO, nil, nil, nil);
+        return;
+    }
 
-    HmacBlockInputStream* hmacedBlockStream = [[HmacBlockInputStream alloc] initWithStream:inputStream hmacKey:keys.hmacKey];
+    NSInputStream* hmacedBlockStream = [MetricsInputStream wrap:[[HmacBlockInputStream alloc] initWithStream:inputStream hmacKey:keys.hmacKey] metrics:metrics stage:kSerializationStageIntegrity];
 
     
 
     id<Cipher> cipher = getCipher(cryptoParams.cipherUuid);
-    NSInputStream* plainTextStream = [cipher getDecryptionStreamForStream:hmacedBlockStream key:keys.masterKey iv:cryptoParams.iv];
+    NSInputStream* plainTextStream = [MetricsInputStream wrap:[cipher getDecryptionStreamForStream:hmacedBlockStream key:keys.masterKey iv:cryptoParams.iv] metrics:metrics stage:kSerializationStageCipher];
 
     
 
     BOOL compressed = cryptoParams.compressionFlags == 1;
-    NSInputStream* decompressedStream = compressed ? [[GZipInputStream alloc] initWithStream:plainTextStream] : plainTextStream;
+    NSInputStream* decompressedStream = compressed ? [MetricsInputStream wrap:[[GZipInputStream alloc] initWithStream:plainTextStream] metrics:metrics stage:kSerializationStageCompression] : plainTextStream;
 
     [decompressedStream open];
     
     NSError* error;
     NSError* innerStreamError;
 
+    [metrics beginStage:kSerializationStageDocument];
     Kdbx4SerializationData* ret = readDecrypted(decompressedStream, xmlDumpStream, sanityCheckInnerStream, &innerStreamError, &error);
+    [metrics endStage:kSerializationStageDocument];
 
     [decompressedStream close];
 
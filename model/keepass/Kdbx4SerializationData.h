@@ -10,6 +10,7 @@
 #import "KdfParameters.h"
 #import "KeePassAttachmentAbstractionLayer.h"
 #import "RootXmlDomainObject.h"
+#import "CompressionProfile.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -17,6 +18,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 @property NSString* fileVersion;
 @property uint32_t compressionFlags;
+@property CompressionProfile compressionProfile;
 @property uint32_t innerRandomStreamId;
 @property (nullable) NSData* innerRandomStreamKey;
 @property NSDictionary<NSNumber*, NSObject*> *extraUnknownHeaders;
@@ -9,6 +9,9 @@
 #import <Foundation/Foundation.h>
 #import "SerializationData.h"
 #import "CompositeKeyFactors.h"
+#import "RootXmlDomainObject.h"
+#import "InnerRandomStream.h"
+#import "SerializationMetrics.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -31,14 +34,19 @@ typedef void (^DeserializeCompletionBlock)(BOOL userCancelled, SerializationData
 compositeKeyFactors:(CompositeKeyFactors*)compositeKeyFactors
       xmlDumpStream:(NSOutputStream*_Nullable)xmlDumpStream
 sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+            metrics:(SerializationMetrics*_Nullable)metrics
          completion:(DeserializeCompletionBlock)completion;
 
 - (instancetype)init:(SerializationData*)serializationData;
+- (instancetype)init:(SerializationData*)serializationData metrics:(SerializationMetrics*_Nullable)metrics;
 
 - (void)stage1Serialize:(CompositeKeyFactors *)compositeKeyFactors
              completion:(SerializeCompletionBlock)completion;
 
-- (nullable NSData*)stage2Serialize:(NSString*)xml error:(NSError**)error;
+- (BOOL)stage2Serialize:(RootXmlDomainObject*)rootXmlDocument
+            innerStream:(id<InnerRandomStream>)innerStream
+           outputStream:(NSOutputStream*)outputStream
+                  error:(NSError**)error;
 
 @end
 
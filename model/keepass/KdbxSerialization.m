@@ -14,7 +14,6 @@
 #import "DecryptionParameters.h"
 #import "PwSafeSerialization.h"
 #import "Utils.h"
-#import "NSData+GZIP.h"
 #import "KeePassConstants.h"
 #import "AesCipher.h"
 #import "KdbxSerializationCommon.h"
@@ -23,7 +22,12 @@
 #import "NSData+Extensions.h"
 #import "NSString+Extensions.h"
 #import "KP31HashedBlockStream.h"
+#import "KP31HashedBlockOutputStream.h"
+#import "GZIPCompressOutputStream.h"
+#import "XmlSerializer.h"
 #import "StrongboxErrorCodes.h"
+#import "MetricsInputStream.h"
+#import "MetricsOutputStream.h"
 
 typedef struct _HeaderEntryHeader {
     uint8_t id;
@@ -31,8 +35,6 @@ typedef struct _HeaderEntryHeader {
 } HeaderEntryHeader;
 #define SIZE_OF_HEADER_ENTRY_HEADER      3
 
-static const struct _BlockHeader EndOfBlocksHeaderTemplate; 
-
 static const uint32_t kDefaultStartStreamBytesLength = 32;
 
 static const uint32_t kKdbx3MajorVersionNumber = 3;
@@ -45,6 +47,7 @@ static const uint32_t kKdbx3MinorVersionNumber = 1;
 @property (nonatomic) NSData* startStream;
 @property (nonatomic) NSData* encryptionIv;
 @property (nonatomic) NSData* masterKey;
+@property (nonatomic, nullable) SerializationMetrics* metrics;
 
 @end
 
@@ -57,10 +60,15 @@ static BOOL kLogVerbose = NO;
 }
 
 - (instancetype)init:(SerializationData*)serializationData {
+    return [self init:serializationData metrics:nil];
+}
+
+- (instancetype)init:(SerializationData*)serializationData metrics:(SerializationMetrics*)metrics {
     self = [super init];
     if (self) {
         self.serializationData = serializationData;
         self.headerData = [[NSMutableData alloc] init];
+        self.metrics = metrics;
     }
     
     return self;
@@ -73,10 +81,12 @@ static BOOL kLogVerbose = NO;
     
     
     
+    [self.metrics beginStage:kSerializationStageKdf];
     NSData* compositeKey = getCompositeKey(compositeKeyFactors);
     NSData* transformSeed = getRandomData(kDefaultTransformSeedLength);
     NSData* transformKey = getAesTransformKey(compositeKey, transformSeed, self.serializationData.transformRounds);
     NSData* masterSeed = getRandomData(kMasterSeedLength); 
+    [self.metrics endStage:kSerializationStageKdf];
     
     if(compositeKeyFactors.yubiKeyCR) {
         NSData* challenge = masterSeed;
@@ -156,18 +166,10 @@ static BOOL kLogVerbose = NO;
     completion(NO, ret, nil);
 }
 
-- (NSData *)stage2Serialize:(NSString *)xml error:(NSError **)error {
-    NSMutableData *ret = [[NSMutableData alloc] initWithData:self.headerData];
-    
-    
-    
-    NSData* payload = [xml dataUsingEncoding:NSUTF8StringEncoding];
-    payload = self.serializationData.compressionFlags == kGzipCompressionFlag ? [payload gzippedData] : payload;
-    
-    
-    
-    NSData * toBeEncrypted = getEncryptionBlob(payload, self.startStream);
-    
+- (BOOL)stage2Serialize:(RootXmlDomainObject *)rootXmlDocument
+            innerStream:(id<InnerRandomStream>)innerStream
+           outputStream:(NSOutputStream *)outputStream
+                  error:(NSError **)error {
     id<Cipher> cipher = getCipher(self.serializationData.cipherId);
     if(!cipher) {
         NSString *message=[NSString stringWithFormat:@"Unknown Cipher ID: [%@]. Do not know how to decrypt.", [self.serializationData.cipherId UUIDString]];
@@ -176,18 +178,72 @@ static BOOL kLogVerbose = NO;
             *error = [Utils createNSError:message errorCode:-5];
         }
         
-        return nil;
+        return NO;
     }
 
-    NSData *encrypted = [cipher encrypt:toBeEncrypted iv:self.encryptionIv key:self.masterKey];
+    outputStream = [MetricsOutputStream wrap:outputStream metrics:self.metrics stage:kSerializationStageIo];
+
+    NSInteger wrote = [outputStream write:self.headerData.bytes maxLength:self.headerData.length];
+    if ( wrote < 0 ) {
+        NSLog(@"Could not serialize HEADER. KDBX3");
+        if (error) {
+            *error = outputStream.streamError ? outputStream.streamError : [Utils createNSError:@"Could not serialize HEADER. KDBX3." errorCode:-1];
+        }
+        return NO;
+    }
     
-    if(!encrypted) {
-        return nil;
+    
+    
+    NSOutputStream* encryptStream = [MetricsOutputStream wrap:[cipher getEncryptionOutputStreamForStream:outputStream key:self.masterKey iv:self.encryptionIv] metrics:self.metrics stage:kSerializationStageCipher];
+    NSOutputStream* blockifyStream = [MetricsOutputStream wrap:[[KP31HashedBlockOutputStream alloc] initWithStream:encryptStream] metrics:self.metrics stage:kSerializationStageIntegrity];
+    NSOutputStream* compression = self.serializationData.compressionFlags == kGzipCompressionFlag ? [MetricsOutputStream wrap:[[GZIPCompressOutputStream alloc] initToOutputStream:blockifyStream profile:self.serializationData.compressionProfile] metrics:self.metrics stage:kSerializationStageCompression] : blockifyStream;
+    
+    [encryptStream open];
+    
+    wrote = [encryptStream write:self.startStream.bytes maxLength:self.startStream.length];
+    if ( wrote < 0 ) {
+        NSLog(@"Could not serialize Start Stream Bytes. KDBX3");
+        if (error) {
+            *error = encryptStream.streamError ? encryptStream.streamError : [Utils createNSError:@"Could not serialize Start Stream Bytes. KDBX3." errorCode:-1];
+        }
+        return NO;
     }
     
-    [ret appendData:encrypted];
+    [blockifyStream open];
+    [compression open];
     
-    return ret;
+    
+    
+    id<IXmlSerializer> xmlSerializer = [[XmlSerializer alloc] initWithProtectedStream:innerStream v4Format:NO prettyPrint:NO outputStream:compression];
+
+    [self.metrics beginStage:kSerializationStageDocument];
+    [xmlSerializer beginDocument];
+    BOOL writeXmlOk = [rootXmlDocument writeXml:xmlSerializer];
+    [xmlSerializer endDocument];
+    [self.metrics endStage:kSerializationStageDocument];
+    
+    if( !writeXmlOk || xmlSerializer.streamError != nil ) {
+        NSLog(@"Could not serialize Xml to Document: [%@]", xmlSerializer.streamError);
+        if (error) {
+            *error = xmlSerializer.streamError ? xmlSerializer.streamError : [Utils createNSError:@"Could not serialize Xml to Document." errorCode:-5];
+        }
+        return NO;
+    }
+    
+    [compression close];
+    [blockifyStream close];
+    [encryptStream close];
+    
+    NSError* streamError = compression.streamError ? compression.streamError : (blockifyStream.streamError ? blockifyStream.streamError : encryptStream.streamError);
+    if ( streamError ) {
+        NSLog(@"Error closing streams [%@]", streamError);
+        if (error) {
+            *error = streamError;
+        }
+        return NO;
+    }
+    
+    return YES;
 }
 
 static BOOL readFileHeader(NSInputStream* stream, KeepassFileHeader *pFileHeader) {
@@ -200,7 +256,10 @@ static BOOL readFileHeader(NSInputStream* stream, KeepassFileHeader *pFileHeader
 compositeKeyFactors:(CompositeKeyFactors *)compositeKeyFactors
       xmlDumpStream:(NSOutputStream*)xmlDumpStream
 sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+            metrics:(SerializationMetrics *)metrics
          completion:(DeserializeCompletionBlock)completion {
+    stream = [MetricsInputStream wrap:stream metrics:metrics stage:kSerializationStageIo];
+
     NSMutableData* headerDataForIntegrityCheck = [NSMutableData data];
     
     
@@ -232,8 +291,10 @@ sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
         NSLog(@"DecryptionParameters: [%@]", decryptionParameters);
     }
     
+    [metrics beginStage:kSerializationStageKdf];
     NSData* compositeKey = getCompositeKey(compositeKeyFactors);
     NSData* transformKey = getAesTransformKey(compositeKey, decryptionParameters.transformSeed, decryptionParameters.transformRounds);
+    [metrics endStage:kSerializationStageKdf];
     
     if (compositeKeyFactors.yubiKeyCR) {
         NSData* challenge = decryptionParameters.masterSeed;
@@ -256,6 +317,7 @@ sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
                                            masterKey:masterKey
                                        xmlDumpStream:xmlDumpStream
                               sanityCheckInnerStream:sanityCheckInnerStream
+                                             metrics:metrics
                                           completion:completion];
             }
         });
@@ -269,6 +331,7 @@ sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
                                    masterKey:masterKey
                                xmlDumpStream:xmlDumpStream
                       sanityCheckInnerStream:sanityCheckInnerStream
+                                     metrics:metrics
                                   completion:completion];
     }
 }
@@ -280,9 +343,12 @@ headerDataForIntegrityCheck:(NSData*)headerDataForIntegrityCheck
                 masterKey:(NSData*)masterKey
             xmlDumpStream:(NSOutputStream*)xmlDumpStream
    sanityCheckInnerStream:(BOOL)sanityCheckInnerStream
+                  metrics:(SerializationMetrics*)metrics
                completion:(DeserializeCompletionBlock)completion {
+    [metrics beginStage:kSerializationStageIntegrity];
     NSMutableData* headerHash = [[NSMutableData alloc] initWithLength:CC_SHA256_DIGEST_LENGTH];
     CC_SHA256(headerDataForIntegrityCheck.bytes, (CC_LONG)headerDataForIntegrityCheck.length, headerHash.mutableBytes);
+    [metrics endStage:kSerializationStageIntegrity];
     
     if(kLogVerbose) {
         NSLog(@"HEADERHASH (ACTUAL): %@", [headerHash base64EncodedStringWithOptions:kNilOptions]);
@@ -299,7 +365,7 @@ headerDataForIntegrityCheck:(NSData*)headerDataForIntegrityCheck
         return;
     }
     
-    NSInputStream *plaintextStream = [cipher getDecryptionStreamForStream:inputStream key:masterKey iv:decryptionParameters.encryptionIv];
+    NSInputStream *plaintextStream = [MetricsInputStream wrap:[cipher getDecryptionStreamForStream:inputStream key:masterKey iv:decryptionParameters.encryptionIv] metrics:metrics stage:kSerializationStageCipher];
     
     uint8_t *start = malloc(decryptionParameters.streamStartBytes.length);
     
@@ -321,15 +387,17 @@ headerDataForIntegrityCheck:(NSData*)headerDataForIntegrityCheck
     }
     free(start);
     
-    NSInputStream* deblockifiedStream = [[KP31HashedBlockStream alloc] initWithStream:plaintextStream];
+    NSInputStream* deblockifiedStream = [MetricsInputStream wrap:[[KP31HashedBlockStream alloc] initWithStream:plaintextStream] metrics:metrics stage:kSerializationStageIntegrity];
     
     BOOL compressed = decryptionParameters.compressionFlags == kGzipCompressionFlag;
-    NSInputStream* decompressedStream = compressed ? [[GZipInputStream alloc] initWithStream:deblockifiedStream] : deblockifiedStream;
+    NSInputStream* decompressedStream = compressed ? [MetricsInputStream wrap:[[GZipInputStream alloc] initWithStream:deblockifiedStream] metrics:metrics stage:kSerializationStageCompression] : deblockifiedStream;
         
     [decompressedStream open];
     
     NSError* error;
     NSError* innerStreamError;
+
+    [metrics beginStage:kSerializationStageDocument];
     RootXmlDomainObject *rootXmlObject = [KdbxSerialization readXml:compressed
                                                              stream:decompressedStream
                                                 innerRandomStreamId:decryptionParameters.innerRandomStreamId
@@ -338,6 +406,7 @@ headerDataForIntegrityCheck:(NSData*)headerDataForIntegrityCheck
                                              sanityCheckInnerStream:sanityCheckInnerStream
                                                    innerStreamError:&innerStreamError
                                                               error:&error];
+    [metrics endStage:kSerializationStageDocument];
 
     [decompressedStream close];
     
@@ -408,46 +477,6 @@ headerDataForIntegrityCheck:(NSData*)headerDataForIntegrityCheck
     return ret;
 }
 
-static NSData * _Nonnull getEncryptionBlob(NSData *payload, NSData* startStream) {
-    NSMutableData *blockified = [[NSMutableData alloc] init];
-    
-    uint64_t bytesRemaining = payload.length;
-    int blockNumber = 0;
-    while (bytesRemaining) {
-        BlockHeader blockHeader;
-        [Utils integerTolittleEndian4Bytes:blockNumber bytes:blockHeader.id];
-        
-        uint64_t blockLength = MIN(kDefaultBlockifySize, bytesRemaining);
-        [Utils integerTolittleEndian4Bytes:(uint32_t)blockLength bytes:blockHeader.size];
-        
-        NSData* block = [payload subdataWithRange:NSMakeRange(blockNumber * kDefaultBlockifySize, (uint32_t)blockLength)];
-        
-        CC_SHA256(block.bytes, (CC_LONG)blockLength, blockHeader.hash);
-   
-        if(kLogVerbose) {
-            NSLog(@"Writing Block %d [%llu bytes]", blockNumber, blockLength);
-        }
-        
-        [blockified appendBytes:&blockHeader length:SIZE_OF_BLOCK_HEADER];
-        [blockified appendData:block];
-        
-        bytesRemaining -= blockLength;
-        blockNumber++;
-    }
-    
-    BlockHeader endBlockHeader = EndOfBlocksHeaderTemplate;
-    [Utils integerTolittleEndian4Bytes:blockNumber bytes:endBlockHeader.id];
-    
-    [blockified appendBytes:&endBlockHeader length:SIZE_OF_BLOCK_HEADER];
-    
-    
-    
-    NSMutableData* ret = [NSMutableData dataWithData:startStream];
-    [ret appendData:blockified];
-    
-    return ret;
-}
-
 static NSDictionary<NSNumber *,NSObject *>* getUnknownHeaders(NSDictionary<NSNumber *,NSObject *>* headers) {
     NSMutableDictionary *ret = [NSMutableDictionary dictionaryWithDictionary:headers];
     
@@ -110,6 +110,26 @@ KeepassFileHeader getKeePassFileHeader(NSData* data) {
     return ret;
 }
 
+static NSDictionary<NSString*, VariantObject*>* getKdfParameters(NSData* data) {
+    NSDictionary<NSString*, VariantObject*>* parameters = [VariantDictionary fromData:data];
+    if ( !parameters ) {
+        NSLog(@"WARN: KDFPARAMETERS entry is not a valid Variant Dictionary. Skipping.");
+        return nil;
+    }
+    
+    VariantObject* uuid = parameters[kKdfParametersKeyUuid];
+    if ( uuid.type != kVariantTypeByteArray || ((NSData*)uuid.theObject).length != sizeof(uuid_t) ) {
+        NSLog(@"WARN: KDFPARAMETERS $UUID entry missing or length != 16. Skipping.");
+        return nil;
+    }
+    
+    if(kLogVerbose) {
+        NSLog(@"KDF UUIDString: [%@]", [[NSUUID alloc] initWithUUIDBytes:((NSData*)uuid.theObject).bytes].UUIDString);
+    }
+    
+    return parameters;
+}
+
 NSObject* getHeaderEntryObject(uint8_t identifier, NSData* data) {
     size_t length = data.length;
     switch(identifier) {
@@ -172,8 +192,7 @@ NSObject* getHeaderEntryObject(uint8_t identifier, NSData* data) {
             }
             break;
         case KDFPARAMETERS:
-            
-            return [VariantDictionary fromData:data];
+            return getKdfParameters(data);
             break;
         default:
             NSLog(@"Found unknown header entry type: [%d] of length [%zu]", identifier, length);
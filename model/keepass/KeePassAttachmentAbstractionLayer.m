@@ -23,6 +23,7 @@
 #import "AesOutputStream.h"
 #import "Sha256PassThroughOutputStream.h"
 #import "AesInputStream.h"
+#import "Constants.h"
 
 static const int kBlockSize = 32 * 1024;
 static NSString* kEmptyDataDigest;
@@ -198,7 +199,7 @@ static const BOOL kMemoryPerfMeasuresEnabled = NO;
 
     NSOutputStream* ciphered;
     if ( kEncrypt ) {
-        ciphered = [[AesOutputStream alloc] initToOutputStream:outputStream encrypt:YES key:self.encryptionKey iv:self.encryptionIV chainOpensAndCloses:YES];
+        ciphered = [[AesOutputStream alloc] initToOutputStream:outputStream encrypt:YES key:self.encryptionKey iv:self.encryptionIV chainOpensAndCloses:YES chunkSize:kStreamingSerializationChunkSize];
     }
     else {
         ciphered = outputStream;
@@ -274,7 +275,7 @@ static const BOOL kMemoryPerfMeasuresEnabled = NO;
  
     NSInputStream* inStream = [self getInputStream];
     
-    NSInputStream* aesDecrypt = kEncrypt ? [[AesInputStream alloc] initWithStream:inStream key:self.encryptionKey iv:self.encryptionIV] : inStream;
+    NSInputStream* aesDecrypt = kEncrypt ? [[AesInputStream alloc] initWithStream:inStream key:self.encryptionKey iv:self.encryptionIV chunkSize:kStreamingSerializationChunkSize] : inStream;
     
     return aesDecrypt;
 }
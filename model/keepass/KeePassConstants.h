@@ -122,6 +122,8 @@ static NSString* const kStrongboxGenerator = @"Strongbox";
 static const uint32_t kNoCompressionFlag = 0;
 static const uint32_t kGzipCompressionFlag = 1;
 
+static NSString* const kCompressionProfileCustomDataKey = @"Strongbox_CompressionProfile";
+
 static const uint32_t kMasterSeedLength = 32;
 static const uint32_t kDefaultTransformSeedLength = 32;
 
@@ -6,11 +6,10 @@
 #import "RootXmlDomainObject.h"
 #import "KeePassXmlModelAdaptor.h"
 #import "KeePassConstants.h"
-#import "XmlSerializer.h"
+#import "InnerRandomStreamFactory.h"
 #import "KdbxSerializationCommon.h"
 #import "KeePass2TagPackage.h"
 #import "NSArray+Extensions.h"
-#import "StreamUtils.h"
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -34,14 +33,15 @@
 }
 
 + (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf completion:(OpenCompletionBlock)completion {
-    [self read:stream ckf:ckf xmlDumpStream:nil sanityCheckInnerStream:YES completion:completion];
+    [self read:stream ckf:ckf xmlDumpStream:nil sanityCheckInnerStream:YES metrics:nil completion:completion];
 }
 
-+ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf xmlDumpStream:(NSOutputStream*)xmlDumpStream sanityCheckInnerStream:(BOOL)sanityCheckInnerStream completion:(OpenCompletionBlock)completion {
++ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf xmlDumpStream:(NSOutputStream*)xmlDumpStream sanityCheckInnerStream:(BOOL)sanityCheckInnerStream metrics:(SerializationMetrics*)metrics completion:(OpenCompletionBlock)completion {
     [KdbxSerialization deserialize:stream
                compositeKeyFactors:ckf
                      xmlDumpStream:xmlDumpStream
             sanityCheckInnerStream:sanityCheckInnerStream
+                           metrics:metrics
                         completion:^(BOOL userCancelled, SerializationData * _Nullable serializationData, NSError * _Nullable innerStreamError, NSError * _Nullable error) {
         if(userCancelled || serializationData == nil || error) {
             if(error) {
@@ -52,11 +52,11 @@
             return;
         }
         
-        onDeserialized(serializationData, innerStreamError, ckf, completion);
+        onDeserialized(serializationData, innerStreamError, ckf, metrics, completion);
     }];
 }
 
-static void onDeserialized(SerializationData *serializationData, NSError * _Nullable innerStreamError, CompositeKeyFactors *ckf, OpenCompletionBlock completion) {
+static void onDeserialized(SerializationData *serializationData, NSError * _Nullable innerStreamError, CompositeKeyFactors *ckf, SerializationMetrics* metrics, OpenCompletionBlock completion) {
     RootXmlDomainObject* xmlRoot = serializationData.rootXmlObject;
     Meta* meta = xmlRoot.keePassFile ? xmlRoot.keePassFile.meta : nil;
     
@@ -77,6 +77,8 @@ static void onDeserialized(SerializationData *serializationData, NSError * _Null
  
     
 
+    [metrics beginStage:kSerializationStageModel];
+
     NSArray<KeePassAttachmentAbstractionLayer*>* attachments = [KeePassXmlModelAdaptor getV3Attachments:xmlRoot];
     NSDictionary<NSUUID*, NodeIcon*>* customIconPool = [KeePassXmlModelAdaptor getCustomIcons:meta];
 
@@ -86,6 +88,7 @@ static void onDeserialized(SerializationData *serializationData, NSError * _Null
     Node* rootGroup = [KeePassXmlModelAdaptor toStrongboxModel:xmlRoot attachments:attachments customIconPool:customIconPool error:&error];
     if(rootGroup == nil) {
         NSLog(@"Error converting Xml model to Strongbox model: [%@]", error);
+        [metrics endStage:kSerializationStageModel];
         completion(NO, nil, innerStreamError, error);
         return;
     }
@@ -109,7 +112,12 @@ static void onDeserialized(SerializationData *serializationData, NSError * _Null
     KeePass2TagPackage* adaptorTag = [[KeePass2TagPackage alloc] init];
     adaptorTag.unknownHeaders = serializationData.extraUnknownHeaders; 
     
+    [metrics endStage:kSerializationStageModel];
+    [metrics beginStage:kSerializationStageFastMaps];
+
     DatabaseModel *ret = [[DatabaseModel alloc] initWithFormat:kKeePass compositeKeyFactors:ckf metadata:metadata root:rootGroup deletedObjects:deletedObjects iconPool:customIconPool];
+
+    [metrics endStage:kSerializationStageFastMaps];
     
     ret.meta.adaptorTag = adaptorTag;
     
@@ -117,6 +125,10 @@ static void onDeserialized(SerializationData *serializationData, NSError * _Null
 }
 
 + (void)save:(DatabaseModel *)database outputStream:(NSOutputStream *)outputStream completion:(SaveCompletionBlock)completion {
+    [self save:database outputStream:outputStream metrics:nil completion:completion];
+}
+
++ (void)save:(DatabaseModel *)database outputStream:(NSOutputStream *)outputStream metrics:(SerializationMetrics *)metrics completion:(SaveCompletionBlock)completion {
     if(!database.ckfs.password &&
        !database.ckfs.keyFileDigest &&
        !database.ckfs.yubiKeyCR) {
@@ -138,12 +150,15 @@ static void onDeserialized(SerializationData *serializationData, NSError * _Null
     databaseProperties.metadata = database.meta;
     
     NSArray<KeePassAttachmentAbstractionLayer*>* minimalAttachmentPool = @[];
+
+    [metrics beginStage:kSerializationStageModel];
     RootXmlDomainObject *rootXmlDocument = [xmlAdaptor toKeePassModel:database.rootNode
                                                    databaseProperties:databaseProperties
                                                               context:[XmlProcessingContext standardV3Context]
                                                 minimalAttachmentPool:&minimalAttachmentPool
                                                              iconPool:database.iconPool
                                                                 error:&err];
+    [metrics endStage:kSerializationStageModel];
         
     if(!rootXmlDocument) {
         NSLog(@"Could not convert Database to Xml Model.");
@@ -171,22 +186,20 @@ static void onDeserialized(SerializationData *serializationData, NSError * _Null
     
     
     
-    XmlSerializer *xmlSerializer = [[XmlSerializer alloc] initWithProtectedStreamId:database.meta.innerRandomStreamId
-                                                                                key:nil 
-                                                                           v4Format:NO
-                                                                        prettyPrint:NO];
+    id<InnerRandomStream> innerStream = [InnerRandomStreamFactory getStream:database.meta.innerRandomStreamId key:nil];
     
     SerializationData *serializationData = [[SerializationData alloc] init];
     
-    serializationData.protectedStreamKey = xmlSerializer.protectedStreamKey;
+    serializationData.protectedStreamKey = innerStream.key;
     serializationData.extraUnknownHeaders = adaptorTag ? adaptorTag.unknownHeaders : @{};
     serializationData.compressionFlags = database.meta.compressionFlags;
+    serializationData.compressionProfile = database.meta.compressionProfile;
     serializationData.innerRandomStreamId = database.meta.innerRandomStreamId;
     serializationData.transformRounds = database.meta.kdfIterations;
     serializationData.fileVersion = database.meta.version;
     serializationData.cipherId = database.meta.cipherUuid;
     
-    KdbxSerialization *kdbxSerializer = [[KdbxSerialization alloc] init:serializationData];
+    KdbxSerialization *kdbxSerializer = [[KdbxSerialization alloc] init:serializationData metrics:metrics];
     
     
     
@@ -203,7 +216,7 @@ static void onDeserialized(SerializationData *serializationData, NSError * _Null
             rootXmlDocument.keePassFile.meta.headerHash = hash;
             [self continueSaveWithHeaderHash:rootXmlDocument
                                     metadata:database.meta
-                               xmlSerializer:xmlSerializer
+                                 innerStream:innerStream
                               kdbxSerializer:kdbxSerializer
                                 outputStream:outputStream
                                   completion:completion];
@@ -213,7 +226,7 @@ static void onDeserialized(SerializationData *serializationData, NSError * _Null
 
 + (void)continueSaveWithHeaderHash:(RootXmlDomainObject*)xmlDoc
                           metadata:(UnifiedDatabaseMetadata*)metadata
-                     xmlSerializer:(XmlSerializer*)xmlSerializer
+                       innerStream:(id<InnerRandomStream>)innerStream
                     kdbxSerializer:(KdbxSerialization*)kdbxSerializer
                       outputStream:(NSOutputStream *)outputStream
                         completion:(SaveCompletionBlock)completion {
@@ -224,39 +237,16 @@ static void onDeserialized(SerializationData *serializationData, NSError * _Null
     xmlDoc.keePassFile.meta.historyMaxSize = metadata.historyMaxSize;
     
     
-   
-    [xmlSerializer beginDocument];
-    BOOL writeXmlOk = [xmlDoc writeXml:xmlSerializer];
-    [xmlSerializer endDocument];
-    NSString *xml = xmlSerializer.xml;
-    if(!xml || !writeXmlOk) {
-        NSLog(@"Could not serialize Xml to Document.");
-        NSError *error = [Utils createNSError:@"Could not serialize Xml to Document." errorCode:-5];
-        completion(NO, nil, error);
-        return;
-    }
-    
-    
     
     NSError* err3;
-    NSData *data = [kdbxSerializer stage2Serialize:xml error:&err3]; 
-    if(!data) {
+    BOOL success = [kdbxSerializer stage2Serialize:xmlDoc innerStream:innerStream outputStream:outputStream error:&err3];
+    if(!success) {
         NSLog(@"Could not serialize Document to KDBX.");
         completion(NO, nil, err3);
         return;
     }
     
-    NSInputStream* inputStream = [NSInputStream inputStreamWithData:data];
-    [inputStream open];
-    BOOL success = [StreamUtils pipeFromStream:inputStream to:outputStream openAndCloseStreams:NO];
-    [inputStream close];
-    
-    if ( !success ) {
-        completion(NO, xml, [Utils createNSError:@"Could not pipe data to stream!" errorCode:-1]);
-    }
-    else {
-        completion(NO, xml, nil);
-    }
+    completion(NO, nil, nil);
 }
 
 @end
@@ -27,6 +27,8 @@ NS_ASSUME_NONNULL_BEGIN
                                    format:(DatabaseFormat)format
                                     error:(NSError**)error;
 
++ (void)clearDigestCache;
+
 @end
 
 NS_ASSUME_NONNULL_END
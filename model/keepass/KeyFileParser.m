@@ -21,6 +21,7 @@
 
 #import "Sha256PassThroughOutputStream.h"
 #import "StreamUtils.h"
+#import "Constants.h"
 #import <CommonCrypto/CommonCrypto.h>
 
 #if TARGET_OS_IPHONE
@@ -39,49 +40,66 @@ static const NSUInteger kStreamReadThreshold = 16 * 1024;
 @implementation KeyFileParser
 
 + (NSData *)getDigest:(NSInputStream*)inStream
-         streamLength:(unsigned long long)streamLength
           checkForXml:(BOOL)checkForXml {
     if ( inStream == nil ) {
         return nil;
     }
     
-    if ( streamLength > kStreamReadThreshold ) {
-        NSLog(@"INFO: Large Key File, will stream the digest and skip XML, Hex etc checks. Pure SHA256");
-             
-        [inStream open];
-        
-        CC_SHA256_CTX *sha256context = malloc(sizeof(CC_SHA256_CTX));
-        CC_SHA256_Init(sha256context);
-        
-        const NSUInteger kChunkSize = 4 * 1024;
-        uint8_t buffer[kChunkSize];
-
-        NSInteger len;
-        while ( ( len = [inStream read:buffer maxLength:kChunkSize] ) > 0 ) {
-            CC_SHA256_Update(sha256context, buffer, (CC_LONG)len);
-        }
-        
-        if ( len != 0 ) {
-            NSLog(@"WARNWARN: Could not read key file stream: [%ld] - [%@]", (long)len, inStream.streamError);
-            [inStream close];
-            free(sha256context);
-            return nil;
-        }
+    [inStream open];
+    
+    const NSUInteger kSniffLength = kStreamReadThreshold + 1;
+    uint8_t *sniffed = malloc(kSniffLength);
+    NSUInteger sniffedLength = 0;
+    
+    NSInteger len = 0;
+    while ( sniffedLength < kSniffLength && ( len = [inStream read:sniffed + sniffedLength maxLength:kSniffLength - sniffedLength] ) > 0 ) {
+        sniffedLength += len;
+    }
+    
+    if ( len < 0 ) {
+        NSLog(@"WARNWARN: Could not read key file stream: [%ld] - [%@]", (long)len, inStream.streamError);
+        [inStream close];
+        free(sniffed);
+        return nil;
+    }
+    
+    if ( sniffedLength <= kStreamReadThreshold ) {
         [inStream close];
-
-        NSMutableData* foo = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
-        CC_SHA256_Final(foo.mutableBytes, sha256context);
         
-        free(sha256context);
+        NSData* data = [NSData dataWithBytesNoCopy:sniffed length:sniffedLength freeWhenDone:YES];
         
-        return foo.copy;
+        return [KeyFileParser getSmallKeyFileDigest:data checkForXml:checkForXml];
+    }
+    
+    NSLog(@"INFO: Large Key File, will stream the digest and skip XML, Hex etc checks. Pure SHA256");
+    
+    CC_SHA256_CTX sha256context;
+    CC_SHA256_Init(&sha256context);
+    CC_SHA256_Update(&sha256context, sniffed, (CC_LONG)sniffedLength);
+    
+    free(sniffed);
+    
+    uint8_t *buffer = malloc(kStreamingSerializationChunkSize);
+    
+    while ( ( len = [inStream read:buffer maxLength:kStreamingSerializationChunkSize] ) > 0 ) {
+        CC_SHA256_Update(&sha256context, buffer, (CC_LONG)len);
     }
     
-    NSData* data = [NSData dataWithContentsOfStream:inStream];
-    if(!data) {
+    free(buffer);
+    [inStream close];
+    
+    if ( len != 0 ) {
+        NSLog(@"WARNWARN: Could not read key file stream: [%ld] - [%@]", (long)len, inStream.streamError);
         return nil;
     }
+    
+    NSMutableData* foo = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final(foo.mutableBytes, &sha256context);
+    
+    return foo.copy;
+}
 
++ (NSData *)getSmallKeyFileDigest:(NSData*)data checkForXml:(BOOL)checkForXml {
     
     
     
@@ -296,7 +314,33 @@ BOOL isAll64CharactersAreHex(NSData* data) {
                                          error:error];
 }
 
+static NSCache<NSString*, NSData*>* digestCache(void) {
+    static NSCache* cache;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        cache = [[NSCache alloc] init];
+        cache.countLimit = 8;
+    });
+    
+    return cache;
+}
+
+static NSString* digestCacheKey(NSURL* keyFileUrl, NSDictionary* attributes, BOOL checkForXml) {
+    NSNumber* fileNumber = attributes[NSFileSystemFileNumber];
+    NSNumber* fileSystemNumber = attributes[NSFileSystemNumber];
+    NSDate* modified = attributes.fileModificationDate;
+    
+    if ( fileNumber == nil || modified == nil ) {
+        return nil;
+    }
+    
+    return [NSString stringWithFormat:@"%@|%@|%@|%f|%llu|%d", keyFileUrl.path, fileSystemNumber, fileNumber, modified.timeIntervalSinceReferenceDate, attributes.fileSize, checkForXml];
+}
+
 static NSData * _Nullable getByUrl(NSError *__autoreleasing *error, DatabaseFormat format, NSURL *keyFileUrl) {
+    BOOL securitySucceeded = [keyFileUrl startAccessingSecurityScopedResource];
+    
     NSError* attrError;
     NSDictionary* attributes = [NSFileManager.defaultManager attributesOfItemAtPath:keyFileUrl.path error:&attrError];
     
@@ -307,15 +351,27 @@ static NSData * _Nullable getByUrl(NSError *__autoreleasing *error, DatabaseForm
         
         NSLog(@"WARNWARN: Could not read Key File URL File Size.");
         
+        if ( securitySucceeded ) {
+            [keyFileUrl stopAccessingSecurityScopedResource];
+        }
+        
         return nil;
     }
     
-    unsigned long long fileSize = attributes.fileSize;
+    BOOL checkForXml = format != kKeePass1;
+    NSString* cacheKey = attributes.fileSize > kStreamReadThreshold ? digestCacheKey(keyFileUrl, attributes, checkForXml) : nil;
     
-    BOOL securitySucceeded = [keyFileUrl startAccessingSecurityScopedResource];
-    NSInputStream* inStream = [NSInputStream inputStreamWithURL:keyFileUrl];
+    NSData* ret = cacheKey ? [digestCache() objectForKey:cacheKey] : nil;
     
-    NSData* ret = [KeyFileParser getDigest:inStream streamLength:fileSize checkForXml:format != kKeePass1];
+    if ( ret == nil ) {
+        NSInputStream* inStream = [NSInputStream inputStreamWithURL:keyFileUrl];
+        
+        ret = [KeyFileParser getDigest:inStream checkForXml:checkForXml];
+        
+        if ( ret && cacheKey ) {
+            [digestCache() setObject:ret forKey:cacheKey];
+        }
+    }
     
     if ( securitySucceeded ) {
         [keyFileUrl stopAccessingSecurityScopedResource];
@@ -324,6 +380,10 @@ static NSData * _Nullable getByUrl(NSError *__autoreleasing *error, DatabaseForm
     return ret;
 }
 
++ (void)clearDigestCache {
+    [digestCache() removeAllObjects];
+}
+
 + (NSData * _Nullable)getByBookmark:(NSError **)error
                              format:(DatabaseFormat)format
                     keyFileBookmark:(NSString *)keyFileBookmark {
@@ -379,9 +439,7 @@ static NSData * _Nullable getByUrl(NSError *__autoreleasing *error, DatabaseForm
     if ( onceOffKeyFileData ) {
         NSInputStream* inStream = [NSInputStream inputStreamWithData:onceOffKeyFileData];
         
-        return [KeyFileParser getDigest:inStream
-                           streamLength:onceOffKeyFileData.length
-                            checkForXml:format != kKeePass1];
+        return [KeyFileParser getDigest:inStream checkForXml:format != kKeePass1];
     }
 
     return nil;
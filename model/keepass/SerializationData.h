@@ -10,12 +10,14 @@
 #import "DecryptionParameters.h"
 #import "KeePassAttachmentAbstractionLayer.h"
 #import "RootXmlDomainObject.h"
+#import "CompressionProfile.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface SerializationData : NSObject
 
 @property (nonatomic) uint32_t compressionFlags;
+@property (nonatomic) CompressionProfile compressionProfile;
 @property (nonatomic) uint32_t innerRandomStreamId;
 @property (nonatomic) uint64_t transformRounds;
 @property (nonatomic) NSData *protectedStreamKey;
@@ -11,6 +11,35 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+typedef struct _VariantDictionaryEntry {
+    uint8_t type;
+    const uint8_t* key;
+    uint32_t keyLength;
+    const uint8_t* value;
+    uint32_t valueLength;
+} VariantDictionaryEntry;
+
+// A validated, non owning view over serialized Variant Dictionary bytes. The bytes must outlive the view.
+typedef struct _VariantDictionaryView {
+    const uint8_t* bytes;
+    size_t length;
+} VariantDictionaryView;
+
+BOOL variantDictionaryViewInit(VariantDictionaryView* view, const uint8_t* bytes, size_t length);
+
+// Start with *offset = 0. Returns NO once the terminator is reached.
+BOOL variantDictionaryViewNextEntry(const VariantDictionaryView* view, size_t* offset, VariantDictionaryEntry* entry);
+
+// Later entries win over earlier ones with the same key, as in fromData.
+BOOL variantDictionaryViewFind(const VariantDictionaryView* view, const char* key, VariantDictionaryEntry* entry);
+
+BOOL variantDictionaryViewGetUInt32(const VariantDictionaryView* view, const char* key, uint32_t* value);
+BOOL variantDictionaryViewGetUInt64(const VariantDictionaryView* view, const char* key, uint64_t* value);
+BOOL variantDictionaryViewGetInt32(const VariantDictionaryView* view, const char* key, int32_t* value);
+BOOL variantDictionaryViewGetInt64(const VariantDictionaryView* view, const char* key, int64_t* value);
+BOOL variantDictionaryViewGetBool(const VariantDictionaryView* view, const char* key, BOOL* value);
+BOOL variantDictionaryViewGetBytes(const VariantDictionaryView* view, const char* key, const uint8_t*_Nullable*_Nonnull bytes, uint32_t* length);
+
 @interface VariantDictionary : NSObject
 
 + (nullable NSDictionary<NSString*, VariantObject*>*)fromData:(NSData*)data;
@@ -9,196 +9,321 @@
 #import "VariantDictionary.h"
 #import "Utils.h"
 
-typedef struct _EntryHeader {
-    uint8_t type;
-    uint8_t keyLength[4];
-    uint8_t keyData[];
-} EntryHeader;
+#define SIZE_OF_VERSION 2
 #define SIZE_OF_ENTRY_HEADER 5
+#define SIZE_OF_VALUE_LENGTH 4
 
-@implementation VariantDictionary
-
-
-
-
-
-
-
-
-
+static const uint8_t kVariantDictionaryVersionMajor = 0x01;
 
+static BOOL readEntry(const uint8_t* bytes, size_t length, size_t offset, VariantDictionaryEntry* entry, size_t* next);
+static BOOL valueLengthIsValid(uint8_t type, uint32_t valueLength);
+static size_t getValueLength(VariantObject* value);
+static void writeValue(VariantObject* value, uint8_t* dest, size_t length);
+static NSObject* getObject(uint8_t type, const uint8_t* data, size_t length);
+static NSString* getKey(const void* data, size_t length);
 
+BOOL variantDictionaryViewInit(VariantDictionaryView* view, const uint8_t* bytes, size_t length) {
+    if ( length < SIZE_OF_VERSION + 1 ) {
+        NSLog(@"Not enough data to read Entry header.");
+        return NO;
+    }
+    
+    if ( bytes[1] != kVariantDictionaryVersionMajor ) {
+        NSLog(@"Variant Dictionary major version != 1");
+        return NO;
+    }
+    
+    size_t offset = SIZE_OF_VERSION;
+    VariantDictionaryEntry entry;
+    
+    while ( bytes[offset] != 0 ) {
+        if ( !readEntry(bytes, length, offset, &entry, &offset) ) {
+            return NO;
+        }
+        
+        if ( !valueLengthIsValid(entry.type, entry.valueLength) ) {
+            NSLog(@"Variant Dictionary value of type %d has unexpected length %u.", entry.type, entry.valueLength);
+            return NO;
+        }
+        
+        if ( offset >= length ) {
+            NSLog(@"Not enough data to read next Entry header Key.");
+            return NO;
+        }
+    }
+    
+    view->bytes = bytes;
+    view->length = offset + 1;
+    
+    return YES;
+}
 
+BOOL variantDictionaryViewNextEntry(const VariantDictionaryView* view, size_t* offset, VariantDictionaryEntry* entry) {
+    if ( *offset < SIZE_OF_VERSION ) {
+        *offset = SIZE_OF_VERSION;
+    }
+    
+    if ( *offset >= view->length || view->bytes[*offset] == 0 ) {
+        return NO;
+    }
+    
+    return readEntry(view->bytes, view->length, *offset, entry, offset);
+}
 
+BOOL variantDictionaryViewFind(const VariantDictionaryView* view, const char* key, VariantDictionaryEntry* entry) {
+    size_t keyLength = strlen(key);
+    size_t offset = 0;
+    BOOL found = NO;
+    
+    VariantDictionaryEntry candidate;
+    while ( variantDictionaryViewNextEntry(view, &offset, &candidate) ) {
+        if ( candidate.keyLength == keyLength && memcmp(candidate.key, key, keyLength) == 0 ) {
+            *entry = candidate;
+            found = YES;
+        }
+    }
+    
+    return found;
+}
 
+static BOOL findTyped(const VariantDictionaryView* view, const char* key, uint8_t type, VariantDictionaryEntry* entry) {
+    return variantDictionaryViewFind(view, key, entry) && entry->type == type;
+}
 
+BOOL variantDictionaryViewGetUInt32(const VariantDictionaryView* view, const char* key, uint32_t* value) {
+    VariantDictionaryEntry entry;
+    if ( !findTyped(view, key, kVariantTypeUint32, &entry) ) {
+        return NO;
+    }
+    
+    *value = littleEndian4BytesToUInt32((uint8_t*)entry.value);
+    return YES;
+}
 
+BOOL variantDictionaryViewGetUInt64(const VariantDictionaryView* view, const char* key, uint64_t* value) {
+    VariantDictionaryEntry entry;
+    if ( !findTyped(view, key, kVariantTypeUint64, &entry) ) {
+        return NO;
+    }
+    
+    *value = littleEndian8BytesToUInt64((uint8_t*)entry.value);
+    return YES;
+}
 
+BOOL variantDictionaryViewGetInt32(const VariantDictionaryView* view, const char* key, int32_t* value) {
+    VariantDictionaryEntry entry;
+    if ( !findTyped(view, key, kVariantTypeInt32, &entry) ) {
+        return NO;
+    }
+    
+    *value = (int32_t)littleEndian4BytesToUInt32((uint8_t*)entry.value);
+    return YES;
+}
 
+BOOL variantDictionaryViewGetInt64(const VariantDictionaryView* view, const char* key, int64_t* value) {
+    VariantDictionaryEntry entry;
+    if ( !findTyped(view, key, kVariantTypeInt64, &entry) ) {
+        return NO;
+    }
+    
+    *value = (int64_t)littleEndian8BytesToUInt64((uint8_t*)entry.value);
+    return YES;
+}
 
+BOOL variantDictionaryViewGetBool(const VariantDictionaryView* view, const char* key, BOOL* value) {
+    VariantDictionaryEntry entry;
+    if ( !findTyped(view, key, kVariantTypeBool, &entry) ) {
+        return NO;
+    }
+    
+    *value = entry.value[0] == 1;
+    return YES;
+}
 
+BOOL variantDictionaryViewGetBytes(const VariantDictionaryView* view, const char* key, const uint8_t** bytes, uint32_t* length) {
+    VariantDictionaryEntry entry;
+    if ( !findTyped(view, key, kVariantTypeByteArray, &entry) ) {
+        return NO;
+    }
+    
+    *bytes = entry.value;
+    *length = entry.valueLength;
+    return YES;
+}
 
+@implementation VariantDictionary
 
 + (NSData *)toData:(NSDictionary<NSString *,VariantObject *> *)dictionary {
-    NSMutableData *ret = [NSMutableData data];
-    
-    uint8_t version[] = { 0x00, 0x01 };
-    [ret appendBytes:version length:2];
-    
-    NSArray* sortedKeys = [dictionary.allKeys sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(id  _Nonnull obj1, id  _Nonnull obj2) {
+    NSArray<NSString*>* sortedKeys = [dictionary.allKeys sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(id  _Nonnull obj1, id  _Nonnull obj2) {
         return [obj1 compare:obj2];
     }];
     
+    size_t total = SIZE_OF_VERSION + 1;
+    
     for (NSString* key in sortedKeys) {
-        VariantObject* value = dictionary[key];
-        
-        
-        
-        uint8_t type[] = { value.type };
-        [ret appendBytes:type length:1];
+        total += SIZE_OF_ENTRY_HEADER + [key lengthOfBytesUsingEncoding:NSUTF8StringEncoding] + SIZE_OF_VALUE_LENGTH + getValueLength(dictionary[key]);
+    }
     
-        
-        
-        NSData *keyLengthData = Uint32ToLittleEndianData((uint32_t)key.length);
-        [ret appendData:keyLengthData];
+    NSMutableData *ret = [NSMutableData dataWithLength:total];
+    uint8_t *dest = ret.mutableBytes;
     
+    dest[0] = 0x00;
+    dest[1] = kVariantDictionaryVersionMajor;
+    dest += SIZE_OF_VERSION;
+    
+    for (NSString* key in sortedKeys) {
+        VariantObject* value = dictionary[key];
         
+        NSUInteger keyLength = [key lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        [key getBytes:dest + SIZE_OF_ENTRY_HEADER
+            maxLength:keyLength
+           usedLength:nil
+             encoding:NSUTF8StringEncoding
+              options:kNilOptions
+                range:NSMakeRange(0, key.length)
+       remainingRange:nil];
         
-        NSData* keyNameData = [key dataUsingEncoding:NSUTF8StringEncoding];
-        [ret appendData:keyNameData];
-        
-        
-        
-        uint32_t valueLength = getValueLength(value);
-        NSData* valueLengthData = Uint32ToLittleEndianData(valueLength);
-        [ret appendData:valueLengthData];
-        
-        
+        dest[0] = value.type;
+        OSWriteLittleInt32(dest + 1, 0, (uint32_t)keyLength);
+        dest += SIZE_OF_ENTRY_HEADER + keyLength;
         
-        NSData* valueData = getValueAsData(value);
-        [ret appendData:valueData];
+        size_t valueLength = getValueLength(value);
+        OSWriteLittleInt32(dest, 0, (uint32_t)valueLength);
+        writeValue(value, dest + SIZE_OF_VALUE_LENGTH, valueLength);
+        dest += SIZE_OF_VALUE_LENGTH + valueLength;
     }
     
-    uint8_t terminator[] = {0x00};
-    [ret appendBytes:terminator length:1];
     return ret;
 }
 
 + (NSDictionary<NSString*, VariantObject*>*)fromData:(NSData*)data {
-    NSMutableDictionary<NSString*, VariantObject*> *ret = [NSMutableDictionary dictionary];
-    
-    uint8_t *buffer = (uint8_t*)data.bytes;
-    uint8_t *eof = (uint8_t*)data.bytes + data.length;
-    
-    if(buffer + 1 > eof) {
-        NSLog(@"Not enough data to read Entry header.");
+    VariantDictionaryView view;
+    if ( !variantDictionaryViewInit(&view, data.bytes, data.length) ) {
         return nil;
     }
     
+    NSMutableDictionary<NSString*, VariantObject*> *ret = [NSMutableDictionary dictionary];
     
-    uint8_t versionMajor = buffer[1];
-    
-    if(versionMajor != 1) {
-        NSLog(@"Variant Dictionary major version != 1");
-        return nil;
-    }
-    
-    EntryHeader* header = (EntryHeader*)&buffer[2];
-
-    while(header->type != 0) {
-        size_t keyLength = littleEndian4BytesToUInt32(header->keyLength);
-
-        if(header->keyData + keyLength > eof) {
-            NSLog(@"Not enough data to read Entry header Key.");
-            return nil;
-        }
-        
-        NSString* key = getKey(header->keyData, keyLength);
-        
-        
+    size_t offset = 0;
+    VariantDictionaryEntry entry;
+    while ( variantDictionaryViewNextEntry(&view, &offset, &entry) ) {
+        NSString* key = getKey(entry.key, entry.keyLength);
         
         if(!key) {
             NSLog(@"Could not get key from Variant Dictionary.");
             return nil;
         }
         
-        uint8_t *value = ((uint8_t*)header) + (SIZE_OF_ENTRY_HEADER + keyLength);
-        size_t valueLength = littleEndian4BytesToUInt32(value);
+        NSObject* theObj = getObject(entry.type, entry.value, entry.valueLength);
         
-        if(value + valueLength > eof) {
-            NSLog(@"Not enough data to read Entry header value.");
+        if(!theObj) {
+            NSLog(@"Could not get value from Variant Dictionary.");
             return nil;
         }
         
-        NSObject* theObj = getObject(header->type, value + 4, valueLength);
-        VariantObject *obj = [[VariantObject alloc] initWithType:header->type theObject:theObj];
-        
-        if(obj) {
-            [ret setObject:obj forKey:key];
-        }
-        
-        uint8_t *next = value + (valueLength + 4);
-        
-        if(next + 1 > eof) {
-            NSLog(@"Not enough data to read next Entry header Key.");
-            return nil;
-        }
-        
-        header = (EntryHeader*)next;
+        ret[key] = [[VariantObject alloc] initWithType:entry.type theObject:theObj];
     }
     
     return ret;
 }
 
-static NSData* getValueAsData(VariantObject* value) {
+static BOOL readEntry(const uint8_t* bytes, size_t length, size_t offset, VariantDictionaryEntry* entry, size_t* next) {
+    if ( length - offset < SIZE_OF_ENTRY_HEADER ) {
+        NSLog(@"Not enough data to read Entry header.");
+        return NO;
+    }
+    
+    const uint8_t* header = bytes + offset;
+    uint32_t keyLength = littleEndian4BytesToUInt32((uint8_t*)header + 1);
+    offset += SIZE_OF_ENTRY_HEADER;
+    
+    if ( length - offset < (size_t)keyLength + SIZE_OF_VALUE_LENGTH ) {
+        NSLog(@"Not enough data to read Entry header Key.");
+        return NO;
+    }
+    
+    const uint8_t* key = bytes + offset;
+    offset += keyLength;
+    
+    uint32_t valueLength = littleEndian4BytesToUInt32((uint8_t*)bytes + offset);
+    offset += SIZE_OF_VALUE_LENGTH;
+    
+    if ( length - offset < valueLength ) {
+        NSLog(@"Not enough data to read Entry header value.");
+        return NO;
+    }
+    
+    entry->type = header[0];
+    entry->key = key;
+    entry->keyLength = keyLength;
+    entry->value = bytes + offset;
+    entry->valueLength = valueLength;
+    
+    *next = offset + valueLength;
+    
+    return YES;
+}
+
+static BOOL valueLengthIsValid(uint8_t type, uint32_t valueLength) {
+    switch (type) {
+        case kVariantTypeInt32:
+        case kVariantTypeUint32:
+            return valueLength == 4;
+        case kVariantTypeInt64:
+        case kVariantTypeUint64:
+            return valueLength == 8;
+        case kVariantTypeBool:
+            return valueLength == 1;
+        default:
+            return YES;
+    }
+}
+
+static void writeValue(VariantObject* value, uint8_t* dest, size_t length) {
     switch (value.type) {
         case kVariantTypeUint32: 
-            return Uint32ToLittleEndianData(((NSNumber*)value.theObject).unsignedIntValue);
+            OSWriteLittleInt32(dest, 0, ((NSNumber*)value.theObject).unsignedIntValue);
             break;
         case kVariantTypeUint64: 
-            return Uint64ToLittleEndianData(((NSNumber*)value.theObject).unsignedLongLongValue);
+            OSWriteLittleInt64(dest, 0, ((NSNumber*)value.theObject).unsignedLongLongValue);
             break;
         case kVariantTypeInt32: 
-            return Int32ToLittleEndianData(((NSNumber*)value.theObject).intValue);
+            OSWriteLittleInt32(dest, 0, (uint32_t)((NSNumber*)value.theObject).intValue);
             break;
         case kVariantTypeInt64: 
-            return Int64ToLittleEndianData(((NSNumber*)value.theObject).longLongValue);
+            OSWriteLittleInt64(dest, 0, (uint64_t)((NSNumber*)value.theObject).longLongValue);
             break;
         case kVariantTypeBool: 
-            {
-                uint8_t boolBytes[] = { ((NSNumber*)value.theObject).boolValue };
-                return [NSData dataWithBytes:boolBytes length:1]; 
-            }
+            dest[0] = ((NSNumber*)value.theObject).boolValue;
             break;
         case kVariantTypeString: 
-            return [((NSString*)value.theObject) dataUsingEncoding:NSUTF8StringEncoding];
+            [((NSString*)value.theObject) getBytes:dest maxLength:length usedLength:nil encoding:NSUTF8StringEncoding options:kNilOptions range:NSMakeRange(0, ((NSString*)value.theObject).length) remainingRange:nil];
             break;
         case kVariantTypeByteArray: 
-            return ((NSData*)value.theObject);
+            [((NSData*)value.theObject) getBytes:dest length:length];
             break;
         default:
-            NSLog(@"WARN: Unknown Variant Dictionary Value Type = %d. returning as Data", value.type);
-            return [NSData data];
+            NSLog(@"WARN: Unknown Variant Dictionary Value Type = %d. writing empty value", value.type);
             break;
     }
 }
 
-static NSObject* getObject(uint8_t type, void* data, size_t length) {
+static NSObject* getObject(uint8_t type, const uint8_t* data, size_t length) {
     switch (type) {
         case kVariantTypeUint32: 
-            return [NSNumber numberWithUnsignedInt:littleEndian4BytesToUInt32(data)];
+            return [NSNumber numberWithUnsignedInt:littleEndian4BytesToUInt32((uint8_t*)data)];
             break;
         case kVariantTypeUint64: 
-            return [NSNumber numberWithUnsignedLongLong:littleEndian8BytesToUInt64(data)];
+            return [NSNumber numberWithUnsignedLongLong:littleEndian8BytesToUInt64((uint8_t*)data)];
             break;
         case kVariantTypeInt32: 
-            return [NSNumber numberWithInt:(int32_t)littleEndian4BytesToUInt32(data)];
+            return [NSNumber numberWithInt:(int32_t)littleEndian4BytesToUInt32((uint8_t*)data)];
             break;
         case kVariantTypeInt64: 
-            return [NSNumber numberWithLongLong:(int64_t)littleEndian8BytesToUInt64(data)];
+            return [NSNumber numberWithLongLong:(int64_t)littleEndian8BytesToUInt64((uint8_t*)data)];
             break;
         case kVariantTypeBool: 
-            return @(*((uint8_t*)data) == 1);
+            return @(data[0] == 1);
             break;
         case kVariantTypeString: 
             return getKey(data, length);
@@ -213,7 +338,7 @@ static NSObject* getObject(uint8_t type, void* data, size_t length) {
     }
 }
 
-static uint32_t getValueLength(VariantObject* value) {
+static size_t getValueLength(VariantObject* value) {
     switch (value.type) {
         case kVariantTypeInt32:
         case kVariantTypeUint32: 
@@ -227,10 +352,10 @@ static uint32_t getValueLength(VariantObject* value) {
             return 1;
             break;
         case kVariantTypeString: 
-            return (uint32_t)((NSString*)value.theObject).length;
+            return [((NSString*)value.theObject) lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
             break;
         case kVariantTypeByteArray: 
-            return (uint32_t)((NSData*)value.theObject).length;
+            return ((NSData*)value.theObject).length;
             break;
         default:
             NSLog(@"WARN: Unknown Variant Dictionary Value Type = %d. returning 0", value.type);
@@ -239,7 +364,7 @@ static uint32_t getValueLength(VariantObject* value) {
     }
 }
 
-static NSString* getKey(void* data, size_t length) {
+static NSString* getKey(const void* data, size_t length) {
     return [[NSString alloc] initWithBytes:data length:length encoding:NSUTF8StringEncoding];
 }
 
@@ -133,12 +133,7 @@
         return YES;
     }
     
-    uuid_t rawUuid;
-    [uuid getUUIDBytes:(uint8_t*)&rawUuid];
-    NSData *dataUuid = [NSData dataWithBytes:&rawUuid length:sizeof(uuid_t)];
-    NSString* uuidString = [dataUuid base64EncodedStringWithOptions:kNilOptions];
-
-    return [self writeElement:elementName text:uuidString];
+    return [self writeElement:elementName text:[SimpleXmlValueExtractor getUuidString:uuid]];
 }
 
 - (BOOL)writeElement:(NSString*)elementName text:(NSString*)text {
@@ -7,6 +7,8 @@
 #import "Constants.h"
 #import "StrongboxErrorCodes.h"
 #import "StreamUtils.h"
+#import "MetricsInputStream.h"
+#import "MetricsOutputStream.h"
 
 const NSInteger kPwSafeDefaultVersionMajor = 0x03;
 const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
@@ -26,28 +28,50 @@ const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
 }
 
 + (void)open:(NSData *)data ckf:(CompositeKeyFactors *)ckf completion:(OpenCompletionBlock)completion {
-    NSError* error;
-    if (![PwSafeDatabase isValidDatabase:data error:&error]) {
-        NSLog(@"Not a valid safe!");
-        error = [Utils createNSError:@"This is not a valid Password Safe 3 File (Invalid Format)." errorCode:-1];
-        completion(NO, nil,  nil, error);
-        return;
-    }
+    [self open:data ckf:ckf metrics:nil completion:completion];
+}
+
++ (void)open:(NSData *)data ckf:(CompositeKeyFactors *)ckf metrics:(SerializationMetrics*)metrics completion:(OpenCompletionBlock)completion {
+    [self read:[NSInputStream inputStreamWithData:data] ckf:ckf metrics:metrics completion:completion];
+}
 
++ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf xmlDumpStream:(NSOutputStream *)xmlDumpStream sanityCheckInnerStream:(BOOL)sanityCheckInnerStream metrics:(SerializationMetrics *)metrics completion:(OpenCompletionBlock)completion {
+    [self read:stream ckf:ckf metrics:metrics completion:completion];
+}
+
++ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf completion:(OpenCompletionBlock)completion {
+    [self read:stream ckf:ckf metrics:nil completion:completion];
+}
+
++ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf metrics:(SerializationMetrics*)metrics completion:(OpenCompletionBlock)completion {
+    stream = [MetricsInputStream wrap:stream metrics:metrics stage:kSerializationStageIo];
+
+    PasswordSafe3Header header;
     NSMutableArray<Field*> *headerFields;
-    NSArray<Record*> *records = [PwSafeDatabase decryptSafe:data
-                                         password:ckf.password
-                                          headers:&headerFields
-                                            error:&error];
+    NSMutableArray<Record*> *records;
+    NSError* error;
+    
+    [stream open];
+    BOOL success = [PwSafeDatabase decryptSafe:stream
+                                      password:ckf.password
+                                        header:&header
+                                       headers:&headerFields
+                                       records:&records
+                                       metrics:metrics
+                                         error:&error];
+    [stream close];
 
-    if(!records) {
+    if(!success) {
         completion(NO, nil,  nil, error);
         return;
     }
     
     
     
+    [metrics beginStage:kSerializationStageModel];
     Node* rootGroup = [PwSafeDatabase buildModel:records headers:headerFields];
+    [metrics endStage:kSerializationStageModel];
+
     if(!rootGroup) {
         NSLog(@"Could not build model from records and headers?!");
         error = [Utils createNSError:@"Could not parse this Password Safe File." errorCode:-1];
@@ -57,46 +81,23 @@ const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
     
     UnifiedDatabaseMetadata* metadata = [UnifiedDatabaseMetadata withDefaultsForFormat:kPasswordSafe];
     metadata.version = [PwSafeDatabase getVersion:headerFields];
-    metadata.kdfIterations = [PwSafeSerialization getKeyStretchIterations:data];
+    metadata.kdfIterations = littleEndian4BytesToUInt32(header.iter);
 
     [PwSafeDatabase syncLastUpdateFieldsFromHeaders:metadata headers:headerFields];
     
+    [metrics beginStage:kSerializationStageFastMaps];
     DatabaseModel *ret = [[DatabaseModel alloc] initWithFormat:kPasswordSafe compositeKeyFactors:ckf metadata:metadata root:rootGroup];
+    [metrics endStage:kSerializationStageFastMaps];
     metadata.adaptorTag = headerFields;
 
     completion(NO, ret, nil, nil);
 }
 
-+ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf xmlDumpStream:(NSOutputStream *)xmlDumpStream sanityCheckInnerStream:(BOOL)sanityCheckInnerStream completion:(OpenCompletionBlock)completion {
-    [self read:stream ckf:ckf completion:completion];
-}
-
-+ (void)read:(NSInputStream *)stream ckf:(CompositeKeyFactors *)ckf completion:(OpenCompletionBlock)completion {
-    NSMutableData* mutableData = [NSMutableData dataWithCapacity:kStreamingSerializationChunkSize];
-    
-    [stream open];
-    uint8_t* buf = malloc(kStreamingSerializationChunkSize);
-    NSInteger bytesRead;
-    
-    do {
-        bytesRead = [stream read:buf maxLength:kStreamingSerializationChunkSize];
-        if (bytesRead > 0) {
-            [mutableData appendBytes:buf length:bytesRead];
-        }
-    } while (bytesRead > 0);
-    
-    free(buf);
-    [stream close];
-    
-    if (bytesRead < 0) {
-        completion(NO, nil, nil, stream.streamError);
-        return;
-    }
-    
-    [self open:mutableData ckf:ckf completion:completion];
++ (void)save:(DatabaseModel *)database outputStream:(NSOutputStream *)outputStream completion:(SaveCompletionBlock)completion {
+    [self save:database outputStream:outputStream metrics:nil completion:completion];
 }
 
-+ (void)save:(DatabaseModel *)database outputStream:(NSOutputStream *)outputStream completion:(SaveCompletionBlock)completion {
++ (void)save:(DatabaseModel *)database outputStream:(NSOutputStream *)outputStream metrics:(SerializationMetrics *)metrics completion:(SaveCompletionBlock)completion {
     if(!database.ckfs.password) {
         NSError* error = [Utils createNSError:@"Master Password not set." errorCode:-3];
         completion(NO, nil, error);
@@ -110,10 +111,13 @@ const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
     NSMutableData *ret = [[NSMutableData alloc] init];
     
     NSData *K, *L;
+
+    [metrics beginStage:kSerializationStageKdf];
     PasswordSafe3Header hdr = [PwSafeSerialization generateNewHeader:(int)database.meta.kdfIterations
                                                       masterPassword:database.ckfs.password
                                                                    K:&K
                                                                    L:&L];
+    [metrics endStage:kSerializationStageKdf];
     
     [ret appendBytes:&hdr length:SIZE_OF_PASSWORD_SAFE_3_HEADER];
     
@@ -124,23 +128,31 @@ const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
     
     NSMutableArray<Field*>* headerFields = database.meta.adaptorTag ? (NSMutableArray<Field*>*)database.meta.adaptorTag : [NSMutableArray array];
     
+    [metrics beginStage:kSerializationStageModel];
     [PwSafeDatabase addDefaultHeaderFieldsIfNotSet:headerFields];
     [PwSafeDatabase syncEmptyGroupsToHeaders:headerFields rootGroup:database.rootNode];
     [PwSafeDatabase syncLastUpdateFieldsToHeaders:database.meta headers:headerFields];
-    
-    [toBeEncrypted appendData:[PwSafeDatabase serializeHeaderFields:headerFields]];
-    [hmacData appendData:[PwSafeDatabase getHeaderFieldHmacData:headerFields]];
-    
-    
-    
     NSArray<Record*>* records = [PwSafeDatabase getRecordsForSerialization:database.rootNode];
+    [metrics endStage:kSerializationStageModel];
     
+    [metrics beginStage:kSerializationStageDocument];
+    [toBeEncrypted appendData:[PwSafeDatabase serializeHeaderFields:headerFields]];
     [toBeEncrypted appendData:[PwSafeDatabase serializeRecords:records]];
+    [metrics endStage:kSerializationStageDocument];
+    [metrics addBytes:toBeEncrypted.length stage:kSerializationStageDocument];
+    
+    [metrics beginStage:kSerializationStageIntegrity];
+    [hmacData appendData:[PwSafeDatabase getHeaderFieldHmacData:headerFields]];
     [hmacData appendData:[PwSafeDatabase getRecordsHmacData:records]];
+    [metrics endStage:kSerializationStageIntegrity];
     
     
     
+    [metrics beginStage:kSerializationStageCipher];
     NSData *ct = [PwSafeSerialization encryptCBC:K ptData:toBeEncrypted iv:hdr.iv];
+    [metrics endStage:kSerializationStageCipher];
+    [metrics addBytes:ct.length stage:kSerializationStageCipher];
+
     [ret appendData:ct];
     
     
@@ -150,12 +162,16 @@ const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
     
     
     
+    [metrics beginStage:kSerializationStageIntegrity];
     NSData *hmac = [PwSafeSerialization calculateRFC2104Hmac:hmacData key:L];
+    [metrics endStage:kSerializationStageIntegrity];
+    [metrics addBytes:hmacData.length stage:kSerializationStageIntegrity];
+
     [ret appendData:hmac];
     
     NSInputStream* inputStream = [NSInputStream inputStreamWithData:ret];
     [inputStream open];
-    BOOL success = [StreamUtils pipeFromStream:inputStream to:outputStream openAndCloseStreams:NO];
+    BOOL success = [StreamUtils pipeFromStream:inputStream to:[MetricsOutputStream wrap:outputStream metrics:metrics stage:kSerializationStageIo] openAndCloseStreams:NO];
     [inputStream close];
     
     if ( !success ) {
@@ -195,9 +211,10 @@ const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
     NSMutableArray<NSArray<NSString*>*> *allKeys = [[groupedByGroup allKeys] mutableCopy];
     
     NSMutableSet<NSUUID*>* usedIds = NSMutableSet.set;
+    NSMutableDictionary<NSArray<NSString*>*, Node*>* groupsByPath = NSMutableDictionary.dictionary;
 
     for (NSArray<NSString*>* groupComponents in allKeys) {
-        Node* group = [self addGroupUsingGroupComponents:root groupComponents:groupComponents];
+        Node* group = [self addGroupUsingGroupComponents:root groupComponents:groupComponents groupsByPath:groupsByPath];
         
         NSMutableArray<Record*>* recordsForThisGroup = [groupedByGroup objectForKey:groupComponents];
 
@@ -210,7 +227,7 @@ const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
     NSSet<Group*> *emptyGroups = [self getEmptyGroupsFromHeaders:headers];
     
     for (Group* emptyGroup in emptyGroups) {
-        [self addGroupUsingGroupComponents:root groupComponents:emptyGroup.pathComponents];
+        [self addGroupUsingGroupComponents:root groupComponents:emptyGroup.pathComponents groupsByPath:groupsByPath];
     }
     
     return root;
@@ -260,18 +277,30 @@ const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
     return groups;
 }
 
-+ (Node*)addGroupUsingGroupComponents:(Node*)root groupComponents:(NSArray<NSString*>*)groupComponents {
-    Node* node = root;
++ (Node*)addGroupUsingGroupComponents:(Node*)root
+                      groupComponents:(NSArray<NSString*>*)groupComponents
+                         groupsByPath:(NSMutableDictionary<NSArray<NSString*>*, Node*>*)groupsByPath {
+    Node* node = groupsByPath[groupComponents];
+    if (node) {
+        return node;
+    }
     
-    for(NSString* component in groupComponents) {
-        Node* foo = [node getChildGroupWithTitle:component];
+    node = root;
+    
+    for(NSUInteger i = 0; i < groupComponents.count; i++) {
+        NSArray<NSString*>* path = [groupComponents subarrayWithRange:NSMakeRange(0, i + 1)];
+        Node* foo = groupsByPath[path];
         
         if(!foo) {
+            NSString* component = groupComponents[i];
+            
             foo = [[Node alloc] initAsGroup:component parent:node keePassGroupTitleRules:NO uuid:nil];
             if(![node addChild:foo keePassGroupTitleRules:NO]) {
                 NSLog(@"Problem adding child group [%@] to node [%@]", component, node.title);
                 return nil;
             }
+            
+            groupsByPath[path] = foo;
         }
         
         node = foo;
@@ -280,57 +309,61 @@ const NSInteger kPwSafeDefaultVersionMinor = 0x0D;
     return node;
 }
 
-+ (NSArray<Record*> *)decryptSafe:(NSData*)safeData
-                         password:(NSString*)password
-                          headers:(NSMutableArray<Field*> **)headerFields
-                            error:(NSError **)ppError {
-    PasswordSafe3Header header = [PwSafeSerialization getHeader:safeData];
++ (BOOL)decryptSafe:(NSInputStream*)stream
+           password:(NSString*)password
+             header:(PasswordSafe3Header*)header
+            headers:(NSMutableArray<Field*> **)headerFields
+            records:(NSMutableArray<Record*> **)records
+            metrics:(SerializationMetrics*)metrics
+              error:(NSError **)ppError {
+    if (![PwSafeSerialization readHeader:stream header:header] ||
+        ![PwSafeDatabase isValidDatabase:[NSData dataWithBytesNoCopy:header length:SIZE_OF_PASSWORD_SAFE_3_HEADER freeWhenDone:NO] error:nil]) {
+        NSLog(@"Not a valid safe!");
+        
+        if (ppError != nil) {
+            *ppError = stream.streamError ? stream.streamError : [Utils createNSError:@"This is not a valid Password Safe 3 File (Invalid Format)." errorCode:-1];
+        }
+        
+        return NO;
+    }
     
     NSData *pBar;
-    if (![PwSafeSerialization checkPassword:&header password:password pBar:&pBar]) {
+
+    [metrics beginStage:kSerializationStageKdf];
+    BOOL passwordOk = [PwSafeSerialization checkPassword:header password:password pBar:&pBar];
+    [metrics endStage:kSerializationStageKdf];
+
+    if (!passwordOk) {
         NSLog(@"Invalid password!");
         
         if (ppError != nil) {
             *ppError = [Utils createNSError:@"The password is incorrect." errorCode:StrongboxErrorCodes.incorrectCredentials];
         }
         
-        return nil;
+        return NO;
     }
     
     NSData *K;
     NSData *L;
     
-    [PwSafeSerialization getKandL:pBar header:header K_p:&K L_p:&L];
-    
-    NSInteger numBlocks = [PwSafeSerialization getNumberOfBlocks:safeData];
-    
-    NSData *decData = [PwSafeSerialization decryptBlocks:K
-                                            ct:(unsigned char *)&safeData.bytes[SIZE_OF_PASSWORD_SAFE_3_HEADER]
-                                            iv:header.iv
-                                     numBlocks:numBlocks];
-    
-    NSMutableArray<Record*> *records = [NSMutableArray array];
-    NSData *dataForHmac = [PwSafeSerialization extractDbHeaderAndRecords:decData headerFields_p:headerFields records_p:&records];
+    [metrics beginStage:kSerializationStageKdf];
+    [PwSafeSerialization getKandL:pBar header:*header K_p:&K L_p:&L];
+    [metrics endStage:kSerializationStageKdf];
     
-    NSData *computedHmac = [PwSafeSerialization calculateRFC2104Hmac:dataForHmac key:L];
-    
-    unsigned char *actualHmac[CC_SHA256_DIGEST_LENGTH];
-    [safeData getBytes:actualHmac range:NSMakeRange(safeData.length - CC_SHA256_DIGEST_LENGTH, CC_SHA256_DIGEST_LENGTH)];
-    NSData *actHmac = [[NSData alloc] initWithBytes:actualHmac length:CC_SHA256_DIGEST_LENGTH];
-    
-    if (![actHmac isEqualToData:computedHmac]) {
-        NSLog(@"HMAC is no good! Corrupted Safe!");
-        
-        if (ppError != nil) {
-            *ppError = [Utils createNSError:@"The data is corrupted (HMAC incorrect)." errorCode:-3];
-        }
-        
-        return nil;
-    }
     
     
+    [metrics beginStage:kSerializationStageDocument];
+    BOOL success = [PwSafeSerialization readDbHeaderAndRecords:stream
+                                                             K:K
+                                                             L:L
+                                                            iv:header->iv
+                                                headerFields_p:headerFields
+                                                     records_p:records
+                                                       metrics:metrics
+                                                         error:ppError];
+    [metrics endStage:kSerializationStageDocument];
 
-    return records;
+    return success;
 }
 
 
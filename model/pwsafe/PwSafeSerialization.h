@@ -8,6 +8,7 @@
 
 #import <Foundation/Foundation.h>
 #import "Field.h"
+#import "SerializationMetrics.h"
 
 #define SIZE_OF_PASSWORD_SAFE_3_HEADER      152
 #define SIZE_OF_PASSWORD_SAFE_3_HEADER_IV   16
@@ -44,15 +45,22 @@ NS_ASSUME_NONNULL_BEGIN
 + (BOOL)isValidDatabase:(NSData *)prefix error:(NSError *__autoreleasing  _Nullable *)error;
 + (PasswordSafe3Header)getHeader:(NSData*)data;
 + (NSUInteger)getKeyStretchIterations:(NSData*)data;
-+ (NSInteger)getNumberOfBlocks:(NSData*)candidate;
++ (BOOL)readHeader:(NSInputStream*)stream header:(PasswordSafe3Header*)header;
 + (PasswordSafe3Header)generateNewHeader:(int)keyStretchIterations masterPassword:(NSString *)masterPassword K:(NSData *_Nonnull*_Nonnull)K L:(NSData *_Nonnull*_Nonnull)L;
 + (nullable NSData *)serializeField:(Field *)field;
 + (nullable NSData *)encryptCBC:(NSData *)K ptData:(NSData *)ptData iv:(unsigned char *)iv;
 + (NSData *)calculateRFC2104Hmac:(NSData *)m key:(NSData *)key;
++ (uint32_t)keyStretchIterationsForTargetTime:(NSTimeInterval)targetTime;
 + (BOOL)checkPassword:(PasswordSafe3Header *)pHeader password:(NSString *)password pBar:(NSData *_Nonnull*_Nonnull)ppBar;
 + (BOOL)getKandL:(NSData *)pBar header:(PasswordSafe3Header)header K_p:(NSData *_Nonnull*_Nonnull)K_p L_p:(NSData *_Nonnull*_Nonnull)L_p;
-+ (nullable NSMutableData *)decryptBlocks:(NSData *)K ct:(unsigned char *)ct iv:(unsigned char *)iv numBlocks:(NSUInteger)numBlocks;
-+ (nullable NSData *)extractDbHeaderAndRecords:(NSData *)decData headerFields_p:(NSMutableArray *_Nonnull*_Nonnull)headerFields_p records_p:(NSMutableArray *_Nonnull*_Nonnull)records_p;
++ (BOOL)readDbHeaderAndRecords:(NSInputStream *)stream
+                            K:(NSData *)K
+                            L:(NSData *)L
+                           iv:(unsigned char *)iv
+               headerFields_p:(NSMutableArray *_Nonnull*_Nonnull)headerFields_p
+                    records_p:(NSMutableArray *_Nonnull*_Nonnull)records_p
+                      metrics:(SerializationMetrics *_Nullable)metrics
+                        error:(NSError **)error;
 + (void)dumpDbHeaderAndRecords:(NSMutableArray *)headerFields records:(NSMutableArray *)records;
 
 @end
@@ -2,70 +2,119 @@
 #import <CommonCrypto/CommonDigest.h>
 #import <CommonCrypto/CommonHMAC.h>
 #import "twofish/tomcrypt.h"
+#import "sha256_iterate.h"
 #import "Record.h"
 #import "Field.h"
 #import "Utils.h"
 #import "NSData+Extensions.h"
+#import "Constants.h"
 
 #include <Security/Security.h>
 
 //#define DEBUG_MEMORY_ALLOCATION_LOGGING
 
-@implementation PwSafeSerialization
+static const NSUInteger kInitialFieldCapacity = 64 * TWOFISH_BLOCK_SIZE;
+static const unsigned char kEofMarker[TWOFISH_BLOCK_SIZE] = { 'P', 'W', 'S', '3', '-', 'E', 'O', 'F', 'P', 'W', 'S', '3', '-', 'E', 'O', 'F' };
+
+typedef NS_ENUM(int, PwSafeReadResult) {
+    kPwSafeReadField,
+    kPwSafeReadEof,
+    kPwSafeReadTruncated,
+    kPwSafeReadOutOfMemory,
+};
+
+typedef struct _PwSafeBlockReader {
+    __unsafe_unretained NSInputStream *stream;
+    uint8_t *buffer;
+    NSUInteger offset;
+    NSUInteger length;
+} PwSafeBlockReader;
+
+static BOOL readBytes(PwSafeBlockReader *reader, unsigned char *dest, NSUInteger count) {
+    while (count > 0) {
+        if (reader->offset == reader->length) {
+            NSInteger bytesRead = [reader->stream read:reader->buffer maxLength:kStreamingSerializationChunkSize];
+
+            if (bytesRead <= 0) {
+                return NO;
+            }
 
-+ (NSData *)calculateRFC2104Hmac:(NSData *)m key:(NSData *)key {
-    unsigned char K[CC_SHA256_BLOCK_BYTES];
+            reader->offset = 0;
+            reader->length = bytesRead;
+        }
 
-    memset(K, 0, CC_SHA256_BLOCK_BYTES);
-    [key getBytes:K length:key.length];
+        NSUInteger available = MIN(count, reader->length - reader->offset);
+        memcpy(dest, &reader->buffer[reader->offset], available);
 
-    
+        reader->offset += available;
+        dest += available;
+        count -= available;
+    }
 
-    unsigned char KwithIpad[CC_SHA256_BLOCK_BYTES];
+    return YES;
+}
 
-    for (int i = 0; i < CC_SHA256_BLOCK_BYTES; i++) {
-        KwithIpad[i] = K[i] ^ 0x36;
+static void readCbcBlock(symmetric_key *skey, const unsigned char *ct, unsigned char *pt, unsigned char *iv) {
+    twofish_ecb_decrypt(ct, pt, skey);
+
+    for (int i = 0; i < TWOFISH_BLOCK_SIZE; i++) {
+        pt[i] ^= iv[i];
     }
 
-    
+    memcpy(iv, ct, TWOFISH_BLOCK_SIZE);
+}
 
-    unsigned char KwithOpad[CC_SHA256_BLOCK_BYTES];
+static uint64_t blocksForField(uint64_t length) {
+    return (length + FIELD_HEADER_LENGTH + TWOFISH_BLOCK_SIZE - 1) / TWOFISH_BLOCK_SIZE;
+}
 
-    for (int i = 0; i < CC_SHA256_BLOCK_BYTES; i++) {
-        KwithOpad[i] = K[i] ^ 0x5c;
-    }
+// Decrypts the next field into *field (grown on demand as blocks actually arrive, so a corrupt length
+// cannot force a huge allocation up front). The EOF marker is only valid on a field boundary.
 
-    
+static PwSafeReadResult readField(PwSafeBlockReader *reader, symmetric_key *skey, unsigned char *iv, unsigned char **field, NSUInteger *capacity, NSUInteger *length) {
+    unsigned char ct[TWOFISH_BLOCK_SIZE];
 
-    CC_SHA256_CTX context;
+    if (!readBytes(reader, ct, TWOFISH_BLOCK_SIZE)) {
+        return kPwSafeReadTruncated;
+    }
 
-    NSMutableData *hKipadAndM = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH ];
+    if (memcmp(ct, kEofMarker, TWOFISH_BLOCK_SIZE) == 0) {
+        return kPwSafeReadEof;
+    }
 
-    CC_SHA256_Init(&context);
+    readCbcBlock(skey, ct, *field, iv);
 
-    NSMutableData *y = [[NSMutableData alloc] initWithBytes:KwithIpad length:CC_SHA256_BLOCK_BYTES];
-    [y appendData:m];
+    uint32_t fieldLength = littleEndian4BytesToUInt32(*field);
+    uint64_t numBlocks = blocksForField(fieldLength);
 
-    CC_SHA256_Update(&context, y.bytes, (CC_LONG)y.length);
-    
+    for (uint64_t i = 1; i < numBlocks; i++) {
+        if (!readBytes(reader, ct, TWOFISH_BLOCK_SIZE) || memcmp(ct, kEofMarker, TWOFISH_BLOCK_SIZE) == 0) {
+            return kPwSafeReadTruncated;
+        }
 
-    CC_SHA256_Final(hKipadAndM.mutableBytes, &context);
+        if ((i + 1) * TWOFISH_BLOCK_SIZE > *capacity) {
+            *capacity *= 2;
+            *field = reallocf(*field, *capacity);
 
-    
+            if (!*field) {
+                return kPwSafeReadOutOfMemory;
+            }
+        }
 
-    CC_SHA256_CTX context2;
+        readCbcBlock(skey, ct, &(*field)[i * TWOFISH_BLOCK_SIZE], iv);
+    }
 
-    NSMutableData *hmac = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH ];
+    *length = fieldLength;
 
-    CC_SHA256_Init(&context2);
+    return kPwSafeReadField;
+}
 
-    NSMutableData *z = [[NSMutableData alloc] initWithBytes:KwithOpad length:CC_SHA256_BLOCK_BYTES];
-    [z appendData:hKipadAndM];
+@implementation PwSafeSerialization
 
-    CC_SHA256_Update(&context2, z.bytes, (CC_LONG)z.length);
-    
++ (NSData *)calculateRFC2104Hmac:(NSData *)m key:(NSData *)key {
+    NSMutableData *hmac = [NSMutableData dataWithLength:CC_SHA256_DIGEST_LENGTH];
 
-    CC_SHA256_Final(hmac.mutableBytes, &context2);
+    CCHmac(kCCHmacAlgSHA256, key.bytes, key.length, m.bytes, m.length, hmac.mutableBytes);
 
     return hmac;
 }
@@ -183,9 +232,7 @@
     CC_SHA256_Update(&context, salt.bytes, (CC_LONG)salt.length);
     CC_SHA256_Final(digest, &context);
 
-    for (int i = 0; i < keyStretchIterations; i++) {
-        CC_SHA256(digest, CC_SHA256_DIGEST_LENGTH, digest);
-    }
+    sha256_iterate(digest, MAX(keyStretchIterations, 0));
     NSData* pBarData = [NSData dataWithBytes:digest length:CC_SHA256_DIGEST_LENGTH];
     
     
@@ -301,33 +348,26 @@
     return YES;
 }
 
-+ (NSInteger)getNumberOfBlocks:(NSData*)candidate {
-    NSUInteger endOfData = [PwSafeSerialization getEofFileOffset:candidate];
-    
-    if (endOfData == NSNotFound) {
-        NSLog(@"No End of File marker magic");
-        return NO;
-    }
-    
-    NSUInteger recordsLength = endOfData - SIZE_OF_PASSWORD_SAFE_3_HEADER;
-    if (recordsLength <= 0) {
-        NSLog(@"Negative or zero record length");
-        return NO;
-    }
-    
-    return recordsLength / TWOFISH_BLOCK_SIZE;
-}
-
 + (NSUInteger)getKeyStretchIterations:(NSData *)data {
     PasswordSafe3Header header = [PwSafeSerialization getHeader:data];
     return littleEndian4BytesToUInt32(header.iter);
 }
 
-+ (NSUInteger)getEofFileOffset:(NSData*)data {
-    NSData *endMarker = [EOF_MARKER dataUsingEncoding:NSUTF8StringEncoding];
-    NSRange endRange = [data rangeOfData:endMarker options:NSDataSearchBackwards range:NSMakeRange(0, data.length)];
-    
-    return endRange.location;
++ (BOOL)readHeader:(NSInputStream *)stream header:(PasswordSafe3Header *)header {
+    uint8_t *dest = (uint8_t *)header;
+    NSUInteger total = 0;
+
+    while (total < SIZE_OF_PASSWORD_SAFE_3_HEADER) {
+        NSInteger bytesRead = [stream read:&dest[total] maxLength:SIZE_OF_PASSWORD_SAFE_3_HEADER - total];
+
+        if (bytesRead <= 0) {
+            return NO;
+        }
+
+        total += bytesRead;
+    }
+
+    return YES;
 }
 
 + (NSData*)keystretch:(uint32_t)iter header:(unsigned char[32])saltBytes pBar_p:(NSData **)ppBar password:(NSString *)password {
@@ -341,9 +381,7 @@
     CC_SHA256_Update(&context, saltBytes, (CC_LONG)32);
     CC_SHA256_Final(digest, &context);
 
-    for (uint32_t i=0; i<iter; i++) {
-        CC_SHA256(digest, CC_SHA256_DIGEST_LENGTH, digest);
-    }
+    sha256_iterate(digest, iter);
     
     *ppBar = [NSData dataWithBytes:digest length:CC_SHA256_DIGEST_LENGTH];
     
@@ -352,6 +390,25 @@
     return (*ppBar).sha256;
 }
 
++ (uint32_t)keyStretchIterationsForTargetTime:(NSTimeInterval)targetTime {
+    const uint64_t sample = 1 << 14;
+    
+    uint8_t digest[CC_SHA256_DIGEST_LENGTH] = { 0 };
+    uint64_t iterations = 0;
+    NSTimeInterval elapsed = 0;
+    NSDate* start = NSDate.date;
+    
+    while (elapsed < 0.05) {
+        sha256_iterate(digest, sample);
+        iterations += sample;
+        elapsed = -start.timeIntervalSinceNow;
+    }
+    
+    double estimate = (iterations / elapsed) * targetTime;
+    
+    return (uint32_t)MIN(MAX(estimate, 1), UINT32_MAX);
+}
+
 + (BOOL)getKandL:(NSData *)pBar header:(PasswordSafe3Header)header K_p:(NSData **)K_p L_p:(NSData **)L_p {
     /* schedule the key */
 
@@ -385,18 +442,6 @@
     return YES;
 }
 
-+ (void)readCbcBlock:(symmetric_key *)skey_p ct:(unsigned char *)ct pt:(unsigned char *)pt iv:(unsigned char *)iv {
-    unsigned char ptBar[16];
-
-    twofish_ecb_decrypt(ct, ptBar, &(*skey_p));
-
-    for (int i = 0; i < TWOFISH_BLOCK_SIZE; i++) {
-        unsigned char b = ((unsigned char *)ptBar)[i];
-        unsigned char c = (unsigned char)iv[i];
-        pt[i] = b ^ c;
-    }
-}
-
 + (BOOL)checkPassword:(PasswordSafe3Header *)pHeader password:(NSString *)password pBar:(NSData **)ppBar {
     uint32_t iter = littleEndian4BytesToUInt32(pHeader->iter);
 
@@ -411,33 +456,6 @@
     return YES;
 }
 
-+ (NSData *)decryptBlocks:(NSData *)K ct:(unsigned char *)ct iv:(unsigned char *)iv numBlocks:(NSUInteger)numBlocks {
-    
-    symmetric_key skey;
-    unsigned char *key = (unsigned char *)K.bytes;
-
-    if ((twofish_setup(key, TWOFISH_KEYSIZE_BYTES, 0, &skey)) != CRYPT_OK) {
-        NSLog(@"Invalid K Key");
-        return nil;
-    }
-
-    NSMutableData *decData = [[NSMutableData alloc] init];
-
-    unsigned char ivForThisBlock[TWOFISH_BLOCK_SIZE];
-    memcpy(ivForThisBlock, iv, TWOFISH_BLOCK_SIZE);
-    unsigned char pt[TWOFISH_BLOCK_SIZE];
-
-    for (int i = 0; i < numBlocks; i++) {
-        [self readCbcBlock:&skey ct:ct pt:pt iv:ivForThisBlock];
-        [decData appendBytes:pt length:TWOFISH_BLOCK_SIZE];
-
-        memcpy(ivForThisBlock, ct, TWOFISH_BLOCK_SIZE);
-        ct += TWOFISH_BLOCK_SIZE;
-    }
-
-    return [NSData dataWithData:decData];
-}
-
 + (void)dumpDbHeaderAndRecords:(NSMutableArray *)headerFields records:(NSMutableArray *)records {
     
 
@@ -470,79 +488,121 @@
     }
 }
 
-+ (NSData *)extractDbHeaderAndRecords:(NSData *)decData
-                       headerFields_p:(NSMutableArray **)headerFields_p
-                            records_p:(NSMutableArray **)records_p {
-    NSMutableData *dataForHmac = [[NSMutableData alloc] init];
++ (BOOL)readDbHeaderAndRecords:(NSInputStream *)stream
+                            K:(NSData *)K
+                            L:(NSData *)L
+                           iv:(unsigned char *)iv
+               headerFields_p:(NSMutableArray **)headerFields_p
+                    records_p:(NSMutableArray **)records_p
+                      metrics:(SerializationMetrics *)metrics
+                        error:(NSError **)error {
+    symmetric_key skey;
 
-#ifdef DEBUG_MEMORY_ALLOCATION_LOGGING
-    NSLog(@"extractDbHeaderAndRecords => Allocating: %lu bytes", (unsigned long)decData.length);
-#endif
-    unsigned char *raw = malloc(decData.length);
-    if (!raw)
-    {
-        return nil;
+    if ((twofish_setup(K.bytes, TWOFISH_KEYSIZE_BYTES, 0, &skey)) != CRYPT_OK) {
+        NSLog(@"Invalid K Key");
+
+        if (error) {
+            *error = [Utils createNSError:@"Could not parse this Password Safe File." errorCode:-1];
+        }
+
+        return NO;
     }
-    
-    [decData getBytes:raw length:decData.length];
 
-    
+    CCHmacContext hmac;
+    CCHmacInit(&hmac, kCCHmacAlgSHA256, L.bytes, L.length);
+
+    PwSafeBlockReader reader = { .stream = stream, .buffer = malloc(kStreamingSerializationChunkSize), .offset = 0, .length = 0 };
+
+    NSUInteger capacity = kInitialFieldCapacity;
+    unsigned char *field = malloc(capacity);
 
-    unsigned char *currentField = raw;
-    unsigned char *end = raw + decData.length;
+    unsigned char ivForThisBlock[TWOFISH_BLOCK_SIZE];
+    memcpy(ivForThisBlock, iv, TWOFISH_BLOCK_SIZE);
 
     BOOL hdrDone = NO;
-    *records_p = [[NSMutableArray alloc] init];
-    *headerFields_p = [[NSMutableArray alloc] init];
+    PwSafeReadResult result;
+    NSUInteger length = 0;
+
+    NSMutableArray *headerFields = [[NSMutableArray alloc] init];
+    NSMutableArray *records = [[NSMutableArray alloc] init];
     NSMutableDictionary *fields = [[NSMutableDictionary alloc] init];
 
-    while (currentField < end) {
-        FieldHeader *fieldStart = (FieldHeader *)currentField;
+    while (YES) {
+        [metrics beginStage:kSerializationStageCipher];
+        result = readField(&reader, &skey, ivForThisBlock, &field, &capacity, &length);
+        [metrics endStage:kSerializationStageCipher];
 
-        [dataForHmac appendBytes:&(fieldStart->data) length:fieldStart->length];
+        if (result != kPwSafeReadField) {
+            break;
+        }
 
-        if (hdrDone) {
-            Field *field = [[Field alloc] initWithData:[NSData dataWithBytes:(&fieldStart->data)
-                                                                      length:fieldStart->length]
-                                                  type:fieldStart->type];
+        [metrics addBytes:blocksForField(length) * TWOFISH_BLOCK_SIZE stage:kSerializationStageCipher];
+
+        [metrics beginStage:kSerializationStageIntegrity];
+        CCHmacUpdate(&hmac, &field[FIELD_HEADER_LENGTH], length);
+        [metrics endStage:kSerializationStageIntegrity];
+        [metrics addBytes:length stage:kSerializationStageIntegrity];
 
-            if (fieldStart->type == FIELD_TYPE_END) {
-                Record *newRecord = [[Record alloc] initWithFields:fields];
-                
-                [*records_p addObject:newRecord];
+        unsigned char type = field[FIELD_HEADER_LENGTH - 1];
+        NSData *data = [NSData dataWithBytes:&field[FIELD_HEADER_LENGTH] length:length];
 
+        if (hdrDone) {
+            if (type == FIELD_TYPE_END) {
+                [records addObject:[[Record alloc] initWithFields:fields]];
                 fields = [[NSMutableDictionary alloc] init];
             }
             else {
-                NSNumber *type = [NSNumber numberWithInt:fieldStart->type];
-                fields[type] = field;
-                
+                fields[[NSNumber numberWithInt:type]] = [[Field alloc] initWithData:data type:type];
             }
         }
         else {
-            Field *field = [[Field alloc] initNewDbHeaderField:fieldStart->type withData:[NSData dataWithBytes:(&fieldStart->data) length:fieldStart->length]];
-
-            if (fieldStart->type == HDR_END) {
+            if (type == HDR_END) {
                 hdrDone = YES;
             }
             else {
-                [*headerFields_p addObject:field];
+                [headerFields addObject:[[Field alloc] initNewDbHeaderField:type withData:data]];
             }
         }
+    }
+
+    unsigned char actualHmac[CC_SHA256_DIGEST_LENGTH];
+    BOOL hmacRead = result == kPwSafeReadEof && readBytes(&reader, actualHmac, CC_SHA256_DIGEST_LENGTH);
+
+    unsigned char computedHmac[CC_SHA256_DIGEST_LENGTH];
+    [metrics beginStage:kSerializationStageIntegrity];
+    CCHmacFinal(&hmac, computedHmac);
+    [metrics endStage:kSerializationStageIntegrity];
+
+    if (field) {
+        memset(field, 0, capacity);
+        free(field);
+    }
+    free(reader.buffer);
+
+    if (!hmacRead) {
+        NSLog(@"Could not read Password Safe records: [%d]", result);
+
+        if (error) {
+            *error = stream.streamError ? stream.streamError : [Utils createNSError:@"This is not a valid Password Safe 3 File (Invalid Format)." errorCode:-1];
+        }
 
-        int add = (fieldStart->length + FIELD_HEADER_LENGTH);
+        return NO;
+    }
 
-        if (add % TWOFISH_BLOCK_SIZE != 0) {
-            int sub = add % TWOFISH_BLOCK_SIZE;
-            add += TWOFISH_BLOCK_SIZE - sub;
+    if (memcmp(actualHmac, computedHmac, CC_SHA256_DIGEST_LENGTH) != 0) {
+        NSLog(@"HMAC is no good! Corrupted Safe!");
+
+        if (error) {
+            *error = [Utils createNSError:@"The data is corrupted (HMAC incorrect)." errorCode:-3];
         }
 
-        currentField += add;
+        return NO;
     }
 
-    free(raw);
+    *headerFields_p = headerFields;
+    *records_p = records;
 
-    return dataForHmac;
+    return YES;
 }
 
 @end
@@ -0,0 +1,270 @@
+//
+//  sha256_iterate.c
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#include "sha256_iterate.h"
+
+#include <string.h>
+
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#define SHA256_ITERATE_ARMV8 1
+#include <arm_neon.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#define SHA256_ITERATE_X86 1
+#include <cpuid.h>
+#include <pthread.h>
+#include <immintrin.h>
+#endif
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t H0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+// Message words 8..15 for a 32 byte message: the 0x80 terminator, zeros, then the bit length (256).
+#define PAD_WORD_8  0x80000000
+#define PAD_WORD_15 0x00000100
+
+static void load_words(const uint8_t digest[SHA256_ITERATE_DIGEST_LENGTH], uint32_t words[8]) {
+    for (int i = 0; i < 8; i++) {
+        words[i] = ((uint32_t)digest[i * 4] << 24) | ((uint32_t)digest[i * 4 + 1] << 16) | ((uint32_t)digest[i * 4 + 2] << 8) | digest[i * 4 + 3];
+    }
+}
+
+static void store_words(const uint32_t words[8], uint8_t digest[SHA256_ITERATE_DIGEST_LENGTH]) {
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4]     = (uint8_t)(words[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(words[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(words[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)words[i];
+    }
+}
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+void sha256_iterate_portable(uint8_t digest[SHA256_ITERATE_DIGEST_LENGTH], uint64_t iterations) {
+    uint32_t h[8];
+    uint32_t w[64];
+
+    load_words(digest, h);
+
+    for (uint64_t n = 0; n < iterations; n++) {
+        memcpy(w, h, sizeof(h));
+        w[8] = PAD_WORD_8;
+        memset(&w[9], 0, 6 * sizeof(uint32_t));
+        w[15] = PAD_WORD_15;
+
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = H0[0], b = H0[1], c = H0[2], d = H0[3], e = H0[4], f = H0[5], g = H0[6], hh = H0[7];
+
+        for (int i = 0; i < 64; i++) {
+            uint32_t t1 = hh + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+
+            hh = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        h[0] = H0[0] + a; h[1] = H0[1] + b; h[2] = H0[2] + c; h[3] = H0[3] + d;
+        h[4] = H0[4] + e; h[5] = H0[5] + f; h[6] = H0[6] + g; h[7] = H0[7] + hh;
+    }
+
+    store_words(h, digest);
+}
+
+#if SHA256_ITERATE_ARMV8
+
+// State lanes are in natural order (ABCD, EFGH), so the output of one iteration is the first half
+// of the next message as is.
+
+#define ARMV8_QUAD(i, m0, m1, m2, m3) do {                     \
+        uint32x4_t wk = vaddq_u32(m0, vld1q_u32(&K[(i) * 4])); \
+        uint32x4_t abcd = state0;                              \
+        if ((i) < 12) m0 = vsha256su0q_u32(m0, m1);            \
+        state0 = vsha256hq_u32(state0, state1, wk);            \
+        state1 = vsha256h2q_u32(state1, abcd, wk);             \
+        if ((i) < 12) m0 = vsha256su1q_u32(m0, m2, m3);        \
+    } while (0)
+
+static void sha256_iterate_armv8(uint8_t digest[SHA256_ITERATE_DIGEST_LENGTH], uint64_t iterations) {
+    uint32_t words[8];
+    load_words(digest, words);
+
+    const uint32x4_t h0 = vld1q_u32(&H0[0]);
+    const uint32x4_t h1 = vld1q_u32(&H0[4]);
+    const uint32_t pad2[4] = { PAD_WORD_8, 0, 0, 0 };
+    const uint32_t pad3[4] = { 0, 0, 0, PAD_WORD_15 };
+
+    uint32x4_t out0 = vld1q_u32(&words[0]);
+    uint32x4_t out1 = vld1q_u32(&words[4]);
+
+    for (uint64_t n = 0; n < iterations; n++) {
+        uint32x4_t m0 = out0, m1 = out1, m2 = vld1q_u32(pad2), m3 = vld1q_u32(pad3);
+        uint32x4_t state0 = h0, state1 = h1;
+
+        ARMV8_QUAD(0, m0, m1, m2, m3);
+        ARMV8_QUAD(1, m1, m2, m3, m0);
+        ARMV8_QUAD(2, m2, m3, m0, m1);
+        ARMV8_QUAD(3, m3, m0, m1, m2);
+        ARMV8_QUAD(4, m0, m1, m2, m3);
+        ARMV8_QUAD(5, m1, m2, m3, m0);
+        ARMV8_QUAD(6, m2, m3, m0, m1);
+        ARMV8_QUAD(7, m3, m0, m1, m2);
+        ARMV8_QUAD(8, m0, m1, m2, m3);
+        ARMV8_QUAD(9, m1, m2, m3, m0);
+        ARMV8_QUAD(10, m2, m3, m0, m1);
+        ARMV8_QUAD(11, m3, m0, m1, m2);
+        ARMV8_QUAD(12, m0, m1, m2, m3);
+        ARMV8_QUAD(13, m1, m2, m3, m0);
+        ARMV8_QUAD(14, m2, m3, m0, m1);
+        ARMV8_QUAD(15, m3, m0, m1, m2);
+
+        out0 = vaddq_u32(state0, h0);
+        out1 = vaddq_u32(state1, h1);
+    }
+
+    vst1q_u32(&words[0], out0);
+    vst1q_u32(&words[4], out1);
+    store_words(words, digest);
+}
+
+#endif
+
+#if SHA256_ITERATE_X86
+
+// SHA-NI keeps the state as ABEF / CDGH. Each iteration ends with the same shuffle the reference code uses
+// to store the digest, which leaves ABCD / EFGH as native words, i.e. the first half of the next message.
+
+#define SHANI_QUAD(i, m0, m1, m3) do {                                                   \
+        __m128i msg = _mm_add_epi32(m0, _mm_loadu_si128((const __m128i*)&K[(i) * 4]));   \
+        state1 = _mm_sha256rnds2_epu32(state1, state0, msg);                             \
+        if ((i) >= 3 && (i) < 15) {                                                      \
+            m1 = _mm_add_epi32(m1, _mm_alignr_epi8(m0, m3, 4));                          \
+            m1 = _mm_sha256msg2_epu32(m1, m0);                                           \
+        }                                                                                \
+        msg = _mm_shuffle_epi32(msg, 0x0E);                                              \
+        state0 = _mm_sha256rnds2_epu32(state0, state1, msg);                             \
+        if ((i) >= 1 && (i) < 13) m3 = _mm_sha256msg1_epu32(m3, m0);                     \
+    } while (0)
+
+__attribute__((target("sha,sse4.1,ssse3")))
+static void sha256_iterate_shani(uint8_t digest[SHA256_ITERATE_DIGEST_LENGTH], uint64_t iterations) {
+    uint32_t words[8];
+    load_words(digest, words);
+
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&H0[0]), 0xB1);
+    __m128i h1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&H0[4]), 0x1B);
+    const __m128i h0 = _mm_alignr_epi8(tmp, h1, 8);
+    h1 = _mm_blend_epi16(h1, tmp, 0xF0);
+
+    const __m128i pad2 = _mm_set_epi32(0, 0, 0, (int)PAD_WORD_8);
+    const __m128i pad3 = _mm_set_epi32(PAD_WORD_15, 0, 0, 0);
+
+    __m128i out0 = _mm_loadu_si128((const __m128i*)&words[0]);
+    __m128i out1 = _mm_loadu_si128((const __m128i*)&words[4]);
+
+    for (uint64_t n = 0; n < iterations; n++) {
+        __m128i m0 = out0, m1 = out1, m2 = pad2, m3 = pad3;
+        __m128i state0 = h0, state1 = h1;
+
+        SHANI_QUAD(0, m0, m1, m3);
+        SHANI_QUAD(1, m1, m2, m0);
+        SHANI_QUAD(2, m2, m3, m1);
+        SHANI_QUAD(3, m3, m0, m2);
+        SHANI_QUAD(4, m0, m1, m3);
+        SHANI_QUAD(5, m1, m2, m0);
+        SHANI_QUAD(6, m2, m3, m1);
+        SHANI_QUAD(7, m3, m0, m2);
+        SHANI_QUAD(8, m0, m1, m3);
+        SHANI_QUAD(9, m1, m2, m0);
+        SHANI_QUAD(10, m2, m3, m1);
+        SHANI_QUAD(11, m3, m0, m2);
+        SHANI_QUAD(12, m0, m1, m3);
+        SHANI_QUAD(13, m1, m2, m0);
+        SHANI_QUAD(14, m2, m3, m1);
+        SHANI_QUAD(15, m3, m0, m2);
+
+        state0 = _mm_add_epi32(state0, h0);
+        state1 = _mm_add_epi32(state1, h1);
+
+        tmp = _mm_shuffle_epi32(state0, 0x1B);
+        state1 = _mm_shuffle_epi32(state1, 0xB1);
+        out0 = _mm_blend_epi16(tmp, state1, 0xF0);
+        out1 = _mm_alignr_epi8(state1, tmp, 8);
+    }
+
+    _mm_storeu_si128((__m128i*)&words[0], out0);
+    _mm_storeu_si128((__m128i*)&words[4], out1);
+    store_words(words, digest);
+}
+
+static int shani_available = 0;
+static pthread_once_t shani_once = PTHREAD_ONCE_INIT;
+
+static void detect_shani(void) {
+    unsigned int eax, ebx, ecx, edx;
+    int ssse3 = 0, sse41 = 0, sha = 0;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        ssse3 = (ecx >> 9) & 1;
+        sse41 = (ecx >> 19) & 1;
+    }
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        sha = (ebx >> 29) & 1;
+    }
+
+    shani_available = ssse3 && sse41 && sha;
+}
+
+static int cpu_has_shani(void) {
+    pthread_once(&shani_once, detect_shani);
+
+    return shani_available;
+}
+
+#endif
+
+void sha256_iterate(uint8_t digest[SHA256_ITERATE_DIGEST_LENGTH], uint64_t iterations) {
+#if SHA256_ITERATE_ARMV8
+    sha256_iterate_armv8(digest, iterations);
+#elif SHA256_ITERATE_X86
+    if (cpu_has_shani()) {
+        sha256_iterate_shani(digest, iterations);
+    }
+    else {
+        sha256_iterate_portable(digest, iterations);
+    }
+#else
+    sha256_iterate_portable(digest, iterations);
+#endif
+}
+
+const char* sha256_iterate_implementation(void) {
+#if SHA256_ITERATE_ARMV8
+    return "armv8";
+#elif SHA256_ITERATE_X86
+    return cpu_has_shani() ? "sha-ni" : "portable";
+#else
+    return "portable";
+#endif
+}
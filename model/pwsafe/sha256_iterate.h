@@ -0,0 +1,27 @@
+//
+//  sha256_iterate.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+//  Password Safe 3 key stretching: digest = SHA-256(digest), repeated. The message is always exactly one
+//  32 byte digest so each iteration is a single compression over a block whose padding words are constant.
+//
+
+#ifndef sha256_iterate_h
+#define sha256_iterate_h
+
+#include <stdint.h>
+
+#define SHA256_ITERATE_DIGEST_LENGTH 32
+
+// Uses the ARMv8 SHA-2 or x86 SHA-NI instructions when available, otherwise the portable kernel.
+void sha256_iterate(uint8_t digest[SHA256_ITERATE_DIGEST_LENGTH], uint64_t iterations);
+
+void sha256_iterate_portable(uint8_t digest[SHA256_ITERATE_DIGEST_LENGTH], uint64_t iterations);
+
+// "armv8", "sha-ni" or "portable"
+const char* sha256_iterate_implementation(void);
+
+#endif /* sha256_iterate_h */
@@ -9,29 +9,54 @@
 import Foundation
 
 class ApplePasswordManagerQuirks {
-    private var equivalents: [String: [String]] = [:]
+    private var groupIds: [String: Int] = [:]
+    private var groupDomains: [Set<String>] = []
 
     static let shared = ApplePasswordManagerQuirks()
 
     private init() {
-        let decoder = JSONDecoder()
-
-        guard let url = Bundle.main.url(forResource: "websites-with-shared-credential-backends", withExtension: "json"),
-              let data = try? Data(contentsOf: url),
-              let equivs = try? decoder.decode([[String]].self, from: data)
-        else {
-            NSLog("🔴 Could not load file 'websites-with-shared-credential-backends.json' from Bundle!")
-            return
-        }
+        let domains = ApplePasswordManagerQuirks.equivalentDomains
+        let starts = ApplePasswordManagerQuirks.equivalentDomainGroupStarts
+
+        groupIds.reserveCapacity(domains.count)
+        groupDomains.reserveCapacity(starts.count - 1)
 
-        for eqGroup in equivs {
-            for eq in eqGroup {
-                equivalents[eq] = eqGroup
+        for groupId in 0 ..< starts.count - 1 {
+            let group = domains[starts[groupId] ..< starts[groupId + 1]]
+
+            for domain in group {
+                groupIds[domain] = groupId
             }
+
+            groupDomains.append(Set(group))
+        }
+    }
+
+    var groupCount: Int {
+        groupDomains.count
+    }
+
+    func groupId(_ domain: String) -> Int? {
+        groupIds[domain] ?? groupIds[domain.lowercased()]
+    }
+
+    func domains(groupId: Int) -> Set<String> {
+        groupDomains[groupId]
+    }
+
+    func areEquivalent(_ domain: String, _ other: String) -> Bool {
+        guard let groupId = groupId(domain) else {
+            return false
         }
+
+        return groupId == self.groupId(other)
     }
 
     func getEquivalentDomains(_ domain: String) -> Set<String> {
-        Set(equivalents[domain.lowercased()] ?? [])
+        guard let groupId = groupId(domain) else {
+            return []
+        }
+
+        return groupDomains[groupId]
     }
 }
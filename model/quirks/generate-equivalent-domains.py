@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+#
+#  generate-equivalent-domains.py
+#  Strongbox
+#
+#  Compiles websites-with-shared-credential-backends.json into ApplePasswordManagerEquivalentDomains.swift.
+#  Run from this directory after updating the JSON.
+#
+
+import json
+import os
+import sys
+
+here = os.path.dirname(os.path.abspath(__file__))
+
+with open(os.path.join(here, "websites-with-shared-credential-backends.json")) as f:
+    groups = json.load(f)
+
+domains = []
+starts = []
+seen = set()
+
+for group in groups:
+    starts.append(len(domains))
+
+    for domain in group:
+        domain = domain.lower()
+
+        if domain in seen:
+            sys.exit("Domain '%s' appears in more than one group" % domain)
+
+        seen.add(domain)
+        domains.append(domain)
+
+starts.append(len(domains))
+
+lines = [
+    "//",
+    "//  ApplePasswordManagerEquivalentDomains.swift",
+    "//  Strongbox",
+    "//",
+    "//  Generated from websites-with-shared-credential-backends.json by generate-equivalent-domains.py. Do not edit.",
+    "//",
+    "",
+    "extension ApplePasswordManagerQuirks {",
+    "    static let equivalentDomains: [String] = [",
+]
+
+for domain in domains:
+    lines.append("        %s," % json.dumps(domain))
+
+lines.append("    ]")
+lines.append("")
+lines.append("    static let equivalentDomainGroupStarts: [Int] = [")
+
+for i in range(0, len(starts), 16):
+    lines.append("        %s," % ", ".join(str(s) for s in starts[i:i + 16]))
+
+lines.append("    ]")
+lines.append("}")
+
+with open(os.path.join(here, "ApplePasswordManagerEquivalentDomains.swift"), "w") as f:
+    f.write("\n".join(lines) + "\n")
@@ -0,0 +1,107 @@
+//
+//  make_common_password_filter.c
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+//  Compiles one or more newline separated word lists into the xor filter blob that PasswordMaker memory maps.
+//
+//  cc -O2 -o make_common_password_filter make_common_password_filter.c xor16_filter.c
+//  ./make_common_password_filter ../../resources/common-passwords.xor16 ../../resources/10-million-password-list-top-10000.txt ../../resources/wordlists/eff_large_wordlist.utf8.txt
+//
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "xor16_filter.h"
+
+static bool add_list(const char* path, uint64_t** keys, size_t* count, size_t* capacity) {
+    FILE* file = fopen(path, "rb");
+    if ( !file ) {
+        fprintf(stderr, "Could not open %s\n", path);
+        return false;
+    }
+
+    char* line = NULL;
+    size_t lineCapacity = 0;
+    ssize_t length;
+
+    while ( (length = getline(&line, &lineCapacity, file)) >= 0 ) {
+        char* start = line;
+        char* end = line + length;
+
+        while ( start < end && isspace((unsigned char)*start) ) start++;
+        while ( end > start && isspace((unsigned char)end[-1]) ) end--;
+
+        if ( start == end ) {
+            continue;
+        }
+
+        for ( char* p = start; p < end; p++ ) {
+            *p = (char)tolower((unsigned char)*p);
+        }
+
+        if ( *count == *capacity ) {
+            *capacity = *capacity ? *capacity * 2 : 65536;
+            *keys = realloc(*keys, *capacity * sizeof(uint64_t));
+            if ( !*keys ) {
+                fclose(file);
+                free(line);
+                return false;
+            }
+        }
+
+        (*keys)[(*count)++] = xor16_hash_bytes(start, end - start);
+    }
+
+    free(line);
+    fclose(file);
+
+    return true;
+}
+
+int main(int argc, const char* argv[]) {
+    if ( argc < 3 ) {
+        fprintf(stderr, "Usage: %s <output> <wordlist> [<wordlist> ...]\n", argv[0]);
+        return 1;
+    }
+
+    uint64_t* keys = NULL;
+    size_t count = 0, capacity = 0;
+
+    for ( int i = 2; i < argc; i++ ) {
+        if ( !add_list(argv[i], &keys, &count, &capacity) ) {
+            return 1;
+        }
+    }
+
+    xor16_filter_t filter;
+    uint16_t* fingerprints;
+
+    if ( !xor16_populate(keys, count, &filter, &fingerprints) ) {
+        fprintf(stderr, "Could not build filter for %zu keys\n", count);
+        return 1;
+    }
+
+    size_t size = xor16_serialized_size(&filter);
+    uint8_t* buffer = malloc(size);
+    xor16_serialize(&filter, buffer);
+
+    FILE* out = fopen(argv[1], "wb");
+    if ( !out || fwrite(buffer, 1, size, out) != size ) {
+        fprintf(stderr, "Could not write %s\n", argv[1]);
+        return 1;
+    }
+    fclose(out);
+
+    printf("%u keys, %zu bytes (%.2f bits per key)\n", filter.keyCount, size, filter.keyCount ? 8.0 * size / filter.keyCount : 0.0);
+
+    free(buffer);
+    free(fingerprints);
+    free(keys);
+
+    return 0;
+}
@@ -0,0 +1,266 @@
+//
+//  xor16_filter.c
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+
+#include "xor16_filter.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const int kMaxPopulateAttempts = 100;
+
+static inline uint64_t mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint64_t rotl64(uint64_t n, unsigned int c) {
+    return (n << (c & 63)) | (n >> ((-c) & 63));
+}
+
+static inline uint32_t reduce(uint32_t hash, uint32_t n) {
+    return (uint32_t)(((uint64_t)hash * n) >> 32);
+}
+
+static inline uint16_t fingerprint(uint64_t hash) {
+    return (uint16_t)(hash ^ (hash >> 32));
+}
+
+static inline uint32_t slot(uint64_t hash, int index, uint32_t blockLength) {
+    return reduce((uint32_t)rotl64(hash, index * 21), blockLength) + index * blockLength;
+}
+
+static inline uint64_t next_seed(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static int compare_keys(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+uint64_t xor16_hash_bytes(const void* data, size_t length) {
+    const uint8_t* p = data;
+    uint64_t h = 0xcbf29ce484222325ULL;
+
+    for ( size_t i = 0; i < length; i++ ) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+
+    return mix(h);
+}
+
+bool xor16_contains(const xor16_filter_t* filter, uint64_t key) {
+    if ( filter->blockLength == 0 ) {
+        return false;
+    }
+
+    uint64_t hash = mix(key + filter->seed);
+    uint16_t f = fingerprint(hash);
+
+    f ^= filter->fingerprints[slot(hash, 0, filter->blockLength)];
+    f ^= filter->fingerprints[slot(hash, 1, filter->blockLength)];
+    f ^= filter->fingerprints[slot(hash, 2, filter->blockLength)];
+
+    return f == 0;
+}
+
+bool xor16_populate(uint64_t* keys, size_t count, xor16_filter_t* filter, uint16_t** fingerprints) {
+    qsort(keys, count, sizeof(uint64_t), compare_keys);
+
+    size_t unique = 0;
+    for ( size_t i = 0; i < count; i++ ) {
+        if ( unique == 0 || keys[unique - 1] != keys[i] ) {
+            keys[unique++] = keys[i];
+        }
+    }
+    count = unique;
+
+    if ( count > UINT32_MAX / 2 ) {
+        return false;
+    }
+
+    uint32_t blockLength = (uint32_t)((32 + 1.23 * count) / 3) + 1;
+    uint32_t capacity = 3 * blockLength;
+
+    uint16_t* out = calloc(capacity, sizeof(uint16_t));
+    uint64_t* xormask = malloc(capacity * sizeof(uint64_t));
+    uint8_t* counts = malloc(capacity);
+    uint32_t* queue = malloc(capacity * sizeof(uint32_t));
+    uint64_t* stackHash = malloc((count + 1) * sizeof(uint64_t));
+    uint8_t* stackIndex = malloc(count + 1);
+
+    if ( !out || !xormask || !counts || !queue || !stackHash || !stackIndex ) {
+        free(out); free(xormask); free(counts); free(queue); free(stackHash); free(stackIndex);
+        return false;
+    }
+
+    uint64_t seedState = 0x5374726f6e67626fULL;
+    bool success = false;
+
+    for ( int attempt = 0; attempt < kMaxPopulateAttempts && !success; attempt++ ) {
+        uint64_t seed = next_seed(&seedState);
+
+        memset(xormask, 0, capacity * sizeof(uint64_t));
+        memset(counts, 0, capacity);
+
+        for ( size_t i = 0; i < count; i++ ) {
+            uint64_t hash = mix(keys[i] + seed);
+
+            for ( int j = 0; j < 3; j++ ) {
+                uint32_t s = slot(hash, j, blockLength);
+                xormask[s] ^= hash;
+                counts[s]++;
+            }
+        }
+
+        size_t queueLength = 0;
+        for ( uint32_t s = 0; s < capacity; s++ ) {
+            if ( counts[s] == 1 ) {
+                queue[queueLength++] = s;
+            }
+        }
+
+        size_t stackLength = 0;
+        while ( queueLength > 0 ) {
+            uint32_t s = queue[--queueLength];
+            if ( counts[s] != 1 ) {
+                continue;
+            }
+
+            uint64_t hash = xormask[s];
+            int found = (int)(s / blockLength);
+
+            stackHash[stackLength] = hash;
+            stackIndex[stackLength] = (uint8_t)found;
+            stackLength++;
+
+            for ( int j = 0; j < 3; j++ ) {
+                uint32_t other = slot(hash, j, blockLength);
+                xormask[other] ^= hash;
+                counts[other]--;
+
+                if ( j != found && counts[other] == 1 ) {
+                    queue[queueLength++] = other;
+                }
+            }
+        }
+
+        if ( stackLength != count ) {
+            continue;
+        }
+
+        memset(out, 0, capacity * sizeof(uint16_t));
+
+        while ( stackLength > 0 ) {
+            stackLength--;
+            uint64_t hash = stackHash[stackLength];
+            int found = stackIndex[stackLength];
+
+            uint16_t f = fingerprint(hash);
+            for ( int j = 0; j < 3; j++ ) {
+                if ( j != found ) {
+                    f ^= out[slot(hash, j, blockLength)];
+                }
+            }
+
+            out[slot(hash, found, blockLength)] = f;
+        }
+
+        filter->seed = seed;
+        filter->blockLength = blockLength;
+        filter->keyCount = (uint32_t)count;
+        filter->fingerprints = out;
+        success = true;
+    }
+
+    free(xormask); free(counts); free(queue); free(stackHash); free(stackIndex);
+
+    if ( success ) {
+        *fingerprints = out;
+    }
+    else {
+        free(out);
+    }
+
+    return success;
+}
+
+static void write_u32(uint8_t* p, uint32_t v) {
+    for ( int i = 0; i < 4; i++ ) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void write_u64(uint8_t* p, uint64_t v) {
+    for ( int i = 0; i < 8; i++ ) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint32_t read_u32(const uint8_t* p) {
+    uint32_t v = 0;
+    for ( int i = 3; i >= 0; i-- ) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static uint64_t read_u64(const uint8_t* p) {
+    uint64_t v = 0;
+    for ( int i = 7; i >= 0; i-- ) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+size_t xor16_serialized_size(const xor16_filter_t* filter) {
+    return XOR16_FILTER_HEADER_SIZE + (size_t)3 * filter->blockLength * sizeof(uint16_t);
+}
+
+void xor16_serialize(const xor16_filter_t* filter, uint8_t* buffer) {
+    memset(buffer, 0, XOR16_FILTER_HEADER_SIZE);
+    memcpy(buffer, XOR16_FILTER_MAGIC, 4);
+    write_u32(&buffer[4], XOR16_FILTER_VERSION);
+    write_u64(&buffer[8], filter->seed);
+    write_u32(&buffer[16], filter->blockLength);
+    write_u32(&buffer[20], filter->keyCount);
+
+    uint8_t* p = &buffer[XOR16_FILTER_HEADER_SIZE];
+    for ( size_t i = 0; i < (size_t)3 * filter->blockLength; i++ ) {
+        p[2 * i] = (uint8_t)filter->fingerprints[i];
+        p[2 * i + 1] = (uint8_t)(filter->fingerprints[i] >> 8);
+    }
+}
+
+bool xor16_deserialize(const uint8_t* buffer, size_t length, xor16_filter_t* filter) {
+    if ( length < XOR16_FILTER_HEADER_SIZE || memcmp(buffer, XOR16_FILTER_MAGIC, 4) != 0 || read_u32(&buffer[4]) != XOR16_FILTER_VERSION ) {
+        return false;
+    }
+
+    xor16_filter_t ret;
+    ret.seed = read_u64(&buffer[8]);
+    ret.blockLength = read_u32(&buffer[16]);
+    ret.keyCount = read_u32(&buffer[20]);
+    ret.fingerprints = (const uint16_t*)&buffer[XOR16_FILTER_HEADER_SIZE]; // Read in place, every target we ship is little endian
+
+    if ( length != xor16_serialized_size(&ret) ) {
+        return false;
+    }
+
+    *filter = ret;
+
+    return true;
+}
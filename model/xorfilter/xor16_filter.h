@@ -0,0 +1,42 @@
+//
+//  xor16_filter.h
+//  Strongbox
+//
+//  Created by Strongbox on 19/10/2026.
+//  Copyright © 2014-2026 Mark McGuill. All rights reserved.
+//
+//  Static set membership with 16 bit fingerprints (Graf & Lemire, "Xor Filters", 2019).
+//  ~19.7 bits per key, false positive rate ~1/65536, no false negatives.
+//
+
+#ifndef xor16_filter_h
+#define xor16_filter_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define XOR16_FILTER_MAGIC "SBXF"
+#define XOR16_FILTER_VERSION 1
+#define XOR16_FILTER_HEADER_SIZE 32
+
+typedef struct {
+    uint64_t seed;
+    uint32_t blockLength;
+    uint32_t keyCount;
+    const uint16_t* fingerprints;
+} xor16_filter_t;
+
+uint64_t xor16_hash_bytes(const void* data, size_t length);
+
+bool xor16_contains(const xor16_filter_t* filter, uint64_t key);
+
+// Sorts and de-duplicates keys in place. On success *fingerprints is malloc'd and owned by the caller.
+bool xor16_populate(uint64_t* keys, size_t count, xor16_filter_t* filter, uint16_t** fingerprints);
+
+// Serialized layout (little endian): magic[4], version u32, seed u64, blockLength u32, keyCount u32, reserved u64, fingerprints u16[3 * blockLength]
+size_t xor16_serialized_size(const xor16_filter_t* filter);
+void xor16_serialize(const xor16_filter_t* filter, uint8_t* buffer);
+bool xor16_deserialize(const uint8_t* buffer, size_t length, xor16_filter_t* filter);
+
+#endif /* xor16_filter_h */